@@ -70,6 +70,7 @@ TaskScheduler m_Scheduler;
 
 Manager m_Manager( "Manager"
                  , m_StatisticalEngine
+                 , m_VisualizationPlayer
                  , m_BT_In
                  , m_Mic_In
                  , m_I2S_Out );
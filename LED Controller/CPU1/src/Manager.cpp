@@ -17,14 +17,17 @@
 */
 
 #include "Manager.h"
+#include "VisualizationPlayer.h"
 
 Manager::Manager( String Title
                 , StatisticalEngine &StatisticalEngine
+                , VisualizationPlayer &visualizationPlayer
                 , Bluetooth_Sink &bluetooth_Sink
                 , I2S_Device &microphone
                 , I2S_Device &i2S_Out )
                 : NamedItem(Title)
                 , m_StatisticalEngine(StatisticalEngine)
+                , m_VisualizationPlayer(visualizationPlayer)
                 , m_Bluetooth_Sink(bluetooth_Sink)
                 , m_Microphone(microphone)
                 , m_I2S_Out(i2S_Out)
@@ -54,6 +57,9 @@ void Manager::SetupDevices()
 
 void Manager::SetupSerialPortManager()
 {
+  m_CPU1SerialPortMessageManager.SetLinkHealthCallback([this](const LinkHealth_t &Health){ m_Link_Health_1_2.SetValue(Health); });
+  m_CPU3SerialPortMessageManager.SetLinkHealthCallback([this](const LinkHealth_t &Health){ m_Link_Health_1_3.SetValue(Health); });
+  m_CPU1SerialPortMessageManager.SetRxMaxAge(CPU2_MAX_FRAME_AGE_US);
   m_CPU1SerialPortMessageManager.Setup();
   m_CPU3SerialPortMessageManager.Setup();
 }
@@ -61,6 +67,8 @@ void Manager::SetupSerialPortManager()
 void Manager::SetupStatisticalEngine()
 {
   m_StatisticalEngine.RegisterForSoundStateChangeNotification(this);
+  //CPU2's reply only calls back if it differs from the request, so start from the requested band count
+  m_StatisticalEngine.SetNumberOfBands(m_Band_Layout.GetValue().BandCount);
 }
 
 void Manager::SetupTasks()
@@ -71,6 +79,12 @@ void Manager::SoundStateChange(SoundState_t SoundState)
 {
 }
 
+void Manager::ToneTriggered(const ToneTrigger_t &Trigger)
+{
+  ESP_LOGI("Manager::ToneTriggered", "Tone Trigger %i: %f Hz Magnitude: %f", Trigger.DetectorIndex, Trigger.Frequency, Trigger.Magnitude);
+  if(Trigger.DetectorIndex >= 0) m_VisualizationPlayer.RequestVisualization(Trigger.DetectorIndex);
+}
+
 void Manager::SetInputSource(SoundInputSource_t Type)
 {
   switch(Type)
@@ -89,7 +103,7 @@ void Manager::SetInputSource(SoundInputSource_t Type)
       m_Microphone.StopDevice();
       m_I2S_Out.StopDevice();
       m_Bluetooth_Sink.StartDevice();
-      m_Bluetooth_Sink.Connect(m_SinkName.GetValuePointer(), m_SinkAutoReConnect.GetValue());
+      m_Bluetooth_Sink.Connect(m_SinkName.GetValueAsString(), m_SinkAutoReConnect.GetValue());
     }
     break;
     case SoundInputSource_t::OFF:
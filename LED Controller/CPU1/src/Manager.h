@@ -28,6 +28,8 @@
 #include "HardwareSerial.h"
 #include "DataItem/DataItems.h"
 
+class VisualizationPlayer;
+
 class Manager: public NamedItem
              , public Bluetooth_Sink_Callbacks
              , public SoundMeasureCalleeInterface
@@ -38,6 +40,7 @@ class Manager: public NamedItem
   public:
     Manager( String Title
            , StatisticalEngine &statisticalEngine
+           , VisualizationPlayer &visualizationPlayer
            , Bluetooth_Sink &bluetooth_Sink
            , I2S_Device &microphone
            , I2S_Device &i2S_Out );
@@ -149,6 +152,7 @@ class Manager: public NamedItem
 
     void SetupStatisticalEngine();
     StatisticalEngine &m_StatisticalEngine;
+    VisualizationPlayer &m_VisualizationPlayer;
     Mute_State_t m_MuteState = Mute_State_t::Mute_State_Un_Muted;
 
     //Bluetooth Data
@@ -261,7 +265,7 @@ class Manager: public NamedItem
           if(sinkConnect)
           {
             ESP_LOGI("SinkConnect_ValueChanged", "Sink Connecting");
-            pBT_In->Connect(pBluetoothSinkName->GetValuePointer(), pBluetoothSinkAutoReConnect->GetValue());
+            pBT_In->Connect(pBluetoothSinkName->GetValueAsString(), pBluetoothSinkAutoReConnect->GetValue());
           }
         }
         else
@@ -322,4 +326,200 @@ class Manager: public NamedItem
                                                                                                      , NULL
                                                                                                      , this );
 
+    //Band Layout requested from CPU2. CPU2 sends the layout back once it is applied, or the layout it kept if the
+    //request was rejected, and the statistical engine takes its band count from that reply.
+    CallbackArguments m_Band_Layout_CallbackArgs = {this};
+    NamedCallback_t m_Band_Layout_Callback = { "Band Layout Callback"
+                                             , &Band_Layout_ValueChanged
+                                             , &m_Band_Layout_CallbackArgs };
+    BandLayout_t m_Band_Layout_InitialValue = BAND_LAYOUT_REQUEST;
+    DataItem<BandLayout_t, 1> m_Band_Layout = DataItem<BandLayout_t, 1>( "Band_Layout"
+                                                                      , m_Band_Layout_InitialValue
+                                                                      , RxTxType_Tx_On_Change
+                                                                      , 0
+                                                                      , &m_CPU1SerialPortMessageManager
+                                                                      , &m_Band_Layout_Callback
+                                                                      , this );
+    static void Band_Layout_ValueChanged(const String &Name, void* object, void* arg)
+    {
+      if(arg && object)
+      {
+        CallbackArguments* arguments = static_cast<CallbackArguments*>(arg);
+        assert(arguments->arg1 && "Null Pointer!");
+        Manager *manager = static_cast<Manager*>(arguments->arg1);
+        manager->m_StatisticalEngine.SetNumberOfBands(static_cast<BandLayout_t*>(object)->BandCount);
+      }
+    }
+
+    //Bands from CPU2. Only the item matching CPU2's band count is sent, the others stay quiet.
+    CallbackArguments m_Bands_CallbackArgs = {this};
+    template<size_t COUNT>
+    static void Right_Bands_ValueChanged(const String &Name, void* object, void* arg)
+    {
+      if(arg && object)
+      {
+        CallbackArguments* arguments = static_cast<CallbackArguments*>(arg);
+        assert(arguments->arg1 && "Null Pointer!");
+        Manager *manager = static_cast<Manager*>(arguments->arg1);
+        manager->m_StatisticalEngine.SetRightBandValues(static_cast<float*>(object), COUNT);
+      }
+    }
+    template<size_t COUNT>
+    static void Left_Bands_ValueChanged(const String &Name, void* object, void* arg)
+    {
+      if(arg && object)
+      {
+        CallbackArguments* arguments = static_cast<CallbackArguments*>(arg);
+        assert(arguments->arg1 && "Null Pointer!");
+        Manager *manager = static_cast<Manager*>(arguments->arg1);
+        manager->m_StatisticalEngine.SetLeftBandValues(static_cast<float*>(object), COUNT);
+      }
+    }
+    const float m_Bands_InitialValue = 0.0;
+    NamedCallback_t m_R_Bands_8_Callback = { "Right Bands 8 Callback", &Right_Bands_ValueChanged<8>, &m_Bands_CallbackArgs };
+    DataItem<float, 8> m_R_Bands_8 = DataItem<float, 8>( "R_Bands_8"
+                                                         , m_Bands_InitialValue
+                                                         , RxTxType_Rx_Only
+                                                         , 0
+                                                         , &m_CPU1SerialPortMessageManager
+                                                         , &m_R_Bands_8_Callback
+                                                         , this );
+    NamedCallback_t m_R_Bands_16_Callback = { "Right Bands 16 Callback", &Right_Bands_ValueChanged<16>, &m_Bands_CallbackArgs };
+    DataItem<float, 16> m_R_Bands_16 = DataItem<float, 16>( "R_Bands_16"
+                                                            , m_Bands_InitialValue
+                                                            , RxTxType_Rx_Only
+                                                            , 0
+                                                            , &m_CPU1SerialPortMessageManager
+                                                            , &m_R_Bands_16_Callback
+                                                            , this );
+    NamedCallback_t m_R_Bands_Callback = { "Right Bands Callback", &Right_Bands_ValueChanged<32>, &m_Bands_CallbackArgs };
+    DataItem<float, 32> m_R_Bands = DataItem<float, 32>( "R_Bands"
+                                                       , m_Bands_InitialValue
+                                                       , RxTxType_Rx_Only
+                                                       , 0
+                                                       , &m_CPU1SerialPortMessageManager
+                                                       , &m_R_Bands_Callback
+                                                       , this );
+    NamedCallback_t m_R_Bands_64_Callback = { "Right Bands 64 Callback", &Right_Bands_ValueChanged<64>, &m_Bands_CallbackArgs };
+    DataItem<float, 64> m_R_Bands_64 = DataItem<float, 64>( "R_Bands_64"
+                                                            , m_Bands_InitialValue
+                                                            , RxTxType_Rx_Only
+                                                            , 0
+                                                            , &m_CPU1SerialPortMessageManager
+                                                            , &m_R_Bands_64_Callback
+                                                            , this );
+    NamedCallback_t m_L_Bands_8_Callback = { "Left Bands 8 Callback", &Left_Bands_ValueChanged<8>, &m_Bands_CallbackArgs };
+    DataItem<float, 8> m_L_Bands_8 = DataItem<float, 8>( "L_Bands_8"
+                                                         , m_Bands_InitialValue
+                                                         , RxTxType_Rx_Only
+                                                         , 0
+                                                         , &m_CPU1SerialPortMessageManager
+                                                         , &m_L_Bands_8_Callback
+                                                         , this );
+    NamedCallback_t m_L_Bands_16_Callback = { "Left Bands 16 Callback", &Left_Bands_ValueChanged<16>, &m_Bands_CallbackArgs };
+    DataItem<float, 16> m_L_Bands_16 = DataItem<float, 16>( "L_Bands_16"
+                                                            , m_Bands_InitialValue
+                                                            , RxTxType_Rx_Only
+                                                            , 0
+                                                            , &m_CPU1SerialPortMessageManager
+                                                            , &m_L_Bands_16_Callback
+                                                            , this );
+    NamedCallback_t m_L_Bands_Callback = { "Left Bands Callback", &Left_Bands_ValueChanged<32>, &m_Bands_CallbackArgs };
+    DataItem<float, 32> m_L_Bands = DataItem<float, 32>( "L_Bands"
+                                                       , m_Bands_InitialValue
+                                                       , RxTxType_Rx_Only
+                                                       , 0
+                                                       , &m_CPU1SerialPortMessageManager
+                                                       , &m_L_Bands_Callback
+                                                       , this );
+    NamedCallback_t m_L_Bands_64_Callback = { "Left Bands 64 Callback", &Left_Bands_ValueChanged<64>, &m_Bands_CallbackArgs };
+    DataItem<float, 64> m_L_Bands_64 = DataItem<float, 64>( "L_Bands_64"
+                                                            , m_Bands_InitialValue
+                                                            , RxTxType_Rx_Only
+                                                            , 0
+                                                            , &m_CPU1SerialPortMessageManager
+                                                            , &m_L_Bands_64_Callback
+                                                            , this );
+
+    //Max Band from CPU2
+    static void Right_Max_Band_ValueChanged(const String &Name, void* object, void* arg)
+    {
+      if(arg && object)
+      {
+        CallbackArguments* arguments = static_cast<CallbackArguments*>(arg);
+        assert(arguments->arg1 && "Null Pointer!");
+        Manager *manager = static_cast<Manager*>(arguments->arg1);
+        manager->m_StatisticalEngine.SetRightMaxBandSoundData(*static_cast<MaxBandSoundData_t*>(object));
+      }
+    }
+    static void Left_Max_Band_ValueChanged(const String &Name, void* object, void* arg)
+    {
+      if(arg && object)
+      {
+        CallbackArguments* arguments = static_cast<CallbackArguments*>(arg);
+        assert(arguments->arg1 && "Null Pointer!");
+        Manager *manager = static_cast<Manager*>(arguments->arg1);
+        manager->m_StatisticalEngine.SetLeftMaxBandSoundData(*static_cast<MaxBandSoundData_t*>(object));
+      }
+    }
+    const MaxBandSoundData_t m_Max_Band_InitialValue = MaxBandSoundData_t();
+    NamedCallback_t m_R_Max_Band_Callback = { "Right Max Band Callback", &Right_Max_Band_ValueChanged, &m_Bands_CallbackArgs };
+    DataItem<MaxBandSoundData_t, 1> m_R_Max_Band = DataItem<MaxBandSoundData_t, 1>( "R_Max_Band"
+                                                                                  , m_Max_Band_InitialValue
+                                                                                  , RxTxType_Rx_Only
+                                                                                  , 0
+                                                                                  , &m_CPU1SerialPortMessageManager
+                                                                                  , &m_R_Max_Band_Callback
+                                                                                  , this );
+    NamedCallback_t m_L_Max_Band_Callback = { "Left Max Band Callback", &Left_Max_Band_ValueChanged, &m_Bands_CallbackArgs };
+    DataItem<MaxBandSoundData_t, 1> m_L_Max_Band = DataItem<MaxBandSoundData_t, 1>( "L_Max_Band"
+                                                                                  , m_Max_Band_InitialValue
+                                                                                  , RxTxType_Rx_Only
+                                                                                  , 0
+                                                                                  , &m_CPU1SerialPortMessageManager
+                                                                                  , &m_L_Max_Band_Callback
+                                                                                  , this );
+
+    //Tone Trigger from CPU2's tone detectors. Each detector cues the visualization with its index.
+    CallbackArguments m_Tone_Trigger_CallbackArgs = {this};
+    NamedCallback_t m_Tone_Trigger_Callback = { "Tone Trigger Callback"
+                                              , &Tone_Trigger_ValueChanged
+                                              , &m_Tone_Trigger_CallbackArgs };
+    const ToneTrigger_t m_Tone_Trigger_InitialValue = ToneTrigger_t();
+    DataItem<ToneTrigger_t, 1> m_Tone_Trigger = DataItem<ToneTrigger_t, 1>( "Tone_Trigger"
+                                                                         , m_Tone_Trigger_InitialValue
+                                                                         , RxTxType_Rx_Only
+                                                                         , 0
+                                                                         , &m_CPU1SerialPortMessageManager
+                                                                         , &m_Tone_Trigger_Callback
+                                                                         , this );
+    static void Tone_Trigger_ValueChanged(const String &Name, void* object, void* arg)
+    {
+      if(arg && object)
+      {
+        CallbackArguments* arguments = static_cast<CallbackArguments*>(arg);
+        assert(arguments->arg1 && "Null Pointer!");
+        Manager *manager = static_cast<Manager*>(arguments->arg1);
+        manager->ToneTriggered(*static_cast<ToneTrigger_t*>(object));
+      }
+    }
+    void ToneTriggered(const ToneTrigger_t &Trigger);
+
+    //Link Health of both serial links, sent to CPU3 for the web UI every SERIAL_LINK_HEALTH_PERIOD
+    const LinkHealth_t m_Link_Health_InitialValue = LinkHealth_t();
+    DataItem<LinkHealth_t, 1> m_Link_Health_1_2 = DataItem<LinkHealth_t, 1>( "Link_Health_1_2"
+                                                                            , m_Link_Health_InitialValue
+                                                                            , RxTxType_Tx_On_Change
+                                                                            , 0
+                                                                            , &m_CPU3SerialPortMessageManager
+                                                                            , NULL
+                                                                            , this );
+    DataItem<LinkHealth_t, 1> m_Link_Health_1_3 = DataItem<LinkHealth_t, 1>( "Link_Health_1_3"
+                                                                            , m_Link_Health_InitialValue
+                                                                            , RxTxType_Tx_On_Change
+                                                                            , 0
+                                                                            , &m_CPU3SerialPortMessageManager
+                                                                            , NULL
+                                                                            , this );
+
 };
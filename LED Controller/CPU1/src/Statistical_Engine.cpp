@@ -68,64 +68,42 @@ bool StatisticalEngine::NewSoundDataReady()
   }
 }
 
+//Band data is stored as it arrives through SetRightBandValues and SetLeftBandValues, so the task only handles the timeout
 bool StatisticalEngine::NewBandDataReady()
 {
   unsigned long currentTime = millis();
-  size_t R_BANDS_Size = uxQueueMessagesWaiting(GetQueueHandleRXForDataItem("R_BANDS"));
-  size_t L_BANDS_Size = uxQueueMessagesWaiting(GetQueueHandleRXForDataItem("L_BANDS"));
-  ESP_LOGD("NewBandDataReady", "New Band Sound Data Messages Waiting: %i | %i", R_BANDS_Size, L_BANDS_Size);
-  bool A = R_BANDS_Size > 0;
-  bool B = L_BANDS_Size > 0;
-  if( true == A && true == B )
-  {
-    ESP_LOGD("Statistical_Engine", "NewBandDataReady");
-    m_NewBandDataCurrentTime = currentTime;
-    m_NewBandDataReady = true;
-    m_NewBandDataTimedOut = false;
-    return true;
-  }
-  else if(currentTime - m_NewBandDataCurrentTime >= m_NewBandDataTimeOut && false == m_NewBandDataTimedOut)
+  pthread_mutex_lock(&m_BandValuesLock);
+  if(currentTime - m_NewBandDataCurrentTime >= m_NewBandDataTimeOut && false == m_NewBandDataTimedOut)
   {
     ESP_LOGW("Statistical_Engine", "WARNING! New Band Data Timeout");
     m_NewBandDataReady = true;
     m_NewBandDataTimedOut = true;
-    return true;
   }
   else
   {
     m_NewBandDataReady = false;
-    return false;
   }
+  pthread_mutex_unlock(&m_BandValuesLock);
+  return m_NewBandDataReady;
 }
 
+//Max band data is stored as it arrives through SetRightMaxBandSoundData and SetLeftMaxBandSoundData, so the task only handles the timeout
 bool StatisticalEngine::NewMaxBandSoundDataReady()
 {
   unsigned long currentTime = millis();
-  size_t R_MAXBAND_Size = uxQueueMessagesWaiting(GetQueueHandleRXForDataItem("R_MAXBAND"));
-  size_t L_MAXBAND_Size = uxQueueMessagesWaiting(GetQueueHandleRXForDataItem("L_MAXBAND"));
-  ESP_LOGV("NewMaxBandSoundDataReady", "New Max Band Sound Messages Waiting: %i | %i", R_MAXBAND_Size, L_MAXBAND_Size);
-  bool A = (R_MAXBAND_Size > 0);
-  bool B = (L_MAXBAND_Size > 0);
-  if( true == A && true == B )
-  {
-    ESP_LOGD("Statistical_Engine", "New Max Band Sound Data Ready");
-    m_NewMaxBandSoundDataCurrentTime = currentTime;
-    m_NewMaxBandSoundDataReady = true;
-    m_NewMaxBandSoundDataTimedOut = false;
-    return true;
-  }
-  else if(currentTime - m_NewMaxBandSoundDataCurrentTime >= m_NewMaxBandSoundDataTimeOut && false == m_NewMaxBandSoundDataTimedOut)
+  pthread_mutex_lock(&m_MaxBinSoundDataLock);
+  if(currentTime - m_NewMaxBandSoundDataCurrentTime >= m_NewMaxBandSoundDataTimeOut && false == m_NewMaxBandSoundDataTimedOut)
   {
     ESP_LOGW("Statistical_Engine", "WARNING! New Max Band Sound Data Timeout");
     m_NewMaxBandSoundDataReady = true;
     m_NewMaxBandSoundDataTimedOut = true;
-    return true;
   }
   else
   {
     m_NewMaxBandSoundDataReady = false;
-    return false;
   }
+  pthread_mutex_unlock(&m_MaxBinSoundDataLock);
+  return m_NewMaxBandSoundDataReady;
 }
 
 bool StatisticalEngine::CanRunMyScheduledTask()
@@ -179,14 +157,6 @@ void StatisticalEngine::RunMyScheduledTask()
       memset(m_Right_Band_Values, 0.0, sizeof(m_Right_Band_Values));
       memset(m_Left_Band_Values, 0.0, sizeof(m_Left_Band_Values));
     }
-    else
-    {
-      static bool R_BandsPullErrorHasOccured = false;
-      GetValueFromQueue(m_Right_Band_Values, GetQueueHandleRXForDataItem("R_BANDS"), "R_BANDS", false, 0, R_BandsPullErrorHasOccured);
-      static bool L_BandsPullErrorHasOccured = false;
-      GetValueFromQueue(m_Left_Band_Values, GetQueueHandleRXForDataItem("L_BANDS"), "L_BANDS", false, 0, L_BandsPullErrorHasOccured);
-      UpdateBandArray();
-    }       
     pthread_mutex_unlock(&m_BandValuesLock);
   }
   
@@ -200,17 +170,96 @@ void StatisticalEngine::RunMyScheduledTask()
       m_Left_MaxBandSoundData.MaxBandNormalizedPower = 0.0;
       m_Left_MaxBandSoundData.MaxBandIndex = 0;
     }
-    else
-    {
-      static bool R_MaxBandPullErrorHasOccured = false;
-      GetValueFromQueue(&m_Right_MaxBandSoundData, GetQueueHandleRXForDataItem("R_MAXBAND"), "R_MAXBAND", false, 0, R_MaxBandPullErrorHasOccured);
-      static bool L_MaxBandPullErrorHasOccured = false;
-      GetValueFromQueue(&m_Left_MaxBandSoundData, GetQueueHandleRXForDataItem("L_MAXBAND"), "L_MAXBAND", false, 0, L_MaxBandPullErrorHasOccured);
-    }
     pthread_mutex_unlock(&m_MaxBinSoundDataLock);
   }
 }
 
+//A layout change clears the band history, since bands of the old layout do not line up with the new ones
+void StatisticalEngine::SetNumberOfBands(unsigned int numBands)
+{
+  if(0 == numBands || numBands > m_MaxBands)
+  {
+    ESP_LOGE("Statistical_Engine", "ERROR! Unsupported Band Count: %u", numBands);
+    return;
+  }
+  pthread_mutex_lock(&m_BandValuesLock);
+  if(numBands != m_NumBands)
+  {
+    ESP_LOGI("Statistical_Engine", "Band Count Changed: %u", numBands);
+    m_NumBands = numBands;
+    memset(BandValues, 0, sizeof(BandValues));
+    memset(BandRunningAverageValues, 0, sizeof(BandRunningAverageValues));
+    memset(m_Right_Band_Values, 0, sizeof(m_Right_Band_Values));
+    memset(m_Left_Band_Values, 0, sizeof(m_Left_Band_Values));
+    m_RightBandValuesReceived = false;
+    m_LeftBandValuesReceived = false;
+  }
+  pthread_mutex_unlock(&m_BandValuesLock);
+}
+
+//Bands sized for another layout were sent before CPU2 applied the current one and are dropped
+void StatisticalEngine::SetRightBandValues(const float* values, size_t count)
+{
+  pthread_mutex_lock(&m_BandValuesLock);
+  if(count == m_NumBands)
+  {
+    memcpy(m_Right_Band_Values, values, sizeof(float) * count);
+    m_RightBandValuesReceived = true;
+    UpdateBandArrayOnceBothChannelsReceived();
+  }
+  else
+  {
+    ESP_LOGD("Statistical_Engine", "Dropped %u Right Bands, Band Count is %u", static_cast<unsigned int>(count), m_NumBands);
+  }
+  pthread_mutex_unlock(&m_BandValuesLock);
+}
+
+void StatisticalEngine::SetLeftBandValues(const float* values, size_t count)
+{
+  pthread_mutex_lock(&m_BandValuesLock);
+  if(count == m_NumBands)
+  {
+    memcpy(m_Left_Band_Values, values, sizeof(float) * count);
+    m_LeftBandValuesReceived = true;
+    UpdateBandArrayOnceBothChannelsReceived();
+  }
+  else
+  {
+    ESP_LOGD("Statistical_Engine", "Dropped %u Left Bands, Band Count is %u", static_cast<unsigned int>(count), m_NumBands);
+  }
+  pthread_mutex_unlock(&m_BandValuesLock);
+}
+
+void StatisticalEngine::UpdateBandArrayOnceBothChannelsReceived()
+{
+  if(m_RightBandValuesReceived && m_LeftBandValuesReceived)
+  {
+    m_RightBandValuesReceived = false;
+    m_LeftBandValuesReceived = false;
+    m_NewBandDataCurrentTime = millis();
+    m_NewBandDataTimedOut = false;
+    UpdateBandArray();
+  }
+}
+
+void StatisticalEngine::SetRightMaxBandSoundData(const MaxBandSoundData_t &maxBandSoundData)
+{
+  pthread_mutex_lock(&m_MaxBinSoundDataLock);
+  m_Right_MaxBandSoundData = maxBandSoundData;
+  m_NewMaxBandSoundDataCurrentTime = millis();
+  m_NewMaxBandSoundDataTimedOut = false;
+  pthread_mutex_unlock(&m_MaxBinSoundDataLock);
+}
+
+void StatisticalEngine::SetLeftMaxBandSoundData(const MaxBandSoundData_t &maxBandSoundData)
+{
+  pthread_mutex_lock(&m_MaxBinSoundDataLock);
+  m_Left_MaxBandSoundData = maxBandSoundData;
+  m_NewMaxBandSoundDataCurrentTime = millis();
+  m_NewMaxBandSoundDataTimedOut = false;
+  pthread_mutex_unlock(&m_MaxBinSoundDataLock);
+}
+
 void StatisticalEngine::AllocateMemory()
 {
   ESP_LOGD("Statistical_Engine", "%s: Allocating Memory.", GetTitle().c_str());
@@ -447,15 +496,20 @@ float StatisticalEngine::GetBandAverage(unsigned int band, unsigned int depth)
   pthread_mutex_unlock(&m_BandValuesLock);
   return result;
 }
+//Asking for more bands than the layout has reads each layout band for several of the requested ones
 float StatisticalEngine::GetBandAverageForABandOutOfNBands(unsigned band, unsigned int depth, unsigned int TotalBands)
 {
   assert(band < TotalBands);
-  assert(TotalBands <= m_NumBands);
   assert(TotalBands > 0);
   float result = 0.0;
   pthread_mutex_lock(&m_BandValuesLock);
   int bandSeparation = m_NumBands / TotalBands;
   int startBand = band * bandSeparation;
+  if(TotalBands > m_NumBands)
+  {
+    bandSeparation = 1;
+    startBand = band * m_NumBands / TotalBands;
+  }
   int endBand = startBand + bandSeparation;
   for(int b = startBand; b < endBand; ++b)
   {
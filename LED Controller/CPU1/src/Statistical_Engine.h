@@ -146,6 +146,13 @@ class StatisticalEngine : public NamedItem
       MaxBandSoundData_t GetMaxBinRightSoundData() { return m_Right_MaxBandSoundData; }
       MaxBandSoundData_t GetMaxBinLeftSoundData() { return m_Left_MaxBandSoundData; }
     
+      //Band Data Setters, called by the Manager as band data arrives from CPU2
+      void SetNumberOfBands(unsigned int numBands);
+      void SetRightBandValues(const float* values, size_t count);
+      void SetLeftBandValues(const float* values, size_t count);
+      void SetRightMaxBandSoundData(const MaxBandSoundData_t &maxBandSoundData);
+      void SetLeftMaxBandSoundData(const MaxBandSoundData_t &maxBandSoundData);
+
       //Band Data Getters
       unsigned int GetNumberOfBands() { return m_NumBands; }
       float GetBandValue(unsigned int band, unsigned int depth);
@@ -158,14 +165,10 @@ class StatisticalEngine : public NamedItem
     bool m_MemoryIsAllocated = false;
 
     //QueueManager
-    static const size_t m_StatisticalEngineConfigCount = 7;
+    static const size_t m_StatisticalEngineConfigCount = 3;
     DataItemConfig_t m_ItemConfig[m_StatisticalEngineConfigCount]
     {
-      { "R_BANDS",          DataType_Float_t,                 32, Transciever::Transciever_RX,   4 },
-      { "L_BANDS",          DataType_Float_t,                 32, Transciever::Transciever_RX,   4 },
       { "Processed_Frame",  DataType_ProcessedSoundFrame_t,   1,  Transciever::Transciever_RX,   4 },
-      { "R_MAXBAND",        DataType_MaxBandSoundData_t,      1,  Transciever::Transciever_RX,   4 },
-      { "L_MAXBAND",        DataType_MaxBandSoundData_t,      1,  Transciever::Transciever_RX,   4 },
       { "R_MAJOR_FREQ",     DataType_Float_t,                 1,  Transciever::Transciever_RX,   4 },
       { "L_MAJOR_FREQ",     DataType_Float_t,                 1,  Transciever::Transciever_RX,   4 },
     };
@@ -175,16 +178,20 @@ class StatisticalEngine : public NamedItem
     
     //BAND Circular Buffer
     pthread_mutex_t m_BandValuesLock;
-    static const unsigned int m_NumBands = 32; //Need way to set this
-    float BandValues[m_NumBands][BAND_SAVE_LENGTH];
+    static const unsigned int m_MaxBands = BAND_LAYOUT_MAX_BANDS;
+    unsigned int m_NumBands = BAND_LAYOUT_DEFAULT_BAND_COUNT;   //Band count of the layout CPU2 applied
+    float BandValues[m_MaxBands][BAND_SAVE_LENGTH];
     int currentBandIndex = -1;
-    float BandRunningAverageValues[m_NumBands][BAND_SAVE_LENGTH];
+    float BandRunningAverageValues[m_MaxBands][BAND_SAVE_LENGTH];
     int currentAverageBandIndex = -1;
     bool m_NewBandDataReady = false;
     unsigned long m_NewBandDataCurrentTime = 0;
     unsigned long m_NewBandDataTimeOut = 1000;
     bool m_NewBandDataTimedOut = false;
+    bool m_RightBandValuesReceived = false;
+    bool m_LeftBandValuesReceived = false;
     bool NewBandDataReady();
+    void UpdateBandArrayOnceBothChannelsReceived();
     void UpdateBandArray();
     void UpdateRunningAverageBandArray();
 
@@ -206,15 +213,13 @@ class StatisticalEngine : public NamedItem
     static void StaticUpdateSoundState(void * Parameters);
     void UpdateSoundState();
 
-    size_t m_BandInputByteCount = sizeof(float) * m_NumBands;
-    
     //Right Channel Input Sound Data
     pthread_mutex_t m_ProcessedSoundDataLock;
-    float m_Right_Band_Values[m_NumBands];
+    float m_Right_Band_Values[m_MaxBands];
     ProcessedSoundData_t m_Right_Channel_Processed_Sound_Data;
 
     //Left Channel Input Sound Data
-    float m_Left_Band_Values[m_NumBands];
+    float m_Left_Band_Values[m_MaxBands];
     ProcessedSoundData_t m_Left_Channel_Processed_Sound_Data;
 
     float m_Power;
@@ -30,6 +30,10 @@
 #define I2S_BUFFER_COUNT 10
 #define I2S_SAMPLE_COUNT 512
 #define ANALOG_GAIN 1
+#define BAND_LAYOUT_REQUEST BandLayout_t(32, BandScale_SAE, 0, 22050)   //{ Band Count, Scale, Min Frequency, Max Frequency }, 8, 16, 32 or 64 bands
+#define BAND_LAYOUT_DEFAULT_BAND_COUNT 32   //Statistical engine band count until the Manager sets the requested one
+#define BAND_LAYOUT_MAX_BANDS 64
+#define CPU2_MAX_FRAME_AGE_US 50000   //Real time frames from CPU2 older than this on arrival would light up after the sound and are dropped
 
 
 //App Debugging
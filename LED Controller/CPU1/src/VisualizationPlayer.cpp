@@ -56,7 +56,12 @@ void VisualizationPlayer::RunMyScheduledTask()
 {
   m_CurrentTime = millis();
   m_CurrentDuration = m_CurrentTime - m_StartTime;
-  if(m_CurrentDuration >= m_Duration && false == m_TestVisualization)
+  const int32_t RequestedVisualization = m_RequestedVisualization.exchange(-1, std::memory_order_relaxed);
+  if(RequestedVisualization >= 0 && false == m_TestVisualization)
+  {
+    GetVisualization(RequestedVisualization);
+  }
+  else if(m_CurrentDuration >= m_Duration && false == m_TestVisualization)
   {
     GetRandomVisualization();
   }
@@ -86,3 +91,14 @@ void VisualizationPlayer::GetRandomVisualization()
   m_StartTime = millis();
   if(true == debugMemory) Serial << "VisualizationPlayer::Getting Next Visualization: Task Count: " << GetTaskCount() << "\n";
 }
+void VisualizationPlayer::GetVisualization(size_t Index)
+{
+  m_Duration = random(1000,120000);
+  RemoveTask(*m_CurrentVisualization);
+  delete m_CurrentVisualization;
+  GetInstanceFunctionPointer GetInstanceFunctionPointer = m_MyVisiualizationInstantiations[ Index % m_MyVisiualizationInstantiations.size() ];
+  m_CurrentVisualization = GetInstanceFunctionPointer(m_StatisticalEngineModelInterface, m_LEDController);
+  AddTask(*m_CurrentVisualization);
+  m_StartTime = millis();
+  if(true == debugMemory) Serial << "VisualizationPlayer::Getting Requested Visualization: Task Count: " << GetTaskCount() << "\n";
+}
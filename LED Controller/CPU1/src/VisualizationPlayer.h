@@ -18,6 +18,7 @@
  
 
 #pragma once
+#include <atomic>
 #include "Streaming.h"
 #include "VisualizationFactory.h"
 #include "TaskInterface.h"
@@ -31,6 +32,9 @@ class VisualizationPlayer : public Task
                                                                                           , m_StatisticalEngineModelInterface(StatisticalEngineModelInterface){}
     virtual ~VisualizationPlayer(){}
 
+    //Safe from any task, the visualization changes on the player's next run. Indexes past the end wrap around.
+    void RequestVisualization(size_t Index) { m_RequestedVisualization.store(static_cast<int32_t>(Index), std::memory_order_relaxed); }
+
   private:
     StatisticalEngineModelInterface &m_StatisticalEngineModelInterface;
     LEDController m_LEDController;
@@ -41,6 +45,7 @@ class VisualizationPlayer : public Task
     unsigned long m_CurrentDuration;
     void GetNextVisualization();
     void GetRandomVisualization();
+    void GetVisualization(size_t Index);
     
     //Task Interface
     void Setup();
@@ -55,4 +60,5 @@ class VisualizationPlayer : public Task
     std::vector<GetInstanceFunctionPointer> m_MyVisiualizationInstantiations = std::vector<GetInstanceFunctionPointer>();
     std::vector<Visualization*> m_MyQueue = std::vector<Visualization*>();
     bool m_TestVisualization = false;
+    std::atomic<int32_t> m_RequestedVisualization = {-1};
 };
@@ -0,0 +1,47 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <DataTypes.h>
+#include <StageProfiler.h>
+
+typedef StageProfiler<AudioPipelineStage_Count> AudioPipelineProfiler_t;
+
+inline constexpr const char* AudioPipelineStageStrings[AudioPipelineStage_Count] =
+{
+  "I2S_Read",
+  "Buffer_Push",
+  "Tone_Detect",
+  "FFT_Window",
+  "FFT_Compute",
+  "FFT_Magnitude",
+  "FFT_Normalize",
+  "Peak_Pick",
+  "Band_Assign",
+  "Band_Send"
+};
+
+//Shared by Manager, Sound_Processor and the FFT calculators. Each stage is recorded from a single task, but not
+//all from the same one: I2S_Read, Buffer_Push and Tone_Detect run on the Bluetooth task and the rest on the FFT
+//task. Read them from other tasks through GetSnapshot only.
+inline AudioPipelineProfiler_t& GetAudioPipelineProfiler()
+{
+  static AudioPipelineProfiler_t profiler;
+  return profiler;
+}
@@ -0,0 +1,93 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <DataTypes.h>
+#include <BandLayout.h>
+#include "Tunes.h"
+#include "FFT_Calculator.h"
+#include "AudioPipelineProfiler.h"
+
+//The per FFT band, max band and peak results. Sound_Processor and the host replay (Tools/AudioReplay) both call
+//these, so a replayed WAV is analysed exactly as the device analyses the live audio.
+
+typedef BandLayout<FFT_SIZE/2, BAND_LAYOUT_MAX_BANDS> FFT_BandLayout_t;
+
+//Sums the FFT solution into the layout's bands and returns the loudest band. Bands must hold BAND_LAYOUT_MAX_BANDS values.
+inline MaxBandSoundData_t CalculateBands(const FFT_BandLayout_t &Layout, const float* FFTBuffer, float* Bands)
+{
+  {
+    PROFILE_STAGE(GetAudioPipelineProfiler(), AudioPipelineStage_Band_Assign);
+    Layout.Accumulate(FFTBuffer, Bands);
+  }
+  const size_t BandCount = Layout.GetBandCount();
+  float MaxBandMagnitude = 0.0;
+  int16_t MaxBandIndex = 0;
+  for(size_t i = 0; i < BandCount; ++i)
+  {
+    if(Bands[i] > MaxBandMagnitude)
+    {
+      MaxBandMagnitude = Bands[i];
+      MaxBandIndex = i;
+    }
+  }
+  return MaxBandSoundData_t(MaxBandMagnitude, MaxBandIndex, BandCount);
+}
+
+//Sets the bands on the item sized for BandCount, the only one the receiver expects for the layout in use.
+//ITEM is DataItem on the device and ReplayDataItem in the replay.
+template<template<typename, size_t> class ITEM>
+inline bool SendBands( const float* Bands
+                     , size_t BandCount
+                     , ITEM<float, 8> &Bands_8
+                     , ITEM<float, 16> &Bands_16
+                     , ITEM<float, 32> &Bands_32
+                     , ITEM<float, 64> &Bands_64 )
+{
+  PROFILE_STAGE(GetAudioPipelineProfiler(), AudioPipelineStage_Band_Send);
+  switch(BandCount)
+  {
+    case 8:
+      Bands_8.SetValue(Bands, 8);
+    break;
+    case 16:
+      Bands_16.SetValue(Bands, 16);
+    break;
+    case 32:
+      Bands_32.SetValue(Bands, 32);
+    break;
+    case 64:
+      Bands_64.SetValue(Bands, 64);
+    break;
+    default:
+      ESP_LOGE("SendBands", "ERROR! Unsupported Band Count: %zu", BandCount);
+      return false;
+  }
+  return true;
+}
+
+//Copies the sub-bin peak estimates of the last FFT solution. Peaks must hold SPECTRAL_PEAK_COUNT values.
+inline void GetSpectralPeaks(FFT_Calculator &FFT, SpectralPeak_t* Peaks)
+{
+  const SpectralPeakEstimate_t* Estimates = FFT.GetPeaks();
+  for(size_t i = 0; i < SPECTRAL_PEAK_COUNT; ++i)
+  {
+    Peaks[i] = SpectralPeak_t(Estimates[i].Frequency, Estimates[i].Magnitude);
+  }
+}
@@ -20,13 +20,17 @@
 
 #include "arduinoFFT.h"
 #include <DataTypes.h>
+#include <SpectralPeakPicker.h>
 #include "Streaming.h"
+#include "Tunes.h"
+#include "AudioPipelineProfiler.h"
 
 class FFT_Calculator
 {
   public:
     FFT_Calculator(int32_t FFT_Size, int32_t SampleRate, BitLength_t BitLength ): m_FFT_Size(FFT_Size)
                                                                                 , m_FFT_SampleRate(SampleRate)
+                                                                                , m_PeakPicker((float)SampleRate / (float)FFT_Size, PeakInterpolation_Gaussian, SPECTRAL_PEAK_MINIMUM_MAGNITUDE)
     {
       mp_RealBuffer = (float*)malloc(sizeof(float)*m_FFT_Size);
       mp_ImaginaryBuffer = (float*)malloc(sizeof(float)*m_FFT_Size);
@@ -84,6 +88,11 @@ class FFT_Calculator
       assert(index < m_FFT_Size/2);
       return mp_RealBuffer[index];
     }
+    const float* GetFFTBuffer()
+    {
+      assert(true == m_SolutionReady);
+      return mp_RealBuffer;
+    }
     float GetFFTMaxValue(){return m_MaxFFTBinValue;}
     int32_t GetFFTMaxValueBin()
     {
@@ -100,6 +109,16 @@ class FFT_Calculator
       assert(true == m_SolutionReady);
       return &m_MajorPeak;
     }
+    const SpectralPeakEstimate_t* GetPeaks()
+    {
+      assert(true == m_SolutionReady);
+      return m_Peaks;
+    }
+    size_t GetPeakCount()
+    {
+      assert(true == m_SolutionReady);
+      return m_PeakCount;
+    }
     size_t GetRequiredValueCount()
     {
       return m_FFT_Size - m_CurrentIndex;
@@ -126,28 +145,46 @@ class FFT_Calculator
         m_CurrentIndex = 0;
         m_MaxFFTBinValue = 0;
         m_MaxFFTBinIndex = 0;
-        m_MyFFT->windowing(FFTWindow::Hamming, FFTDirection::Forward, true);
-        m_MyFFT->compute(FFTDirection::Forward);
-        m_MyFFT->complexToMagnitude();
-        m_MajorPeak = m_MyFFT->majorPeak();
-        for(int i = 0; i < m_FFT_Size; ++i)
         {
-          mp_RealBuffer[i] = ( ( (2 * mp_RealBuffer[i]) / (float)m_FFT_Size ) * Gain ) / m_BitLengthMaxValue;
-          if(mp_RealBuffer[i] > 1.0)
-          {
-            mp_RealBuffer[i] = 1.0;
-          }
-          if(i < m_FFT_Size/2 && mp_RealBuffer[i] > m_MaxFFTBinValue)
-          {
-            m_MaxFFTBinValue = mp_RealBuffer[i];
-            m_MaxFFTBinIndex = i;
-          }
+          PROFILE_STAGE(GetAudioPipelineProfiler(), AudioPipelineStage_FFT_Window);
+          m_MyFFT->windowing(FFTWindow::Hamming, FFTDirection::Forward, true);
         }
+        {
+          PROFILE_STAGE(GetAudioPipelineProfiler(), AudioPipelineStage_FFT_Compute);
+          m_MyFFT->compute(FFTDirection::Forward);
+        }
+        {
+          PROFILE_STAGE(GetAudioPipelineProfiler(), AudioPipelineStage_FFT_Magnitude);
+          m_MyFFT->complexToMagnitude();
+        }
+        Normalize(Gain);
+        {
+          PROFILE_STAGE(GetAudioPipelineProfiler(), AudioPipelineStage_Peak_Pick);
+          m_PeakCount = m_PeakPicker.FindPeaks(mp_RealBuffer, m_FFT_Size/2, m_Peaks);
+        }
+        m_MajorPeak = m_Peaks[0].Frequency;
         m_SolutionReady = true;
       }
       return m_SolutionReady;
     }
   private:
+    void Normalize(float Gain)
+    {
+      PROFILE_STAGE(GetAudioPipelineProfiler(), AudioPipelineStage_FFT_Normalize);
+      for(int i = 0; i < m_FFT_Size; ++i)
+      {
+        mp_RealBuffer[i] = ( ( (2 * mp_RealBuffer[i]) / (float)m_FFT_Size ) * Gain ) / m_BitLengthMaxValue;
+        if(mp_RealBuffer[i] > 1.0)
+        {
+          mp_RealBuffer[i] = 1.0;
+        }
+        if(i < m_FFT_Size/2 && mp_RealBuffer[i] > m_MaxFFTBinValue)
+        {
+          m_MaxFFTBinValue = mp_RealBuffer[i];
+          m_MaxFFTBinIndex = i;
+        }
+      }
+    }
     int32_t m_CurrentIndex = 0;
     int32_t m_FFT_Size = 0;
     int32_t m_FFT_SampleRate = 0;
@@ -157,6 +194,9 @@ class FFT_Calculator
     float m_MaxFFTBinValue = 0;
     int32_t m_MaxFFTBinIndex = 0;
     float m_MajorPeak = 0;
+    SpectralPeakPicker<SPECTRAL_PEAK_COUNT> m_PeakPicker;
+    SpectralPeakEstimate_t m_Peaks[SPECTRAL_PEAK_COUNT];
+    size_t m_PeakCount = 0;
     bool m_SolutionReady = false;
     float m_BitLengthMaxValue = 1.0;
     ArduinoFFT<float>*m_MyFFT;
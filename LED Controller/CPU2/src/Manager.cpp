@@ -45,6 +45,8 @@ void Manager::Setup()
   m_AudioBuffer.Initialize();
   m_BT_Out.ResgisterForCallbacks(this);
   SetupAllSetupCallees();
+  m_CPU1SerialPortMessageManager.SetLinkHealthCallback([this](const LinkHealth_t &Health){ m_Link_Health_2_1.SetValue(Health); });
+  m_CPU3SerialPortMessageManager.SetLinkHealthCallback([this](const LinkHealth_t &Health){ m_Link_Health_2_3.SetValue(Health); });
 }
 
 void Manager::StartBluetooth()
@@ -73,10 +75,21 @@ void Manager::I2SDataReceived(String DeviceTitle, uint8_t *Data, uint32_t channe
 int32_t Manager::SetBTTxData(uint8_t *Data, int32_t channel_len)
 {
   ESP_LOGV("SetBTTxData", "BT Tx Data: %i bytes requested.", channel_len);
-  size_t ByteReceived = m_I2S_In.ReadSoundBufferData(Data, channel_len);
+  size_t ByteReceived = 0;
+  {
+    PROFILE_STAGE(GetAudioPipelineProfiler(), AudioPipelineStage_I2S_Read);
+    ByteReceived = m_I2S_In.ReadSoundBufferData(Data, channel_len);
+  }
   ESP_LOGV("SetBTTxData", "BT Tx Data: %i bytes received.", ByteReceived);
   size_t FrameCount = ByteReceived / sizeof(uint32_t);
-  m_AudioBuffer.Push((Frame_t*)Data, FrameCount);
+  {
+    PROFILE_STAGE(GetAudioPipelineProfiler(), AudioPipelineStage_Buffer_Push);
+    m_AudioBuffer.Push((Frame_t*)Data, FrameCount);
+  }
+  {
+    PROFILE_STAGE(GetAudioPipelineProfiler(), AudioPipelineStage_Tone_Detect);
+    m_SoundProcessor.ProcessToneDetectors((Frame_t*)Data, FrameCount);
+  }
   return ByteReceived;
 }
 
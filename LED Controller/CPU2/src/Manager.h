@@ -199,6 +199,10 @@ class Manager: public NamedItem
     //Bluetooth Source Connection Status
     ConnectionStatus_t m_ConnectionStatus_InitialValue = ConnectionStatus_t::Disconnected;
     DataItem<ConnectionStatus_t, 1> m_ConnectionStatus = DataItem<ConnectionStatus_t, 1>( "Src_Conn_State", m_ConnectionStatus_InitialValue, RxTxType_Tx_On_Change_With_Heartbeat, 5000, &m_CPU3SerialPortMessageManager, nullptr, this );
+    //Link Health of both serial links, sent to CPU3 for the web UI every SERIAL_LINK_HEALTH_PERIOD
+    const LinkHealth_t m_Link_Health_InitialValue = LinkHealth_t();
+    DataItem<LinkHealth_t, 1> m_Link_Health_2_1 = DataItem<LinkHealth_t, 1>( "Link_Health_2_1", m_Link_Health_InitialValue, RxTxType_Tx_On_Change, 0, &m_CPU3SerialPortMessageManager, nullptr, this );
+    DataItem<LinkHealth_t, 1> m_Link_Health_2_3 = DataItem<LinkHealth_t, 1>( "Link_Health_2_3", m_Link_Health_InitialValue, RxTxType_Tx_On_Change, 0, &m_CPU3SerialPortMessageManager, nullptr, this );
     
     /*
     //Output Source Start Scan
@@ -357,7 +361,8 @@ class Manager: public NamedItem
             pTargetDevice->ResetToDefaultValue();
             pBT_Out->Disconnect();
             pBT_Out->Set_Reset_BLE(true);
-            pBT_Out->Connect(pTargetDevice->GetValuePointer()->name, pTargetDevice->GetValuePointer()->address);
+            const BluetoothDevice_t TargetDevice = pTargetDevice->GetValue();
+            pBT_Out->Connect(TargetDevice.name, TargetDevice.address);
             pBT_Out->Set_Reset_BLE(false);
             
           }
@@ -29,6 +29,27 @@ Sound_Processor::Sound_Processor( String Title
                                 , m_CPU3SerialPortMessageManager(CPU3SerialPortMessageManager)
                                 , m_Preferences(preferences)
 {
+  //Band data goes stale within a frame, so it must not queue behind settings traffic
+  m_R_Max_Band.SetTxLane(LinkTxLane_RealTime);
+  m_L_Max_Band.SetTxLane(LinkTxLane_RealTime);
+  m_R_Bands_8.SetTxLane(LinkTxLane_RealTime);
+  m_L_Bands_8.SetTxLane(LinkTxLane_RealTime);
+  m_R_Bands_16.SetTxLane(LinkTxLane_RealTime);
+  m_L_Bands_16.SetTxLane(LinkTxLane_RealTime);
+  m_R_Bands.SetTxLane(LinkTxLane_RealTime);
+  m_L_Bands.SetTxLane(LinkTxLane_RealTime);
+  m_R_Bands_64.SetTxLane(LinkTxLane_RealTime);
+  m_L_Bands_64.SetTxLane(LinkTxLane_RealTime);
+  m_Tone_Trigger.SetTxLane(LinkTxLane_RealTime);
+  //Visualizations use the bands at about 8 bit precision, so they go out quantized and delta coded
+  m_R_Bands_8.SetTxCodec(LinkCodec_Quantized8);
+  m_L_Bands_8.SetTxCodec(LinkCodec_Quantized8);
+  m_R_Bands_16.SetTxCodec(LinkCodec_Quantized8);
+  m_L_Bands_16.SetTxCodec(LinkCodec_Quantized8);
+  m_R_Bands.SetTxCodec(LinkCodec_Quantized8);
+  m_L_Bands.SetTxCodec(LinkCodec_Quantized8);
+  m_R_Bands_64.SetTxCodec(LinkCodec_Quantized8);
+  m_L_Bands_64.SetTxCodec(LinkCodec_Quantized8);
 }
 Sound_Processor::~Sound_Processor()
 {
@@ -62,6 +83,14 @@ void Sound_Processor::Calculate_FFTs()
   while(true)
   {
     vTaskDelayUntil( &xLastWakeTime, xFrequency );
+    ApplyRequestedBandLayout();
+    #ifdef ENABLE_STAGE_PROFILER
+    if(++m_StageProfileLoopCount >= STAGE_PROFILER_REPORT_INTERVAL)
+    {
+      m_StageProfileLoopCount = 0;
+      SendStageProfile();
+    }
+    #endif
     m_R_FFT.ResetCalculator();
     m_L_FFT.ResetCalculator();
     bool R_FFT_Calculated = false;
@@ -86,54 +115,96 @@ void Sound_Processor::Calculate_FFTs()
   }
 }
 
-void Sound_Processor::Update_Right_Bands_And_Send_Result()
+void Sound_Processor::RequestBandLayout(const BandLayout_t &Layout)
 {
-    float R_Bands_DataBuffer[32] = {0.0};
-    MaxBandSoundData_t R_MaxBand;
-    float MaxBandMagnitude = 0.0;
-    int16_t MaxBandIndex = 0;
+  std::lock_guard<std::mutex> lock(m_BandLayoutMutex);
+  m_RequestedBandLayout = Layout;
+  m_BandLayoutRequested = true;
+}
 
-    ESP_LOGI("Sound_Processor", "Updating Right Channel FFT Bands");
-    AssignToBands(R_Bands_DataBuffer, &m_R_FFT, FFT_SIZE);
-    for(size_t i = 0; i < 32; ++i)
-    {
-      if(R_Bands_DataBuffer[i] > MaxBandMagnitude)
+void Sound_Processor::ApplyRequestedBandLayout()
+{
+  BandLayout_t Layout;
+  {
+    std::lock_guard<std::mutex> lock(m_BandLayoutMutex);
+    if(!m_BandLayoutRequested) return;
+    Layout = m_RequestedBandLayout;
+    m_BandLayoutRequested = false;
+  }
+  switch(Layout.BandCount)
+  {
+    case 8:
+    case 16:
+    case 32:
+    case 64:
+      if(m_BandLayout.Configure(Layout, I2S_SAMPLE_RATE, FFT_SIZE))
       {
-        MaxBandMagnitude = R_Bands_DataBuffer[i];
-        MaxBandIndex = i;
+        ESP_LOGI("ApplyRequestedBandLayout", "Band Layout Set: \"%s\"", Layout.toString().c_str());
+        m_Band_Layout.SetValue(Layout);
+        return;
       }
-    }
-    m_R_Bands.SetValue(R_Bands_DataBuffer, 32);
-    R_MaxBand.MaxBandNormalizedPower = MaxBandMagnitude;
-    R_MaxBand.MaxBandIndex = MaxBandIndex;
-    R_MaxBand.TotalBands = 32;
+    break;
+    default:
+    break;
+  }
+  ESP_LOGW("ApplyRequestedBandLayout", "WARNING! Unsupported Band Layout Rejected: \"%s\"", Layout.toString().c_str());
+  //The request was stored when it arrived, so send the layout still in use to put both CPUs back on it
+  m_Band_Layout.Tx_Now(m_Band_Layout.GetChangeCount());
+}
+
+void Sound_Processor::Update_Right_Bands_And_Send_Result()
+{
+    float R_Bands_DataBuffer[BAND_LAYOUT_MAX_BANDS];
+    ESP_LOGI("Sound_Processor", "Updating Right Channel FFT Bands");
+    const MaxBandSoundData_t R_MaxBand = CalculateBands(m_BandLayout, m_R_FFT.GetFFTBuffer(), R_Bands_DataBuffer);
+    SendBands(R_Bands_DataBuffer, R_MaxBand.TotalBands, m_R_Bands_8, m_R_Bands_16, m_R_Bands, m_R_Bands_64);
     m_R_Max_Band.SetValue(R_MaxBand);
 }
 void Sound_Processor::Update_Left_Bands_And_Send_Result()
 {
-    float L_Bands_DataBuffer[32] = {0.0};
-    MaxBandSoundData_t L_MaxBand;
-    float MaxBandMagnitude = 0.0;
-    int16_t MaxBandIndex = 0;
-
+    float L_Bands_DataBuffer[BAND_LAYOUT_MAX_BANDS];
     ESP_LOGI("Sound_Processor", "Updating Left Channel FFT Bands");
-    AssignToBands(L_Bands_DataBuffer, &m_L_FFT, FFT_SIZE);
-    for(size_t i = 0; i < 32; ++i)
+    const MaxBandSoundData_t L_MaxBand = CalculateBands(m_BandLayout, m_L_FFT.GetFFTBuffer(), L_Bands_DataBuffer);
+    SendBands(L_Bands_DataBuffer, L_MaxBand.TotalBands, m_L_Bands_8, m_L_Bands_16, m_L_Bands, m_L_Bands_64);
+    m_L_Max_Band.SetValue(L_MaxBand);
+}
+
+#ifdef ENABLE_STAGE_PROFILER
+void Sound_Processor::SendStageProfile()
+{
+  AudioPipelineProfiler_t &Profiler = GetAudioPipelineProfiler();
+  StageProfile_t Profile[AudioPipelineStage_Count];
+  //Stages recorded by the Bluetooth task are read here on the FFT task, so only the snapshots each task published
+  //are read. A snapshot covers the interval up to the previous report's request.
+  for(size_t i = 0; i < AudioPipelineStage_Count; ++i)
+  {
+    Profile[i] = StageProfile_t(Profiler.GetSnapshot(i));
+    ESP_LOGD("SendStageProfile", "Stage \"%s\": %s", AudioPipelineStageStrings[i], Profile[i].toString().c_str());
+  }
+  Profiler.RequestSnapshotAll();
+  m_Stage_Profile.SetValue(Profile, AudioPipelineStage_Count);
+}
+#endif
+
+void Sound_Processor::ProcessToneDetectors(const Frame_t *Frames, size_t FrameCount)
+{
+  const float sampleScale = 0.5f / (float)INT16_MAX;
+  for(size_t i = 0; i < FrameCount; ++i)
+  {
+    float sample = ((float)Frames[i].channel1 + (float)Frames[i].channel2) * sampleScale;
+    uint32_t triggerMask = m_ToneDetectors.PushSample(sample);
+    for(int16_t d = 0; triggerMask; ++d, triggerMask >>= 1)
     {
-      if(L_Bands_DataBuffer[i] > MaxBandMagnitude)
+      if(triggerMask & 1UL)
       {
-        MaxBandMagnitude = L_Bands_DataBuffer[i];
-        MaxBandIndex = i;
+        const GoertzelDetector &detector = m_ToneDetectors.GetDetector(d);
+        ESP_LOGI("ProcessToneDetectors", "Tone Detected: %f Hz Magnitude: %f", detector.GetFrequency(), detector.GetMagnitude());
+        m_Tone_Trigger.SetValue(ToneTrigger_t(d, detector.GetFrequency(), detector.GetMagnitude(), ++m_ToneTriggerCount));
       }
     }
-    m_L_Bands.SetValue(L_Bands_DataBuffer, 32);
-    L_MaxBand.MaxBandNormalizedPower = MaxBandMagnitude;
-    L_MaxBand.MaxBandIndex = MaxBandIndex;
-    L_MaxBand.TotalBands = 32;
-    m_L_Max_Band.SetValue(L_MaxBand);
+  }
 }
 
-
 void Sound_Processor::Static_Calculate_Power(void * parameter)
 {
   Sound_Processor *aSound_Processor = (Sound_Processor*)parameter;
@@ -183,56 +254,6 @@ void Sound_Processor::Calculate_Power()
     */
   }
 }
-void Sound_Processor::AssignToBands(float* Band_Data, FFT_Calculator* FFT_Calculator, int16_t FFT_Size)
-{
-  for(int i = 0; i < FFT_Size/2; ++i)
-  {
-    float magnitude = FFT_Calculator->GetFFTBufferValue(i);
-    float freq = GetFreqForBin(i);
-    int bandIndex = -1;
-
-    //SAE BAND BRAKEDOWN
-    if(freq > 0 && freq <= 43) bandIndex = 0;
-    else if(freq > 43 && freq <= 86) bandIndex = 1;
-    else if(freq > 86 && freq <= 129) bandIndex = 2;
-    else if(freq > 129 && freq <= 172) bandIndex = 3;
-    else if(freq > 172 && freq <= 215) bandIndex = 4;
-    else if(freq > 215 && freq <= 258) bandIndex = 5;
-    else if(freq > 258 && freq <= 301) bandIndex = 6;
-    else if(freq > 301 && freq <= 344) bandIndex = 7;
-    else if(freq > 344 && freq <= 388) bandIndex = 8;
-    else if(freq > 388 && freq <= 431) bandIndex = 9;
-    else if(freq > 431 && freq <= 474) bandIndex = 10;
-    else if(freq > 474 && freq <= 517) bandIndex = 11;
-    else if(freq > 517 && freq <= 560) bandIndex = 12;
-    else if(freq > 560 && freq <= 603) bandIndex = 13;
-    else if(freq > 603 && freq <= 646) bandIndex = 14;
-    else if(freq > 646 && freq <= 689) bandIndex = 15;
-    else if(freq > 689 && freq <= 800) bandIndex = 16;
-    else if(freq > 800 && freq <= 1000) bandIndex = 17;
-    else if(freq > 1000 && freq <= 1250) bandIndex = 18;
-    else if(freq > 1250 && freq <= 1600) bandIndex = 19;
-    else if(freq > 1600 && freq <= 2000) bandIndex = 20;
-    else if(freq > 2000 && freq <= 2500) bandIndex = 21;
-    else if(freq > 2500 && freq <= 3150) bandIndex = 22;
-    else if(freq > 3150 && freq <= 4000) bandIndex = 23;
-    else if(freq > 4000 && freq <= 5000) bandIndex = 24;
-    else if(freq > 5000 && freq <= 6300) bandIndex = 25;
-    else if(freq > 6300 && freq <= 8000) bandIndex = 26;
-    else if(freq > 8000 && freq <= 10000) bandIndex = 27;
-    else if(freq > 10000 && freq <= 12500) bandIndex = 28;
-    else if(freq > 12500 && freq <= 16000) bandIndex = 29;
-    else if(freq > 16000 && freq <= 20000) bandIndex = 30;
-    else if(freq > 20000 ) bandIndex = 31;
-    
-    if(bandIndex >= 0 && freq < I2S_SAMPLE_RATE / 2) Band_Data[bandIndex] += magnitude;
-    if(Band_Data[bandIndex] > 1.0)
-    {
-      Band_Data[bandIndex] = 1.0;
-    }
-  }
-}
-
 float Sound_Processor::GetFreqForBin(int Bin)
 {
   return 0.0; // (float)(Bin * ((float)I2S_SAMPLE_RATE / (float)(FFT_SIZE)));
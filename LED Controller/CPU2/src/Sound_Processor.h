@@ -27,6 +27,11 @@
 #include "Streaming.h"
 #include "float.h"
 #include "AudioBuffer.h"
+#include "GoertzelDetector.h"
+#include "BandLayout.h"
+#include "AudioPipelineProfiler.h"
+#include "Band_Calculator.h"
+#include <mutex>
 #include "DataItem/DataItems.h"
 
 class Sound_Processor: public NamedItem
@@ -41,6 +46,8 @@ class Sound_Processor: public NamedItem
                    , IPreferences& preferences );
     virtual ~Sound_Processor();
     void Setup();
+    void ProcessToneDetectors(const Frame_t *Frames, size_t FrameCount);
+    void RequestBandLayout(const BandLayout_t &Layout);
     
   private:
     ContinuousAudioBuffer<AUDIO_BUFFER_SIZE> &m_AudioBuffer;
@@ -83,6 +90,20 @@ class Sound_Processor: public NamedItem
                                                                                   , NULL
                                                                                   , this );
     float m_R_Bands_InitialValue = 0.0;
+    DataItem<float, 8> m_R_Bands_8 = DataItem<float, 8>( "R_Bands_8"
+                                                         , m_R_Bands_InitialValue
+                                                         , RxTxType_Tx_On_Change
+                                                         , 0
+                                                         , &m_CPU1SerialPortMessageManager
+                                                         , NULL
+                                                         , this );
+    DataItem<float, 16> m_R_Bands_16 = DataItem<float, 16>( "R_Bands_16"
+                                                            , m_R_Bands_InitialValue
+                                                            , RxTxType_Tx_On_Change
+                                                            , 0
+                                                            , &m_CPU1SerialPortMessageManager
+                                                            , NULL
+                                                            , this );
     DataItem<float, 32> m_R_Bands = DataItem<float, 32>( "R_Bands"
                                                        , m_R_Bands_InitialValue
                                                        , RxTxType_Tx_On_Change
@@ -90,6 +111,13 @@ class Sound_Processor: public NamedItem
                                                        , &m_CPU1SerialPortMessageManager
                                                        , NULL
                                                        , this );
+    DataItem<float, 64> m_R_Bands_64 = DataItem<float, 64>( "R_Bands_64"
+                                                            , m_R_Bands_InitialValue
+                                                            , RxTxType_Tx_On_Change
+                                                            , 0
+                                                            , &m_CPU1SerialPortMessageManager
+                                                            , NULL
+                                                            , this );
     
     MaxBandSoundData_t m_L_Max_Band_InitialValue = MaxBandSoundData_t();
     DataItem<MaxBandSoundData_t, 1> m_L_Max_Band = DataItem<MaxBandSoundData_t, 1>( "L_Max_Band"
@@ -101,6 +129,20 @@ class Sound_Processor: public NamedItem
                                                                                   , this );
     
     float m_L_Bands_InitialValue = 0.0;
+    DataItem<float, 8> m_L_Bands_8 = DataItem<float, 8>( "L_Bands_8"
+                                                         , m_L_Bands_InitialValue
+                                                         , RxTxType_Tx_On_Change
+                                                         , 0
+                                                         , &m_CPU1SerialPortMessageManager
+                                                         , NULL
+                                                         , this );
+    DataItem<float, 16> m_L_Bands_16 = DataItem<float, 16>( "L_Bands_16"
+                                                            , m_L_Bands_InitialValue
+                                                            , RxTxType_Tx_On_Change
+                                                            , 0
+                                                            , &m_CPU1SerialPortMessageManager
+                                                            , NULL
+                                                            , this );
     DataItem<float, 32> m_L_Bands = DataItem<float, 32>( "L_Bands"
                                                        , m_L_Bands_InitialValue
                                                        , RxTxType_Tx_On_Change
@@ -108,6 +150,84 @@ class Sound_Processor: public NamedItem
                                                        , &m_CPU1SerialPortMessageManager
                                                        , NULL
                                                        , this );
+    DataItem<float, 64> m_L_Bands_64 = DataItem<float, 64>( "L_Bands_64"
+                                                            , m_L_Bands_InitialValue
+                                                            , RxTxType_Tx_On_Change
+                                                            , 0
+                                                            , &m_CPU1SerialPortMessageManager
+                                                            , NULL
+                                                            , this );
+    
+    struct CallbackArguments 
+    {
+      void* arg1;
+      void* arg2;
+      void* arg3;
+      void* arg4;
+
+      CallbackArguments(void* a1 = nullptr, void* a2 = nullptr, void* a3 = nullptr, void* a4 = nullptr)
+        : arg1(a1), arg2(a2), arg3(a3), arg4(a4) {}
+    };
+
+    //Band Layout requested by CPU1. Requests arrive through the item's RX path, and the item only transmits the layout
+    //ApplyRequestedBandLayout has applied or kept. Only the band data item matching the active band count is transmitted.
+    CallbackArguments m_Band_Layout_CallbackArgs = {this};
+    NamedCallback_t m_Band_Layout_Callback = {"Band Layout Callback", &Band_Layout_ValueChanged, &m_Band_Layout_CallbackArgs};
+    BandLayout_t m_Band_Layout_InitialValue = BAND_LAYOUT_DEFAULT;
+    DataItem<BandLayout_t, 1> m_Band_Layout = DataItem<BandLayout_t, 1>( "Band_Layout"
+                                                                      , m_Band_Layout_InitialValue
+                                                                      , RxTxType_Tx_On_Change
+                                                                      , 0
+                                                                      , &m_CPU1SerialPortMessageManager
+                                                                      , &m_Band_Layout_Callback
+                                                                      , this );
+    static void Band_Layout_ValueChanged(const String &Name, void* object, void* arg)
+    {
+      if(arg && object)
+      {
+        CallbackArguments* arguments = static_cast<CallbackArguments*>(arg);
+        assert((arguments->arg1) && "Null Pointer!");
+        Sound_Processor* soundProcessor = static_cast<Sound_Processor*>(arguments->arg1);
+        soundProcessor->RequestBandLayout(*static_cast<BandLayout_t*>(object));
+      }
+    }
+    FFT_BandLayout_t m_BandLayout;
+    std::mutex m_BandLayoutMutex;
+    BandLayout_t m_RequestedBandLayout = BAND_LAYOUT_DEFAULT;
+    bool m_BandLayoutRequested = true;
+    void ApplyRequestedBandLayout();
+    
+    //The FFT calculators pick sub-bin peaks on every FFT, see FFT_Calculator::GetPeaks. They are not sent to CPU1
+    //until it has an effect that reads them, so the real time lane only carries data that is used.
+    
+    ToneTrigger_t m_Tone_Trigger_InitialValue = ToneTrigger_t();
+    DataItem<ToneTrigger_t, 1> m_Tone_Trigger = DataItem<ToneTrigger_t, 1>( "Tone_Trigger"
+                                                                         , m_Tone_Trigger_InitialValue
+                                                                         , RxTxType_Tx_On_Change
+                                                                         , 0
+                                                                         , &m_CPU1SerialPortMessageManager
+                                                                         , NULL
+                                                                         , this );
+    const GoertzelDetectorConfig_t m_ToneDetectorConfigs[TONE_DETECTOR_COUNT] = TONE_DETECTOR_CONFIGS;
+    GoertzelDetectorBank<TONE_DETECTOR_COUNT> m_ToneDetectors = GoertzelDetectorBank<TONE_DETECTOR_COUNT>( m_ToneDetectorConfigs
+                                                                                                        , I2S_SAMPLE_RATE
+                                                                                                        , TONE_DETECTOR_BLOCK_SIZE
+                                                                                                        , TONE_DETECTOR_HOLD_BLOCKS );
+    uint32_t m_ToneTriggerCount = 0;
+    
+    #ifdef ENABLE_STAGE_PROFILER
+    //Audio pipeline stage timings in CPU cycles, reported to CPU3 every STAGE_PROFILER_REPORT_INTERVAL FFT loops
+    StageProfile_t m_Stage_Profile_InitialValue = StageProfile_t();
+    DataItem<StageProfile_t, AudioPipelineStage_Count> m_Stage_Profile = DataItem<StageProfile_t, AudioPipelineStage_Count>( "Stage_Profile"
+                                                                                                                        , m_Stage_Profile_InitialValue
+                                                                                                                        , RxTxType_Tx_On_Change
+                                                                                                                        , 0
+                                                                                                                        , &m_CPU3SerialPortMessageManager
+                                                                                                                        , NULL
+                                                                                                                        , this );
+    size_t m_StageProfileLoopCount = 0;
+    void SendStageProfile();
+    #endif
     
     //DB Conversion taken from INMP441 Datasheet
     float m_IMNP441_1PA_Offset = 94;          //DB Output at 1PA
@@ -125,8 +245,6 @@ class Sound_Processor: public NamedItem
     void Calculate_FFTs();
     void Update_Right_Bands_And_Send_Result();
     void Update_Left_Bands_And_Send_Result();
-
-    void AssignToBands(float* Band_Data, FFT_Calculator* FFT_Calculator, int16_t FFT_Size);
     float GetFreqForBin(int bin);
     int GetBinForFrequency(float Frequency);
     int16_t m_AudioBinLimit;
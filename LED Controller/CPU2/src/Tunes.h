@@ -13,16 +13,38 @@
 #define CPU3_RX                   14
 #define CPU3_TX                   15
 
+//CPU2&3 DMA SPI, replaces the CPU3 UART when built with -DBUILD_SPI_TRANSPORT. CPU2 is the master.
+#define CPU3_SPI_SCK              18
+#define CPU3_SPI_MISO             19
+#define CPU3_SPI_MOSI             23
+#define CPU3_SPI_SS               5
+
 //App Tunes
 #define I2S_SAMPLE_RATE                 44100
 #define MAX_VISUALIZATION_FREQUENCY     4000.0
 #define I2S_BUFFER_COUNT                10
 #define I2S_SAMPLE_COUNT                512
-#define NUMBER_OF_BANDS                 32
 #define FFT_SIZE                        512
 #define AMPLITUDE_BUFFER_FRAME_COUNT    100
 #define AUDIO_BUFFER_SIZE               2048
 
+//Tone Detector Tunes
+#define TONE_DETECTOR_COUNT             2
+#define TONE_DETECTOR_CONFIGS           { { 1000.0, 0.05, 0.5 }, { 2000.0, 0.05, 0.5 } }   //{ Frequency, Magnitude Threshold, Purity Threshold }
+#define TONE_DETECTOR_BLOCK_SIZE        441                                                 //10ms blocks, 100Hz bins
+#define TONE_DETECTOR_HOLD_BLOCKS       3
+
+//Band Layout Tunes
+#define BAND_LAYOUT_MAX_BANDS           64
+#define BAND_LAYOUT_DEFAULT             BandLayout_t(32, BandScale_SAE, 0, 22050)   //{ Band Count, Scale, Min Frequency, Max Frequency }
+
+//Spectral Peak Tunes
+#define SPECTRAL_PEAK_COUNT             4
+#define SPECTRAL_PEAK_MINIMUM_MAGNITUDE 0.001
+
+//Stage Profiler Tunes. Profiling is compiled in with -DENABLE_STAGE_PROFILER
+#define STAGE_PROFILER_REPORT_INTERVAL  10                                                  //FFT loops between reports
+
 #define TASK_STACK_SIZE_DEBUG           false
 #define TASK_LOOP_COUNT_DEBUG           false
 
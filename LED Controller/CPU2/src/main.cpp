@@ -20,6 +20,9 @@
 #include "Tunes.h"
 #include "esp_log.h"
 #include "DataItem/DataItems.h"
+#ifdef BUILD_SPI_TRANSPORT
+#include "SpiTransport.h"
+#endif
 #define SERIAL_RX_BUFFER_SIZE 2048
 
 Preferences m_Preferences;
@@ -53,7 +56,13 @@ ContinuousAudioBuffer<AUDIO_BUFFER_SIZE> m_AudioBuffer;
 
 DataSerializer m_DataSerializer;
 SerialPortMessageManager m_CPU1SerialPortMessageManager = SerialPortMessageManager("CPU1", &Serial1, &m_DataSerializer);
+#ifdef BUILD_SPI_TRANSPORT
+//The CPU3 link carries the band and preview streams, so it can run over DMA SPI with CPU2 as the master
+SpiTransport m_CPU3SpiTransport = SpiTransport("CPU3 SPI", SpiTransportRole_Master, VSPI, CPU3_SPI_SCK, CPU3_SPI_MISO, CPU3_SPI_MOSI, CPU3_SPI_SS);
+SerialPortMessageManager m_CPU3SerialPortMessageManager = SerialPortMessageManager("CPU3", &m_CPU3SpiTransport, &m_DataSerializer);
+#else
 SerialPortMessageManager m_CPU3SerialPortMessageManager = SerialPortMessageManager("CPU3", &Serial2, &m_DataSerializer);
+#endif
 
 
 Sound_Processor m_SoundProcessor ( "Sound Processor"
@@ -122,9 +131,13 @@ void setup()
   Serial1.begin(500000, SERIAL_8O2, CPU1_RX, CPU1_TX);
   Serial1.flush();
   
+#ifdef BUILD_SPI_TRANSPORT
+  m_CPU3SpiTransport.Begin();
+#else
   Serial2.setRxBufferSize(SERIAL_RX_BUFFER_SIZE);
   Serial2.begin(500000, SERIAL_8O2, CPU3_RX, CPU3_TX);
   Serial2.flush();
+#endif
 
   TestPSRam();
   m_PreferencesWrapper.Setup();
@@ -67,6 +67,8 @@ class SettingsWebServerManager: public SetupCallerInterface
 
     void InitializeLocalvariables()
     {
+      m_CPU1SerialPortMessageManager.SetLinkHealthCallback([this](const LinkHealth_t &Health){ m_LinkHealth_3_1.SetValue(Health); });
+      m_CPU2SerialPortMessageManager.SetLinkHealthCallback([this](const LinkHealth_t &Health){ m_LinkHealth_3_2.SetValue(Health); });
     }
 
     void StartWiFi()
@@ -119,6 +121,10 @@ class SettingsWebServerManager: public SetupCallerInterface
           file.close(); // Close the file after streaming
       });
 
+      // Link captures, when the build records them
+      ServeLinkCapture("/link_capture/cpu1", m_CPU1SerialPortMessageManager);
+      ServeLinkCapture("/link_capture/cpu2", m_CPU2SerialPortMessageManager);
+
       // Serve all other static files from SPIFFS
       m_WebServer.serveStatic("/", SPIFFS, "/"); // Serve static files
       
@@ -129,6 +135,26 @@ class SettingsWebServerManager: public SetupCallerInterface
 
     }
 
+    // Streams the capture file of a link. The link keeps running, but is not recorded, while the download runs.
+    void ServeLinkCapture(const char* Path, SerialPortMessageManager &Manager)
+    {
+      LinkCapture* Capture = Manager.GetLinkCapture();
+      if(!Capture) return;
+      const String FileName = Manager.GetName() + ".ltcap";
+      m_WebServer.on(Path, HTTP_GET, [this, Capture, FileName]()
+      {
+          m_WebServer.sendHeader("Content-Disposition", "attachment; filename=" + FileName);
+          m_WebServer.setContentLength(CONTENT_LENGTH_UNKNOWN);
+          m_WebServer.send(200, "application/octet-stream", "");
+          const size_t Bytes = Capture->Dump([this](const uint8_t* Data, size_t Length)
+          {
+              m_WebServer.sendContent(reinterpret_cast<const char*>(Data), Length);
+          });
+          m_WebServer.sendContent("");
+          ESP_LOGI("ServeLinkCapture", "Link Capture Sent: \"%s\" %zu bytes", FileName.c_str(), Bytes);
+      });
+    }
+
     // Initialize SPIFFS
     void InitFileSystem()
     {
@@ -728,6 +754,26 @@ class SettingsWebServerManager: public SetupCallerInterface
     const bool m_SourceReset_InitialValue = false;
     DataItem<bool, 1> m_SourceReset = DataItem<bool, 1>( "BT_Src_Reset", m_SourceReset_InitialValue, RxTxType_Tx_On_Change_With_Heartbeat, 5000, &m_CPU2SerialPortMessageManager, nullptr, this, &validBoolValues);
     WebSocketDataHandler<bool, 1> m_SourceReset_DataHandler = WebSocketDataHandler<bool, 1>( m_WebSocketDataProcessor, m_SourceReset );    
+
+    //CPU2 Audio Pipeline Stage Profile
+    const StageProfile_t m_StageProfile_InitialValue = StageProfile_t();
+    DataItem<StageProfile_t, AudioPipelineStage_Count> m_StageProfile = DataItem<StageProfile_t, AudioPipelineStage_Count>( "Stage_Profile", m_StageProfile_InitialValue, RxTxType_Rx_Only, 0, &m_CPU2SerialPortMessageManager, nullptr, this);
+    WebSocketDataHandler<StageProfile_t, AudioPipelineStage_Count> m_StageProfile_DataHandler = WebSocketDataHandler<StageProfile_t, AudioPipelineStage_Count>( m_WebSocketDataProcessor, m_StageProfile );
+
+    //Link Health, every serial link as seen from both of its ends
+    const LinkHealth_t m_LinkHealth_InitialValue = LinkHealth_t();
+    DataItem<LinkHealth_t, 1> m_LinkHealth_1_2 = DataItem<LinkHealth_t, 1>( "Link_Health_1_2", m_LinkHealth_InitialValue, RxTxType_Rx_Only, 0, &m_CPU1SerialPortMessageManager, nullptr, this);
+    WebSocketDataHandler<LinkHealth_t, 1> m_LinkHealth_1_2_DataHandler = WebSocketDataHandler<LinkHealth_t, 1>( m_WebSocketDataProcessor, m_LinkHealth_1_2 );
+    DataItem<LinkHealth_t, 1> m_LinkHealth_1_3 = DataItem<LinkHealth_t, 1>( "Link_Health_1_3", m_LinkHealth_InitialValue, RxTxType_Rx_Only, 0, &m_CPU1SerialPortMessageManager, nullptr, this);
+    WebSocketDataHandler<LinkHealth_t, 1> m_LinkHealth_1_3_DataHandler = WebSocketDataHandler<LinkHealth_t, 1>( m_WebSocketDataProcessor, m_LinkHealth_1_3 );
+    DataItem<LinkHealth_t, 1> m_LinkHealth_2_1 = DataItem<LinkHealth_t, 1>( "Link_Health_2_1", m_LinkHealth_InitialValue, RxTxType_Rx_Only, 0, &m_CPU2SerialPortMessageManager, nullptr, this);
+    WebSocketDataHandler<LinkHealth_t, 1> m_LinkHealth_2_1_DataHandler = WebSocketDataHandler<LinkHealth_t, 1>( m_WebSocketDataProcessor, m_LinkHealth_2_1 );
+    DataItem<LinkHealth_t, 1> m_LinkHealth_2_3 = DataItem<LinkHealth_t, 1>( "Link_Health_2_3", m_LinkHealth_InitialValue, RxTxType_Rx_Only, 0, &m_CPU2SerialPortMessageManager, nullptr, this);
+    WebSocketDataHandler<LinkHealth_t, 1> m_LinkHealth_2_3_DataHandler = WebSocketDataHandler<LinkHealth_t, 1>( m_WebSocketDataProcessor, m_LinkHealth_2_3 );
+    LocalDataItem<LinkHealth_t, 1> m_LinkHealth_3_1 = LocalDataItem<LinkHealth_t, 1>( "Link_Health_3_1", m_LinkHealth_InitialValue, nullptr, this);
+    WebSocketDataHandler<LinkHealth_t, 1> m_LinkHealth_3_1_DataHandler = WebSocketDataHandler<LinkHealth_t, 1>( m_WebSocketDataProcessor, m_LinkHealth_3_1 );
+    LocalDataItem<LinkHealth_t, 1> m_LinkHealth_3_2 = LocalDataItem<LinkHealth_t, 1>( "Link_Health_3_2", m_LinkHealth_InitialValue, nullptr, this);
+    WebSocketDataHandler<LinkHealth_t, 1> m_LinkHealth_3_2_DataHandler = WebSocketDataHandler<LinkHealth_t, 1>( m_WebSocketDataProcessor, m_LinkHealth_3_2 );
     
     void HandleWebSocketMessage(uint8_t clientID, WStype_t type, uint8_t *payload, size_t length)
     {
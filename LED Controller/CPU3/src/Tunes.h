@@ -8,6 +8,15 @@
 #define CPU2_RX             14
 #define CPU2_TX             15
 
+//CPU2&3 DMA SPI, replaces the CPU2 UART when built with -DBUILD_SPI_TRANSPORT. CPU3 is the slave.
+#define CPU2_SPI_SCK        18
+#define CPU2_SPI_MISO       19
+#define CPU2_SPI_MOSI       23
+#define CPU2_SPI_SS         5
+
+//Link capture, compiled in with -DENABLE_LINK_CAPTURE
+#define LINK_CAPTURE_SIZE   1048576     //Bytes of PSRAM per link, the latest traffic is kept
+
 
 //APP TUNES
 #define ACTIVE_NAME_TIMEOUT  15000
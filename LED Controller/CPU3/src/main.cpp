@@ -21,6 +21,9 @@
 
 #include "Tunes.h"
 #include "SettingsWebServer.h"
+#ifdef BUILD_SPI_TRANSPORT
+#include "SpiTransport.h"
+#endif
 
 #define SERIAL_RX_BUFFER_SIZE 2048
 
@@ -29,7 +32,18 @@ PreferencesWrapper m_PreferencesWrapper = PreferencesWrapper("Settings", &m_Pref
 
 DataSerializer m_DataSerializer;  
 SerialPortMessageManager m_CPU1SerialPortMessageManager = SerialPortMessageManager("CPU1", &Serial1, &m_DataSerializer);
+#ifdef BUILD_SPI_TRANSPORT
+//CPU2 is the master of the DMA SPI link
+SpiTransport m_CPU2SpiTransport = SpiTransport("CPU2 SPI", SpiTransportRole_Slave, VSPI, CPU2_SPI_SCK, CPU2_SPI_MISO, CPU2_SPI_MOSI, CPU2_SPI_SS);
+SerialPortMessageManager m_CPU2SerialPortMessageManager = SerialPortMessageManager("CPU2", &m_CPU2SpiTransport, &m_DataSerializer);
+#else
 SerialPortMessageManager m_CPU2SerialPortMessageManager = SerialPortMessageManager("CPU2", &Serial2, &m_DataSerializer);
+#endif
+
+#ifdef ENABLE_LINK_CAPTURE
+LinkCapture m_CPU1LinkCapture = LinkCapture(LINK_CAPTURE_SIZE);
+LinkCapture m_CPU2LinkCapture = LinkCapture(LINK_CAPTURE_SIZE);
+#endif
 
 // Create AsyncWebServer object on port 80
 WebServer MyWebServer(80);
@@ -52,9 +66,13 @@ void SetupSerialPorts()
   Serial1.setRxBufferSize(SERIAL_RX_BUFFER_SIZE);
   Serial1.begin(500000, SERIAL_8O2, CPU1_RX, CPU1_TX);
   Serial1.flush();
+#ifdef BUILD_SPI_TRANSPORT
+  m_CPU2SpiTransport.Begin();
+#else
   Serial2.setRxBufferSize(SERIAL_RX_BUFFER_SIZE);
   Serial2.begin(500000, SERIAL_8O2, CPU2_RX, CPU2_TX);
   Serial2.flush();
+#endif
   ESP_LOGI("SetupSerialPorts", "Serial Ports Setup");
 }
 
@@ -89,8 +107,27 @@ void TestPSRam()
     assert(freeSizeAfterFree == freeSizeBefore);
 }
 
+#ifdef ENABLE_LINK_CAPTURE
+void SetupLinkCapture(SerialPortMessageManager &Manager, LinkCapture &Capture)
+{
+  if(Capture.Begin())
+  {
+    Manager.SetLinkCapture(&Capture);
+    ESP_LOGI("SetupLinkCapture", "\"%s\" Link Capture Started: %zu bytes", Manager.GetName().c_str(), Capture.GetSize());
+  }
+  else
+  {
+    ESP_LOGE("SetupLinkCapture", "ERROR! \"%s\" Unable to allocate the Link Capture.", Manager.GetName().c_str());
+  }
+}
+#endif
+
 void InitLocalVariables()
 {
+#ifdef ENABLE_LINK_CAPTURE
+  SetupLinkCapture(m_CPU1SerialPortMessageManager, m_CPU1LinkCapture);
+  SetupLinkCapture(m_CPU2SerialPortMessageManager, m_CPU2LinkCapture);
+#endif
   m_CPU1SerialPortMessageManager.Setup();
   m_CPU2SerialPortMessageManager.Setup();
   m_SettingsWebServerManager.SetupSettingsWebServerManager();
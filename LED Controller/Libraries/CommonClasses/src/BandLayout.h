@@ -0,0 +1,174 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+
+#define BAND_LAYOUT_NO_BAND 0xFF
+
+enum BandScale_t
+{
+	BandScale_Linear,
+	BandScale_Mel,
+	BandScale_Octave,
+	BandScale_SAE,
+	BandScale_Count
+};
+
+//Compact layout schema exchanged over the link. 6 bytes describe any supported layout.
+struct BandLayoutDescriptor_t
+{
+	uint8_t BandCount = 32;
+	uint8_t Scale = BandScale_SAE;
+	uint16_t MinFrequency = 0;      //Hz
+	uint16_t MaxFrequency = 22050;  //Hz
+};
+
+//Lower edges of the 32 band SAE breakdown. The upper edge of the last band is the layout maximum frequency.
+static const uint16_t SAEBandLowerEdges[] =
+{
+	0, 43, 86, 129, 172, 215, 258, 301, 344, 388, 431, 474, 517, 560, 603, 646,
+	689, 800, 1000, 1250, 1600, 2000, 2500, 3150, 4000, 5000, 6300, 8000, 10000, 12500, 16000, 20000
+};
+static const size_t SAEBandCount = sizeof(SAEBandLowerEdges) / sizeof(SAEBandLowerEdges[0]);
+
+//Maps FFT bins to bands for a descriptor. The table is built once when the layout changes so
+//the per frame accumulation is a single pass over the bins with no frequency math or branching on band edges.
+template <size_t MAX_BINS, size_t MAX_BANDS>
+class BandLayout
+{
+	static_assert(MAX_BANDS < BAND_LAYOUT_NO_BAND, "Band index must fit the bin table");
+	public:
+		BandLayout(){}
+		virtual ~BandLayout(){}
+
+		static bool IsValidDescriptor(const BandLayoutDescriptor_t &descriptor)
+		{
+			if(0 == descriptor.BandCount || descriptor.BandCount > MAX_BANDS) return false;
+			if(descriptor.MinFrequency >= descriptor.MaxFrequency) return false;
+			switch(descriptor.Scale)
+			{
+				case BandScale_Linear:
+				case BandScale_Mel:
+					return true;
+				case BandScale_Octave:
+					return (descriptor.MinFrequency > 0);
+				case BandScale_SAE:
+					return (descriptor.BandCount <= SAEBandCount) && (0 == (SAEBandCount % descriptor.BandCount));
+				default:
+					return false;
+			}
+		}
+
+		//Builds the band edges and the bin to band table. Returns false and leaves the current layout untouched for an invalid descriptor.
+		bool Configure(const BandLayoutDescriptor_t &descriptor, float sampleRate, size_t fftSize)
+		{
+			if(!IsValidDescriptor(descriptor) || 0 == fftSize) return false;
+			size_t binCount = fftSize / 2;
+			if(binCount > MAX_BINS) return false;
+
+			m_Descriptor = descriptor;
+			m_BinCount = binCount;
+			const size_t bandCount = descriptor.BandCount;
+			const float nyquist = sampleRate / 2.0f;
+			const float maxFrequency = (descriptor.MaxFrequency < nyquist) ? descriptor.MaxFrequency : nyquist;
+			for(size_t i = 0; i <= bandCount; ++i)
+			{
+				const float edge = CalculateEdge(descriptor, i, maxFrequency);
+				m_Edges[i] = (edge < maxFrequency) ? edge : maxFrequency;
+			}
+
+			const float binWidth = sampleRate / static_cast<float>(fftSize);
+			m_FirstBin = binCount;
+			m_LastBin = 0;
+			size_t band = 0;
+			for(size_t bin = 0; bin < binCount; ++bin)
+			{
+				const float frequency = static_cast<float>(bin) * binWidth;
+				m_BinToBand[bin] = BAND_LAYOUT_NO_BAND;
+				if(frequency <= m_Edges[0] || frequency > m_Edges[bandCount]) continue;
+				while(band + 1 < bandCount && frequency > m_Edges[band + 1]) ++band;
+				m_BinToBand[bin] = static_cast<uint8_t>(band);
+				if(bin < m_FirstBin) m_FirstBin = bin;
+				m_LastBin = bin + 1;
+			}
+			if(m_FirstBin > m_LastBin) m_FirstBin = m_LastBin;
+			return true;
+		}
+
+		//Sums the bin magnitudes into bands. bands must hold GetBandCount() values and is overwritten.
+		inline void Accumulate(const float* magnitudes, float* bands) const
+		{
+			for(size_t i = 0; i < m_Descriptor.BandCount; ++i)
+			{
+				bands[i] = 0.0f;
+			}
+			for(size_t bin = m_FirstBin; bin < m_LastBin; ++bin)
+			{
+				const uint8_t band = m_BinToBand[bin];
+				if(BAND_LAYOUT_NO_BAND != band) bands[band] += magnitudes[bin];
+			}
+			for(size_t i = 0; i < m_Descriptor.BandCount; ++i)
+			{
+				if(bands[i] > 1.0f) bands[i] = 1.0f;
+			}
+		}
+
+		const BandLayoutDescriptor_t& GetDescriptor() const { return m_Descriptor; }
+		size_t GetBandCount() const { return m_Descriptor.BandCount; }
+		size_t GetBinCount() const { return m_BinCount; }
+		int16_t GetBandForBin(size_t bin) const { return (bin < m_BinCount && BAND_LAYOUT_NO_BAND != m_BinToBand[bin]) ? m_BinToBand[bin] : -1; }
+		float GetBandLowerFrequency(size_t band) const { return m_Edges[band]; }
+		float GetBandUpperFrequency(size_t band) const { return m_Edges[band + 1]; }
+
+	private:
+		BandLayoutDescriptor_t m_Descriptor;
+		float m_Edges[MAX_BANDS + 1] = {0.0f};
+		uint8_t m_BinToBand[MAX_BINS] = {0};
+		size_t m_BinCount = 0;
+		size_t m_FirstBin = 0;
+		size_t m_LastBin = 0;
+
+		static float HzToMel(float hz) { return 2595.0f * std::log10(1.0f + (hz / 700.0f)); }
+		static float MelToHz(float mel) { return 700.0f * (std::pow(10.0f, mel / 2595.0f) - 1.0f); }
+
+		static float CalculateEdge(const BandLayoutDescriptor_t &descriptor, size_t edge, float maxFrequency)
+		{
+			const float minFrequency = descriptor.MinFrequency;
+			const float fraction = static_cast<float>(edge) / static_cast<float>(descriptor.BandCount);
+			if(edge == descriptor.BandCount) return maxFrequency;
+			switch(descriptor.Scale)
+			{
+				case BandScale_Mel:
+				{
+					const float minMel = HzToMel(minFrequency);
+					return MelToHz(minMel + ((HzToMel(maxFrequency) - minMel) * fraction));
+				}
+				case BandScale_Octave:
+					return minFrequency * std::pow(maxFrequency / minFrequency, fraction);
+				case BandScale_SAE:
+					return SAEBandLowerEdges[edge * (SAEBandCount / descriptor.BandCount)];
+				case BandScale_Linear:
+				default:
+					return minFrequency + ((maxFrequency - minFrequency) * fraction);
+			}
+		}
+};
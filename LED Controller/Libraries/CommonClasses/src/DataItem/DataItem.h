@@ -136,7 +136,7 @@ class DataItem: public LocalDataItem<T, COUNT>
 		{
 			return LocalDataItem<T, COUNT>::GetChangeCount();
 		}
-		virtual T* GetValuePointer() const override
+		virtual const T* GetValuePointer() const override
 		{
 			return LocalDataItem<T, COUNT>::GetValuePointer();
 		}
@@ -166,6 +166,7 @@ class DataItem: public LocalDataItem<T, COUNT>
 			return LocalDataItem<T, COUNT>::ConvertValueToString(pvalue, count);
 		}
 
+		using LocalDataItem<T, COUNT>::ParseStringValueIntoValues;
 		virtual size_t ParseStringValueIntoValues(const String& stringValue, T* values) override
 		{
 			return LocalDataItem<T, COUNT>::ParseStringValueIntoValues(stringValue, values);
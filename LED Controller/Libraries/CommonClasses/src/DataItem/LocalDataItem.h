@@ -23,7 +23,10 @@
 #include <esp_timer.h>
 #include <Arduino.h>
 #include <esp_heap_caps.h>
+#include <algorithm>
+#include <array>
 #include "DataItemInterface.h"
+#include "ValueStore.h"
 #include "SerialMessageManager.h"
 #include "SetupCallInterfaces.h"
 #include "ValidValueChecker.h"
@@ -115,7 +118,7 @@ class LocalDataItem: public DataItemInterface<T, COUNT>
 		
 		virtual ~LocalDataItem()
 		{
-			ESP_LOGI("DataItem<T, COUNT>::Setup()", "\"%s\": LocalDataItem Freeing Memory", m_Name.c_str());
+			ESP_LOGI("DataItem<T, COUNT>::Setup()", "\"%s\": Deleting LocalDataItem", m_Name.c_str());
 			if(mp_SetupCallerInterface)
 			{
         		ESP_LOGD("~LocalDataItem", "DeRegistering for Setup Call");
@@ -126,17 +129,6 @@ class LocalDataItem: public DataItemInterface<T, COUNT>
         		ESP_LOGD("~LocalDataItem", "DeRegistering Named Callback");
 				this->DeRegisterNamedCallback(mp_NamedCallback);
 			}
-			if(mp_Value)
-			{
-				std::lock_guard<std::recursive_mutex> lock(m_ValueMutex);
-        		ESP_LOGD("~LocalDataItem", "freeing mp_Value Memory");
-				free(mp_Value);
-			}
-			if(mp_InitialValue) 
-			{
-        		ESP_LOGD("~LocalDataItem", "freeing mp_InitialValue Memory");
-				free(mp_InitialValue);
-			}
 		}
 
 		void CommonSetup()
@@ -147,11 +139,11 @@ class LocalDataItem: public DataItemInterface<T, COUNT>
 		virtual void Setup() override
 		{
 			std::lock_guard<std::recursive_mutex> lock(m_ValueMutex);
-			ESP_LOGD("DataItem<T, COUNT>::Setup()", "\"%s\": Allocating Memory", m_Name.c_str());
+			ESP_LOGD("DataItem<T, COUNT>::Setup()", "\"%s\": Setting Initial Value", m_Name.c_str());
 			if(mp_NamedCallback) this->RegisterNamedCallback(mp_NamedCallback);
-			mp_Value = (T*)malloc(sizeof(T)*COUNT);
-			mp_InitialValue = (T*)malloc(sizeof(T)*COUNT);
-			if (mp_Value && mp_InitialValue && mp_InitialValuePtr)
+			//The values are stored inline, so there is nothing to allocate. The initial value is copied here rather
+			//than in the constructor since it may be another object's member that is not constructed yet.
+			if (mp_InitialValuePtr)
 			{
 				if (std::is_same<T, char>::value)
 				{
@@ -164,30 +156,32 @@ class LocalDataItem: public DataItemInterface<T, COUNT>
 						{
 							value = '\0';
 						}
-						memcpy(mp_Value+i, &value, sizeof(char));
-						memcpy(mp_InitialValue+i, &value, sizeof(char));
+						memcpy(&m_Value[i], &value, sizeof(char));
+						memcpy(&m_InitialValue[i], &value, sizeof(char));
 					}
 					ESP_LOGD( "DataItem<T, COUNT>::Setup()", "\"%s\": Set initial value <char>: \"%s\""
 							, m_Name.c_str()
 							, GetInitialValueAsString().c_str());
-					this->CallNamedCallbacks(mp_Value);
+					m_PublishedValue.Store(m_Value.data());
+					this->CallNamedCallbacks(m_Value.data());
 				}
 				else
 				{
 					for (size_t i = 0; i < COUNT; ++i)
 					{
-						memcpy(mp_Value+i, mp_InitialValuePtr, sizeof(T));
-						memcpy(mp_InitialValue+i, mp_InitialValuePtr, sizeof(T));
+						memcpy(&m_Value[i], mp_InitialValuePtr, sizeof(T));
+						memcpy(&m_InitialValue[i], mp_InitialValuePtr, sizeof(T));
 					}
 					ESP_LOGD( "DataItem<T, COUNT>::Setup()", "\"%s\": Set initial value <T>: \"%s\""
 							, m_Name.c_str()
 							, GetInitialValueAsString().c_str());
-					this->CallNamedCallbacks(mp_Value);
+					m_PublishedValue.Store(m_Value.data());
+					this->CallNamedCallbacks(m_Value.data());
 				}
 			}
 			else
 			{
-				ESP_LOGE("DataItem<T, COUNT>::Setup()", "Failed to allocate memory on spi ram.");
+				ESP_LOGE("DataItem<T, COUNT>::Setup()", "ERROR! \"%s\": NULL Initial Value Pointer.", m_Name.c_str());
 			}
 		}
 		
@@ -227,65 +221,35 @@ class LocalDataItem: public DataItemInterface<T, COUNT>
 
 		void ResetToDefaultValue()
 		{
-			SetValue(mp_InitialValue, COUNT);
+			SetValue(m_InitialValue.data(), COUNT);
 		}
 
+		//Readers take the published copy rather than the lock, so they never wait on a writer and writers never wait on them
 		void GetValue(void* object, size_t count) const
 		{
-			std::lock_guard<std::recursive_mutex> lock(this->m_ValueMutex);
 			assert((count == COUNT) && "Counts must be equal");
-			if (mp_Value)
-			{
-				memcpy(object, mp_Value, sizeof(T) * count);
-			}
-			else
-			{
-				ESP_LOGE("GetValue", "ERROR! NULL Pointer in mp_Value.");
-				if constexpr (std::is_pointer_v<T>)
-				{
-					*reinterpret_cast<T*>(object) = nullptr;
-				}
-			}
+			m_PublishedValue.Load(static_cast<T*>(object));
 		}
 
-		T* GetValuePointer() const
+		//Points at the live value, which is neither locked nor published. Only read it from the task that sets the
+		//item or under m_ValueMutex; other tasks read a copy through GetValue.
+		const T* GetValuePointer() const
 		{
-			std::lock_guard<std::recursive_mutex> lock(this->m_ValueMutex);
-			if(!mp_Value)
-			{
-				ESP_LOGE("GetValueAsString", "ERROR! \"%s\": NULL Pointer.", m_Name.c_str());
-			}
-			return mp_Value;
+			return m_Value.data();
 		}
 
 		virtual T GetValue() const
 		{
-			std::lock_guard<std::recursive_mutex> lock(this->m_ValueMutex);
 			assert((1 == COUNT) && "Count must 1 to use this function");
-			if(mp_Value)
-			{
-				return static_cast<T>(*mp_Value);
-			}
-			else
-			{
-				ESP_LOGE("GetValueAsString", "ERROR! \"%s\": NULL Pointer.", m_Name.c_str());
-				return T();
-			}
+			T value;
+			m_PublishedValue.Load(&value);
+			return value;
 		}
 
 		virtual bool GetInitialValueAsString(String &stringValue) const
 		{
-			stringValue = "";
-			if (mp_InitialValue && COUNT > 0)
-			{
-				stringValue = ConvertValueToString(mp_InitialValue, COUNT);
-				return true;
-			}
-			else
-			{
-				ESP_LOGE("GetInitialValueAsString", "ERROR! \"%s\": NULL Pointer.", m_Name.c_str());
-				return false;
-			}
+			stringValue = ConvertValueToString(m_InitialValue.data(), COUNT);
+			return true;
 		}
 
 		virtual String GetInitialValueAsString() const
@@ -302,18 +266,9 @@ class LocalDataItem: public DataItemInterface<T, COUNT>
 		virtual bool GetValueAsString(String &stringValue) const
 		{
 			std::lock_guard<std::recursive_mutex> lock(m_ValueMutex);
-			stringValue = "";
-			if (mp_Value && COUNT > 0)
-			{
-				stringValue = ConvertValueToString(mp_Value, COUNT);
-				ESP_LOGV("GetValueAsString", "\"%s\": String Value: \"%s\"", m_Name.c_str(), stringValue.c_str());
-				return true;
-			}
-			else
-			{
-				ESP_LOGE("GetValueAsString", "ERROR! \"%s\": NULL Pointer.", m_Name.c_str());
-				return false;
-			}
+			stringValue = ConvertValueToString(m_Value.data(), COUNT);
+			ESP_LOGV("GetValueAsString", "\"%s\": String Value: \"%s\"", m_Name.c_str(), stringValue.c_str());
+			return true;
 		}
 
 		virtual String GetValueAsString() const
@@ -350,44 +305,48 @@ class LocalDataItem: public DataItemInterface<T, COUNT>
 
 		virtual size_t ParseStringValueIntoValues(const String& stringValue, T* values)
 		{
-			std::vector<String> substrings;
-			size_t start = 0;
-			size_t end = stringValue.indexOf(ENCODE_OBJECT_DIVIDER);
+			return ParseStringValueIntoValues(stringValue.c_str(), stringValue.length(), values);
+		}
 
-			// Split the input string by ENCODE_OBJECT_DIVIDER
-			while (end != -1)
+		//Splits the string by ENCODE_OBJECT_DIVIDER and decodes each part straight into values, without copying the parts.
+		//Returns COUNT, or 0 if the number of parts is wrong or a part is rejected or cannot be decoded.
+		size_t ParseStringValueIntoValues(const char* string, size_t length, T* values)
+		{
+			const char* const last = string + length;
+			const size_t dividerLength = strlen(ENCODE_OBJECT_DIVIDER);
+			size_t count = 0;
+			for(const char* first = string; ; first += dividerLength)
 			{
-				String parsedString = stringValue.substring(start, end);
-				ESP_LOGD("SetValueFromString", "Parsed String: \"%s\"", parsedString.c_str());
-				substrings.push_back(parsedString);
-				start = end + 1;
-				end = stringValue.indexOf(ENCODE_OBJECT_DIVIDER, start);
+				const char* end = std::search(first, last, ENCODE_OBJECT_DIVIDER, ENCODE_OBJECT_DIVIDER + dividerLength);
+				ESP_LOGD("SetValueFromString", "Parsed String: \"%.*s\"", (int)(end - first), first);
+				if(count < COUNT)
+				{
+					if(false == m_ValidValueChecker.IsValidStringValue(first, end - first))
+					{
+						ESP_LOGW("SetValue", "WARNING! \"%s\" Value Rejected: \"%.*s\".", m_Name.c_str(), (int)(end - first), first );
+						return 0;
+					}
+					if(!StringEncoderDecoder<T>::DecodeFromChars(first, end, values[count]))
+					{
+						ESP_LOGW("SetValue", "WARNING! \"%s\" Value Not Decoded: \"%.*s\".", m_Name.c_str(), (int)(end - first), first );
+						return 0;
+					}
+				}
+				++count;
+				if(end == last) break;
+				first = end;
 			}
-			String parsedString = stringValue.substring(start);
-			ESP_LOGD("SetValueFromString", "Parsed String: \"%s\"", parsedString.c_str());
-			substrings.push_back(parsedString);
 
 			// Check if the number of substrings matches the expected COUNT
-			if (substrings.size() != COUNT) 
+			if (count != COUNT) 
 			{
 				ESP_LOGE( "SetValueFromString",
-						  "Expected %zu substrings but got %zu in string: \"%s\".",
-						  COUNT, substrings.size(), stringValue.c_str());
+						  "Expected %zu substrings but got %zu in string: \"%.*s\".",
+						  COUNT, count, (int)length, string);
 				return 0;
 			}
-
-			// Decode each substring and store it in the value array
-			ESP_LOGD("ParseStringValueIntoValues", "\"%s\" Parsed %i Strings.", m_Name.c_str(), substrings.size() );
-			for (size_t i = 0; i < substrings.size(); ++i) 
-			{
-				if(false == m_ValidValueChecker.IsValidStringValue(substrings[i]))
-				{
-					ESP_LOGW("SetValue", "WARNING! \"%s\" Value Rejected: \"%s\".", m_Name.c_str(), substrings[i].c_str() );
-					return 0;
-				}
-				values[i] = StringEncoderDecoder<T>::DecodeFromString(substrings[i]);
-			}
-			return substrings.size();
+			ESP_LOGD("ParseStringValueIntoValues", "\"%s\" Parsed %zu Strings.", m_Name.c_str(), count );
+			return count;
 		}
 
 		virtual UpdateStatus_t SetValueFromString(const String& stringValue)
@@ -421,7 +380,6 @@ class LocalDataItem: public DataItemInterface<T, COUNT>
 		virtual UpdateStatus_t SetValue(const T& value)
 		{
 			assert(COUNT == 1);
-			assert(mp_Value != nullptr);	
 			return SetValue(&value, 1);
 		}
 
@@ -430,39 +388,58 @@ class LocalDataItem: public DataItemInterface<T, COUNT>
 			std::lock_guard<std::recursive_mutex> lock(m_ValueMutex);
 			if(COUNT == count)
 			{
-				return (memcmp(mp_Value, values, sizeof(T)*count) == 0);
+				return (memcmp(m_Value.data(), values, sizeof(T)*count) == 0);
 			}
 			return false;
 		}
 
 		virtual String ConvertValueToString(const T *pvalue, size_t count) const
 		{
-			std::vector<String> valueStrings;
-			if(pvalue && count > 0)
+			String stringValue = "";
+			char encoded[STRING_ENCODER_NUMBER_LENGTH];
+			for (size_t i = 0; pvalue && i < count; ++i)
 			{
-				for (size_t i = 0; i < count; ++i)
+				if(i > 0) stringValue += ENCODE_OBJECT_DIVIDER;
+				if(StringEncoderDecoder<T>::EncodeToChars(pvalue[i], encoded, encoded + sizeof(encoded)))
+				{
+					stringValue += encoded;
+				}
+				else
 				{
-					String encodedString = StringEncoderDecoder<T>::EncodeToString(pvalue[i]);
-					ESP_LOGD("ConvertValueToString", "Encoded String \"%s\"", encodedString.c_str());
-					valueStrings.push_back(encodedString);
+					stringValue += StringEncoderDecoder<T>::EncodeToString(pvalue[i]);
 				}
 			}
-			String stringValue = "";
-			for (size_t i = 0; i < count - 1; ++i)
+			return stringValue;
+		}
+
+		//Writes the values into [first, last) as ConvertValueToString formats them, followed by a terminator. Returns a
+		//pointer to the terminator, or nullptr if they do not fit.
+		char* ConvertValueToChars(const T *pvalue, size_t count, char* first, char* last) const
+		{
+			if(first >= last) return nullptr;
+			const size_t dividerLength = strlen(ENCODE_OBJECT_DIVIDER);
+			char* end = first;
+			*end = '\0';
+			for (size_t i = 0; end && i < count; ++i)
 			{
-				stringValue += valueStrings[i];
-				stringValue += ENCODE_OBJECT_DIVIDER;
+				if(i > 0)
+				{
+					if(static_cast<size_t>(last - end) <= dividerLength) return nullptr;
+					memcpy(end, ENCODE_OBJECT_DIVIDER, dividerLength);
+					end += dividerLength;
+				}
+				end = StringEncoderDecoder<T>::EncodeToChars(pvalue[i], end, last);
 			}
-			stringValue += valueStrings[COUNT - 1];
-			return stringValue;
+			return end;
 		}
 
 	protected:
 		ValidValueChecker m_ValidValueChecker;
 		std::string m_Name;
 		const T* const mp_InitialValuePtr;
-		T *mp_Value = nullptr;
-		T *mp_InitialValue = nullptr;
+		std::array<T, COUNT> m_Value = {};
+		std::array<T, COUNT> m_InitialValue = {};
+		ValueStore<T, COUNT> m_PublishedValue;    //Copy of m_Value for the lock free getters, stored under m_ValueMutex
 		NamedCallback_t *mp_NamedCallback = nullptr;
 		
 		bool UpdateChangeCount(const size_t newChangeCount, const bool incrementChangeCount)
@@ -492,7 +469,6 @@ class LocalDataItem: public DataItemInterface<T, COUNT>
 		{
 			std::lock_guard<std::recursive_mutex> lock(m_ValueMutex);
 			assert(newValues != nullptr);
-			assert(mp_Value != nullptr);
 			assert(COUNT > 0);
 			ESP_LOGD( "UpdateStore"
 					, "Name: \"%s\" Update Store with value: \"%s\" Change Count: \"%i\" New Change Count: \"%i\""
@@ -501,20 +477,21 @@ class LocalDataItem: public DataItemInterface<T, COUNT>
 					, m_ChangeCount
 					, newChangeCount );
 			UpdateStatus_t updateStatus;
-			updateStatus.ValueChanged = (0 != memcmp(mp_Value, newValues, sizeof(T)*COUNT));
+			updateStatus.ValueChanged = (0 != memcmp(m_Value.data(), newValues, sizeof(T)*COUNT));
 			updateStatus.ValidValue = ConfirmValueValidity(newValues, COUNT);
 			updateStatus.UpdateAllowed = updateStatus.ValueChanged && updateStatus.ValidValue;
 			updateStatus.UpdateSuccessful = UpdateChangeCount(newChangeCount, updateStatus.UpdateAllowed);
-			ESP_LOGD( "UpdateStore", "\"%s\": UpdateAllowed: \"%i\" Store Updated: \"%i\"", GetName().c_str(), updateAllowed, storeUpdated);
+			ESP_LOGD( "UpdateStore", "\"%s\": UpdateAllowed: \"%i\" Store Updated: \"%i\"", GetName().c_str(), updateStatus.UpdateAllowed, updateStatus.UpdateSuccessful);
 			if(updateStatus.UpdateSuccessful)
 			{
-				ZeroOutMemory(mp_Value);
-				memcpy(mp_Value, newValues, sizeof(T) * COUNT);
-				updateStatus.UpdateSuccessful = ( memcmp(mp_Value, newValues, sizeof(T) * COUNT) == 0);
+				ZeroOutMemory(m_Value.data());
+				memcpy(m_Value.data(), newValues, sizeof(T) * COUNT);
+				updateStatus.UpdateSuccessful = ( memcmp(m_Value.data(), newValues, sizeof(T) * COUNT) == 0);
 				if(updateStatus.UpdateSuccessful)
 				{
+					m_PublishedValue.Store(m_Value.data());
 					ESP_LOGD( "UpdateStore", "\"%s\": Update Store: Successful. Value: \"%s\" Change Count: \"%i\"", GetName().c_str(), GetValueAsString().c_str(), m_ChangeCount);
-					this->CallNamedCallbacks(mp_Value);
+					this->CallNamedCallbacks(m_Value.data());
 				}
 				else
 				{
@@ -530,12 +507,27 @@ class LocalDataItem: public DataItemInterface<T, COUNT>
 
 		virtual bool ConfirmValueValidity(const T* values, size_t count) const
 		{
-			for(int i = 0; i < count; ++i)
+			//Most items accept any value, so there is nothing to encode
+			if(!this->m_ValidValueChecker.IsConfigured()) return true;
+			char encoded[STRING_ENCODER_NUMBER_LENGTH];
+			for(size_t i = 0; i < count; ++i)
 			{
-				String stringValue = StringEncoderDecoder<T>::EncodeToString(values[i]);
-				if(false == this->m_ValidValueChecker.IsValidStringValue(stringValue))
+				const char* value = encoded;
+				size_t length;
+				String stringValue;
+				if(const char* end = StringEncoderDecoder<T>::EncodeToChars(values[i], encoded, encoded + sizeof(encoded)))
+				{
+					length = end - encoded;
+				}
+				else
+				{
+					stringValue = StringEncoderDecoder<T>::EncodeToString(values[i]);
+					value = stringValue.c_str();
+					length = stringValue.length();
+				}
+				if(false == this->m_ValidValueChecker.IsValidStringValue(value, length))
 				{
-					ESP_LOGW("SetValue", "WARNING! \"%s\" Value Rejected: \"%s\".", this->GetName().c_str(), stringValue.c_str() );
+					ESP_LOGW("SetValue", "WARNING! \"%s\" Value Rejected: \"%s\".", this->GetName().c_str(), value );
 					return false;
 				}
 			}
@@ -51,17 +51,9 @@ class LocalStringDataItem: public LocalDataItem<char, DATAITEM_STRING_LENGTH>
 		virtual bool GetInitialValueAsString(String &stringValue) const override
 		{
 			std::lock_guard<std::recursive_mutex> lock(this->m_ValueMutex);
-			if(mp_InitialValue)
-			{
-				stringValue = String(mp_InitialValue);
-				ESP_LOGD("GetInitialValueAsString", "\"%s\": GetInitialValueAsString: \"%s\"", m_Name.c_str(), stringValue.c_str());
-				return true;
-			}
-			else
-			{
-				ESP_LOGE("GetValueAsString", "ERROR! \"%s\": NULL Pointer.", m_Name.c_str());
-				return false;
-			}
+			stringValue = String(m_InitialValue.data());
+			ESP_LOGD("GetInitialValueAsString", "\"%s\": GetInitialValueAsString: \"%s\"", m_Name.c_str(), stringValue.c_str());
+			return true;
 		}
 
 		virtual String GetInitialValueAsString() const
@@ -78,19 +70,12 @@ class LocalStringDataItem: public LocalDataItem<char, DATAITEM_STRING_LENGTH>
 		virtual bool GetValueAsString(String &stringValue) const override
 		{
 			std::lock_guard<std::recursive_mutex> lock(this->m_ValueMutex);
-			if(mp_Value)
-			{
-				stringValue = String(mp_Value);
-				ESP_LOGD("GetValueAsString"
-						, "\"%s\": GetValueAsString: %s"
-						, m_Name.c_str()
-						, stringValue.c_str());
-				return true;
-			}
-			else
-			{
-				return false;
-			}
+			stringValue = String(m_Value.data());
+			ESP_LOGD("GetValueAsString"
+					, "\"%s\": GetValueAsString: %s"
+					, m_Name.c_str()
+					, stringValue.c_str());
+			return true;
 		}
 
 		virtual String GetValueAsString() const override
@@ -116,25 +101,25 @@ class LocalStringDataItem: public LocalDataItem<char, DATAITEM_STRING_LENGTH>
 		{
 			std::lock_guard<std::recursive_mutex> lock(this->m_ValueMutex);
 			assert(value != nullptr);
-			assert(mp_Value != nullptr);
 			assert(count <= DATAITEM_STRING_LENGTH);
 
 			std::string newValue(value, count);
 			ESP_LOGD("DataItem: SetValue", "\"%s\" Set Value: \"%s\"", m_Name.c_str(), newValue.c_str());
 			
 			UpdateStatus_t updateStatus;
-			updateStatus.ValueChanged = (strncmp(mp_Value, value, count) != 0);
+			updateStatus.ValueChanged = (strncmp(m_Value.data(), value, count) != 0);
 			updateStatus.ValidValue = ConfirmValueValidity(value, count);
 			updateStatus.UpdateAllowed = UpdateChangeCount(GetChangeCount(), (updateStatus.ValueChanged && updateStatus.ValidValue));
 			if (updateStatus.UpdateAllowed)
 			{   
-				ZeroOutMemory(mp_Value);
-				strncpy(mp_Value, value, count);
-				updateStatus.UpdateSuccessful = (strncmp(mp_Value, value, count) == 0);
+				ZeroOutMemory(m_Value.data());
+				strncpy(m_Value.data(), value, count);
+				updateStatus.UpdateSuccessful = (strncmp(m_Value.data(), value, count) == 0);
 				if(updateStatus.UpdateSuccessful)
 				{
+					m_PublishedValue.Store(m_Value.data());
 					ESP_LOGI("LocalDataItem: SetValue", "\"%s\": Set Value to \"%s\".", GetName().c_str(), newValue.c_str());
-					this->CallNamedCallbacks(mp_Value);
+					this->CallNamedCallbacks(m_Value.data());
 				}
 				else
 				{
@@ -18,6 +18,7 @@
 
 #pragma once
 #include "SerialMessageManager.h"
+#include <array>
 #include <iostream>
 #include <sstream>
 
@@ -62,19 +63,10 @@ class SerialMessageInterface: public Rx_Value_Caller_Interface<T>
 			if(mp_SerialPortMessageManager)
 			{
 				mp_SerialPortMessageManager->DeRegisterForNewRxValueNotification(this);
-			}
-			if(mp_RxValue)
-			{
-        		ESP_LOGD("~SerialMessageInterface", "freeing mp_RxValue Memory");
-				free(mp_RxValue);
-			}
-			if(mp_TxValue)
-			{
-        		ESP_LOGD("~SerialMessageInterface", "freeing mp_TxValue Memory");
-				free(mp_TxValue);	
+				EnableTxItem(false);
 			}
 		}
-		virtual T* GetValuePointer() const = 0;
+		virtual const T* GetValuePointer() const = 0;
 		virtual UpdateStatus_t UpdateStore(const T *newValues, const size_t changeCount) = 0;
 		virtual bool EqualsValue(T *Object, size_t Count) const = 0;
 		virtual String GetName() const = 0;
@@ -100,7 +92,7 @@ class SerialMessageInterface: public Rx_Value_Caller_Interface<T>
 						, "Rx Echo for: \"%s\" with Value: \"%s\""
 						, GetName().c_str()
 						, ConvertValueToString(receivedValues, GetCount()).c_str() );
-				if(UpdateTxStore(mp_RxValue).UpdateSuccessful)
+				if(UpdateTxStore(m_RxValue.data()).UpdateSuccessful)
 				{
 					storeUpdated |= Tx_Now(GetChangeCount());
 				}
@@ -112,8 +104,38 @@ class SerialMessageInterface: public Rx_Value_Caller_Interface<T>
 			m_RxTxType = rxTxType;
 			m_Rate = rate;
 		}
+		//How TX values are handled when the link falls behind. Defaults to LinkQoS_LatestValue.
+		void SetTxQoS(LinkQoS_t qos)
+		{
+			m_TxItem.QoS = qos;
+		}
+		//Lane the TX values use. Defaults to LinkTxLane_Bulk, LinkTxLane_RealTime is for data that is stale within a frame.
+		void SetTxLane(LinkTxLane_t lane)
+		{
+			m_TxItem.Lane = lane;
+		}
+		//Sends the values quantized, and delta coded when little changed, with LinkCodec_Quantized8/16. Float arrays only.
+		void SetTxCodec(LinkCodec_t codec)
+		{
+			LinkFloatEncoder* encoder = m_LinkCodec.GetEncoder();
+			if(nullptr == encoder)
+			{
+				if(LinkCodec_None != codec) ESP_LOGE("SetTxCodec", "ERROR! \"%s\": Link Codec Not Supported.", GetName().c_str());
+				return;
+			}
+			encoder->SetCodec(codec);
+			m_TxItem.Encoder = (LinkCodec_None == codec) ? nullptr : encoder;
+		}
+		const LinkTxItem_t& GetTxItem() const
+		{
+			return m_TxItem;
+		}
 
 		//Named_Object_Callee_Interface
+		virtual LinkFloatDecoder* GetLinkDecoder() override
+		{
+			return m_LinkCodec.GetDecoder();
+		}
 		virtual UpdateStatus_t New_Object_From_Sender(const Named_Object_Caller_Interface* sender, const void* values, const size_t changeCount) override
 		{
 			UpdateStatus_t storeUpdated;
@@ -126,8 +148,8 @@ class SerialMessageInterface: public Rx_Value_Caller_Interface<T>
 					, GetChangeCount());
 			if(UpdateRxStore(receivedValues).UpdateSuccessful)
 			{
-				storeUpdated |= UpdateStore(mp_RxValue, changeCount);
-				this->Notify_NewRxValue_Callees(mp_RxValue, COUNT, changeCount);
+				storeUpdated |= UpdateStore(m_RxValue.data(), changeCount);
+				this->Notify_NewRxValue_Callees(m_RxValue.data(), COUNT, changeCount);
 			}
 			storeUpdated |= Try_Echo_Value(receivedValues);
 			return storeUpdated;
@@ -135,21 +157,12 @@ class SerialMessageInterface: public Rx_Value_Caller_Interface<T>
 
 		void Setup()
 		{
-			if(!mp_RxValue) mp_RxValue = (T*)malloc(sizeof(T)*COUNT);
-			if(!mp_TxValue) mp_TxValue = (T*)malloc(sizeof(T)*COUNT);
 			if(GetValuePointer())
 			{
-				if (mp_RxValue && mp_TxValue)
-				{
-					ESP_LOGD("DataItem<T, COUNT>::Setup()", "Setting Initial Tx/Rx Values to: %s", GetValueAsString().c_str());
-					UpdateRxStore(GetValuePointer());
-					UpdateTxStore(GetValuePointer());
-					SetDataLinkEnabled(true);
-				}
-				else
-				{
-					ESP_LOGE("DataItem<T, COUNT>::Setup()", "ERROR! Failed to allocate memory on SPI RAM.");
-				}
+				ESP_LOGD("DataItem<T, COUNT>::Setup()", "Setting Initial Tx/Rx Values to: %s", GetValueAsString().c_str());
+				UpdateRxStore(GetValuePointer());
+				UpdateTxStore(GetValuePointer());
+				SetDataLinkEnabled(true);
 			}
 			else
 			{
@@ -164,17 +177,16 @@ class SerialMessageInterface: public Rx_Value_Caller_Interface<T>
 					, GetName().c_str()
 					, ConvertValueToString(newTxValues, count).c_str());
 			assert(newTxValues != nullptr);
-			assert(mp_TxValue != nullptr);
 			assert(COUNT > 0);
 			assert(count <= COUNT);
 			UpdateStatus_t updateStatus;
-			updateStatus.ValueChanged = (0 != memcmp(mp_TxValue, newTxValues, sizeof(T)*count));
+			updateStatus.ValueChanged = (0 != memcmp(m_TxValue.data(), newTxValues, sizeof(T)*count));
 			updateStatus.ValidValue = ConfirmValueValidity(newTxValues, COUNT);
 			updateStatus.UpdateAllowed = (updateStatus.ValueChanged && updateStatus.ValidValue);
 			ESP_LOGD( "Set_Tx_Value", "\"%s\": UpdateAllowed: \"%i\" Current Value: \"%s\" New Value: \"%s\""
 					, GetName().c_str()
 					, updateStatus.UpdateAllowed
-					, ConvertValueToString(mp_TxValue, count).c_str()
+					, ConvertValueToString(m_TxValue.data(), count).c_str()
 					, ConvertValueToString(newTxValues, count).c_str() );
 			if(updateStatus.UpdateAllowed)
 			{
@@ -193,22 +205,21 @@ class SerialMessageInterface: public Rx_Value_Caller_Interface<T>
 		UpdateStatus_t UpdateRxStore(const T *newValues)
 		{
 			assert(newValues != nullptr);
-			assert(mp_RxValue != nullptr);
 			assert(COUNT > 0);
 			ESP_LOGD( "UpdateRxStore"
 					, "Name: \"%s\" Update Rx Store with value: \"%s\""
 					, GetName().c_str()
 					, ConvertValueToString(newValues, COUNT).c_str());
 			UpdateStatus_t updateStatus;
-			updateStatus.ValueChanged= (0 != memcmp(mp_RxValue, newValues, sizeof(T)*COUNT));
+			updateStatus.ValueChanged= (0 != memcmp(m_RxValue.data(), newValues, sizeof(T)*COUNT));
 			updateStatus.ValidValue = ConfirmValueValidity(newValues, COUNT);
 			updateStatus.UpdateAllowed = updateStatus.ValueChanged && updateStatus.ValidValue;
-			ESP_LOGD( "UpdateRxStore", "\"%s\": UpdateAllowed: \"%i\"", GetName().c_str(), storeUpdated);
+			ESP_LOGD( "UpdateRxStore", "\"%s\": UpdateAllowed: \"%i\"", GetName().c_str(), updateStatus.UpdateAllowed);
 			if(updateStatus.UpdateAllowed)
 			{
-				ZeroOutMemory(mp_RxValue);
-				memcpy(mp_RxValue, newValues, sizeof(T) * COUNT);
-				updateStatus.UpdateSuccessful = ( memcmp(mp_RxValue, newValues, sizeof(T) * COUNT) == 0 );
+				ZeroOutMemory(m_RxValue.data());
+				memcpy(m_RxValue.data(), newValues, sizeof(T) * COUNT);
+				updateStatus.UpdateSuccessful = ( memcmp(m_RxValue.data(), newValues, sizeof(T) * COUNT) == 0 );
 				if(updateStatus.UpdateSuccessful)
 				{
 					ESP_LOGD( "UpdateRxStore", "\"%s\": Update Rx Store: Successful.", GetName().c_str());
@@ -228,21 +239,20 @@ class SerialMessageInterface: public Rx_Value_Caller_Interface<T>
 		UpdateStatus_t UpdateTxStore(const T *newValues)
 		{
 			assert(newValues != nullptr);
-			assert(mp_TxValue != nullptr);
 			assert(COUNT > 0);
 			ESP_LOGD( "UpdateTxStore"
 					, "Name: \"%s\" Update Tx Store with value: \"%s\""
 					, GetName().c_str()
 					, ConvertValueToString(newValues, COUNT).c_str());
 			UpdateStatus_t updateStatus;
-			updateStatus.ValueChanged = (0 != memcmp(mp_TxValue, newValues, sizeof(T)*COUNT));
+			updateStatus.ValueChanged = (0 != memcmp(m_TxValue.data(), newValues, sizeof(T)*COUNT));
 			updateStatus.ValidValue = ConfirmValueValidity(newValues, COUNT);
 			updateStatus.UpdateAllowed = updateStatus.ValueChanged && updateStatus.ValidValue;
 			if(updateStatus.UpdateAllowed)
 			{
-				ZeroOutMemory(mp_TxValue);
-				memcpy(mp_TxValue, newValues, sizeof(T) * COUNT);
-				updateStatus.UpdateSuccessful = (memcmp(mp_TxValue, newValues, sizeof(T) * COUNT) == 0);
+				ZeroOutMemory(m_TxValue.data());
+				memcpy(m_TxValue.data(), newValues, sizeof(T) * COUNT);
+				updateStatus.UpdateSuccessful = (memcmp(m_TxValue.data(), newValues, sizeof(T) * COUNT) == 0);
 				if(updateStatus.UpdateSuccessful)
 				{
 					ESP_LOGD( "UpdateTxStore", "\"%s\": Update Tx Store: Successful.", GetName().c_str());
@@ -264,14 +274,14 @@ class SerialMessageInterface: public Rx_Value_Caller_Interface<T>
 			ESP_LOGD( "Tx_Now", "\"%s\" Tx: \"%s\" Value: \"%s\" Change Count: \"%i\""
 					, mp_SerialPortMessageManager->GetName().c_str()
 					, GetName().c_str()
-					, ConvertValueToString(mp_TxValue, COUNT)
+					, ConvertValueToString(m_TxValue.data(), COUNT)
 					, GetChangeCount() );
 			UpdateStatus_t updateStatus;
 			if(mp_SerialPortMessageManager)
 			{
-				updateStatus |= UpdateStore(mp_TxValue, changeCount);
+				updateStatus |= UpdateStore(m_TxValue.data(), changeCount);
 				ESP_LOGD( "Tx_Now", "\"%s\": Tx Message Change Count \"%i\"", GetName().c_str(), GetChangeCount());
-				if(!mp_SerialPortMessageManager->QueueMessageFromDataType(GetName(), GetDataType(), mp_TxValue, GetCount(), GetChangeCount()))
+				if(!mp_SerialPortMessageManager->QueueMessageFromDataType(GetName(), GetDataType(), m_TxValue.data(), GetCount(), GetChangeCount()))
 				{
 					ESP_LOGE("Tx_Now", "ERROR! Data Item: \"%s\": Unable to Tx Message.", GetName().c_str());
 				}
@@ -287,11 +297,14 @@ class SerialMessageInterface: public Rx_Value_Caller_Interface<T>
 		RxTxType_t m_RxTxType;
 		uint16_t m_Rate;
 		SerialPortMessageManager *mp_SerialPortMessageManager = nullptr;
-		T *mp_RxValue = nullptr;
-		T *mp_TxValue = nullptr;
+		std::array<T, COUNT> m_RxValue = {};
+		std::array<T, COUNT> m_TxValue = {};
 	private:
 		esp_timer_handle_t m_TxTimer = nullptr;
 		esp_timer_create_args_t m_TxTimerArgs;
+		LinkTxItem_t m_TxItem;
+		bool m_TxItemRegistered = false;
+		LinkItemCodec<T, COUNT> m_LinkCodec;
 		
 		void SetDataLinkEnabled(bool enable)
 		{
@@ -302,6 +315,7 @@ class SerialMessageInterface: public Rx_Value_Caller_Interface<T>
 					ESP_LOGD( "SetDataLinkEnabled", "\"%s\" Set Datalink Enabled for: \"%s\""
 							, mp_SerialPortMessageManager->GetName().c_str()
 							, GetName().c_str() );
+					EnableTxItem(true);
 					bool enablePeriodicTx = false;
 					bool enableRx = true;
 					switch(m_RxTxType)
@@ -330,6 +344,7 @@ class SerialMessageInterface: public Rx_Value_Caller_Interface<T>
 							, GetName().c_str() );
 					EnableRx(false);
 					EnablePeriodicTx(false);
+					EnableTxItem(false);
 				}
 				m_DataLinkEnabled = enable;
 			}
@@ -397,6 +412,25 @@ class SerialMessageInterface: public Rx_Value_Caller_Interface<T>
 			}
 		}
 
+		//Called with a valid mp_SerialPortMessageManager
+		void EnableTxItem(bool enable)
+		{
+			if(enable && !m_TxItemRegistered)
+			{
+				//The receiver may have missed anything sent before, start again from a key frame
+				if(m_TxItem.Encoder) m_TxItem.Encoder->Reset();
+				m_TxItem.DataType = GetDataType();
+				m_TxItem.Count = COUNT;
+				mp_SerialPortMessageManager->RegisterTxItem(GetItemId(), &m_TxItem);
+				m_TxItemRegistered = true;
+			}
+			else if(!enable && m_TxItemRegistered)
+			{
+				mp_SerialPortMessageManager->DeRegisterTxItem(GetItemId());
+				m_TxItemRegistered = false;
+			}
+		}
+
 		void EnableRx(bool enableRX)
 		{
 			if(enableRX)
@@ -70,7 +70,7 @@ class StringDataItem: public LocalStringDataItem
 		}
 
 		//SerialMessageInterface
-		virtual char* GetValuePointer() const override
+		virtual const char* GetValuePointer() const override
 		{
 			return LocalStringDataItem::GetValuePointer();
 		}
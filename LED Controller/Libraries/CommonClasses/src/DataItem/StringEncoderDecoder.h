@@ -1,3 +1,16 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <type_traits>
+
+#define STRING_ENCODER_NUMBER_LENGTH 32    //Longest encoded number, with its terminator
+
 template <typename T>
 class StringEncoderDecoder
 {
@@ -7,24 +20,119 @@ class StringEncoderDecoder
 
         T DecodeFromString(String str) const
         {
-            std::string stdStr = str.c_str();
-            std::istringstream iss(stdStr);
-            T value;
-            iss >> value;
+            T value = T();
+            DecodeFromChars(str.c_str(), str.c_str() + str.length(), value);
             return value;
         }
-        
+
         String EncodeToString(T value) const
         {
-            std::ostringstream oss;
-            oss << value;
+            if constexpr (std::is_arithmetic<T>::value)
+            {
+                char buffer[STRING_ENCODER_NUMBER_LENGTH];
+                return EncodeToChars(value, buffer, buffer + sizeof(buffer)) ? String(buffer) : String();
+            }
+            else
+            {
+                std::ostringstream oss;
+                oss << value;
 
-            if (oss.fail())
+                if (oss.fail())
+                {
+                    ESP_LOGE("EncodeToString", "Failed to encode value to string");
+                    return String();
+                }
+
+                return String(oss.str().c_str());
+            }
+        }
+
+        //Reads a value from the characters in [first, last), which need not be terminated. Numbers are converted in
+        //place, skipping leading whitespace as the stream operators do, and other types go through their stream
+        //operator. Returns false, with value reset, if no value could be read.
+        bool DecodeFromChars(const char* first, const char* last, T &value) const
+        {
+            bool decoded = false;
+            if constexpr (std::is_arithmetic<T>::value)
             {
-                ESP_LOGE("EncodeToString", "Failed to encode value to string");
-                return String();
+                while(first < last && isspace(static_cast<unsigned char>(*first))) ++first;
+                if constexpr (IS_CHARACTER)
+                {
+                    decoded = (first < last);
+                    if(decoded) value = static_cast<T>(*first);
+                }
+                else if constexpr (std::is_floating_point<T>::value)
+                {
+                    //strtof needs a terminator, which a token inside a longer string does not have
+                    char number[STRING_ENCODER_NUMBER_LENGTH];
+                    const size_t length = std::min<size_t>(last - first, sizeof(number) - 1);
+                    memcpy(number, first, length);
+                    number[length] = '\0';
+                    char* end;
+                    const T parsed = std::is_same<T, float>::value ? strtof(number, &end) : strtod(number, &end);
+                    decoded = (end != number);
+                    if(decoded) value = parsed;
+                }
+                else
+                {
+                    if(first < last && '+' == *first) ++first;
+                    typename std::conditional<std::is_same<T, bool>::value, int, T>::type parsed;
+                    decoded = (std::errc() == std::from_chars(first, last, parsed).ec);
+                    if(decoded) value = static_cast<T>(parsed);
+                }
             }
+            else
+            {
+                std::istringstream iss(std::string(first, last));
+                iss >> value;
+                decoded = !iss.fail();
+            }
+            if(!decoded) value = T();
+            return decoded;
+        }
 
-            return String(oss.str().c_str());
+        //Writes the value into [first, last) followed by a terminator, in the format of its stream operator. Returns a
+        //pointer to the terminator, or nullptr if it does not fit. Numbers are converted without allocating.
+        char* EncodeToChars(const T &value, char* first, char* last) const
+        {
+            if(first >= last) return nullptr;
+            char* end = nullptr;
+            if constexpr (IS_CHARACTER || std::is_same<T, bool>::value)
+            {
+                if(last - first >= 2)
+                {
+                    first[0] = IS_CHARACTER ? static_cast<char>(value) : (value ? '1' : '0');
+                    first[1] = '\0';
+                    end = first + 1;
+                }
+            }
+            else if constexpr (std::is_floating_point<T>::value)
+            {
+                //The streams print 6 significant digits, as %g does
+                const int length = snprintf(first, last - first, "%g", static_cast<double>(value));
+                if(length >= 0 && length < last - first) end = first + length;
+            }
+            else if constexpr (std::is_integral<T>::value)
+            {
+                const std::to_chars_result result = std::to_chars(first, last - 1, value);
+                if(std::errc() == result.ec)
+                {
+                    end = result.ptr;
+                    *end = '\0';
+                }
+            }
+            else
+            {
+                const String encoded = EncodeToString(value);
+                if(encoded.length() < static_cast<size_t>(last - first))
+                {
+                    memcpy(first, encoded.c_str(), encoded.length() + 1);
+                    end = first + encoded.length();
+                }
+            }
+            return end;
         }
-};
\ No newline at end of file
+
+    private:
+        static constexpr bool IS_CHARACTER = std::is_same<T, char>::value || std::is_same<T, signed char>::value || std::is_same<T, unsigned char>::value;
+};
@@ -21,6 +21,8 @@
 #include "Helpers.h"
 #include "Streaming.h"
 #include "DataTypes.h"
+#include "LinkFrame.h"
+#include "LinkFloatCodec.h"
 
 class DataSerializer: public CommonUtils
 					, public DataTypeFunctions
@@ -64,6 +66,90 @@ class DataSerializer: public CommonUtils
 			m_SerializeDoc[m_CheckSumTag] = CheckSum;
 			return JSON.stringify(m_SerializeDoc);
 		}
+		//Encodes a DataItem as a binary link frame. Returns the encoded length including the delimiter, 0 on failure.
+		virtual size_t SerializeDataItemToFrame(const String& Name, DataType_t DataType, const void* Object, size_t Count, size_t ChangeCount, uint8_t Sequence, uint8_t* Buffer, size_t BufferSize)
+		{
+			if(DataType >= DataType_Undef || Count > UINT16_MAX)
+			{
+				ESP_LOGE("SerializeDataItemToFrame", "ERROR! \"%s\": Invalid Data Type or Count.", Name.c_str());
+				return 0;
+			}
+			LinkFrameHeader_t Header;
+			Header.ItemId = GetLinkItemId(Name.c_str());
+			Header.DataType = DataType;
+			Header.Sequence = Sequence;
+			Header.Count = Count;
+			Header.ChangeCount = ChangeCount;
+			size_t Length = EncodeLinkFrame(Header, Object, GetSizeOfDataType(DataType) * Count, Buffer, BufferSize);
+			if(0 == Length)
+			{
+				ESP_LOGE("SerializeDataItemToFrame", "ERROR! \"%s\": Frame exceeds %i bytes.", Name.c_str(), BufferSize);
+			}
+			return Length;
+		}
+		//Decodes a received frame in place. On success View.Payload points into Frame.
+		virtual bool DeSerializeFrame(uint8_t* Frame, size_t Length, LinkFrameView_t &View)
+		{
+			if(!DecodeLinkFrame(Frame, Length, View))
+			{
+				++m_FailCount;
+				ESP_LOGW("DeSerializeFrame", "WARNING! Deserialize failed: \"Frame Error\"");
+				FailPercentage();
+				return false;
+			}
+			return ValidateFrame(View);
+		}
+		//Checks a frame that already passed its CRC against the data type table. Encoded frames carry float arrays.
+		virtual bool ValidateFrame(const LinkFrameView_t &View)
+		{
+			bool valid;
+			if(View.Header.DataType & LINK_DATATYPE_FLAG_ENCODED)
+			{
+				valid = (DataType_Float_t == (View.Header.DataType & ~LINK_DATATYPE_FLAG_ENCODED)) &&
+						(View.Header.Count <= LINK_CODEC_MAX_COUNT) &&
+						(View.PayloadLength == GetLinkCodecPayloadLength(View.Payload, View.PayloadLength));
+			}
+			else
+			{
+				valid = (View.Header.DataType < DataType_Undef) &&
+						(View.PayloadLength == GetSizeOfDataType(static_cast<DataType_t>(View.Header.DataType)) * View.Header.Count);
+			}
+			if(!valid)
+			{
+				++m_FailCount;
+				ESP_LOGW("ValidateFrame", "WARNING! Deserialize failed: Byte Count Error.");
+			}
+			FailPercentage();
+			return valid;
+		}
+		//Walks the records of a batch frame. Offset starts at 0 and is advanced past each record.
+		//Returns false at the end of the batch or at a record that does not fit, so a bad batch is never read past its end.
+		virtual bool GetNextBatchRecord(const LinkFrameView_t &Batch, size_t &Offset, LinkFrameView_t &Record)
+		{
+			if(Offset + sizeof(LinkBatchRecordHeader_t) > Batch.PayloadLength) return false;
+			LinkBatchRecordHeader_t RecordHeader;
+			memcpy(&RecordHeader, Batch.Payload + Offset, sizeof(RecordHeader));
+			const uint8_t DataType = RecordHeader.DataType & ~LINK_DATATYPE_FLAG_ENCODED;
+			if(DataType >= DataType_Undef) return false;
+			const size_t DataOffset = Offset + sizeof(RecordHeader);
+			size_t Length = GetSizeOfDataType(static_cast<DataType_t>(DataType)) * RecordHeader.Count;
+			if(RecordHeader.DataType & LINK_DATATYPE_FLAG_ENCODED)
+			{
+				Length = GetLinkCodecPayloadLength(Batch.Payload + DataOffset, Batch.PayloadLength - DataOffset);
+				if(0 == Length) return false;
+			}
+			if(DataOffset + Length > Batch.PayloadLength) return false;
+			Record.Header.ItemId = RecordHeader.ItemId;
+			Record.Header.DataType = RecordHeader.DataType;
+			Record.Header.Sequence = Batch.Header.Sequence;
+			Record.Header.Count = RecordHeader.Count;
+			Record.Header.Flags = 0;
+			Record.Header.ChangeCount = RecordHeader.ChangeCount;
+			Record.Payload = Batch.Payload + DataOffset;
+			Record.PayloadLength = Length;
+			Offset = DataOffset + LINK_BATCH_ALIGN(Length);
+			return true;
+		}
 		virtual bool DeSerializeJsonToNamedObject(String json, NamedObject_t &NamedObject)
 		{
 			ESP_LOGD("DeSerializeJsonToNamedObject", "JSON String: %s", json.c_str());
@@ -99,17 +185,17 @@ class DataSerializer: public CommonUtils
 					ESP_LOGD("DeSerializeJsonToNamedObject", "Actual Count: %i", ActualDataCount);
 					size_t ObjectByteCount = GetSizeOfDataType(DataType);
 					ESP_LOGD("DeSerializeJsonToNamedObject", "Actual Byte Count: %i", ObjectByteCount);
-					//This memory needs deleted by caller of function.
-					uint8_t *Buffer = (uint8_t*)malloc(sizeof(uint8_t)* ByteCountIn);								
 					if( ActualDataCount == CountIn && ByteCountIn == ActualDataCount * ObjectByteCount )
 					{
+						//This memory needs deleted by caller of function.
+						uint8_t *Buffer = (uint8_t*)malloc(sizeof(uint8_t)* ByteCountIn);
 						for(int j = 0; j < CountIn; ++j)
 						{
 							String BytesString = m_DeserializeDoc[m_DataTag][j];
 							for(int k = 0; k < ObjectByteCount; ++k)
 							{
 								size_t startIndex = 2*k;
-								char hexArray[2];
+								char hexArray[3];
 								strcpy(hexArray, BytesString.substring(startIndex,startIndex+2).c_str());
 								long decValue = strtol(String(hexArray).c_str(), NULL, 16);
 								CheckSumCalc += decValue;
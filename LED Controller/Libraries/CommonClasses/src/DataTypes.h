@@ -3,8 +3,12 @@
 #include <iostream>
 #include <string>
 #include <sstream>
+#include <vector>
 #include <type_traits>
+#include <algorithm>
 #include "Streaming.h"
+#include "BandLayout.h"
+#include "StageProfiler.h"
 
 #define BT_NAME_LENGTH 50
 #define BT_ADDRESS_LENGTH 18
@@ -907,6 +911,11 @@ enum DataType_t
   DataType_SoundInputSource_t,
   DataType_SoundOutputSource_t,
   DataType_Bluetooth_Discovery_Mode_t,
+  DataType_ToneTrigger_t,
+  DataType_SpectralPeak_t,
+  DataType_BandLayout_t,
+  DataType_StageProfile_t,
+  DataType_LinkHealth_t,
   DataType_Undef,
 };
 
@@ -936,6 +945,11 @@ static const char* DataTypeStrings[] =
   "SoundInputSource_t",
   "SoundOutputSource_t",
   "Bluetooth_Discovery_Mode_t",
+  "ToneTrigger_t",
+  "SpectralPeak_t",
+  "BandLayout_t",
+  "StageProfile_t",
+  "LinkHealth_t",
   "Undefined_t"
 };
 
@@ -1203,6 +1217,379 @@ struct MaxBandSoundData_t
 };
 
 
+struct ToneTrigger_t
+{
+	int16_t DetectorIndex = 0;
+	float Frequency = 0.0;
+	float Magnitude = 0.0;
+	uint32_t TriggerCount = 0;  //Increments on every trigger so repeated cues of the same tone are still sent as a change
+    ToneTrigger_t(){}
+    ToneTrigger_t(int16_t DetectorIndex_In, float Frequency_In, float Magnitude_In, uint32_t TriggerCount_In)
+    {
+        DetectorIndex = DetectorIndex_In;
+        Frequency = Frequency_In;
+        Magnitude = Magnitude_In;
+        TriggerCount = TriggerCount_In;
+    }
+    bool operator==(const ToneTrigger_t& other) const
+    {
+        return this->DetectorIndex == other.DetectorIndex && this->Frequency == other.Frequency && this->Magnitude == other.Magnitude && this->TriggerCount == other.TriggerCount;
+    }
+
+    bool operator!=(const ToneTrigger_t& other) const
+    {
+        return !(*this == other);
+    }
+
+    operator String() const
+    {
+        return toString();
+    }
+
+    String toString() const
+    {
+        return String(DetectorIndex) + ENCODE_VALUE_DIVIDER + String(Frequency) + ENCODE_VALUE_DIVIDER + String(Magnitude) + ENCODE_VALUE_DIVIDER + String(TriggerCount);
+    }
+
+    static ToneTrigger_t fromString(const std::string &str)
+    {
+        std::vector<std::string> values;
+        std::stringstream ss(str);
+        std::string value;
+        while (std::getline(ss, value, ENCODE_VALUE_DIVIDER[0]))
+        {
+            values.push_back(value);
+        }
+        if (values.size() != 4)
+        {
+            return ToneTrigger_t();
+        }
+        return ToneTrigger_t(std::stoi(values[0]), std::stof(values[1]), std::stof(values[2]), std::stoul(values[3]));
+    }
+
+    friend std::istream& operator>>(std::istream& is, ToneTrigger_t& trigger) {
+        std::string str;
+        std::getline(is, str);
+        trigger = ToneTrigger_t::fromString(str);
+        return is;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const ToneTrigger_t& trigger) {
+        os << trigger.toString().c_str();
+        return os;
+    }
+};
+
+
+struct SpectralPeak_t
+{
+	uint16_t Frequency = 0;  //Peak frequency in Hz
+	uint16_t Magnitude = 0;  //Normalized peak magnitude scaled to UINT16_MAX
+    SpectralPeak_t(){}
+    SpectralPeak_t(uint16_t Frequency_In, uint16_t Magnitude_In)
+    {
+        Frequency = Frequency_In;
+        Magnitude = Magnitude_In;
+    }
+    SpectralPeak_t(float Frequency_In, float Magnitude_In)
+    {
+        Frequency = (uint16_t)std::min(std::max(Frequency_In + 0.5f, 0.0f), (float)UINT16_MAX);
+        Magnitude = (uint16_t)std::min(std::max((Magnitude_In * UINT16_MAX) + 0.5f, 0.0f), (float)UINT16_MAX);
+    }
+    float GetFrequency() const { return (float)Frequency; }
+    float GetNormalizedMagnitude() const { return (float)Magnitude / UINT16_MAX; }
+    bool operator==(const SpectralPeak_t& other) const
+    {
+        return this->Frequency == other.Frequency && this->Magnitude == other.Magnitude;
+    }
+
+    bool operator!=(const SpectralPeak_t& other) const
+    {
+        return !(*this == other);
+    }
+
+    operator String() const
+    {
+        return toString();
+    }
+
+    String toString() const
+    {
+        return String(Frequency) + ENCODE_VALUE_DIVIDER + String(Magnitude);
+    }
+
+    static SpectralPeak_t fromString(const std::string &str)
+    {
+        std::vector<std::string> values;
+        std::stringstream ss(str);
+        std::string value;
+        while (std::getline(ss, value, ENCODE_VALUE_DIVIDER[0]))
+        {
+            values.push_back(value);
+        }
+        if (values.size() != 2)
+        {
+            return SpectralPeak_t();
+        }
+        return SpectralPeak_t((uint16_t)std::stoul(values[0]), (uint16_t)std::stoul(values[1]));
+    }
+
+    friend std::istream& operator>>(std::istream& is, SpectralPeak_t& peak) {
+        std::string str;
+        std::getline(is, str);
+        peak = SpectralPeak_t::fromString(str);
+        return is;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const SpectralPeak_t& peak) {
+        os << peak.toString().c_str();
+        return os;
+    }
+};
+
+
+struct BandLayout_t: public BandLayoutDescriptor_t
+{
+    BandLayout_t(){}
+    BandLayout_t(uint8_t BandCount_In, BandScale_t Scale_In, uint16_t MinFrequency_In, uint16_t MaxFrequency_In)
+    {
+        BandCount = BandCount_In;
+        Scale = Scale_In;
+        MinFrequency = MinFrequency_In;
+        MaxFrequency = MaxFrequency_In;
+    }
+    bool operator==(const BandLayout_t& other) const
+    {
+        return this->BandCount == other.BandCount && this->Scale == other.Scale && this->MinFrequency == other.MinFrequency && this->MaxFrequency == other.MaxFrequency;
+    }
+
+    bool operator!=(const BandLayout_t& other) const
+    {
+        return !(*this == other);
+    }
+
+    operator String() const
+    {
+        return toString();
+    }
+
+    String toString() const
+    {
+        return String(BandCount) + ENCODE_VALUE_DIVIDER + String(Scale) + ENCODE_VALUE_DIVIDER + String(MinFrequency) + ENCODE_VALUE_DIVIDER + String(MaxFrequency);
+    }
+
+    static BandLayout_t fromString(const std::string &str)
+    {
+        std::vector<std::string> values;
+        std::stringstream ss(str);
+        std::string value;
+        while (std::getline(ss, value, ENCODE_VALUE_DIVIDER[0]))
+        {
+            values.push_back(value);
+        }
+        if (values.size() != 4)
+        {
+            return BandLayout_t();
+        }
+        return BandLayout_t((uint8_t)std::stoul(values[0]), (BandScale_t)std::stoul(values[1]), (uint16_t)std::stoul(values[2]), (uint16_t)std::stoul(values[3]));
+    }
+
+    friend std::istream& operator>>(std::istream& is, BandLayout_t& layout) {
+        std::string str;
+        std::getline(is, str);
+        layout = BandLayout_t::fromString(str);
+        return is;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const BandLayout_t& layout) {
+        os << layout.toString().c_str();
+        return os;
+    }
+};
+
+
+//Stages of the CPU2 audio pipeline reported by its stage profiler
+enum AudioPipelineStage_t
+{
+  AudioPipelineStage_I2S_Read,
+  AudioPipelineStage_Buffer_Push,
+  AudioPipelineStage_Tone_Detect,
+  AudioPipelineStage_FFT_Window,
+  AudioPipelineStage_FFT_Compute,
+  AudioPipelineStage_FFT_Magnitude,
+  AudioPipelineStage_FFT_Normalize,
+  AudioPipelineStage_Peak_Pick,
+  AudioPipelineStage_Band_Assign,
+  AudioPipelineStage_Band_Send,
+  AudioPipelineStage_Count
+};
+
+struct StageProfile_t: public StageStatistics_t
+{
+    StageProfile_t(){}
+    StageProfile_t(const StageStatistics_t &Statistics): StageStatistics_t(Statistics){}
+    StageProfile_t(uint32_t Count_In, uint32_t Min_In, uint32_t Max_In, uint32_t Mean_In, uint32_t P95_In)
+    {
+        Count = Count_In;
+        Min = Min_In;
+        Max = Max_In;
+        Mean = Mean_In;
+        P95 = P95_In;
+    }
+    bool operator==(const StageProfile_t& other) const
+    {
+        return this->Count == other.Count && this->Min == other.Min && this->Max == other.Max && this->Mean == other.Mean && this->P95 == other.P95;
+    }
+
+    bool operator!=(const StageProfile_t& other) const
+    {
+        return !(*this == other);
+    }
+
+    operator String() const
+    {
+        return toString();
+    }
+
+    String toString() const
+    {
+        return String(Count) + ENCODE_VALUE_DIVIDER + String(Min) + ENCODE_VALUE_DIVIDER + String(Max) + ENCODE_VALUE_DIVIDER + String(Mean) + ENCODE_VALUE_DIVIDER + String(P95);
+    }
+
+    static StageProfile_t fromString(const std::string &str)
+    {
+        std::vector<std::string> values;
+        std::stringstream ss(str);
+        std::string value;
+        while (std::getline(ss, value, ENCODE_VALUE_DIVIDER[0]))
+        {
+            values.push_back(value);
+        }
+        if (values.size() != 5)
+        {
+            return StageProfile_t();
+        }
+        return StageProfile_t(std::stoul(values[0]), std::stoul(values[1]), std::stoul(values[2]), std::stoul(values[3]), std::stoul(values[4]));
+    }
+
+    friend std::istream& operator>>(std::istream& is, StageProfile_t& profile) {
+        std::string str;
+        std::getline(is, str);
+        profile = StageProfile_t::fromString(str);
+        return is;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const StageProfile_t& profile) {
+        os << profile.toString().c_str();
+        return os;
+    }
+};
+
+#define LINK_HEALTH_LATENCY_BUCKETS 8
+#define LINK_HEALTH_LATENCY_FIRST_BUCKET_US 250
+#define LINK_HEALTH_VALUE_COUNT (16 + LINK_HEALTH_LATENCY_BUCKETS)
+
+//Snapshot of one serial link, published periodically by its SerialPortMessageManager.
+//Rates cover the last period, counters are totals since boot and the latency and age figures cover the last period.
+struct LinkHealth_t
+{
+    uint32_t TxBytesPerSecond = 0;
+    uint32_t TxFramesPerSecond = 0;
+    uint32_t RxBytesPerSecond = 0;
+    uint32_t RxFramesPerSecond = 0;
+    uint32_t TxDropped = 0;             //Values dropped because the TX lanes were full
+    uint32_t RxLost = 0;                //Frames missing from the sender's sequence, the link has no retransmission
+    uint32_t RxCrcErrors = 0;
+    uint32_t RxFramingErrors = 0;       //Framing errors and frames longer than the receive buffer
+    uint32_t RxRejected = 0;            //Frames that decoded but did not validate
+    uint32_t RxOverflows = 0;           //UART FIFO or RX buffer overflows
+    uint32_t RxLineErrors = 0;
+    uint32_t TxLatencyMaxUs = 0;
+    uint32_t RxLate = 0;                //Timestamped frames dropped for arriving older than the receiver allows
+    uint32_t RxAgeMeanUs = 0;           //Capture to arrival of timestamped frames, in the receiver's clock
+    uint32_t RxAgeMaxUs = 0;
+    uint32_t ClockRoundTripUs = 0;      //Round trip of the clock sync sample in use, 0 until the clocks are synchronized
+    //Frames by queue to wire latency: <250us, <500us, <1ms, <2ms, <4ms, <8ms, <16ms, 16ms and over
+    uint32_t TxLatencyHistogram[LINK_HEALTH_LATENCY_BUCKETS] = {};
+
+    static size_t GetLatencyBucket(uint32_t LatencyUs)
+    {
+        size_t Bucket = 0;
+        uint32_t Limit = LINK_HEALTH_LATENCY_FIRST_BUCKET_US;
+        while(Bucket < LINK_HEALTH_LATENCY_BUCKETS - 1 && LatencyUs >= Limit)
+        {
+            ++Bucket;
+            Limit <<= 1;
+        }
+        return Bucket;
+    }
+
+    bool operator==(const LinkHealth_t& other) const
+    {
+        return 0 == memcmp(this, &other, sizeof(LinkHealth_t));
+    }
+
+    bool operator!=(const LinkHealth_t& other) const
+    {
+        return !(*this == other);
+    }
+
+    operator String() const
+    {
+        return toString();
+    }
+
+    String toString() const
+    {
+        uint32_t Values[LINK_HEALTH_VALUE_COUNT];
+        memcpy(Values, this, sizeof(Values));
+        String Result = String(Values[0]);
+        for(size_t i = 1; i < LINK_HEALTH_VALUE_COUNT; ++i)
+        {
+            Result += ENCODE_VALUE_DIVIDER + String(Values[i]);
+        }
+        return Result;
+    }
+
+    static LinkHealth_t fromString(const std::string &str)
+    {
+        std::vector<std::string> values;
+        std::stringstream ss(str);
+        std::string value;
+        while (std::getline(ss, value, ENCODE_VALUE_DIVIDER[0]))
+        {
+            values.push_back(value);
+        }
+        LinkHealth_t Health;
+        if (values.size() != LINK_HEALTH_VALUE_COUNT)
+        {
+            return Health;
+        }
+        uint32_t Values[LINK_HEALTH_VALUE_COUNT];
+        for(size_t i = 0; i < LINK_HEALTH_VALUE_COUNT; ++i)
+        {
+            Values[i] = std::stoul(values[i]);
+        }
+        memcpy(&Health, Values, sizeof(Values));
+        return Health;
+    }
+
+    friend std::istream& operator>>(std::istream& is, LinkHealth_t& health) {
+        std::string str;
+        std::getline(is, str);
+        health = LinkHealth_t::fromString(str);
+        return is;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const LinkHealth_t& health) {
+        os << health.toString().c_str();
+        return os;
+    }
+};
+//Every field is a uint32_t, encoded in declaration order
+static_assert(sizeof(LinkHealth_t) == LINK_HEALTH_VALUE_COUNT * sizeof(uint32_t), "LinkHealth_t is encoded as a flat list of uint32_t");
+
+
 class DataTypeFunctions
 {
 	public:			
@@ -1243,6 +1630,11 @@ class DataTypeFunctions
 			else if(std::is_same<T, SoundInputSource_t>::value)							return DataType_SoundInputSource_t;
 			else if(std::is_same<T, SoundOutputSource_t>::value)						return DataType_SoundOutputSource_t;
 			else if(std::is_same<T, Bluetooth_Discovery_Mode_t>::value)					return DataType_Bluetooth_Discovery_Mode_t;
+			else if(std::is_same<T, ToneTrigger_t>::value)								return DataType_ToneTrigger_t;
+			else if(std::is_same<T, SpectralPeak_t>::value)								return DataType_SpectralPeak_t;
+			else if(std::is_same<T, BandLayout_t>::value)								return DataType_BandLayout_t;
+			else if(std::is_same<T, StageProfile_t>::value)								return DataType_StageProfile_t;
+			else if(std::is_same<T, LinkHealth_t>::value)								return DataType_LinkHealth_t;
 			else
 			{
 				ESP_LOGE("DataTypes: GetDataTypeFromTemplateType", "ERROR! Undefined Data Type.");
@@ -1349,6 +1741,26 @@ class DataTypeFunctions
                 case DataType_Bluetooth_Discovery_Mode_t:
                     result = sizeof(Bluetooth_Discovery_Mode_t);
 				break;
+
+				case DataType_ToneTrigger_t:
+					result = sizeof(ToneTrigger_t);
+				break;
+
+				case DataType_SpectralPeak_t:
+					result = sizeof(SpectralPeak_t);
+				break;
+
+				case DataType_BandLayout_t:
+					result = sizeof(BandLayout_t);
+				break;
+
+				case DataType_StageProfile_t:
+					result = sizeof(StageProfile_t);
+				break;
+
+				case DataType_LinkHealth_t:
+					result = sizeof(LinkHealth_t);
+				break;
 				
 				default:
 					ESP_LOGE("DataTypes: GetSizeOfDataType: %s", "ERROR! \"%s\": Undefined Data Type.", DataTypeStrings[DataType]);
@@ -0,0 +1,208 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+
+struct GoertzelDetectorConfig_t
+{
+	float Frequency;         //Target frequency in Hz
+	float MagnitudeThreshold; //Minimum normalized tone amplitude (0.0 - 1.0)
+	float PurityThreshold;   //Minimum fraction of the block energy that must be in the target bin (0.0 - 1.0)
+};
+
+//Single frequency Goertzel filter evaluated over fixed length blocks.
+//Each pushed sample costs one multiply and two adds.
+class GoertzelDetector
+{
+	public:
+		GoertzelDetector(){}
+		GoertzelDetector( const GoertzelDetectorConfig_t &config, float sampleRate, size_t blockSize )
+		{
+			Configure(config, sampleRate, blockSize);
+		}
+		virtual ~GoertzelDetector(){}
+
+		void Configure( const GoertzelDetectorConfig_t &config, float sampleRate, size_t blockSize )
+		{
+			m_Config = config;
+			m_BlockSize = blockSize;
+			//Snap the target to the nearest bin so the tone lands on the bin center for the block length
+			float bin = std::round( (static_cast<float>(blockSize) * config.Frequency) / sampleRate );
+			float omega = (2.0f * static_cast<float>(M_PI) * bin) / static_cast<float>(blockSize);
+			m_Coefficient = 2.0f * std::cos(omega);
+			Reset();
+		}
+
+		void Reset()
+		{
+			m_S1 = 0.0f;
+			m_S2 = 0.0f;
+			m_Magnitude = 0.0f;
+			m_Purity = 0.0f;
+		}
+
+		inline void PushSample(float sample)
+		{
+			float s0 = sample + (m_Coefficient * m_S1) - m_S2;
+			m_S2 = m_S1;
+			m_S1 = s0;
+		}
+
+		//Closes the current block. blockEnergy is the sum of the squared samples of the same block.
+		void EvaluateBlock(float blockEnergy)
+		{
+			float power = (m_S1 * m_S1) + (m_S2 * m_S2) - (m_Coefficient * m_S1 * m_S2);
+			if(power < 0.0f) power = 0.0f;
+			m_Magnitude = (2.0f * std::sqrt(power)) / static_cast<float>(m_BlockSize);
+			//A pure tone on the bin center puts 2|X|^2/N of the N samples energy in the bin
+			m_Purity = (blockEnergy > 0.0f) ? ((2.0f * power) / (static_cast<float>(m_BlockSize) * blockEnergy)) : 0.0f;
+			if(m_Purity > 1.0f) m_Purity = 1.0f;
+			m_S1 = 0.0f;
+			m_S2 = 0.0f;
+		}
+
+		bool IsToneDetected() const
+		{
+			return (m_Magnitude >= m_Config.MagnitudeThreshold) && (m_Purity >= m_Config.PurityThreshold);
+		}
+		float GetMagnitude() const { return m_Magnitude; }
+		float GetPurity() const { return m_Purity; }
+		float GetFrequency() const { return m_Config.Frequency; }
+		const GoertzelDetectorConfig_t& GetConfig() const { return m_Config; }
+
+	private:
+		GoertzelDetectorConfig_t m_Config = {0.0f, 1.0f, 1.0f};
+		size_t m_BlockSize = 1;
+		float m_Coefficient = 0.0f;
+		float m_S1 = 0.0f;
+		float m_S2 = 0.0f;
+		float m_Magnitude = 0.0f;
+		float m_Purity = 0.0f;
+};
+
+//Bank of Goertzel detectors sharing a block clock and block energy.
+//A detector triggers once after its tone has been present for holdBlocks consecutive blocks
+//and re-arms after the tone has been absent for the same number of blocks.
+template <size_t COUNT>
+class GoertzelDetectorBank
+{
+	static_assert(COUNT <= 32, "Trigger mask supports at most 32 detectors");
+	public:
+		GoertzelDetectorBank( const GoertzelDetectorConfig_t (&configs)[COUNT]
+							, float sampleRate
+							, size_t blockSize
+							, uint8_t holdBlocks )
+							: m_BlockSize(blockSize)
+							, m_HoldBlocks(holdBlocks)
+		{
+			for(size_t i = 0; i < COUNT; ++i)
+			{
+				m_Detectors[i].Configure(configs[i], sampleRate, blockSize);
+			}
+			Reset();
+		}
+		virtual ~GoertzelDetectorBank(){}
+
+		void Reset()
+		{
+			m_SampleIndex = 0;
+			m_BlockEnergy = 0.0f;
+			for(size_t i = 0; i < COUNT; ++i)
+			{
+				m_Detectors[i].Reset();
+				m_PresentCount[i] = 0;
+				m_AbsentCount[i] = 0;
+				m_Triggered[i] = false;
+			}
+		}
+
+		//Pushes one sample to every detector. Returns a bit mask of the detectors that triggered on this sample.
+		uint32_t PushSample(float sample)
+		{
+			m_BlockEnergy += sample * sample;
+			for(size_t i = 0; i < COUNT; ++i)
+			{
+				m_Detectors[i].PushSample(sample);
+			}
+			if(++m_SampleIndex < m_BlockSize)
+			{
+				return 0;
+			}
+			return EvaluateBlock();
+		}
+
+		uint32_t PushSamples(const float* samples, size_t count)
+		{
+			uint32_t triggerMask = 0;
+			for(size_t i = 0; i < count; ++i)
+			{
+				triggerMask |= PushSample(samples[i]);
+			}
+			return triggerMask;
+		}
+
+		const GoertzelDetector& GetDetector(size_t index) const { return m_Detectors[index]; }
+		bool IsTriggered(size_t index) const { return m_Triggered[index]; }
+		size_t GetDetectorCount() const { return COUNT; }
+		size_t GetBlockSize() const { return m_BlockSize; }
+
+	private:
+		GoertzelDetector m_Detectors[COUNT];
+		uint8_t m_PresentCount[COUNT];
+		uint8_t m_AbsentCount[COUNT];
+		bool m_Triggered[COUNT];
+		size_t m_BlockSize;
+		uint8_t m_HoldBlocks;
+		size_t m_SampleIndex = 0;
+		float m_BlockEnergy = 0.0f;
+
+		uint32_t EvaluateBlock()
+		{
+			uint32_t triggerMask = 0;
+			for(size_t i = 0; i < COUNT; ++i)
+			{
+				m_Detectors[i].EvaluateBlock(m_BlockEnergy);
+				if(m_Detectors[i].IsToneDetected())
+				{
+					m_AbsentCount[i] = 0;
+					if(m_PresentCount[i] < m_HoldBlocks) ++m_PresentCount[i];
+					if(!m_Triggered[i] && m_PresentCount[i] >= m_HoldBlocks)
+					{
+						m_Triggered[i] = true;
+						triggerMask |= (1UL << i);
+					}
+				}
+				else
+				{
+					m_PresentCount[i] = 0;
+					if(m_AbsentCount[i] < m_HoldBlocks) ++m_AbsentCount[i];
+					if(m_Triggered[i] && m_AbsentCount[i] >= m_HoldBlocks)
+					{
+						m_Triggered[i] = false;
+					}
+				}
+			}
+			m_SampleIndex = 0;
+			m_BlockEnergy = 0.0f;
+			return triggerMask;
+		}
+};
@@ -0,0 +1,208 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <mutex>
+
+#if defined(ESP_PLATFORM)
+	#include <esp_heap_caps.h>
+#endif
+
+//Capture file written by LinkCapture::Dump:
+//
+//  LinkCaptureFileHeader_t | ( LinkCaptureRecordHeader_t | bytes )...
+//
+//TX records hold one encoded frame as it was written to the transport. RX records hold the bytes of one transport
+//read, so line errors and partial frames are kept as they arrived.
+#define LINK_CAPTURE_MAGIC      0x5043544C    //"LTCP"
+#define LINK_CAPTURE_VERSION    1
+
+enum LinkCaptureDirection_t
+{
+	LinkCaptureDirection_Rx,
+	LinkCaptureDirection_Tx,
+};
+
+struct __attribute__((packed)) LinkCaptureFileHeader_t
+{
+	uint32_t Magic = LINK_CAPTURE_MAGIC;
+	uint16_t Version = LINK_CAPTURE_VERSION;
+	uint16_t Reserved = 0;
+	uint32_t Records = 0;
+	uint32_t Overwritten = 0;     //Oldest records the ring gave up for newer ones
+	uint32_t Skipped = 0;         //Records that did not fit, or arrived while a dump was running
+};
+
+struct __attribute__((packed)) LinkCaptureRecordHeader_t
+{
+	uint32_t TimeUs = 0;          //micros() of the capturing CPU
+	uint16_t Length = 0;
+	uint8_t Direction = LinkCaptureDirection_Rx;
+	uint8_t Reserved = 0;
+};
+
+//Walks the records of a capture file after its header. Returns false at the end or at a record that does not fit.
+inline bool GetNextLinkCaptureRecord(const uint8_t* data, size_t length, size_t &offset, LinkCaptureRecordHeader_t &record, const uint8_t* &bytes)
+{
+	if(offset + sizeof(record) > length) return false;
+	memcpy(&record, data + offset, sizeof(record));
+	if(offset + sizeof(record) + record.Length > length) return false;
+	bytes = data + offset + sizeof(record);
+	offset += sizeof(record) + record.Length;
+	return true;
+}
+
+//Bounded flight recorder of the traffic on one link. Records go into a byte ring, in PSRAM on the ESP32, and the
+//oldest are given up to make room, so a capture always holds the latest traffic. Recording takes a short lock and
+//two copies, and nothing at all when no capture is set on the manager.
+//
+//  LinkCapture capture(LINK_CAPTURE_SIZE);
+//  capture.Begin();
+//  manager.SetLinkCapture(&capture);
+//  capture.Dump([](const uint8_t* data, size_t length){ server.sendContent((const char*)data, length); });
+class LinkCapture
+{
+	public:
+		LinkCapture(size_t size): m_Size(size){}
+		virtual ~LinkCapture()
+		{
+			free(mp_Buffer);
+		}
+
+		//Allocates the ring. Called from setup, once PSRAM is available.
+		bool Begin()
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			if(mp_Buffer) return true;
+#if defined(ESP_PLATFORM)
+			mp_Buffer = static_cast<uint8_t*>(heap_caps_malloc(m_Size, MALLOC_CAP_SPIRAM));
+#else
+			mp_Buffer = static_cast<uint8_t*>(malloc(m_Size));
+#endif
+			return nullptr != mp_Buffer;
+		}
+
+		void Record(LinkCaptureDirection_t direction, uint32_t timeUs, const uint8_t* data, size_t length)
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			const size_t needed = sizeof(LinkCaptureRecordHeader_t) + length;
+			if(!mp_Buffer || m_Dumping || length > UINT16_MAX || needed > m_Size)
+			{
+				++m_Skipped;
+				return;
+			}
+			while(m_Size - m_Used < needed) DropOldest();
+			LinkCaptureRecordHeader_t header;
+			header.TimeUs = timeUs;
+			header.Length = static_cast<uint16_t>(length);
+			header.Direction = direction;
+			CopyIn(&header, sizeof(header));
+			CopyIn(data, length);
+			++m_Records;
+		}
+
+		//Writes the capture file in chunks through write. Recording is paused, not blocked, while it runs.
+		//Returns the bytes written.
+		size_t Dump(std::function<void(const uint8_t* data, size_t length)> write)
+		{
+			LinkCaptureFileHeader_t header;
+			size_t start;
+			size_t used;
+			{
+				std::lock_guard<std::mutex> lock(m_Mutex);
+				if(m_Dumping) return 0;
+				m_Dumping = true;
+				header.Records = m_Records;
+				header.Overwritten = m_Overwritten;
+				header.Skipped = m_Skipped;
+				start = GetTail();
+				used = m_Used;
+			}
+			write(reinterpret_cast<const uint8_t*>(&header), sizeof(header));
+			const size_t first = std::min(used, m_Size - start);
+			if(first > 0) write(mp_Buffer + start, first);
+			if(used > first) write(mp_Buffer, used - first);
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Dumping = false;
+			return sizeof(header) + used;
+		}
+
+		void Clear()
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			if(m_Dumping) return;
+			m_Head = 0;
+			m_Used = 0;
+			m_Records = 0;
+			m_Overwritten = 0;
+			m_Skipped = 0;
+		}
+
+		size_t GetSize() const { return m_Size; }
+		size_t GetUsed()
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			return m_Used;
+		}
+		uint32_t GetRecordCount()
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			return m_Records;
+		}
+
+	private:
+		const size_t m_Size;
+		uint8_t* mp_Buffer = nullptr;
+		std::mutex m_Mutex;
+		size_t m_Head = 0;
+		size_t m_Used = 0;
+		uint32_t m_Records = 0;
+		uint32_t m_Overwritten = 0;
+		uint32_t m_Skipped = 0;
+		bool m_Dumping = false;
+
+		size_t GetTail() const { return (m_Head + m_Size - m_Used) % m_Size; }
+
+		void CopyIn(const void* data, size_t length)
+		{
+			const size_t first = std::min(length, m_Size - m_Head);
+			memcpy(mp_Buffer + m_Head, data, first);
+			memcpy(mp_Buffer, static_cast<const uint8_t*>(data) + first, length - first);
+			m_Head = (m_Head + length) % m_Size;
+			m_Used += length;
+		}
+
+		void DropOldest()
+		{
+			const size_t tail = GetTail();
+			LinkCaptureRecordHeader_t header;
+			const size_t first = std::min(sizeof(header), m_Size - tail);
+			memcpy(&header, mp_Buffer + tail, first);
+			memcpy(reinterpret_cast<uint8_t*>(&header) + first, mp_Buffer, sizeof(header) - first);
+			m_Used -= sizeof(header) + header.Length;
+			--m_Records;
+			++m_Overwritten;
+		}
+};
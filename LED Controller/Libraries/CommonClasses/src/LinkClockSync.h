@@ -0,0 +1,90 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#define LINK_CLOCK_SYNC_SAMPLES 8
+
+//Payload of the clock frames. A request carries OriginUs, the response returns it with the peer's receive and
+//transmit times. Every time is the low 32 bits of micros() of the CPU that took it.
+struct __attribute__((packed)) LinkClockSync_t
+{
+	uint32_t OriginUs = 0;
+	uint32_t ReceiveUs = 0;
+	uint32_t TransmitUs = 0;
+};
+
+//NTP style estimate of a peer's clock. Each request and response pair gives the round trip and the offset of the peer
+//clock. Queueing on either side only ever adds to the round trip, so the sample with the shortest round trip among the
+//last LINK_CLOCK_SYNC_SAMPLES is the most accurate and its offset is used. Times wrap every 71 minutes, which the
+//32 bit differences absorb. Not thread safe.
+class LinkClockSync
+{
+	public:
+		LinkClockSync(){}
+		virtual ~LinkClockSync(){}
+
+		//destinationUs is the local time the response arrived. Returns false if the sample made no sense.
+		bool AddSample(const LinkClockSync_t &response, uint32_t destinationUs)
+		{
+			const int32_t elapsed = static_cast<int32_t>(destinationUs - response.OriginUs);
+			const int32_t held = static_cast<int32_t>(response.TransmitUs - response.ReceiveUs);
+			if(elapsed < 0 || held < 0 || held > elapsed) return false;
+			Sample_t &sample = m_Samples[m_Next];
+			sample.RoundTripUs = static_cast<uint32_t>(elapsed - held);
+			sample.OffsetUs = static_cast<int32_t>(((static_cast<int64_t>(static_cast<int32_t>(response.ReceiveUs - response.OriginUs)) +
+													 static_cast<int32_t>(response.TransmitUs - destinationUs))) / 2);
+			m_Next = (m_Next + 1) % LINK_CLOCK_SYNC_SAMPLES;
+			if(m_Count < LINK_CLOCK_SYNC_SAMPLES) ++m_Count;
+
+			const Sample_t* best = &m_Samples[0];
+			for(size_t i = 1; i < m_Count; ++i)
+			{
+				if(m_Samples[i].RoundTripUs < best->RoundTripUs) best = &m_Samples[i];
+			}
+			m_Best = *best;
+			return true;
+		}
+
+		bool IsSynchronized() const { return m_Count > 0; }
+		//Peer clock minus local clock
+		int32_t GetOffsetUs() const { return m_Best.OffsetUs; }
+		uint32_t GetRoundTripUs() const { return m_Best.RoundTripUs; }
+		//Translates a time taken by the peer to the local clock
+		uint32_t ToLocalTime(uint32_t peerUs) const { return peerUs - static_cast<uint32_t>(m_Best.OffsetUs); }
+		void Reset()
+		{
+			m_Count = 0;
+			m_Next = 0;
+			m_Best = Sample_t();
+		}
+
+	private:
+		struct Sample_t
+		{
+			uint32_t RoundTripUs = 0;
+			int32_t OffsetUs = 0;
+		};
+		Sample_t m_Samples[LINK_CLOCK_SYNC_SAMPLES];
+		Sample_t m_Best;
+		size_t m_Count = 0;
+		size_t m_Next = 0;
+};
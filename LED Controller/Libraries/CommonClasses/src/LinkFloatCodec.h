@@ -0,0 +1,354 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include "LinkFrame.h"
+
+//Optional link codec for float array items such as the sound bands. The payload of an encoded frame or record is
+//
+//  LinkCodecHeader_t | token stream
+//
+//Values are quantized to 8 or 16 bit codes, value = code * Scale, negative values are sent as 0. The scale is kept
+//while the frame peak stays within a factor of 4 of it, so the error is at most Scale / 2 <= 2 * peak / (2^bits - 1).
+//A key frame carries the codes, a delta frame the change from the item's previous frame modulo 2^bits. Both are run
+//length coded: a token with the top bit set is (token & 0x7F) + 1 zero codes, otherwise token + 1 literal codes follow.
+//There are no acknowledgements on the link, so a delta only applies on top of the frame with the previous Sequence and
+//a lost frame stalls the item until the next key frame, at most LINK_CODEC_KEY_INTERVAL frames later.
+#define LINK_CODEC_MAX_COUNT            64
+#define LINK_CODEC_KEY_INTERVAL         16
+#define LINK_CODEC_FLAG_DELTA           0x80
+#define LINK_CODEC_MAX_ENCODED_SIZE(count)  (sizeof(LinkCodecHeader_t) + 3 * (count))
+
+enum LinkCodec_t
+{
+	LinkCodec_None,
+	LinkCodec_Quantized8,
+	LinkCodec_Quantized16,
+};
+
+struct __attribute__((packed)) LinkCodecHeader_t
+{
+	uint8_t Format = 0;        //LinkCodec_t, plus LINK_CODEC_FLAG_DELTA for a delta frame
+	uint8_t Sequence = 0;      //Per item, wraps at 256
+	uint16_t Length = 0;       //Token stream bytes that follow
+	float Scale = 0.0f;
+};
+static_assert(sizeof(LinkCodecHeader_t) == 8, "Codec header keeps the token stream 4 byte aligned");
+
+//Total length of the encoded payload at the start of data, or 0 if it does not fit in length bytes
+inline size_t GetLinkCodecPayloadLength(const uint8_t* data, size_t length)
+{
+	if(length < sizeof(LinkCodecHeader_t)) return 0;
+	LinkCodecHeader_t header;
+	memcpy(&header, data, sizeof(header));
+	const size_t total = sizeof(header) + header.Length;
+	return (total <= length) ? total : 0;
+}
+
+inline size_t GetLinkCodecWidth(uint8_t format)
+{
+	switch(format & ~LINK_CODEC_FLAG_DELTA)
+	{
+		case LinkCodec_Quantized8: return 1;
+		case LinkCodec_Quantized16: return 2;
+		default: return 0;
+	}
+}
+
+//Run length codes count codes of width bytes. Returns the stream length or 0 if output is too small.
+inline size_t LinkRleEncode(const uint16_t* codes, size_t count, size_t width, uint8_t* output, size_t outputSize)
+{
+	size_t length = 0;
+	size_t i = 0;
+	while(i < count)
+	{
+		size_t run = 0;
+		while(i + run < count && run < 128 && 0 == codes[i + run]) ++run;
+		if(run >= 2)
+		{
+			if(length + 1 > outputSize) return 0;
+			output[length++] = 0x80 | static_cast<uint8_t>(run - 1);
+			i += run;
+			continue;
+		}
+		//A single zero is cheaper inside the literal than as a run of its own
+		size_t literal = 1;
+		while(i + literal < count && literal < 128 && !(0 == codes[i + literal] && i + literal + 1 < count && 0 == codes[i + literal + 1])) ++literal;
+		if(length + 1 + literal * width > outputSize) return 0;
+		output[length++] = static_cast<uint8_t>(literal - 1);
+		for(size_t j = 0; j < literal; ++j)
+		{
+			const uint16_t code = codes[i + j];
+			output[length++] = static_cast<uint8_t>(code & 0xFF);
+			if(2 == width) output[length++] = static_cast<uint8_t>(code >> 8);
+		}
+		i += literal;
+	}
+	return length;
+}
+
+//Returns false unless the stream decodes to exactly count codes
+inline bool LinkRleDecode(const uint8_t* input, size_t length, size_t width, uint16_t* codes, size_t count)
+{
+	size_t read = 0;
+	size_t written = 0;
+	while(read < length)
+	{
+		const uint8_t token = input[read++];
+		const size_t run = (token & 0x7F) + 1;
+		if(written + run > count) return false;
+		if(token & 0x80)
+		{
+			for(size_t j = 0; j < run; ++j) codes[written++] = 0;
+		}
+		else
+		{
+			if(read + run * width > length) return false;
+			for(size_t j = 0; j < run; ++j)
+			{
+				uint16_t code = input[read++];
+				if(2 == width) code |= static_cast<uint16_t>(input[read++]) << 8;
+				codes[written++] = code;
+			}
+		}
+	}
+	return written == count;
+}
+
+//TX side of one item on one link. Not thread safe, the owner serializes Encode and Accept.
+class LinkFloatEncoder
+{
+	public:
+		LinkFloatEncoder(){}
+		virtual ~LinkFloatEncoder(){}
+
+		void SetCodec(LinkCodec_t codec)
+		{
+			m_Codec = codec;
+			Reset();
+		}
+		LinkCodec_t GetCodec() const { return m_Codec; }
+
+		//The next frame is a key frame
+		void Reset()
+		{
+			m_States[SLOT_PREVIOUS].Valid = false;
+			m_States[SLOT_BASE].Valid = false;
+		}
+
+		//Encodes count values into output and returns the payload length, or 0 if they cannot be encoded.
+		//replacing is set when this frame takes the place of the last accepted one before that was sent, so it is
+		//coded against the frame before. Nothing changes until Accept.
+		size_t Encode(const float* values, size_t count, bool replacing, uint8_t* output, size_t outputSize)
+		{
+			const size_t width = GetLinkCodecWidth(m_Codec);
+			if(0 == width || 0 == count || count > GetCapacity() || outputSize < sizeof(LinkCodecHeader_t)) return 0;
+			const float range = (1 == width) ? UINT8_MAX : UINT16_MAX;
+			float peak = 0.0f;
+			for(size_t i = 0; i < count; ++i)
+			{
+				if(values[i] > peak) peak = values[i];
+			}
+			if(!std::isfinite(peak)) return 0;
+
+			const State_t &base = m_States[replacing ? SLOT_PREVIOUS : SLOT_BASE];
+			const uint16_t* baseCodes = GetCodes(m_Slots[replacing ? SLOT_PREVIOUS : SLOT_BASE]);
+			float scale = base.Valid ? base.Scale : 0.0f;
+			const float full = scale * range;
+			if(scale <= 0.0f || peak > full || (peak > 0.0f && peak < full / 4))
+			{
+				scale = (peak > 0.0f) ? 2.0f * peak / range : 1.0f / range;
+			}
+			uint16_t* codes = GetCodes(m_Slots[SLOT_NEXT]);
+			for(size_t i = 0; i < count; ++i)
+			{
+				const float code = (values[i] > 0.0f) ? std::round(values[i] / scale) : 0.0f;
+				codes[i] = static_cast<uint16_t>(std::min(code, range));
+			}
+
+			uint8_t* stream = output + sizeof(LinkCodecHeader_t);
+			const size_t streamSize = outputSize - sizeof(LinkCodecHeader_t);
+			size_t length = LinkRleEncode(codes, count, width, stream, streamSize);
+			bool delta = false;
+			if(base.Valid && scale == base.Scale && base.SinceKey + 1 < LINK_CODEC_KEY_INTERVAL)
+			{
+				const uint16_t mask = (1 == width) ? UINT8_MAX : UINT16_MAX;
+				uint16_t deltas[LINK_CODEC_MAX_COUNT];
+				uint8_t deltaStream[LINK_CODEC_MAX_ENCODED_SIZE(LINK_CODEC_MAX_COUNT)];
+				for(size_t i = 0; i < count; ++i) deltas[i] = (codes[i] - baseCodes[i]) & mask;
+				const size_t deltaLength = LinkRleEncode(deltas, count, width, deltaStream, std::min(streamSize, sizeof(deltaStream)));
+				if(deltaLength > 0 && (0 == length || deltaLength < length))
+				{
+					memcpy(stream, deltaStream, deltaLength);
+					length = deltaLength;
+					delta = true;
+				}
+			}
+			if(0 == length) return 0;
+
+			LinkCodecHeader_t header;
+			header.Format = static_cast<uint8_t>(m_Codec) | (delta ? LINK_CODEC_FLAG_DELTA : 0);
+			header.Sequence = base.Sequence + 1;
+			header.Length = length;
+			header.Scale = scale;
+			memcpy(output, &header, sizeof(header));
+
+			State_t &next = m_States[SLOT_NEXT];
+			next.Scale = scale;
+			next.Sequence = header.Sequence;
+			next.SinceKey = delta ? base.SinceKey + 1 : 0;
+			next.Valid = true;
+			return sizeof(header) + length;
+		}
+
+		//The last encoded frame was queued. replacing must match what it was encoded with.
+		void Accept(bool replacing)
+		{
+			if(!replacing)
+			{
+				Rotate(SLOT_PREVIOUS, SLOT_BASE);
+			}
+			Rotate(SLOT_BASE, SLOT_NEXT);
+		}
+
+	protected:
+		//Three arrays of GetCapacity codes
+		virtual uint16_t* GetCodes(size_t slot) = 0;
+		virtual size_t GetCapacity() const = 0;
+
+	private:
+		enum Slot_t
+		{
+			SLOT_PREVIOUS,
+			SLOT_BASE,
+			SLOT_NEXT,
+			SLOT_COUNT,
+		};
+		struct State_t
+		{
+			float Scale = 0.0f;
+			uint8_t Sequence = 0;
+			uint8_t SinceKey = 0;
+			bool Valid = false;
+		};
+		LinkCodec_t m_Codec = LinkCodec_None;
+		State_t m_States[SLOT_COUNT];
+		uint8_t m_Slots[SLOT_COUNT] = { 0, 1, 2 };
+
+		void Rotate(Slot_t to, Slot_t from)
+		{
+			std::swap(m_States[to], m_States[from]);
+			std::swap(m_Slots[to], m_Slots[from]);
+		}
+};
+
+//RX side of one item on one link
+class LinkFloatDecoder
+{
+	public:
+		LinkFloatDecoder(){}
+		virtual ~LinkFloatDecoder(){}
+
+		//Decodes an encoded payload into count values. Returns false for a malformed payload, or for a delta that
+		//does not follow the last frame decoded, in which case deltas are refused until the next key frame.
+		bool Decode(const uint8_t* payload, size_t length, float* values, size_t count)
+		{
+			if(length < sizeof(LinkCodecHeader_t)) return false;
+			LinkCodecHeader_t header;
+			memcpy(&header, payload, sizeof(header));
+			const size_t width = GetLinkCodecWidth(header.Format);
+			if(0 == width || 0 == count || count > GetCapacity() || sizeof(header) + header.Length != length) return false;
+			const uint8_t* stream = payload + sizeof(header);
+			uint16_t* codes = GetCodes();
+			if(header.Format & LINK_CODEC_FLAG_DELTA)
+			{
+				const uint8_t expected = m_Sequence + 1;
+				uint16_t deltas[LINK_CODEC_MAX_COUNT];
+				if(!m_Valid || header.Sequence != expected || !LinkRleDecode(stream, header.Length, width, deltas, count))
+				{
+					m_Valid = false;
+					return false;
+				}
+				const uint16_t mask = (1 == width) ? UINT8_MAX : UINT16_MAX;
+				for(size_t i = 0; i < count; ++i) codes[i] = (codes[i] + deltas[i]) & mask;
+			}
+			else if(!LinkRleDecode(stream, header.Length, width, codes, count))
+			{
+				m_Valid = false;
+				return false;
+			}
+			m_Sequence = header.Sequence;
+			m_Valid = true;
+			for(size_t i = 0; i < count; ++i) values[i] = codes[i] * header.Scale;
+			return true;
+		}
+
+	protected:
+		virtual uint16_t* GetCodes() = 0;
+		virtual size_t GetCapacity() const = 0;
+
+	private:
+		uint8_t m_Sequence = 0;
+		bool m_Valid = false;
+};
+
+template <size_t COUNT>
+class FixedLinkFloatEncoder: public LinkFloatEncoder
+{
+	static_assert(COUNT <= LINK_CODEC_MAX_COUNT, "Too many values for the link codec");
+	protected:
+		uint16_t* GetCodes(size_t slot) override { return m_Codes[slot]; }
+		size_t GetCapacity() const override { return COUNT; }
+	private:
+		uint16_t m_Codes[3][COUNT] = {};
+};
+
+template <size_t COUNT>
+class FixedLinkFloatDecoder: public LinkFloatDecoder
+{
+	static_assert(COUNT <= LINK_CODEC_MAX_COUNT, "Too many values for the link codec");
+	protected:
+		uint16_t* GetCodes() override { return m_Codes; }
+		size_t GetCapacity() const override { return COUNT; }
+	private:
+		uint16_t m_Codes[COUNT] = {};
+};
+
+//Codec state a DataItem carries for its link. Only float arrays can be encoded, other items carry none.
+template <typename T, size_t COUNT, typename Enable = void>
+class LinkItemCodec
+{
+	public:
+		LinkFloatEncoder* GetEncoder() { return nullptr; }
+		LinkFloatDecoder* GetDecoder() { return nullptr; }
+};
+
+template <typename T, size_t COUNT>
+class LinkItemCodec<T, COUNT, typename std::enable_if<std::is_same<T, float>::value && (COUNT <= LINK_CODEC_MAX_COUNT)>::type>
+{
+	public:
+		LinkFloatEncoder* GetEncoder() { return &m_Encoder; }
+		LinkFloatDecoder* GetDecoder() { return &m_Decoder; }
+	private:
+		FixedLinkFloatEncoder<COUNT> m_Encoder;
+		FixedLinkFloatDecoder<COUNT> m_Decoder;
+};
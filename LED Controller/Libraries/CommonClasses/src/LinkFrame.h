@@ -0,0 +1,248 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+//Binary frame used on the inter CPU UART links:
+//
+//  COBS( LinkFrameHeader_t | payload | CRC16 ) 0x00
+//
+//The payload is the raw little endian bytes of the DataItem values. COBS removes every 0x00 from the
+//encoded bytes so the delimiter always marks a frame boundary and a receiver can resync after any error.
+#define LINK_FRAME_DELIMITER        0x00
+#define LINK_FRAME_CRC_SIZE         2
+#define LINK_FRAME_CRC_SEED         0xFFFF
+
+//Worst case encoded size of a frame carrying payloadSize bytes, including the delimiter.
+#define LINK_FRAME_MAX_ENCODED_SIZE(payloadSize) \
+	( (sizeof(LinkFrameHeader_t) + (payloadSize) + LINK_FRAME_CRC_SIZE) + \
+	  ((sizeof(LinkFrameHeader_t) + (payloadSize) + LINK_FRAME_CRC_SIZE) / 254) + 2 )
+
+struct __attribute__((packed)) LinkFrameHeader_t
+{
+	uint16_t ItemId = 0;
+	uint8_t DataType = 0;
+	uint8_t Sequence = 0;      //Per link frame counter, wraps at 256
+	uint16_t Count = 0;
+	uint16_t Flags = 0;        //LINK_FRAME_FLAG_*, also keeps the payload 4 byte aligned
+	uint32_t ChangeCount = 0;
+};
+static_assert(sizeof(LinkFrameHeader_t) == 12, "Payload must start 4 byte aligned in the decode buffer");
+
+//Header flags
+#define LINK_FRAME_FLAG_BATCH       0x0001   //Payload is a list of LinkBatchRecordHeader_t | data records
+#define LINK_FRAME_FLAG_TIMESTAMP   0x0002   //Payload starts with a uint32_t capture time in us of the sender's clock
+#define LINK_FRAME_FLAG_CLOCK_REQUEST   0x0004   //Clock sync frames carry a LinkClockSync_t, and no sequence number
+#define LINK_FRAME_FLAG_CLOCK_RESPONSE  0x0008
+#define LINK_FRAME_FLAG_CLOCK       (LINK_FRAME_FLAG_CLOCK_REQUEST | LINK_FRAME_FLAG_CLOCK_RESPONSE)
+#define LINK_FRAME_FLAG_SCHEMA      0x0010   //Payload is the sender's LinkSchemaEntry_t list, no sequence number
+#define LINK_FRAME_FLAG_SCHEMA_ACK  0x0020   //Schema sent in reply, ChangeCount echoes the version it answers
+#define LINK_FRAME_TIMESTAMP_SIZE   4
+
+//Set in the DataType of a frame or batch record whose data is a LinkCodecHeader_t | coded values payload
+#define LINK_DATATYPE_FLAG_ENCODED  0x80
+
+//Record inside a batch frame. The data length follows from DataType and Count, and the data is padded to
+//4 bytes so every record payload stays 4 byte aligned.
+struct __attribute__((packed)) LinkBatchRecordHeader_t
+{
+	uint16_t ItemId = 0;
+	uint8_t DataType = 0;
+	uint8_t Count = 0;
+	uint32_t ChangeCount = 0;
+};
+static_assert(sizeof(LinkBatchRecordHeader_t) == 8, "Record data must start 4 byte aligned");
+
+#define LINK_BATCH_MAX_COUNT        UINT8_MAX
+#define LINK_BATCH_ALIGN(length)    (((length) + 3) & ~static_cast<size_t>(3))
+
+struct LinkFrameView_t
+{
+	LinkFrameHeader_t Header;
+	const uint8_t* Payload = nullptr;
+	size_t PayloadLength = 0;
+};
+
+//16 bit FNV-1a of the item name. Both ends derive the same id from the DataItem name so no table has to be exchanged.
+constexpr uint16_t GetLinkItemId(const char* name)
+{
+	uint32_t hash = 2166136261UL;
+	while(*name)
+	{
+		hash ^= static_cast<uint8_t>(*name++);
+		hash *= 16777619UL;
+	}
+	return static_cast<uint16_t>((hash >> 16) ^ (hash & 0xFFFF));
+}
+
+//CRC-16/CCITT-FALSE, nibble table
+inline uint16_t LinkCrc16(const uint8_t* data, size_t length, uint16_t crc = LINK_FRAME_CRC_SEED)
+{
+	static const uint16_t table[16] =
+	{
+		0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+		0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+	};
+	for(size_t i = 0; i < length; ++i)
+	{
+		crc = (crc << 4) ^ table[(crc >> 12) ^ (data[i] >> 4)];
+		crc = (crc << 4) ^ table[(crc >> 12) ^ (data[i] & 0x0F)];
+	}
+	return crc;
+}
+
+//Streams bytes into a COBS encoded buffer so the header, payload and CRC do not have to be copied together first.
+class CobsEncoder
+{
+	public:
+		CobsEncoder(uint8_t* output, size_t outputSize)
+				   : mp_Output(output)
+				   , m_OutputSize(outputSize)
+		{
+			if(m_OutputSize > 0) m_Length = 1;
+			else m_Overflow = true;
+		}
+		virtual ~CobsEncoder(){}
+
+		void Write(const void* data, size_t length)
+		{
+			const uint8_t* bytes = static_cast<const uint8_t*>(data);
+			for(size_t i = 0; i < length && !m_Overflow; ++i)
+			{
+				if(LINK_FRAME_DELIMITER == bytes[i])
+				{
+					CloseBlock();
+				}
+				else
+				{
+					if(!Put(bytes[i])) return;
+					if(0xFF == ++m_Code) CloseBlock();
+				}
+			}
+		}
+
+		//Closes the last block and appends the delimiter. Returns the encoded length or 0 if the output was too small.
+		size_t Finish()
+		{
+			if(m_Overflow) return 0;
+			mp_Output[m_CodeIndex] = m_Code;
+			if(!Put(LINK_FRAME_DELIMITER)) return 0;
+			return m_Length;
+		}
+
+	private:
+		uint8_t* mp_Output;
+		size_t m_OutputSize;
+		size_t m_Length = 0;
+		size_t m_CodeIndex = 0;
+		uint8_t m_Code = 1;
+		bool m_Overflow = false;
+
+		bool Put(uint8_t value)
+		{
+			if(m_Length >= m_OutputSize)
+			{
+				m_Overflow = true;
+				return false;
+			}
+			mp_Output[m_Length++] = value;
+			return true;
+		}
+		void CloseBlock()
+		{
+			mp_Output[m_CodeIndex] = m_Code;
+			m_CodeIndex = m_Length;
+			m_Code = 1;
+			Put(0);
+		}
+};
+
+//Decodes a COBS block without its delimiter. Decoding in place (output == input) is allowed.
+//Returns the decoded length or 0 if the block is malformed.
+inline size_t CobsDecode(const uint8_t* input, size_t length, uint8_t* output)
+{
+	size_t read = 0;
+	size_t written = 0;
+	while(read < length)
+	{
+		const uint8_t code = input[read++];
+		if(LINK_FRAME_DELIMITER == code || read + code - 1 > length) return 0;
+		for(uint8_t i = 1; i < code; ++i)
+		{
+			const uint8_t value = input[read++];
+			if(LINK_FRAME_DELIMITER == value) return 0;
+			output[written++] = value;
+		}
+		if(0xFF != code && read < length) output[written++] = 0;
+	}
+	return written;
+}
+
+//Encodes one frame whose payload is prefix | payload into output, so a timestamp can lead data that is already laid out.
+//Returns the number of bytes to send, delimiter included, or 0 if output is too small.
+inline size_t EncodeLinkFrame(const LinkFrameHeader_t &header, const void* prefix, size_t prefixLength, const void* payload, size_t payloadLength, uint8_t* output, size_t outputSize)
+{
+	uint16_t crc = LinkCrc16(reinterpret_cast<const uint8_t*>(&header), sizeof(header));
+	crc = LinkCrc16(static_cast<const uint8_t*>(prefix), prefixLength, crc);
+	crc = LinkCrc16(static_cast<const uint8_t*>(payload), payloadLength, crc);
+	const uint8_t crcBytes[LINK_FRAME_CRC_SIZE] = { static_cast<uint8_t>(crc & 0xFF), static_cast<uint8_t>(crc >> 8) };
+	CobsEncoder encoder(output, outputSize);
+	encoder.Write(&header, sizeof(header));
+	encoder.Write(prefix, prefixLength);
+	encoder.Write(payload, payloadLength);
+	encoder.Write(crcBytes, LINK_FRAME_CRC_SIZE);
+	return encoder.Finish();
+}
+
+//Encodes one frame into output. Returns the number of bytes to send, delimiter included, or 0 if output is too small.
+inline size_t EncodeLinkFrame(const LinkFrameHeader_t &header, const void* payload, size_t payloadLength, uint8_t* output, size_t outputSize)
+{
+	return EncodeLinkFrame(header, nullptr, 0, payload, payloadLength, output, outputSize);
+}
+
+//Moves the capture time of a LINK_FRAME_FLAG_TIMESTAMP frame out of its payload, leaving the frame as if it had been
+//sent without one. Returns false if the frame is too short to hold it.
+inline bool TakeLinkFrameTimestamp(LinkFrameView_t &view, uint32_t &timestampUs)
+{
+	if(view.PayloadLength < LINK_FRAME_TIMESTAMP_SIZE) return false;
+	memcpy(&timestampUs, view.Payload, LINK_FRAME_TIMESTAMP_SIZE);
+	view.Payload += LINK_FRAME_TIMESTAMP_SIZE;
+	view.PayloadLength -= LINK_FRAME_TIMESTAMP_SIZE;
+	view.Header.Flags &= ~LINK_FRAME_FLAG_TIMESTAMP;
+	return true;
+}
+
+//Decodes a received frame in place. frame holds the bytes before the delimiter. On success view points into frame,
+//so a 4 byte aligned frame buffer gives a 4 byte aligned payload.
+inline bool DecodeLinkFrame(uint8_t* frame, size_t length, LinkFrameView_t &view)
+{
+	const size_t decoded = CobsDecode(frame, length, frame);
+	if(decoded < sizeof(LinkFrameHeader_t) + LINK_FRAME_CRC_SIZE) return false;
+	const size_t crcIndex = decoded - LINK_FRAME_CRC_SIZE;
+	const uint16_t crcIn = static_cast<uint16_t>(frame[crcIndex]) | (static_cast<uint16_t>(frame[crcIndex + 1]) << 8);
+	if(crcIn != LinkCrc16(frame, crcIndex)) return false;
+	memcpy(&view.Header, frame, sizeof(LinkFrameHeader_t));
+	view.Payload = frame + sizeof(LinkFrameHeader_t);
+	view.PayloadLength = crcIndex - sizeof(LinkFrameHeader_t);
+	return true;
+}
+
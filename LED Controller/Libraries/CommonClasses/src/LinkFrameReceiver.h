@@ -0,0 +1,140 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "LinkFrame.h"
+
+//Byte at a time receiver for COBS link frames. Bytes are COBS decoded as they arrive into a fixed buffer,
+//so a complete frame only needs its CRC checked before it is handed out. Nothing is allocated.
+//
+//  while(serial.available())
+//  {
+//    if(receiver.Push(serial.read())) Dispatch(receiver.GetFrame());
+//  }
+template <size_t MAX_FRAME_SIZE>
+class LinkFrameReceiver
+{
+	static_assert(MAX_FRAME_SIZE >= sizeof(LinkFrameHeader_t) + LINK_FRAME_CRC_SIZE, "Buffer must hold an empty frame");
+	public:
+		LinkFrameReceiver(){}
+		virtual ~LinkFrameReceiver(){}
+
+		//Returns true when value completes a valid frame. The frame stays valid until the next Push.
+		inline bool Push(uint8_t value)
+		{
+			if(LINK_FRAME_DELIMITER == value)
+			{
+				const bool complete = EndFrame();
+				Reset();
+				return complete;
+			}
+			if(m_Discarding) return false;
+			if(0 == m_BlockRemaining)
+			{
+				//Code byte. The block before it ended with an implied zero unless it was a full 0xFF block.
+				if(m_InFrame && 0xFF != m_BlockCode && !Append(0)) return false;
+				m_BlockCode = value;
+				m_BlockRemaining = value - 1;
+				m_InFrame = true;
+			}
+			else
+			{
+				if(!Append(value)) return false;
+				--m_BlockRemaining;
+			}
+			return false;
+		}
+
+		//Pushes count bytes and returns how many were consumed. Stops after a complete frame so it can be handled first.
+		size_t Push(const uint8_t* values, size_t count, bool &frameReady)
+		{
+			frameReady = false;
+			for(size_t i = 0; i < count; ++i)
+			{
+				if(Push(values[i]))
+				{
+					frameReady = true;
+					return i + 1;
+				}
+			}
+			return count;
+		}
+
+		const LinkFrameView_t& GetFrame() const { return m_Frame; }
+		uint32_t GetFrameCount() const { return m_FrameCount; }
+		uint32_t GetCrcErrorCount() const { return m_CrcErrorCount; }
+		uint32_t GetFramingErrorCount() const { return m_FramingErrorCount; }
+		uint32_t GetOverrunCount() const { return m_OverrunCount; }
+
+	private:
+		alignas(4) uint8_t m_Buffer[MAX_FRAME_SIZE];
+		size_t m_Length = 0;
+		uint8_t m_BlockCode = 0;
+		uint8_t m_BlockRemaining = 0;
+		bool m_InFrame = false;
+		bool m_Discarding = false;
+		LinkFrameView_t m_Frame;
+		uint32_t m_FrameCount = 0;
+		uint32_t m_CrcErrorCount = 0;
+		uint32_t m_FramingErrorCount = 0;
+		uint32_t m_OverrunCount = 0;
+
+		inline bool Append(uint8_t value)
+		{
+			if(m_Length >= MAX_FRAME_SIZE)
+			{
+				++m_OverrunCount;
+				m_Discarding = true;
+				return false;
+			}
+			m_Buffer[m_Length++] = value;
+			return true;
+		}
+
+		bool EndFrame()
+		{
+			if(m_Discarding || !m_InFrame) return false;
+			if(0 != m_BlockRemaining || m_Length < sizeof(LinkFrameHeader_t) + LINK_FRAME_CRC_SIZE)
+			{
+				++m_FramingErrorCount;
+				return false;
+			}
+			const size_t crcIndex = m_Length - LINK_FRAME_CRC_SIZE;
+			const uint16_t crcIn = static_cast<uint16_t>(m_Buffer[crcIndex]) | (static_cast<uint16_t>(m_Buffer[crcIndex + 1]) << 8);
+			if(crcIn != LinkCrc16(m_Buffer, crcIndex))
+			{
+				++m_CrcErrorCount;
+				return false;
+			}
+			memcpy(&m_Frame.Header, m_Buffer, sizeof(LinkFrameHeader_t));
+			m_Frame.Payload = m_Buffer + sizeof(LinkFrameHeader_t);
+			m_Frame.PayloadLength = crcIndex - sizeof(LinkFrameHeader_t);
+			++m_FrameCount;
+			return true;
+		}
+
+		void Reset()
+		{
+			m_Length = 0;
+			m_BlockCode = 0;
+			m_BlockRemaining = 0;
+			m_InFrame = false;
+			m_Discarding = false;
+		}
+};
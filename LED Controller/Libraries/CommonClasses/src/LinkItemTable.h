@@ -0,0 +1,110 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+//Fixed size open addressed table from link item id to a pointer. The id is already a hash of the
+//item name, so its low bits index the slot array directly and a lookup is one or two probes.
+//Keep SIZE at least twice the number of registered items.
+template <typename T, size_t SIZE>
+class LinkItemTable
+{
+	static_assert(SIZE > 0 && (SIZE & (SIZE - 1)) == 0, "SIZE must be a power of 2");
+	public:
+		LinkItemTable(){}
+		virtual ~LinkItemTable(){}
+
+		//Returns false if the id is already taken or the table is full. One slot always stays empty so Find terminates.
+		bool Insert(uint16_t id, T* item)
+		{
+			if(nullptr == item || m_Count + 1 >= SIZE) return false;
+			size_t index = id & MASK;
+			while(m_Slots[index].Item)
+			{
+				if(id == m_Slots[index].Id) return false;
+				index = (index + 1) & MASK;
+			}
+			m_Slots[index].Id = id;
+			m_Slots[index].Item = item;
+			++m_Count;
+			return true;
+		}
+
+		inline T* Find(uint16_t id) const
+		{
+			size_t index = id & MASK;
+			while(m_Slots[index].Item)
+			{
+				if(id == m_Slots[index].Id) return m_Slots[index].Item;
+				index = (index + 1) & MASK;
+			}
+			return nullptr;
+		}
+
+		bool Remove(uint16_t id)
+		{
+			size_t index = id & MASK;
+			while(m_Slots[index].Item && id != m_Slots[index].Id)
+			{
+				index = (index + 1) & MASK;
+			}
+			if(nullptr == m_Slots[index].Item) return false;
+			m_Slots[index].Item = nullptr;
+			--m_Count;
+			//Shift later entries of the same probe run back so Find never stops early at the hole
+			size_t hole = index;
+			size_t next = (index + 1) & MASK;
+			while(m_Slots[next].Item)
+			{
+				const size_t home = m_Slots[next].Id & MASK;
+				if(((next - home) & MASK) >= ((next - hole) & MASK))
+				{
+					m_Slots[hole] = m_Slots[next];
+					m_Slots[next].Item = nullptr;
+					hole = next;
+				}
+				next = (next + 1) & MASK;
+			}
+			return true;
+		}
+
+		size_t GetCount() const { return m_Count; }
+
+		//Calls visit(id, item) for every item, in slot order
+		template <typename Visitor>
+		void ForEach(Visitor visit) const
+		{
+			for(size_t i = 0; i < SIZE; ++i)
+			{
+				if(m_Slots[i].Item) visit(m_Slots[i].Id, m_Slots[i].Item);
+			}
+		}
+
+	private:
+		static constexpr size_t MASK = SIZE - 1;
+		struct Slot_t
+		{
+			uint16_t Id = 0;
+			T* Item = nullptr;
+		};
+		Slot_t m_Slots[SIZE];
+		size_t m_Count = 0;
+};
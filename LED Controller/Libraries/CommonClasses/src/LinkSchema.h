@@ -0,0 +1,64 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include "DataTypes.h"
+#include "LinkFrame.h"
+
+//Payload record of the schema frames. Each side lists the items it sends, and the receiver checks every entry
+//against the item it delivers to, once per connection rather than on every frame. Items go by their link id,
+//which both sides already derive from the name, so no names cross the link.
+struct __attribute__((packed)) LinkSchemaEntry_t
+{
+	uint16_t ItemId = 0;
+	uint8_t DataType = DataType_Undef;     //LINK_DATATYPE_FLAG_ENCODED is set for values sent through the link codec
+	uint16_t Count = 0;                    //0 if the sender does not know it
+};
+
+enum LinkSchemaCheck_t
+{
+	LinkSchemaCheck_Match,
+	LinkSchemaCheck_TypeMismatch,
+	LinkSchemaCheck_CountMismatch,
+	LinkSchemaCheck_NotDecodable,          //Coded values for an item without a link decoder
+};
+
+inline const char* GetLinkSchemaCheckString(LinkSchemaCheck_t check)
+{
+	switch(check)
+	{
+		case LinkSchemaCheck_Match: return "Match";
+		case LinkSchemaCheck_TypeMismatch: return "Type Mismatch";
+		case LinkSchemaCheck_CountMismatch: return "Count Mismatch";
+		case LinkSchemaCheck_NotDecodable: return "Not Decodable";
+		default: return "Unknown";
+	}
+}
+
+//Checks what the peer sends against the receiving item. Types or counts either side does not know are not compared.
+inline LinkSchemaCheck_t CheckLinkSchemaEntry(const LinkSchemaEntry_t &entry, DataType_t localType, size_t localCount, bool localDecoder)
+{
+	const uint8_t peerType = entry.DataType & ~LINK_DATATYPE_FLAG_ENCODED;
+	if(DataType_Undef != peerType && DataType_Undef != localType && peerType != localType) return LinkSchemaCheck_TypeMismatch;
+	if(0 != entry.Count && entry.Count != localCount) return LinkSchemaCheck_CountMismatch;
+	if((entry.DataType & LINK_DATATYPE_FLAG_ENCODED) && !localDecoder) return LinkSchemaCheck_NotDecodable;
+	return LinkSchemaCheck_Match;
+}
@@ -0,0 +1,152 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <mutex>
+#include "LinkFrame.h"
+#include "LinkTxRing.h"
+
+//Buffering for a transport that moves link frames in fixed size transactions, kept apart from the hardware.
+//
+//TX is double buffered. Frames are written into the fill buffer while the previous transaction is still being
+//clocked out of the other one, and BeginTransfer swaps the two. The unused end of a transaction is padded with
+//frame delimiters, which the receiver sees as empty frames. A frame is only ever written whole, so padding can
+//never land inside one.
+//
+//RX keeps each received transaction, padding trimmed, in a ring that the reader drains as a byte stream.
+//One writer, one transfer task and one reader may run concurrently.
+//
+//  Transfer task:  Exchange(buffer.BeginTransfer(), rx, TRANSFER_SIZE); buffer.Receive(rx, TRANSFER_SIZE);
+//  Writer:         while(!buffer.Write(frame, length)) WaitForTheNextTransfer();
+//  Reader:         while(buffer.Available()) Push(data, buffer.Read(data, sizeof(data)));
+template <size_t TRANSFER_SIZE, size_t RX_RING_SIZE>
+class LinkTransferBuffer
+{
+	static_assert(0 == TRANSFER_SIZE % 4, "DMA transactions are a multiple of 4 bytes");
+	public:
+		LinkTransferBuffer(){}
+		virtual ~LinkTransferBuffer(){}
+
+		//Both buffers are TRANSFER_SIZE bytes and must be DMA capable
+		void SetTxBuffers(uint8_t* first, uint8_t* second)
+		{
+			std::lock_guard<std::mutex> lock(m_TxMutex);
+			mp_Fill = first;
+			mp_Transfer = second;
+			m_FillLength = 0;
+		}
+
+		//Copies the frame into the fill buffer. Returns false, copying nothing, if it does not fit until the next transfer.
+		bool Write(const uint8_t* frame, size_t length)
+		{
+			std::lock_guard<std::mutex> lock(m_TxMutex);
+			if(!mp_Fill || length > TRANSFER_SIZE - m_FillLength) return false;
+			memcpy(mp_Fill + m_FillLength, frame, length);
+			m_FillLength += length;
+			return true;
+		}
+
+		bool HasTxData()
+		{
+			std::lock_guard<std::mutex> lock(m_TxMutex);
+			return m_FillLength > 0;
+		}
+
+		//Pads the fill buffer and hands it to the transaction, the other buffer takes the next frames.
+		//The returned buffer holds TRANSFER_SIZE bytes and stays untouched until the following call.
+		const uint8_t* BeginTransfer()
+		{
+			std::lock_guard<std::mutex> lock(m_TxMutex);
+			if(!mp_Fill) return nullptr;
+			std::swap(mp_Fill, mp_Transfer);
+			memset(mp_Transfer + m_FillLength, LINK_FRAME_DELIMITER, TRANSFER_SIZE - m_FillLength);
+			m_TxBytes += m_FillLength;
+			m_FillLength = 0;
+			return mp_Transfer;
+		}
+
+		//Stores the bytes of a completed transaction for the reader. Returns false if the ring had no room for them.
+		bool Receive(const uint8_t* data, size_t length)
+		{
+			length = GetReceivedLength(data, length);
+			if(0 == length) return true;
+			uint8_t* slot = m_RxRing.Reserve(length);
+			if(!slot) return false;
+			memcpy(slot, data, length);
+			m_RxRing.Commit(length);
+			return true;
+		}
+
+		//Bytes the reader can take in one Read
+		size_t Available()
+		{
+			if(!mp_ReadData)
+			{
+				if(!m_RxRing.Peek(mp_ReadData, m_ReadLength)) return 0;
+				m_ReadOffset = 0;
+			}
+			return m_ReadLength - m_ReadOffset;
+		}
+
+		size_t Read(uint8_t* buffer, size_t size)
+		{
+			size_t count = 0;
+			size_t available;
+			while(count < size && (available = Available()) > 0)
+			{
+				const size_t take = std::min(available, size - count);
+				memcpy(buffer + count, mp_ReadData + m_ReadOffset, take);
+				m_ReadOffset += take;
+				count += take;
+				if(m_ReadOffset == m_ReadLength)
+				{
+					m_RxRing.Consume();
+					mp_ReadData = nullptr;
+				}
+			}
+			return count;
+		}
+
+		//Frame bytes sent, padding excluded
+		uint32_t GetTxBytes()
+		{
+			std::lock_guard<std::mutex> lock(m_TxMutex);
+			return m_TxBytes;
+		}
+
+		//Length of a transaction without its padding. One delimiter is kept to close the last frame.
+		static size_t GetReceivedLength(const uint8_t* data, size_t length)
+		{
+			size_t used = length;
+			while(used > 0 && LINK_FRAME_DELIMITER == data[used - 1]) --used;
+			return (used > 0 && used < length) ? used + 1 : used;
+		}
+
+	private:
+		std::mutex m_TxMutex;
+		uint8_t* mp_Fill = nullptr;
+		uint8_t* mp_Transfer = nullptr;
+		size_t m_FillLength = 0;
+		uint32_t m_TxBytes = 0;
+		LinkTxRing<RX_RING_SIZE> m_RxRing;
+		const uint8_t* mp_ReadData = nullptr;
+		size_t m_ReadLength = 0;
+		size_t m_ReadOffset = 0;
+};
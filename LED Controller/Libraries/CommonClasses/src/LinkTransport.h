@@ -0,0 +1,61 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <HardwareSerial.h>
+#include <Arduino.h>
+#include <functional>
+
+//Called by the transport when bytes arrive, so the reader can sleep instead of polling
+typedef std::function<void(void)> TransportRxCallback_t;
+//Transports report what they lost with the UART driver's error kinds, so every link feeds the same statistics
+typedef std::function<void(hardwareSerial_error_t)> TransportRxErrorCallback_t;
+
+//Byte stream a SerialPortMessageManager sends its link frames over. Write is called from the TX task with one
+//whole frame at a time, Available and Read from the RX task.
+class ITransport
+{
+	public:
+		ITransport(){}
+		virtual ~ITransport(){}
+		virtual int Available() = 0;
+		virtual size_t Read(uint8_t* buffer, size_t size) = 0;
+		//Returns the bytes written, 0 if the frame could not be sent
+		virtual size_t Write(const uint8_t* buffer, size_t size) = 0;
+		//Pass nullptr to stop the callbacks
+		virtual void SetRxCallbacks(TransportRxCallback_t onReceive, TransportRxErrorCallback_t onError) = 0;
+};
+
+//The UART links, driven by the HardwareSerial driver and its event task
+class UartTransport: public ITransport
+{
+	public:
+		UartTransport(HardwareSerial* serial = nullptr): mp_Serial(serial){}
+		virtual ~UartTransport(){}
+		int Available() override { return mp_Serial->available(); }
+		size_t Read(uint8_t* buffer, size_t size) override { return mp_Serial->read(buffer, size); }
+		size_t Write(const uint8_t* buffer, size_t size) override { return mp_Serial->write(buffer, size); }
+		void SetRxCallbacks(TransportRxCallback_t onReceive, TransportRxErrorCallback_t onError) override
+		{
+			mp_Serial->onReceive(onReceive);
+			mp_Serial->onReceiveError(onError);
+		}
+		HardwareSerial* GetSerial() const { return mp_Serial; }
+	private:
+		HardwareSerial* mp_Serial = nullptr;
+};
@@ -0,0 +1,209 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "LinkFrame.h"
+
+struct LinkTxStats_t
+{
+	uint32_t Updates = 0;          //Values handed to Stage
+	uint32_t Coalesced = 0;        //Values replaced before they were sent
+	uint32_t Frames = 0;
+	uint32_t Records = 0;
+	uint32_t Bytes = 0;            //Encoded bytes produced
+	uint32_t UnbatchedBytes = 0;   //Bytes the same updates would have cost as one frame each
+	uint32_t Retransmits = 0;      //Values queued again while already waiting, sent once from the staged record
+};
+
+//Collects DataItem updates between flushes and encodes them as one link frame. An update for an item that is
+//already waiting replaces the waiting value, so only the latest value of each item goes out per flush.
+//Records are laid out in their wire format as they are staged, so a flush is a single frame encode of the arena.
+//Not thread safe, the owner serializes Stage and Flush.
+template <size_t ARENA_SIZE, size_t MAX_RECORDS>
+class LinkTxBatcher
+{
+	static_assert(ARENA_SIZE % 4 == 0, "Arena must keep records 4 byte aligned");
+	static_assert(ARENA_SIZE <= UINT16_MAX, "Record offsets are 16 bit");
+	public:
+		LinkTxBatcher(){}
+		virtual ~LinkTxBatcher(){}
+
+		//Values that can never be batched have to be sent as a frame of their own
+		static constexpr bool CanStage(size_t length, size_t count)
+		{
+			return count <= LINK_BATCH_MAX_COUNT && sizeof(LinkBatchRecordHeader_t) + LINK_BATCH_ALIGN(length) <= ARENA_SIZE;
+		}
+
+		//length is the data size for dataType * count. Returns false if the value does not fit in what is left of the batch.
+		//coalesced is set when the value replaced one that was already waiting.
+		bool Stage(uint16_t itemId, uint8_t dataType, const void* object, size_t length, size_t count, uint32_t changeCount, bool* coalesced = nullptr)
+		{
+			if(coalesced) *coalesced = false;
+			if(!CanStage(length, count)) return false;
+			for(size_t i = 0; i < m_RecordCount; ++i)
+			{
+				if(itemId == m_Records[i].ItemId)
+				{
+					LinkBatchRecordHeader_t* header = GetRecordHeader(i);
+					if(header->DataType != dataType || header->Count != count) return false;
+					if(m_Records[i].Length != length)
+					{
+						//Encoded values change length, the waiting record moves to the end with its new size
+						const size_t oldSize = sizeof(LinkBatchRecordHeader_t) + LINK_BATCH_ALIGN(m_Records[i].Length);
+						if(m_Used - oldSize + sizeof(LinkBatchRecordHeader_t) + LINK_BATCH_ALIGN(length) > ARENA_SIZE) return false;
+						RemoveRecord(i);
+						Append(itemId, dataType, object, length, count, changeCount);
+					}
+					else
+					{
+						memcpy(m_Arena + m_Records[i].Offset + sizeof(LinkBatchRecordHeader_t), object, length);
+						header->ChangeCount = changeCount;
+					}
+					CountUpdate(length);
+					++m_Stats.Coalesced;
+					if(coalesced) *coalesced = true;
+					return true;
+				}
+			}
+			if(m_RecordCount >= MAX_RECORDS || m_Used + sizeof(LinkBatchRecordHeader_t) + LINK_BATCH_ALIGN(length) > ARENA_SIZE) return false;
+			Append(itemId, dataType, object, length, count, changeCount);
+			CountUpdate(length);
+			return true;
+		}
+
+		//Encodes everything staged into output and empties the batch. A single record goes out as a plain frame.
+		//A timestamp, if given, leads the payload and sets LINK_FRAME_FLAG_TIMESTAMP.
+		//Returns the encoded length including the delimiter, 0 if nothing was staged or output is too small.
+		size_t Flush(uint8_t sequence, uint8_t* output, size_t outputSize, const uint32_t* timestampUs = nullptr)
+		{
+			if(0 == m_RecordCount) return 0;
+			const size_t timestampLength = timestampUs ? LINK_FRAME_TIMESTAMP_SIZE : 0;
+			const uint16_t flags = timestampUs ? LINK_FRAME_FLAG_TIMESTAMP : 0;
+			size_t length;
+			if(1 == m_RecordCount)
+			{
+				const LinkBatchRecordHeader_t* record = GetRecordHeader(0);
+				LinkFrameHeader_t header;
+				header.ItemId = record->ItemId;
+				header.DataType = record->DataType;
+				header.Sequence = sequence;
+				header.Count = record->Count;
+				header.Flags = flags;
+				header.ChangeCount = record->ChangeCount;
+				length = EncodeLinkFrame(header, timestampUs, timestampLength, m_Arena + sizeof(LinkBatchRecordHeader_t), m_Records[0].Length, output, outputSize);
+			}
+			else
+			{
+				LinkFrameHeader_t header;
+				header.Sequence = sequence;
+				header.Count = m_RecordCount;
+				header.Flags = LINK_FRAME_FLAG_BATCH | flags;
+				length = EncodeLinkFrame(header, timestampUs, timestampLength, m_Arena, m_Used, output, outputSize);
+			}
+			if(length > 0)
+			{
+				++m_Stats.Frames;
+				m_Stats.Records += m_RecordCount;
+				m_Stats.Bytes += length;
+			}
+			m_RecordCount = 0;
+			m_Used = 0;
+			return length;
+		}
+
+		bool IsStaged(uint16_t itemId) const
+		{
+			for(size_t i = 0; i < m_RecordCount; ++i)
+			{
+				if(itemId == m_Records[i].ItemId) return true;
+			}
+			return false;
+		}
+		//True if itemId is waiting with changeCount, so the record already holds that value
+		bool IsStaged(uint16_t itemId, uint32_t changeCount) const
+		{
+			for(size_t i = 0; i < m_RecordCount; ++i)
+			{
+				if(itemId == m_Records[i].ItemId)
+				{
+					return changeCount == reinterpret_cast<const LinkBatchRecordHeader_t*>(m_Arena + m_Records[i].Offset)->ChangeCount;
+				}
+			}
+			return false;
+		}
+		//Counts a value that was not staged because IsStaged found it waiting
+		void CountRetransmit() { ++m_Stats.Retransmits; }
+		bool IsEmpty() const { return 0 == m_RecordCount; }
+		size_t GetRecordCount() const { return m_RecordCount; }
+		const LinkTxStats_t& GetStats() const { return m_Stats; }
+
+	private:
+		struct PendingRecord_t
+		{
+			uint16_t ItemId = 0;
+			uint16_t Offset = 0;
+			uint16_t Length = 0;
+		};
+		alignas(4) uint8_t m_Arena[ARENA_SIZE];
+		PendingRecord_t m_Records[MAX_RECORDS];
+		size_t m_RecordCount = 0;
+		size_t m_Used = 0;
+		LinkTxStats_t m_Stats;
+
+		LinkBatchRecordHeader_t* GetRecordHeader(size_t index)
+		{
+			return reinterpret_cast<LinkBatchRecordHeader_t*>(m_Arena + m_Records[index].Offset);
+		}
+		//Caller checked there is room
+		void Append(uint16_t itemId, uint8_t dataType, const void* object, size_t length, size_t count, uint32_t changeCount)
+		{
+			const size_t needed = sizeof(LinkBatchRecordHeader_t) + LINK_BATCH_ALIGN(length);
+			LinkBatchRecordHeader_t header;
+			header.ItemId = itemId;
+			header.DataType = dataType;
+			header.Count = count;
+			header.ChangeCount = changeCount;
+			memcpy(m_Arena + m_Used, &header, sizeof(header));
+			memcpy(m_Arena + m_Used + sizeof(header), object, length);
+			memset(m_Arena + m_Used + sizeof(header) + length, 0, needed - sizeof(header) - length);
+			m_Records[m_RecordCount].ItemId = itemId;
+			m_Records[m_RecordCount].Offset = m_Used;
+			m_Records[m_RecordCount].Length = length;
+			++m_RecordCount;
+			m_Used += needed;
+		}
+		void RemoveRecord(size_t index)
+		{
+			const size_t offset = m_Records[index].Offset;
+			const size_t size = sizeof(LinkBatchRecordHeader_t) + LINK_BATCH_ALIGN(m_Records[index].Length);
+			memmove(m_Arena + offset, m_Arena + offset + size, m_Used - offset - size);
+			for(size_t i = index; i + 1 < m_RecordCount; ++i)
+			{
+				m_Records[i] = m_Records[i + 1];
+				m_Records[i].Offset -= size;
+			}
+			--m_RecordCount;
+			m_Used -= size;
+		}
+		void CountUpdate(size_t length)
+		{
+			++m_Stats.Updates;
+			m_Stats.UnbatchedBytes += LINK_FRAME_MAX_ENCODED_SIZE(length);
+		}
+};
@@ -0,0 +1,141 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+//Ring of variable length messages. Each message takes a 2 byte length plus its own bytes and is never split
+//across the end of the buffer, so the writer encodes straight into the ring and the reader hands out a pointer
+//into it. Safe for one writer and one reader running concurrently; several writers must share a lock.
+//
+//  Writer:  if(uint8_t* slot = ring.Reserve(maxLength)) ring.Commit(Encode(slot, maxLength));
+//  Reader:  while(ring.Peek(data, length)) { Send(data, length); ring.Consume(); }
+template <size_t SIZE>
+class LinkTxRing
+{
+	public:
+		LinkTxRing(){}
+		virtual ~LinkTxRing(){}
+
+		//Returns space for a message of up to maxLength bytes, or nullptr if there is not enough free space.
+		//Nothing is visible to the reader until Commit.
+		uint8_t* Reserve(size_t maxLength)
+		{
+			if(maxLength >= WRAP_MARKER) return nullptr;
+			const size_t needed = LENGTH_SIZE + maxLength;
+			const size_t head = m_Head.load(std::memory_order_relaxed);
+			const size_t tail = m_Tail.load(std::memory_order_acquire);
+			m_Wrap = false;
+			if(head >= tail)
+			{
+				//Filling to the very end is only allowed if the head can then move to 0 without meeting the tail
+				const size_t spaceAtEnd = SIZE - head;
+				if(needed < spaceAtEnd || (needed == spaceAtEnd && tail > 0))
+				{
+					m_ReserveIndex = head;
+				}
+				else if(needed < tail)
+				{
+					m_ReserveIndex = 0;
+					m_Wrap = true;
+				}
+				else return nullptr;
+			}
+			else if(needed < tail - head)
+			{
+				m_ReserveIndex = head;
+			}
+			else return nullptr;
+			return m_Buffer + m_ReserveIndex + LENGTH_SIZE;
+		}
+
+		//Publishes the reserved message with its final length. length must not exceed the reserved size.
+		void Commit(size_t length)
+		{
+			if(m_Wrap)
+			{
+				const size_t head = m_Head.load(std::memory_order_relaxed);
+				if(SIZE - head >= LENGTH_SIZE) WriteLength(head, WRAP_MARKER);
+			}
+			WriteLength(m_ReserveIndex, length);
+			size_t head = m_ReserveIndex + LENGTH_SIZE + length;
+			if(SIZE == head) head = 0;
+			m_Head.store(head, std::memory_order_release);
+		}
+
+		//Points data at the oldest message. Returns false if the ring is empty.
+		bool Peek(const uint8_t* &data, size_t &length)
+		{
+			size_t tail = m_Tail.load(std::memory_order_relaxed);
+			const size_t head = m_Head.load(std::memory_order_acquire);
+			if(tail == head) return false;
+			if(SIZE - tail < LENGTH_SIZE || WRAP_MARKER == ReadLength(tail))
+			{
+				tail = 0;
+			}
+			length = ReadLength(tail);
+			data = m_Buffer + tail + LENGTH_SIZE;
+			m_NextTail = tail + LENGTH_SIZE + length;
+			if(SIZE == m_NextTail) m_NextTail = 0;
+			return true;
+		}
+
+		//Releases the message returned by the last Peek
+		void Consume()
+		{
+			m_Tail.store(m_NextTail, std::memory_order_release);
+		}
+
+		bool IsEmpty() const { return m_Head.load(std::memory_order_acquire) == m_Tail.load(std::memory_order_acquire); }
+
+		//Bytes in use, length headers and skipped space at the end included
+		size_t GetUsed() const
+		{
+			const size_t head = m_Head.load(std::memory_order_acquire);
+			const size_t tail = m_Tail.load(std::memory_order_acquire);
+			return (head >= tail) ? head - tail : SIZE - tail + head;
+		}
+
+		static constexpr size_t GetSize() { return SIZE; }
+
+	private:
+		static constexpr size_t LENGTH_SIZE = sizeof(uint16_t);
+		static constexpr uint16_t WRAP_MARKER = 0xFFFF;
+		static_assert(SIZE > 2 * LENGTH_SIZE, "Ring too small");
+		uint8_t m_Buffer[SIZE];
+		std::atomic<size_t> m_Head = {0};
+		std::atomic<size_t> m_Tail = {0};
+		size_t m_ReserveIndex = 0;
+		bool m_Wrap = false;
+		size_t m_NextTail = 0;
+
+		void WriteLength(size_t index, uint16_t length)
+		{
+			memcpy(m_Buffer + index, &length, LENGTH_SIZE);
+		}
+		uint16_t ReadLength(size_t index) const
+		{
+			uint16_t length;
+			memcpy(&length, m_Buffer + index, LENGTH_SIZE);
+			return length;
+		}
+};
@@ -0,0 +1,133 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <algorithm>
+#include <mutex>
+#include <vector>
+#include "LinkTransport.h"
+
+#define LOOPBACK_TRANSPORT_BUFFER_SIZE 4096     //Bytes each end holds for its reader, the size of the UART RX buffers
+
+//In-memory link between two managers in the same process, for tests and host benchmarks. Bytes written to one end
+//are read from the other, and the other end's receive callback runs on the writer's thread the way the UART event
+//task calls it. A write that does not fit the far end is dropped whole and reported as UART_BUFFER_FULL_ERROR.
+//
+//  LoopbackTransport a, b;
+//  LoopbackTransport::Connect(a, b);
+//  SerialPortMessageManager managerA("A", &a, &serializer);
+//  SerialPortMessageManager managerB("B", &b, &serializer);
+class LoopbackTransport: public ITransport
+{
+	public:
+		LoopbackTransport(size_t bufferSize = LOOPBACK_TRANSPORT_BUFFER_SIZE): m_Buffer(bufferSize){}
+		virtual ~LoopbackTransport()
+		{
+			Disconnect();
+		}
+
+		static void Connect(LoopbackTransport& a, LoopbackTransport& b)
+		{
+			a.Disconnect();
+			b.Disconnect();
+			{
+				std::lock_guard<std::mutex> lock(a.m_PeerMutex);
+				a.mp_Peer = &b;
+			}
+			std::lock_guard<std::mutex> lock(b.m_PeerMutex);
+			b.mp_Peer = &a;
+		}
+
+		void Disconnect()
+		{
+			LoopbackTransport* peer;
+			{
+				std::lock_guard<std::mutex> lock(m_PeerMutex);
+				peer = mp_Peer;
+				mp_Peer = nullptr;
+			}
+			if(!peer) return;
+			std::lock_guard<std::mutex> lock(peer->m_PeerMutex);
+			if(this == peer->mp_Peer) peer->mp_Peer = nullptr;
+		}
+
+		int Available() override
+		{
+			std::lock_guard<std::mutex> lock(m_BufferMutex);
+			return static_cast<int>(m_Count);
+		}
+
+		size_t Read(uint8_t* buffer, size_t size) override
+		{
+			std::lock_guard<std::mutex> lock(m_BufferMutex);
+			const size_t count = std::min(size, m_Count);
+			for(size_t i = 0; i < count; ++i)
+			{
+				buffer[i] = m_Buffer[m_Head];
+				m_Head = (m_Head + 1) % m_Buffer.size();
+			}
+			m_Count -= count;
+			return count;
+		}
+
+		size_t Write(const uint8_t* buffer, size_t size) override
+		{
+			std::lock_guard<std::mutex> lock(m_PeerMutex);
+			return mp_Peer ? mp_Peer->Receive(buffer, size) : 0;
+		}
+
+		void SetRxCallbacks(TransportRxCallback_t onReceive, TransportRxErrorCallback_t onError) override
+		{
+			std::lock_guard<std::mutex> lock(m_CallbackMutex);
+			m_OnReceive = onReceive;
+			m_OnError = onError;
+		}
+
+	private:
+		std::mutex m_PeerMutex;
+		LoopbackTransport* mp_Peer = nullptr;
+		std::mutex m_BufferMutex;
+		std::vector<uint8_t> m_Buffer;
+		size_t m_Head = 0;
+		size_t m_Count = 0;
+		std::mutex m_CallbackMutex;
+		TransportRxCallback_t m_OnReceive;
+		TransportRxErrorCallback_t m_OnError;
+
+		size_t Receive(const uint8_t* data, size_t size)
+		{
+			bool stored = false;
+			{
+				std::lock_guard<std::mutex> lock(m_BufferMutex);
+				if(size <= m_Buffer.size() - m_Count)
+				{
+					for(size_t i = 0; i < size; ++i) m_Buffer[(m_Head + m_Count + i) % m_Buffer.size()] = data[i];
+					m_Count += size;
+					stored = true;
+				}
+			}
+			std::lock_guard<std::mutex> lock(m_CallbackMutex);
+			if(!stored)
+			{
+				if(m_OnError) m_OnError(UART_BUFFER_FULL_ERROR);
+				return 0;
+			}
+			if(m_OnReceive) m_OnReceive();
+			return size;
+		}
+};
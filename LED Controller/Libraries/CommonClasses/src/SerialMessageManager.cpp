@@ -33,8 +33,21 @@ void Named_Object_Caller_Interface::RegisterForNewRxValueNotification(Named_Obje
 	}
 	if(false == IsFound)
 	{
-		ESP_LOGD("RegisterForNewRxValueNotification", "Callee Registered");
-		m_NewValueCallees.push_back(NewCallee);
+		const uint16_t ItemId = NewCallee->GetItemId();
+		if(m_CalleeTable.Insert(ItemId, NewCallee))
+		{
+			ESP_LOGD("RegisterForNewRxValueNotification", "Callee Registered");
+			m_NewValueCallees.push_back(NewCallee);
+		}
+		else if(Named_Object_Callee_Interface* existing = m_CalleeTable.Find(ItemId))
+		{
+			ESP_LOGE( "RegisterForNewRxValueNotification", "ERROR! Item Id Collision between \"%s\" and \"%s\"."
+					, NewCallee->GetName().c_str(), existing->GetName().c_str() );
+		}
+		else
+		{
+			ESP_LOGE("RegisterForNewRxValueNotification", "ERROR! \"%s\": Callee Table Full.", NewCallee->GetName().c_str());
+		}
 	}
 }
 
@@ -44,6 +57,7 @@ void Named_Object_Caller_Interface::DeRegisterForNewRxValueNotification(Named_Ob
 	auto it = std::find(m_NewValueCallees.begin(), m_NewValueCallees.end(), Callee);
 	if (it != m_NewValueCallees.end()) {
 		ESP_LOGD("RegisterForNewRxValueNotification", "Callee DeRegistered");
+		m_CalleeTable.Remove(Callee->GetItemId());
 		m_NewValueCallees.erase(it);
 	}
 }
@@ -68,6 +82,67 @@ void Named_Object_Caller_Interface::Call_Named_Object_Callback(const String& nam
 	if(!found) ESP_LOGE("NewRxValueReceived", "ERROR! Rx Value Callee Not Found Found: \"%s\"", name.c_str());
 }
 
+void Named_Object_Caller_Interface::Call_Item_Id_Callback(uint16_t itemId, void* object, const size_t count, const size_t changeCount)
+{
+	Named_Object_Callee_Interface* callee = m_CalleeTable.Find(itemId);
+	if (nullptr == callee)
+	{
+		ESP_LOGE("Call_Item_Id_Callback", "ERROR! Rx Value Callee Not Found for Item Id: \"%04X\"", itemId);
+	}
+	else if(count == callee->GetCount())
+	{
+		ESP_LOGD("Call_Item_Id_Callback", "Callee Found: \"%s\"", callee->GetName().c_str());
+		callee->New_Object_From_Sender(this, object, changeCount);
+	}
+	else
+	{
+		ESP_LOGE("Call_Item_Id_Callback", "ERROR! \"%s\": Count Mismatch: \"%i != %i\"", callee->GetName().c_str(), count, callee->GetCount());
+	}
+}
+
+void Named_Object_Caller_Interface::Call_Item_Id_Encoded_Callback(uint16_t itemId, const uint8_t* payload, size_t length, const size_t count, const size_t changeCount)
+{
+	Named_Object_Callee_Interface* callee = m_CalleeTable.Find(itemId);
+	LinkFloatDecoder* decoder = callee ? callee->GetLinkDecoder() : nullptr;
+	if (nullptr == callee)
+	{
+		ESP_LOGE("Call_Item_Id_Encoded_Callback", "ERROR! Rx Value Callee Not Found for Item Id: \"%04X\"", itemId);
+	}
+	else if(nullptr == decoder || count != callee->GetCount())
+	{
+		ESP_LOGE("Call_Item_Id_Encoded_Callback", "ERROR! \"%s\": Unable to Decode \"%i\" Values", callee->GetName().c_str(), count);
+	}
+	else
+	{
+		float values[LINK_CODEC_MAX_COUNT];
+		if(decoder->Decode(payload, length, values, count))
+		{
+			callee->New_Object_From_Sender(this, values, changeCount);
+		}
+		else
+		{
+			ESP_LOGD("Call_Item_Id_Encoded_Callback", "\"%s\": Waiting for Key Frame", callee->GetName().c_str());
+		}
+	}
+}
+
+void SerialPortMessageManager::RegisterTxItem(uint16_t itemId, LinkTxItem_t* item)
+{
+	if(!m_TxItems.Insert(itemId, item))
+	{
+		ESP_LOGE("RegisterTxItem", "ERROR! \"%s\" Unable to Register TX Item: \"%04X\"", m_Name.c_str(), itemId);
+	}
+	else
+	{
+		m_SchemaVersion.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+void SerialPortMessageManager::DeRegisterTxItem(uint16_t itemId)
+{
+	if(m_TxItems.Remove(itemId)) m_SchemaVersion.fetch_add(1, std::memory_order_relaxed);
+}
+
 void SerialPortMessageManager::Setup()
 {
 	if(xTaskCreatePinnedToCore( StaticSerialPortMessageManager_RxTask, m_Name.c_str(), 5000, this,  THREAD_PRIORITY_HIGH,  &m_RXTaskHandle,  m_CoreId ) == pdPASS)
@@ -77,10 +152,71 @@ void SerialPortMessageManager::Setup()
 	if(xTaskCreatePinnedToCore( StaticSerialPortMessageManager_TxTask, m_Name.c_str(), 5000, this,  THREAD_PRIORITY_HIGH,  &m_TXTaskHandle,  m_CoreId ) == pdPASS)
 	ESP_LOGD("Setup", "TX Task Created.");
 	else ESP_LOGE("Setup", "ERROR! Error creating the TX Task.");
-	
-	if(m_TXQueue = xQueueCreate(MaxQueueCount, sizeof(char) * MaxMessageLength ))
-	ESP_LOGD("Setup", "TX Queue Created.");
-	else ESP_LOGE("Setup", "ERROR! Error creating the TX Queue.");
+
+	//The transport wakes the RX task as data arrives and reports what it lost
+	if(mp_Transport)
+	{
+		mp_Transport->SetRxCallbacks([this](){ NotifyRx(); }, [this](hardwareSerial_error_t Error){ HandleRxError(Error); });
+	}
+}
+
+void SerialPortMessageManager::NotifyRx()
+{
+	if(m_RXTaskHandle) xTaskNotifyGive(m_RXTaskHandle);
+}
+
+void SerialPortMessageManager::HandleRxError(hardwareSerial_error_t Error)
+{
+	switch(Error)
+	{
+		case UART_FIFO_OVF_ERROR:
+			m_RxFifoOverflows.fetch_add(1, std::memory_order_relaxed);
+			break;
+		case UART_BUFFER_FULL_ERROR:
+			m_RxBufferFull.fetch_add(1, std::memory_order_relaxed);
+			break;
+		case UART_BREAK_ERROR:
+		case UART_FRAME_ERROR:
+		case UART_PARITY_ERROR:
+			m_RxLineErrors.fetch_add(1, std::memory_order_relaxed);
+			break;
+		default:
+			break;
+	}
+	NotifyRx();
+}
+
+LinkRxStats_t SerialPortMessageManager::GetRxStats() const
+{
+	LinkRxStats_t Stats;
+	Stats.Wakeups = m_RxWakeups.load(std::memory_order_relaxed);
+	Stats.Bytes = m_RxBytes.load(std::memory_order_relaxed);
+	Stats.Frames = m_RxFrames.load(std::memory_order_relaxed);
+	Stats.CrcErrors = m_RxCrcErrors.load(std::memory_order_relaxed);
+	Stats.FramingErrors = m_RxFramingErrors.load(std::memory_order_relaxed);
+	Stats.Overruns = m_RxOverruns.load(std::memory_order_relaxed);
+	Stats.FifoOverflows = m_RxFifoOverflows.load(std::memory_order_relaxed);
+	Stats.BufferFull = m_RxBufferFull.load(std::memory_order_relaxed);
+	Stats.LineErrors = m_RxLineErrors.load(std::memory_order_relaxed);
+	return Stats;
+}
+
+LinkHealth_t SerialPortMessageManager::GetLinkHealth()
+{
+	std::lock_guard<std::mutex> lock(m_LinkHealthMutex);
+	return m_LinkHealth;
+}
+
+void SerialPortMessageManager::SetLinkHealthCallback(LinkHealthCallback_t callback)
+{
+	std::lock_guard<std::mutex> lock(m_LinkHealthMutex);
+	m_LinkHealthCallback = callback;
+}
+
+bool SerialPortMessageManager::GetRxCaptureTime(uint32_t &captureUs) const
+{
+	if(m_RxCaptureValid) captureUs = m_RxCaptureUs;
+	return m_RxCaptureValid;
 }
 
 bool SerialPortMessageManager::QueueMessageFromDataType(const String& Name, DataType_t DataType, void* Object, size_t Count, size_t ChangeCount)
@@ -94,8 +230,51 @@ bool SerialPortMessageManager::QueueMessageFromDataType(const String& Name, Data
 	{
 		if(mp_DataSerializer)
 		{
-			String message = mp_DataSerializer->SerializeDataItemToJson(Name, DataType, Object, Count, ChangeCount);
-			result = QueueMessage( message.c_str() );
+			if(DataType >= DataType_Undef || Count > UINT16_MAX)
+			{
+				ESP_LOGE("QueueMessageFromDataType", "ERROR! \"%s\": Invalid Data Type or Count.", Name.c_str());
+				return false;
+			}
+			const uint16_t ItemId = GetLinkItemId(Name.c_str());
+			const size_t Length = mp_DataSerializer->GetSizeOfDataType(DataType) * Count;
+			LinkTxItem_t* Item = m_TxItems.Find(ItemId);
+			const LinkQoS_t QoS = Item ? Item->QoS : LinkQoS_LatestValue;
+			TxLane_t &Lane = m_TxLanes[Item ? Item->Lane : LinkTxLane_Bulk];
+			LinkFloatEncoder* Encoder = (Item && DataType_Float_t == DataType && Count <= LINK_CODEC_MAX_COUNT) ? Item->Encoder : nullptr;
+			const TickType_t Wait = (LinkQoS_MustDeliver == QoS) ? SERIAL_TX_RING_WAIT : 0;
+			bool Coalesced = false;
+			if(Lane.Batcher.CanStage(Length, Count))
+			{
+				const TickType_t Deadline = xTaskGetTickCount() + Wait;
+				for(;;)
+				{
+					const TxStageResult_t Staged = StageTxValue(Lane, ItemId, QoS, Encoder, DataType, Object, Length, Count, ChangeCount);
+					result = (TxStageResult_NoSpace != Staged);
+					Coalesced = (TxStageResult_Coalesced == Staged);
+					if(result || IsTxDeadlinePassed(Deadline)) break;
+					vTaskDelay(1);
+				}
+			}
+			else
+			{
+				//Too large for a batch record, goes out on its own
+				result = QueueEncodedFrame(Lane, MaxMessageLength, [&](uint8_t* Buffer, size_t BufferSize)
+				{
+					return mp_DataSerializer->SerializeDataItemToFrame(Name, DataType, Object, Count, ChangeCount, m_TxSequence++, Buffer, BufferSize);
+				}, Wait, micros());
+			}
+			if(Item)
+			{
+				if(!result) ++Item->Dropped;
+				else if(Coalesced) ++Item->Coalesced;
+				else ++Item->Queued;
+			}
+			if(!result)
+			{
+				m_TxDropCount.fetch_add(1, std::memory_order_relaxed);
+				++Lane.Dropped;
+				ESP_LOGD("QueueMessageFromDataType", "\"%s\" TX Full, Dropped: \"%s\"", m_Name.c_str(), Name.c_str());
+			}
 		}
 		else
 		{
@@ -105,74 +284,144 @@ bool SerialPortMessageManager::QueueMessageFromDataType(const String& Name, Data
 	return result;
 }
 
+//Queues raw bytes. The receiving side only accepts encoded link frames, so this is for diagnostics.
 bool SerialPortMessageManager::QueueMessage(const String& message)
 {
-	bool result = false;
-	if(m_TXQueue)
-	{	
-		if( message.length() > 0 &&
-            message.length() <= MaxMessageLength &&
-            message.indexOf('\0') != -1 &&
-            xQueueSend(m_TXQueue, message.c_str(), portMAX_DELAY) == pdTRUE )
-		{
-			ESP_LOGD("QueueMessage", "\"%s\" Queued Message: \"%s\"", m_Name.c_str(), message.c_str());
-			result = true;
-		}
-		else
+	return QueueFrame(reinterpret_cast<const uint8_t*>(message.c_str()), message.length());
+}
+
+bool SerialPortMessageManager::QueueFrame(const uint8_t* frame, size_t length)
+{
+	if(0 == length || length > MaxMessageLength)
+	{
+		ESP_LOGW("QueueFrame", "WARNING! \"%s\" Invalid Frame Length: \"%i\".", m_Name.c_str(), length);
+		return false;
+	}
+	return QueueEncodedFrame(m_TxLanes[LinkTxLane_Bulk], length, [&](uint8_t* Buffer, size_t BufferSize)
+	{
+		if(length > BufferSize) return static_cast<size_t>(0);
+		memcpy(Buffer, frame, length);
+		return length;
+	}, SERIAL_TX_RING_WAIT, micros());
+}
+
+//One attempt to place a value in the TX batch. Never waits, the caller decides whether to try again.
+SerialPortMessageManager::TxStageResult_t SerialPortMessageManager::StageTxValue(TxLane_t &Lane, uint16_t ItemId, LinkQoS_t QoS, LinkFloatEncoder* Encoder, DataType_t DataType, const void* Object, size_t Length, size_t Count, size_t ChangeCount)
+{
+	std::lock_guard<std::mutex> lock(Lane.BatchMutex);
+	//Heartbeats and unchanged values are sent again with the same change count. While the first copy is still
+	//waiting it goes out for both, encoded once.
+	if(Lane.Batcher.IsStaged(ItemId, static_cast<uint32_t>(ChangeCount)))
+	{
+		Lane.Batcher.CountRetransmit();
+		return TxStageResult_Coalesced;
+	}
+	if(LinkQoS_LatestValue != QoS && Lane.Batcher.IsStaged(ItemId))
+	{
+		//The waiting value has to go out before it can be followed by this one
+		if(!FlushTxBatch(Lane)) return TxStageResult_NoSpace;
+	}
+	//Latency of a batch counts from its oldest value
+	if(Lane.Batcher.IsEmpty()) Lane.BatchStartUs = micros();
+	bool Coalesced = false;
+	if(StageTxRecord(Lane, ItemId, Encoder, DataType, Object, Length, Count, ChangeCount, Coalesced))
+	{
+		return Coalesced ? TxStageResult_Coalesced : TxStageResult_Staged;
+	}
+	//Batch is full, send what is waiting and start a new one
+	if(FlushTxBatch(Lane) && StageTxRecord(Lane, ItemId, Encoder, DataType, Object, Length, Count, ChangeCount, Coalesced))
+	{
+		Lane.BatchStartUs = micros();
+		return TxStageResult_Staged;
+	}
+	return TxStageResult_NoSpace;
+}
+
+//Called with Lane.BatchMutex held. An encoded value replacing a waiting one is coded against what the receiver had
+//before that, and the encoder only moves on once the record is in the batch. Values the codec cannot carry go out as is.
+bool SerialPortMessageManager::StageTxRecord(TxLane_t &Lane, uint16_t ItemId, LinkFloatEncoder* Encoder, DataType_t DataType, const void* Object, size_t Length, size_t Count, size_t ChangeCount, bool &Coalesced)
+{
+	if(Encoder)
+	{
+		const bool Replacing = Lane.Batcher.IsStaged(ItemId);
+		uint8_t Encoded[LINK_CODEC_MAX_ENCODED_SIZE(LINK_CODEC_MAX_COUNT)];
+		const size_t EncodedLength = Encoder->Encode(static_cast<const float*>(Object), Count, Replacing, Encoded, sizeof(Encoded));
+		if(EncodedLength > 0)
 		{
-			ESP_LOGW("QueueMessage", "WARNING! \"%s\" Unable to Queue Message.", m_Name.c_str());
+			if(!Lane.Batcher.Stage(ItemId, DataType | LINK_DATATYPE_FLAG_ENCODED, Encoded, EncodedLength, Count, ChangeCount, &Coalesced)) return false;
+			Encoder->Accept(Replacing);
+			return true;
 		}
+		Encoder->Reset();
 	}
-	else
+	return Lane.Batcher.Stage(ItemId, DataType, Object, Length, Count, ChangeCount, &Coalesced);
+}
+
+//Called with Lane.BatchMutex held. If the lane is full the batch stays staged for the next flush.
+bool SerialPortMessageManager::FlushTxBatch(TxLane_t &Lane)
+{
+	if(Lane.Batcher.IsEmpty()) return true;
+	const uint32_t CaptureUs = Lane.BatchStartUs;
+	const uint32_t* Timestamp = (&Lane == &m_TxLanes[LinkTxLane_RealTime]) ? &CaptureUs : nullptr;
+	return QueueEncodedFrame(Lane, LINK_FRAME_MAX_ENCODED_SIZE(LINK_TX_BATCH_SIZE + LINK_FRAME_TIMESTAMP_SIZE), [&](uint8_t* Buffer, size_t BufferSize)
 	{
-		ESP_LOGE("QueueMessage", "ERROR! NULL Queue.");
+		return Lane.Batcher.Flush(m_TxSequence++, Buffer, BufferSize, Timestamp);
+	}, 0, Lane.BatchStartUs);
+}
+
+//Flushes the batch if its oldest value has waited a whole flush window
+bool SerialPortMessageManager::FlushDueTxBatch(TxLane_t &Lane)
+{
+	std::lock_guard<std::mutex> lock(Lane.BatchMutex);
+	if(Lane.Batcher.IsEmpty()) return false;
+	if(micros() - Lane.BatchStartUs < m_TxFlushWindow * portTICK_PERIOD_MS * 1000UL) return false;
+	return FlushTxBatch(Lane);
+}
+
+LinkTxStats_t SerialPortMessageManager::GetTxStats()
+{
+	LinkTxStats_t Total;
+	for(TxLane_t &Lane : m_TxLanes)
+	{
+		std::lock_guard<std::mutex> lock(Lane.BatchMutex);
+		const LinkTxStats_t Stats = Lane.Batcher.GetStats();
+		Total.Updates += Stats.Updates;
+		Total.Coalesced += Stats.Coalesced;
+		Total.Frames += Stats.Frames;
+		Total.Records += Stats.Records;
+		Total.Bytes += Stats.Bytes;
+		Total.UnbatchedBytes += Stats.UnbatchedBytes;
+		Total.Retransmits += Stats.Retransmits;
 	}
-	return result;
+	return Total;
+}
+
+LinkTxLaneStats_t SerialPortMessageManager::GetTxLaneStats(LinkTxLane_t lane)
+{
+	TxLane_t &Lane = m_TxLanes[lane];
+	LinkTxLaneStats_t Stats;
+	{
+		std::lock_guard<std::mutex> lock(Lane.StatsMutex);
+		Stats = Lane.Stats;
+	}
+	Stats.Dropped = Lane.Dropped;
+	Stats.MaxDepth = Lane.MaxDepth;
+	return Stats;
 }
 
 void SerialPortMessageManager::SerialPortMessageManager_RxTask()
 {
     ESP_LOGD("Setup", "Starting RX Task.");
-    const TickType_t xFrequency = 25;
-    TickType_t xLastWakeTime = xTaskGetTickCount();
-    
+    m_RxStatsTime = millis();
     while (true)
     {
-        vTaskDelayUntil(&xLastWakeTime, xFrequency);
-        
-        if (mp_Serial && mp_DataSerializer)
+        //Sleeps until the transport reports data, so a frame is handled as soon as its bytes arrive
+        ulTaskNotifyTake(pdTRUE, SERIAL_RX_IDLE_WAIT);
+        if (mp_Transport && mp_DataSerializer)
         {
-            while (mp_Serial->available())
-            {
-                char character = mp_Serial->read();
-                if (m_message.length() >= MaxMessageLength)
-                {
-                    ESP_LOGE("SerialPortMessageManager", "ERROR! Message RX Overrun: \"%s\".", m_message.c_str());
-                    m_message.clear();
-                    break;
-                }
-
-                m_message += character;
-
-                if (m_message.endsWith("\n"))
-                {
-                    m_message.trim();
-                    ESP_LOGD("SerialPortMessageManager", "Rx from: \"%s\" Message: \"%s\"", m_Name.c_str(), m_message.c_str());
-
-                    NamedObject_t NamedObject;
-                    if (mp_DataSerializer->DeSerializeJsonToNamedObject(m_message.c_str(), NamedObject))
-                    {
-                        ESP_LOGD("SerialPortMessageManager", "\"%s\" DeSerialized Named object: \"%s\" Address: \"%p\"", m_Name.c_str(), NamedObject.Name.c_str(), static_cast<void*>(NamedObject.Object));
-                        this->Call_Named_Object_Callback(NamedObject.Name, NamedObject.Object, NamedObject.ChangeCount);
-                    }
-                    else
-                    {
-                        ESP_LOGW("SerialPortMessageManager", "WARNING! \"%s\" DeSerialized Named object failed", m_Name.c_str());
-                    }
-
-                    m_message.clear();
-                }
-            }
+            m_RxWakeups.fetch_add(1, std::memory_order_relaxed);
+            ServiceRx();
+            ReportRxStats();
         }
         else
         {
@@ -182,40 +431,463 @@ void SerialPortMessageManager::SerialPortMessageManager_RxTask()
     }
 }
 
+size_t SerialPortMessageManager::ServiceRx()
+{
+    size_t total = 0;
+    uint8_t buffer[SERIAL_RX_CHUNK_SIZE];
+    int available;
+    while ((available = mp_Transport->Available()) > 0)
+    {
+        size_t count = mp_Transport->Read(buffer, std::min(static_cast<size_t>(available), sizeof(buffer)));
+        if (0 == count) break;
+        LinkCapture* capture = mp_LinkCapture.load(std::memory_order_acquire);
+        if (capture) capture->Record(LinkCaptureDirection_Rx, micros(), buffer, count);
+        total += count;
+        size_t index = 0;
+        while (index < count)
+        {
+            bool frameReady = false;
+            index += m_FrameReceiver.Push(buffer + index, count - index, frameReady);
+            if (frameReady)
+            {
+                ReceiveRxFrame(m_FrameReceiver.GetFrame());
+            }
+        }
+    }
+    m_RxBytes.fetch_add(total, std::memory_order_relaxed);
+    m_RxFrames.store(m_FrameReceiver.GetFrameCount(), std::memory_order_relaxed);
+    m_RxCrcErrors.store(m_FrameReceiver.GetCrcErrorCount(), std::memory_order_relaxed);
+    m_RxFramingErrors.store(m_FrameReceiver.GetFramingErrorCount(), std::memory_order_relaxed);
+    m_RxOverruns.store(m_FrameReceiver.GetOverrunCount(), std::memory_order_relaxed);
+    return total;
+}
+
+//Every frame a manager sends takes the next sequence number, so a gap counts the frames lost on the way.
+//A restarted sender shows up as one gap. Clock and schema frames are written by the TX task as they come up, ahead
+//of frames that already have their numbers, so they carry none.
+void SerialPortMessageManager::ReceiveRxFrame(const LinkFrameView_t &View)
+{
+    const uint32_t arrivalUs = micros();
+    if (View.Header.Flags & LINK_FRAME_FLAG_CLOCK)
+    {
+        ProcessClockFrame(View, arrivalUs);
+        return;
+    }
+    if (View.Header.Flags & LINK_FRAME_FLAG_SCHEMA)
+    {
+        ProcessSchemaFrame(View);
+        return;
+    }
+    const uint8_t expected = m_RxSequence + 1;
+    if (m_RxSequenceValid && View.Header.Sequence != expected)
+    {
+        m_RxLost.fetch_add(static_cast<uint8_t>(View.Header.Sequence - expected), std::memory_order_relaxed);
+    }
+    m_RxSequence = View.Header.Sequence;
+    m_RxSequenceValid = true;
+
+    LinkFrameView_t frame = View;
+    uint32_t captureUs = 0;
+    if ((frame.Header.Flags & LINK_FRAME_FLAG_TIMESTAMP) && !TakeLinkFrameTimestamp(frame, captureUs))
+    {
+        m_RxRejected.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    //The capture time only means something here once the peer's clock is known
+    if ((View.Header.Flags & LINK_FRAME_FLAG_TIMESTAMP) && m_ClockSync.IsSynchronized())
+    {
+        m_RxCaptureUs = m_ClockSync.ToLocalTime(captureUs);
+        const int32_t age = static_cast<int32_t>(arrivalUs - m_RxCaptureUs);
+        const uint32_t ageUs = (age > 0) ? static_cast<uint32_t>(age) : 0;
+        m_RxAgeCount.fetch_add(1, std::memory_order_relaxed);
+        m_RxAgeSumUs.fetch_add(ageUs, std::memory_order_relaxed);
+        uint32_t maxAgeUs = m_RxAgeMaxUs.load(std::memory_order_relaxed);
+        while (ageUs > maxAgeUs && !m_RxAgeMaxUs.compare_exchange_weak(maxAgeUs, ageUs, std::memory_order_relaxed)){}
+        const uint32_t allowedAgeUs = m_RxMaxAgeUs.load(std::memory_order_relaxed);
+        if (allowedAgeUs > 0 && ageUs > allowedAgeUs)
+        {
+            m_RxLate.fetch_add(1, std::memory_order_relaxed);
+            ESP_LOGD("SerialPortMessageManager", "\"%s\" Late Frame Dropped: \"%lu\" us old", m_Name.c_str(), (unsigned long)ageUs);
+            return;
+        }
+        m_RxCaptureValid = true;
+    }
+    ProcessRxFrame(frame);
+    m_RxCaptureValid = false;
+}
+
+//Requests are answered by the TX task, which stamps the response as it writes it
+void SerialPortMessageManager::ProcessClockFrame(const LinkFrameView_t &View, uint32_t ArrivalUs)
+{
+    LinkClockSync_t sync;
+    if (View.PayloadLength != sizeof(sync))
+    {
+        m_RxRejected.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    memcpy(&sync, View.Payload, sizeof(sync));
+    if (View.Header.Flags & LINK_FRAME_FLAG_CLOCK_REQUEST)
+    {
+        std::lock_guard<std::mutex> lock(m_ClockMutex);
+        m_ClockResponse.OriginUs = sync.OriginUs;
+        m_ClockResponse.ReceiveUs = ArrivalUs;
+        m_ClockResponsePending = true;
+    }
+    else if (m_ClockSync.AddSample(sync, ArrivalUs))
+    {
+        m_ClockOffsetUs.store(m_ClockSync.GetOffsetUs(), std::memory_order_relaxed);
+        m_ClockRoundTripUs.store(m_ClockSync.GetRoundTripUs(), std::memory_order_relaxed);
+        m_ClockSynchronized.store(true, std::memory_order_relaxed);
+    }
+}
+
+//Every entry is checked against the item it would be delivered to. Mismatches are logged here, once per schema,
+//and the frames of those items are then dropped without another word. A schema replaces the last one in full.
+void SerialPortMessageManager::ProcessSchemaFrame(const LinkFrameView_t &View)
+{
+    const size_t count = View.PayloadLength / sizeof(LinkSchemaEntry_t);
+    if (View.PayloadLength != count * sizeof(LinkSchemaEntry_t) || count != View.Header.Count)
+    {
+        m_RxRejected.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    m_SchemaRejectedItems = LinkItemTable<Named_Object_Callee_Interface, LINK_ITEM_TABLE_SIZE>();
+    uint32_t mismatches = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        LinkSchemaEntry_t entry;
+        memcpy(&entry, View.Payload + i * sizeof(entry), sizeof(entry));
+        Named_Object_Callee_Interface* callee = FindCallee(entry.ItemId);
+        if (nullptr == callee)
+        {
+            ESP_LOGW("SerialPortMessageManager", "WARNING! \"%s\" Schema: Peer Sends Item Id \"%04X\" That Is Not Received Here", m_Name.c_str(), entry.ItemId);
+            continue;
+        }
+        const LinkSchemaCheck_t check = CheckLinkSchemaEntry(entry, callee->GetDataType(), callee->GetCount(), nullptr != callee->GetLinkDecoder());
+        if (LinkSchemaCheck_Match != check)
+        {
+            ++mismatches;
+            m_SchemaRejectedItems.Insert(entry.ItemId, callee);
+            ESP_LOGE("SerialPortMessageManager", "ERROR! \"%s\" Schema: \"%s\" Rejected: %s, Peer Type: \"%i\" Count: \"%i\", Local Type: \"%i\" Count: \"%i\""
+                    , m_Name.c_str(), callee->GetName().c_str(), GetLinkSchemaCheckString(check)
+                    , entry.DataType, entry.Count, callee->GetDataType(), callee->GetCount());
+        }
+    }
+    m_SchemaMismatches.store(mismatches, std::memory_order_relaxed);
+    m_SchemaVerified.store(true, std::memory_order_relaxed);
+    if (View.Header.Flags & LINK_FRAME_FLAG_SCHEMA_ACK)
+    {
+        m_SchemaAckedVersion.store(View.Header.ChangeCount, std::memory_order_relaxed);
+    }
+    else
+    {
+        m_SchemaReplyVersion.store(View.Header.ChangeCount, std::memory_order_relaxed);
+        m_SchemaReplyPending.store(true, std::memory_order_release);
+    }
+}
+
+void SerialPortMessageManager::ReportRxStats()
+{
+    const unsigned long now = millis();
+    const unsigned long elapsed = now - m_RxStatsTime;
+    if (elapsed < SERIAL_RX_STATS_PERIOD) return;
+    const LinkRxStats_t stats = GetRxStats();
+    ESP_LOGI( "RxStats", "\"%s\" RX: %lu bytes/s %lu frames/s %lu wakeups/s, CRC Errors: %lu, Framing Errors: %lu, Overruns: %lu, FIFO Overflows: %lu, Buffer Full: %lu, Line Errors: %lu"
+            , m_Name.c_str()
+            , (stats.Bytes - m_ReportedRxStats.Bytes) * 1000UL / elapsed
+            , (stats.Frames - m_ReportedRxStats.Frames) * 1000UL / elapsed
+            , (stats.Wakeups - m_ReportedRxStats.Wakeups) * 1000UL / elapsed
+            , (unsigned long)(stats.CrcErrors - m_ReportedRxStats.CrcErrors)
+            , (unsigned long)(stats.FramingErrors - m_ReportedRxStats.FramingErrors)
+            , (unsigned long)(stats.Overruns - m_ReportedRxStats.Overruns)
+            , (unsigned long)(stats.FifoOverflows - m_ReportedRxStats.FifoOverflows)
+            , (unsigned long)(stats.BufferFull - m_ReportedRxStats.BufferFull)
+            , (unsigned long)(stats.LineErrors - m_ReportedRxStats.LineErrors) );
+    m_ReportedRxStats = stats;
+    m_RxStatsTime = now;
+}
+
+void SerialPortMessageManager::ProcessRxFrame(const LinkFrameView_t &View)
+{
+    if (View.Header.Flags & LINK_FRAME_FLAG_BATCH)
+    {
+        size_t Offset = 0;
+        size_t Records = 0;
+        LinkFrameView_t Record;
+        while (mp_DataSerializer->GetNextBatchRecord(View, Offset, Record))
+        {
+            ++Records;
+            ProcessRxFrame(Record);
+        }
+        if (Records != View.Header.Count || Offset != View.PayloadLength)
+        {
+            m_RxRejected.fetch_add(1, std::memory_order_relaxed);
+            ESP_LOGW("SerialPortMessageManager", "WARNING! \"%s\" Batch Frame: \"%i\" of \"%i\" Records Read", m_Name.c_str(), Records, View.Header.Count);
+        }
+    }
+    else if (m_SchemaRejectedItems.Find(View.Header.ItemId))
+    {
+        m_RxRejected.fetch_add(1, std::memory_order_relaxed);
+    }
+    else if (mp_DataSerializer->ValidateFrame(View))
+    {
+        ESP_LOGD("SerialPortMessageManager", "\"%s\" Rx Frame: Item Id: \"%04X\" Sequence: \"%i\"", m_Name.c_str(), View.Header.ItemId, View.Header.Sequence);
+        if (View.Header.DataType & LINK_DATATYPE_FLAG_ENCODED)
+        {
+            this->Call_Item_Id_Encoded_Callback(View.Header.ItemId, View.Payload, View.PayloadLength, View.Header.Count, View.Header.ChangeCount);
+        }
+        else
+        {
+            this->Call_Item_Id_Callback(View.Header.ItemId, const_cast<uint8_t*>(View.Payload), View.Header.Count, View.Header.ChangeCount);
+        }
+    }
+    else
+    {
+        m_RxRejected.fetch_add(1, std::memory_order_relaxed);
+        ESP_LOGW("SerialPortMessageManager", "WARNING! \"%s\" Frame Rejected", m_Name.c_str());
+    }
+}
+
 void SerialPortMessageManager::SerialPortMessageManager_TxTask()
 {
 	ESP_LOGD("Setup", "Starting TX Task.");
-	const TickType_t xFrequency = 25;
 	TickType_t xLastWakeTime = xTaskGetTickCount();
+	m_TxStatsTime = millis();
+	m_LinkHealthTime = m_TxStatsTime;
 	while(true)
 	{
-		vTaskDelayUntil( &xLastWakeTime, xFrequency );
-		if(NULL != m_TXQueue)
-		{
-			size_t QueueCount = uxQueueMessagesWaiting(m_TXQueue);
-			if(QueueCount) ESP_LOGD("SerialPortMessageManager_TxTask", "Queue Count: %i", QueueCount);
-			for(size_t i = 0; i < QueueCount; ++i)
-			{
-				char message[MaxMessageLength] = "\0";
-				if ( xQueueReceive(m_TXQueue, message, 0) == pdTRUE )
-				{
-					if (strlen(message) > MaxMessageLength)
-                    {
-                        ESP_LOGW("SerialPortMessageManager_TxTask", "\"%s\" WARNING! Message exceeds MaxMessageLength. Truncating.",m_Name.c_str());
-                        message[MaxMessageLength - 1] = '\0';
-                    }
-					ESP_LOGI("SerialPortMessageManager_TxTask", "\"%s\" Data TX: \"%s\"",m_Name.c_str(), message);
-					mp_Serial->println(message);
-				}
-				else
-				{
-					ESP_LOGE("SerialPortMessageManager_TxTask", "\"%s\" ERROR! Unable to Send Message.",m_Name.c_str());
-				}
-			}
-		}
-		else
-		{
-			ESP_LOGE("SerialPortMessageManager_TxTask", "ERROR! NULL TX Queue.");
-		}
+		vTaskDelayUntil( &xLastWakeTime, m_TxFlushWindow );
+		ServiceClockSync();
+		ServiceSchema();
+		ServiceTx();
+	}
+}
+
+void SerialPortMessageManager::ServiceTx()
+{
+	//Drain first so the batches find room in the rings
+	WriteTxLanes();
+	for(TxLane_t &Lane : m_TxLanes)
+	{
+		std::lock_guard<std::mutex> lock(Lane.BatchMutex);
+		FlushTxBatch(Lane);
+	}
+	WriteTxLanes();
+	ReportTxStats();
+	if(millis() - m_LinkHealthTime >= SERIAL_LINK_HEALTH_PERIOD) UpdateLinkHealth();
+}
+
+//Strict priority: every waiting real time frame goes out before each bulk frame. A real time batch that
+//comes due while a long bulk backlog drains is flushed in between rather than waiting for the next period.
+void SerialPortMessageManager::WriteTxLanes()
+{
+	TxLane_t &RealTime = m_TxLanes[LinkTxLane_RealTime];
+	TxLane_t &Bulk = m_TxLanes[LinkTxLane_Bulk];
+	while(true)
+	{
+		while(WriteTxFrame(RealTime)){}
+		if(Bulk.Ring.IsEmpty()) break;
+		if(FlushDueTxBatch(RealTime)) continue;
+		WriteTxFrame(Bulk);
+	}
+}
+
+//Writes the oldest frame of the lane straight from its ring. Returns false if the lane is empty.
+bool SerialPortMessageManager::WriteTxFrame(TxLane_t &Lane)
+{
+	const uint8_t* Data;
+	size_t Length;
+	if(!Lane.Ring.Peek(Data, Length)) return false;
+	uint32_t QueuedUs;
+	memcpy(&QueuedUs, Data, sizeof(QueuedUs));
+	const uint32_t LatencyUs = static_cast<uint32_t>(micros()) - QueuedUs;
+	const size_t FrameLength = Length - sizeof(QueuedUs);
+	ESP_LOGD("SerialPortMessageManager_TxTask", "\"%s\" Data TX: \"%i\" bytes",m_Name.c_str(), FrameLength);
+	WriteTransport(Data + sizeof(QueuedUs), FrameLength);
+	Lane.Ring.Consume();
+	--Lane.Depth;
+	m_TxLatencyHistogram[LinkHealth_t::GetLatencyBucket(LatencyUs)].fetch_add(1, std::memory_order_relaxed);
+	if(LatencyUs > m_TxLatencyMaxUs.load(std::memory_order_relaxed)) m_TxLatencyMaxUs.store(LatencyUs, std::memory_order_relaxed);
+	std::lock_guard<std::mutex> lock(Lane.StatsMutex);
+	++Lane.Stats.Frames;
+	Lane.Stats.Bytes += FrameLength;
+	Lane.Stats.LatencySumUs += LatencyUs;
+	Lane.Stats.LatencyMaxUs = std::max(Lane.Stats.LatencyMaxUs, LatencyUs);
+	return true;
+}
+
+void SerialPortMessageManager::ServiceClockSync()
+{
+	if(!mp_Transport) return;
+	LinkClockSync_t Response;
+	bool Respond;
+	{
+		std::lock_guard<std::mutex> lock(m_ClockMutex);
+		Respond = m_ClockResponsePending;
+		Response = m_ClockResponse;
+		m_ClockResponsePending = false;
+	}
+	if(Respond) WriteClockFrame(LINK_FRAME_FLAG_CLOCK_RESPONSE, Response);
+	const unsigned long now = millis();
+	if(0 == m_ClockSyncTime || now - m_ClockSyncTime >= SERIAL_CLOCK_SYNC_PERIOD)
+	{
+		m_ClockSyncTime = now;
+		WriteClockFrame(LINK_FRAME_FLAG_CLOCK_REQUEST, LinkClockSync_t());
+	}
+}
+
+//Clock frames skip the lanes and are stamped right before they are written, a queued frame would carry the time it waited
+bool SerialPortMessageManager::WriteClockFrame(uint16_t Flags, LinkClockSync_t Sync)
+{
+	LinkFrameHeader_t Header;
+	Header.Flags = Flags;
+	uint8_t Frame[LINK_FRAME_MAX_ENCODED_SIZE(sizeof(LinkClockSync_t))];
+	const uint32_t NowUs = micros();
+	if(LINK_FRAME_FLAG_CLOCK_REQUEST == Flags) Sync.OriginUs = NowUs;
+	else Sync.TransmitUs = NowUs;
+	const size_t Length = EncodeLinkFrame(Header, &Sync, sizeof(Sync), Frame, sizeof(Frame));
+	return Length > 0 && Length == WriteTransport(Frame, Length);
+}
+
+void SerialPortMessageManager::ServiceSchema()
+{
+	if(!mp_Transport) return;
+	if(m_SchemaReplyPending.exchange(false, std::memory_order_acquire))
+	{
+		WriteSchemaFrame(LINK_FRAME_FLAG_SCHEMA | LINK_FRAME_FLAG_SCHEMA_ACK, m_SchemaReplyVersion.load(std::memory_order_relaxed));
+	}
+	const unsigned long now = millis();
+	const uint32_t Version = m_SchemaVersion.load(std::memory_order_relaxed);
+	if(Version == m_SchemaAckedVersion.load(std::memory_order_relaxed)) return;
+	if(Version != m_SchemaSentVersion || now - m_SchemaTime >= SERIAL_SCHEMA_PERIOD)
+	{
+		m_SchemaTime = now;
+		m_SchemaSentVersion = Version;
+		WriteSchemaFrame(LINK_FRAME_FLAG_SCHEMA, Version);
 	}
-}
\ No newline at end of file
+}
+
+//Lists every registered TX item. A reply carries the version it answers, a schema of our own carries our version.
+bool SerialPortMessageManager::WriteSchemaFrame(uint16_t Flags, uint32_t Version)
+{
+	size_t Count = 0;
+	m_TxItems.ForEach([this, &Count](uint16_t ItemId, LinkTxItem_t* Item)
+	{
+		if(Count >= LINK_ITEM_TABLE_SIZE) return;
+		LinkSchemaEntry_t &Entry = m_SchemaEntries[Count++];
+		Entry.ItemId = ItemId;
+		Entry.DataType = static_cast<uint8_t>(Item->DataType) | (Item->Encoder ? LINK_DATATYPE_FLAG_ENCODED : 0);
+		Entry.Count = static_cast<uint16_t>(Item->Count);
+	});
+	LinkFrameHeader_t Header;
+	Header.Flags = Flags;
+	Header.Count = Count;
+	Header.ChangeCount = Version;
+	const size_t Length = EncodeLinkFrame(Header, m_SchemaEntries, Count * sizeof(LinkSchemaEntry_t), m_SchemaFrame, sizeof(m_SchemaFrame));
+	return Length > 0 && Length == WriteTransport(m_SchemaFrame, Length);
+}
+
+size_t SerialPortMessageManager::WriteTransport(const uint8_t* Data, size_t Length)
+{
+	LinkCapture* Capture = mp_LinkCapture.load(std::memory_order_acquire);
+	if(Capture) Capture->Record(LinkCaptureDirection_Tx, micros(), Data, Length);
+	return mp_Transport->Write(Data, Length);
+}
+
+void SerialPortMessageManager::ReportTxStats()
+{
+	const unsigned long now = millis();
+	const unsigned long elapsed = now - m_TxStatsTime;
+	if(elapsed < SERIAL_TX_STATS_PERIOD) return;
+	const LinkTxStats_t stats = GetTxStats();
+	const uint32_t updates = stats.Updates - m_ReportedTxStats.Updates;
+	const uint32_t frames = stats.Frames - m_ReportedTxStats.Frames;
+	const uint32_t bytes = stats.Bytes - m_ReportedTxStats.Bytes;
+	const uint32_t unbatchedBytes = stats.UnbatchedBytes - m_ReportedTxStats.UnbatchedBytes;
+	const uint32_t dropCount = m_TxDropCount.load(std::memory_order_relaxed);
+	ESP_LOGI( "TxStats", "\"%s\" TX: %lu frames/s %lu bytes/s, Saved: %lu frames/s %ld bytes/s, Coalesced: %lu, Retransmits: %lu, Dropped: %lu"
+			, m_Name.c_str()
+			, frames * 1000UL / elapsed
+			, bytes * 1000UL / elapsed
+			, (updates - frames) * 1000UL / elapsed
+			, ((long)unbatchedBytes - (long)bytes) * 1000L / (long)elapsed
+			, (unsigned long)(stats.Coalesced - m_ReportedTxStats.Coalesced)
+			, (unsigned long)(stats.Retransmits - m_ReportedTxStats.Retransmits)
+			, (unsigned long)(dropCount - m_ReportedTxDropCount) );
+	static const char* const LaneNames[LinkTxLane_Count] = { "Real Time", "Bulk" };
+	for(size_t i = 0; i < LinkTxLane_Count; ++i)
+	{
+		TxLane_t &Lane = m_TxLanes[i];
+		const LinkTxLaneStats_t laneStats = GetTxLaneStats(static_cast<LinkTxLane_t>(i));
+		const uint32_t laneFrames = laneStats.Frames - Lane.ReportedStats.Frames;
+		const uint64_t latencySumUs = laneStats.LatencySumUs - Lane.ReportedStats.LatencySumUs;
+		ESP_LOGI( "TxStats", "\"%s\" %s Lane: %lu frames/s, Latency: %lu us mean %lu us max, Max Depth: %lu, Dropped: %lu"
+				, m_Name.c_str()
+				, LaneNames[i]
+				, laneFrames * 1000UL / elapsed
+				, laneFrames ? (unsigned long)(latencySumUs / laneFrames) : 0UL
+				, (unsigned long)laneStats.LatencyMaxUs
+				, (unsigned long)laneStats.MaxDepth
+				, (unsigned long)(laneStats.Dropped - Lane.ReportedStats.Dropped) );
+		Lane.ReportedStats = laneStats;
+		std::lock_guard<std::mutex> lock(Lane.StatsMutex);
+		Lane.Stats.LatencyMaxUs = 0;
+	}
+	m_ReportedTxStats = stats;
+	m_ReportedTxDropCount = dropCount;
+	m_TxStatsTime = now;
+}
+
+void SerialPortMessageManager::UpdateLinkHealth()
+{
+	const unsigned long now = millis();
+	const unsigned long elapsed = std::max(now - m_LinkHealthTime, 1UL);
+	LinkTxLaneStats_t txStats;
+	for(size_t i = 0; i < LinkTxLane_Count; ++i)
+	{
+		const LinkTxLaneStats_t laneStats = GetTxLaneStats(static_cast<LinkTxLane_t>(i));
+		txStats.Frames += laneStats.Frames;
+		txStats.Bytes += laneStats.Bytes;
+	}
+	const LinkRxStats_t rxStats = GetRxStats();
+
+	LinkHealth_t Health;
+	Health.TxBytesPerSecond = (txStats.Bytes - m_LinkHealthTxStats.Bytes) * 1000ULL / elapsed;
+	Health.TxFramesPerSecond = (txStats.Frames - m_LinkHealthTxStats.Frames) * 1000ULL / elapsed;
+	Health.RxBytesPerSecond = (rxStats.Bytes - m_LinkHealthRxStats.Bytes) * 1000ULL / elapsed;
+	Health.RxFramesPerSecond = (rxStats.Frames - m_LinkHealthRxStats.Frames) * 1000ULL / elapsed;
+	Health.TxDropped = m_TxDropCount.load(std::memory_order_relaxed);
+	Health.RxLost = m_RxLost.load(std::memory_order_relaxed);
+	Health.RxCrcErrors = rxStats.CrcErrors;
+	Health.RxFramingErrors = rxStats.FramingErrors + rxStats.Overruns;
+	Health.RxRejected = m_RxRejected.load(std::memory_order_relaxed);
+	Health.RxOverflows = rxStats.FifoOverflows + rxStats.BufferFull;
+	Health.RxLineErrors = rxStats.LineErrors;
+	//Only the TX task writes the TX latency counters, so nothing lands between the read and the reset
+	Health.TxLatencyMaxUs = m_TxLatencyMaxUs.exchange(0, std::memory_order_relaxed);
+	Health.RxLate = m_RxLate.load(std::memory_order_relaxed);
+	const uint32_t ageCount = m_RxAgeCount.load(std::memory_order_relaxed);
+	const uint32_t ageSumUs = m_RxAgeSumUs.load(std::memory_order_relaxed);
+	Health.RxAgeMeanUs = (ageCount != m_ReportedRxAgeCount) ? (ageSumUs - m_ReportedRxAgeSumUs) / (ageCount - m_ReportedRxAgeCount) : 0;
+	Health.RxAgeMaxUs = m_RxAgeMaxUs.exchange(0, std::memory_order_relaxed);
+	m_ReportedRxAgeCount = ageCount;
+	m_ReportedRxAgeSumUs = ageSumUs;
+	Health.ClockRoundTripUs = m_ClockRoundTripUs.load(std::memory_order_relaxed);
+	for(size_t i = 0; i < LINK_HEALTH_LATENCY_BUCKETS; ++i)
+	{
+		const uint32_t count = m_TxLatencyHistogram[i].load(std::memory_order_relaxed);
+		Health.TxLatencyHistogram[i] = count - m_ReportedTxLatencyHistogram[i];
+		m_ReportedTxLatencyHistogram[i] = count;
+	}
+	m_LinkHealthTxStats = txStats;
+	m_LinkHealthRxStats = rxStats;
+	m_LinkHealthTime = now;
+
+	LinkHealthCallback_t callback;
+	{
+		std::lock_guard<std::mutex> lock(m_LinkHealthMutex);
+		m_LinkHealth = Health;
+		callback = m_LinkHealthCallback;
+	}
+	if(callback) callback(Health);
+}
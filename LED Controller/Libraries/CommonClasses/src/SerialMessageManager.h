@@ -20,11 +20,101 @@
 #include <HardwareSerial.h>
 #include <Arduino.h>
 #include <vector>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <functional>
 #include "Helpers.h"
 #include "DataSerializer.h"
+#include "LinkFrame.h"
+#include "LinkFloatCodec.h"
+#include "LinkFrameReceiver.h"
+#include "LinkItemTable.h"
+#include "LinkTxBatcher.h"
+#include "LinkTxRing.h"
+#include "LinkTransport.h"
+#include "LinkClockSync.h"
+#include "LinkSchema.h"
+#include "LinkCapture.h"
 
-#define MaxQueueCount 10
 #define MaxMessageLength 1000
+#define SERIAL_RX_CHUNK_SIZE 64
+#define SERIAL_RX_IDLE_WAIT 100              //Most ticks the RX task sleeps without a UART event, covers a missed wakeup
+#define SERIAL_RX_STATS_PERIOD 10000         //ms between RX statistics reports
+#define LINK_ITEM_TABLE_SIZE 128
+#define SERIAL_TX_FLUSH_WINDOW 25            //Ticks between TX batch flushes
+#define SERIAL_TX_STATS_PERIOD 10000         //ms between TX statistics reports
+#define LINK_TX_BATCH_SIZE 960
+#define LINK_TX_BATCH_MAX_RECORDS 32
+#define SERIAL_TX_RING_SIZE 2048             //Bytes of encoded frames waiting for the TX task, per lane
+#define SERIAL_TX_RING_WAIT 100              //Most ticks a LinkQoS_MustDeliver writer waits for space before dropping its value
+#define SERIAL_TX_REALTIME_DEPTH_LIMIT 4     //Frames waiting in the real time lane before it counts as full
+#define SERIAL_TX_BULK_DEPTH_LIMIT 32        //Frames waiting in the bulk lane before it counts as full
+#define SERIAL_LINK_HEALTH_PERIOD 5000       //ms between link health snapshots
+#define SERIAL_CLOCK_SYNC_PERIOD 1000        //ms between clock sync requests to the peer
+#define SERIAL_SCHEMA_PERIOD 1000            //ms between schema sends until the peer acknowledges the current one
+
+static_assert(LINK_FRAME_MAX_ENCODED_SIZE(LINK_TX_BATCH_SIZE + LINK_FRAME_TIMESTAMP_SIZE) <= MaxMessageLength, "A full timestamped TX batch must fit one frame");
+static_assert(LINK_FRAME_MAX_ENCODED_SIZE(LINK_ITEM_TABLE_SIZE * sizeof(LinkSchemaEntry_t)) <= MaxMessageLength, "The schema of a full TX item table must fit one frame");
+
+//How updates of an item are handled when the link falls behind
+enum LinkQoS_t
+{
+	LinkQoS_LatestValue,     //A waiting value is replaced by the newer one. Never waits for space.
+	LinkQoS_MustDeliver,     //Every value is sent. Waits up to SERIAL_TX_RING_WAIT ticks for space.
+	LinkQoS_BestEffort,      //Every value is sent if there is space right away, dropped otherwise.
+};
+
+//TX lanes in priority order. The TX task writes every waiting real time frame before the next bulk frame,
+//so a burst of settings cannot hold back band data by more than one bulk frame. Real time frames carry the time
+//their oldest value was queued, which the receiver translates to its own clock.
+enum LinkTxLane_t
+{
+	LinkTxLane_RealTime,
+	LinkTxLane_Bulk,
+	LinkTxLane_Count,
+};
+
+//RX statistics. The UART counters come from the driver's error events, bytes lost there show up as CRC or framing errors.
+struct LinkRxStats_t
+{
+	uint32_t Wakeups = 0;
+	uint32_t Bytes = 0;
+	uint32_t Frames = 0;
+	uint32_t CrcErrors = 0;
+	uint32_t FramingErrors = 0;
+	uint32_t Overruns = 0;          //Frames longer than the receive buffer
+	uint32_t FifoOverflows = 0;     //UART hardware FIFO overflowed
+	uint32_t BufferFull = 0;        //UART driver or transport RX buffer filled up
+	uint32_t LineErrors = 0;        //Break, parity or UART framing errors, failed transport transactions
+};
+
+//Per lane TX statistics. Latency runs from the value being queued to its frame being written to the UART.
+struct LinkTxLaneStats_t
+{
+	uint32_t Frames = 0;
+	uint32_t Bytes = 0;
+	uint32_t Dropped = 0;
+	uint32_t MaxDepth = 0;          //Most frames waiting at once
+	uint64_t LatencySumUs = 0;
+	uint32_t LatencyMaxUs = 0;      //Since the last statistics report
+};
+
+//Per item TX policy and counters, owned by the item and registered with its SerialPortMessageManager
+struct LinkTxItem_t
+{
+	LinkQoS_t QoS = LinkQoS_LatestValue;
+	LinkTxLane_t Lane = LinkTxLane_Bulk;
+	LinkFloatEncoder* Encoder = nullptr;    //Set to send float arrays through the link codec
+	DataType_t DataType = DataType_Undef;   //Listed in the link schema for the peer to check, with Count
+	size_t Count = 0;
+	uint32_t Queued = 0;
+	uint32_t Coalesced = 0;
+	uint32_t Dropped = 0;
+};
+
+//Called from the TX task with every new link health snapshot
+typedef std::function<void(const LinkHealth_t&)> LinkHealthCallback_t;
 
 template <typename T>
 class Rx_Value_Caller_Interface;
@@ -175,9 +265,25 @@ class Named_Object_Callee_Interface
 		}
 		virtual UpdateStatus_t New_Object_From_Sender(const Named_Object_Caller_Interface* sender, const void* object, const size_t changeCount) = 0;
 		virtual String GetName() const = 0;
+		//Decoder for values that arrive through the link codec, nullptr if the item cannot take them
+		virtual LinkFloatDecoder* GetLinkDecoder(){ return nullptr; }
+		//Checked against the peer's schema, DataType_Undef skips the check
+		virtual DataType_t GetDataType(){ return DataType_Undef; }
 		size_t GetCount(){ return m_Count;}
+		//Link id of this item. Derived from the name on first use since GetName is not available during construction.
+		uint16_t GetItemId()
+		{
+			if(!m_ItemIdValid)
+			{
+				m_ItemId = GetLinkItemId(GetName().c_str());
+				m_ItemIdValid = true;
+			}
+			return m_ItemId;
+		}
 	private:
 		size_t m_Count = 0;
+		uint16_t m_ItemId = 0;
+		bool m_ItemIdValid = false;
 };
 
 class Named_Object_Caller_Interface
@@ -194,26 +300,49 @@ class Named_Object_Caller_Interface
 		virtual void RegisterForNewRxValueNotification(Named_Object_Callee_Interface* newCallee);
 		virtual void DeRegisterForNewRxValueNotification(Named_Object_Callee_Interface* callee);
 		virtual String GetName() const = 0;
+		//Capture time, in this CPU's micros(), of the value being delivered. Only valid within New_Object_From_Sender.
+		virtual bool GetRxCaptureTime(uint32_t &) const { return false; }
 	protected:
 		virtual void Call_Named_Object_Callback(const String& name, void* object, const size_t changeCount);
+		virtual void Call_Item_Id_Callback(uint16_t itemId, void* object, const size_t count, const size_t changeCount);
+		virtual void Call_Item_Id_Encoded_Callback(uint16_t itemId, const uint8_t* payload, size_t length, const size_t count, const size_t changeCount);
+		Named_Object_Callee_Interface* FindCallee(uint16_t itemId) const { return m_CalleeTable.Find(itemId); }
 	private:
 		std::vector<Named_Object_Callee_Interface*> m_NewValueCallees = std::vector<Named_Object_Callee_Interface*>();
+		LinkItemTable<Named_Object_Callee_Interface, LINK_ITEM_TABLE_SIZE> m_CalleeTable;
 		std::vector<NamedCallback_t*> m_NamedCallbacks = std::vector<NamedCallback_t*>();
 };
 
 class SerialPortMessageManager: public Named_Object_Caller_Interface
 {
 	public:
-		SerialPortMessageManager(){}
+		SerialPortMessageManager()
+		{
+			m_TxLanes[LinkTxLane_RealTime].DepthLimit = SERIAL_TX_REALTIME_DEPTH_LIMIT;
+		}
 		SerialPortMessageManager( const String& name
 								, HardwareSerial *serial
 								, DataSerializer *dataSerializer
 								, BaseType_t coreId = 1 )
 								: m_Name(name)
-								, mp_Serial(serial)
+								, m_UartTransport(serial)
+								, mp_Transport(serial ? &m_UartTransport : nullptr)
 								, mp_DataSerializer(dataSerializer)
 								, m_CoreId(coreId)
 		{
+			m_TxLanes[LinkTxLane_RealTime].DepthLimit = SERIAL_TX_REALTIME_DEPTH_LIMIT;
+		}
+		//Runs the link over any transport, such as SpiTransport, instead of a UART
+		SerialPortMessageManager( const String& name
+								, ITransport *transport
+								, DataSerializer *dataSerializer
+								, BaseType_t coreId = 1 )
+								: m_Name(name)
+								, mp_Transport(transport)
+								, mp_DataSerializer(dataSerializer)
+								, m_CoreId(coreId)
+		{
+			m_TxLanes[LinkTxLane_RealTime].DepthLimit = SERIAL_TX_REALTIME_DEPTH_LIMIT;
 		}
 		virtual ~SerialPortMessageManager()
 		{
@@ -221,6 +350,7 @@ class SerialPortMessageManager: public Named_Object_Caller_Interface
 			if(m_RXTaskHandle)
 			{
 				ESP_LOGD("~SerialPortMessageManager", "RX Task Exists.");
+				if(mp_Transport) mp_Transport->SetRxCallbacks(nullptr, nullptr);
 				if(eTaskGetState(m_RXTaskHandle) != eDeleted)
 				{
 					ESP_LOGD("~SerialPortMessageManager", "Deleting RX Task.");
@@ -236,35 +366,212 @@ class SerialPortMessageManager: public Named_Object_Caller_Interface
 					vTaskDelete(m_TXTaskHandle);
 				}
 			}
-			if(m_TXQueue)
-			{
-				ESP_LOGD("~SerialPortMessageManager", "Deleting Queue");
-				vQueueDelete(m_TXQueue);
-			}
 			ESP_LOGD("~SerialPortMessageManager", "SerialPortMessageManager Deleted");
 		}
 		virtual void Setup();
+		//A value queued again with the change count of one still waiting to go out is taken to be the same value and sent once
 		virtual bool QueueMessageFromDataType(const String& Name, DataType_t DataType, void* Object, size_t Count, size_t ChangeCount);
 		virtual bool QueueMessage(const String& message);
+		virtual bool QueueFrame(const uint8_t* frame, size_t length);
+		//Items that are not registered are sent as LinkQoS_LatestValue on the bulk lane
+		virtual void RegisterTxItem(uint16_t itemId, LinkTxItem_t* item);
+		virtual void DeRegisterTxItem(uint16_t itemId);
+		uint32_t GetTxDropCount() const { return m_TxDropCount.load(std::memory_order_relaxed); }
+		//Updates staged within one window go out together as a single batch frame
+		void SetTxFlushWindow(TickType_t window){ m_TxFlushWindow = window; }
+		TickType_t GetTxFlushWindow() const { return m_TxFlushWindow; }
+		//A lane holding limit frames counts as full, so its writers wait or drop according to their QoS
+		void SetTxLaneDepthLimit(LinkTxLane_t lane, uint32_t limit){ m_TxLanes[lane].DepthLimit = limit; }
+		uint32_t GetTxLaneDepthLimit(LinkTxLane_t lane) const { return m_TxLanes[lane].DepthLimit; }
+		LinkTxStats_t GetTxStats();
+		LinkTxLaneStats_t GetTxLaneStats(LinkTxLane_t lane);
+		LinkRxStats_t GetRxStats() const;
+		//Latest snapshot, taken every SERIAL_LINK_HEALTH_PERIOD
+		LinkHealth_t GetLinkHealth();
+		void SetLinkHealthCallback(LinkHealthCallback_t callback);
+		//Timestamped frames older than maxAgeUs on arrival are dropped. 0 keeps them all.
+		void SetRxMaxAge(uint32_t maxAgeUs){ m_RxMaxAgeUs.store(maxAgeUs, std::memory_order_relaxed); }
+		bool GetRxCaptureTime(uint32_t &captureUs) const override;
+		bool IsClockSynchronized() const { return m_ClockSynchronized.load(std::memory_order_relaxed); }
+		//Peer clock minus local clock
+		int32_t GetClockOffsetUs() const { return m_ClockOffsetUs.load(std::memory_order_relaxed); }
+		//True once the peer's schema has been checked. Items it got wrong are logged then, and their frames dropped quietly.
+		bool IsSchemaVerified() const { return m_SchemaVerified.load(std::memory_order_relaxed); }
+		uint32_t GetSchemaMismatchCount() const { return m_SchemaMismatches.load(std::memory_order_relaxed); }
+		//Records every frame written and every transport read into capture, nullptr stops recording
+		void SetLinkCapture(LinkCapture* capture){ mp_LinkCapture.store(capture, std::memory_order_release); }
+		LinkCapture* GetLinkCapture() const { return mp_LinkCapture.load(std::memory_order_acquire); }
+		//True once the peer has acknowledged the current list of TX items
+		bool IsSchemaAcknowledged() const { return m_SchemaVersion.load(std::memory_order_relaxed) == m_SchemaAckedVersion.load(std::memory_order_relaxed); }
 		String GetName() const 
 		{
 			return m_Name;
 		}
+	protected:
+		//One TX period: writes what is waiting, flushes the batch and writes it. Run by the TX task.
+		void ServiceTx();
+		void ProcessRxFrame(const LinkFrameView_t &View);
+		//Handles a frame straight off the wire: clock sync, sequence check and capture time, then processing
+		void ReceiveRxFrame(const LinkFrameView_t &View);
+		void ProcessClockFrame(const LinkFrameView_t &View, uint32_t ArrivalUs);
+		//Answers a waiting clock request and sends one of our own when due. Run by the TX task.
+		void ServiceClockSync();
+		void ProcessSchemaFrame(const LinkFrameView_t &View);
+		//Sends the schema when it changed, until the peer acknowledges it, and in reply to the peer's. Run by the TX task.
+		void ServiceSchema();
+		//Reads everything the transport holds and dispatches the frames in it. Returns the bytes read.
+		size_t ServiceRx();
+		//Called from the UART driver's event task, or the task of another transport
+		void NotifyRx();
+		void HandleRxError(hardwareSerial_error_t Error);
+		//Takes a link health snapshot covering the time since the last one. Run by the TX task.
+		void UpdateLinkHealth();
 	private:
 		String m_Name;
-		HardwareSerial *mp_Serial = nullptr;
+		UartTransport m_UartTransport;
+		ITransport *mp_Transport = nullptr;
 		DataSerializer *mp_DataSerializer = nullptr;
 		BaseType_t  m_CoreId = 1;
-		String m_message;
+		std::atomic<LinkCapture*> mp_LinkCapture = {nullptr};
+		std::atomic<uint8_t> m_TxSequence = {0};
+		//Each lane batches and queues on its own, only the TX task decides which lane goes next
+		struct TxLane_t
+		{
+			std::mutex BatchMutex;
+			LinkTxBatcher<LINK_TX_BATCH_SIZE, LINK_TX_BATCH_MAX_RECORDS> Batcher;
+			unsigned long BatchStartUs = 0;
+			std::mutex RingMutex;
+			LinkTxRing<SERIAL_TX_RING_SIZE> Ring;
+			std::atomic<uint32_t> Depth = {0};
+			std::atomic<uint32_t> DepthLimit = {SERIAL_TX_BULK_DEPTH_LIMIT};
+			std::atomic<uint32_t> MaxDepth = {0};
+			std::atomic<uint32_t> Dropped = {0};
+			std::mutex StatsMutex;
+			LinkTxLaneStats_t Stats;
+			LinkTxLaneStats_t ReportedStats;
+		};
+		TxLane_t m_TxLanes[LinkTxLane_Count];
+		TickType_t m_TxFlushWindow = SERIAL_TX_FLUSH_WINDOW;
+		LinkTxStats_t m_ReportedTxStats;
+		uint32_t m_ReportedTxDropCount = 0;
+		unsigned long m_TxStatsTime = 0;
+		LinkFrameReceiver<MaxMessageLength> m_FrameReceiver;
+		std::atomic<uint32_t> m_RxWakeups = {0};
+		std::atomic<uint32_t> m_RxBytes = {0};
+		std::atomic<uint32_t> m_RxFrames = {0};
+		std::atomic<uint32_t> m_RxCrcErrors = {0};
+		std::atomic<uint32_t> m_RxFramingErrors = {0};
+		std::atomic<uint32_t> m_RxOverruns = {0};
+		std::atomic<uint32_t> m_RxFifoOverflows = {0};
+		std::atomic<uint32_t> m_RxBufferFull = {0};
+		std::atomic<uint32_t> m_RxLineErrors = {0};
+		std::atomic<uint32_t> m_RxLost = {0};
+		std::atomic<uint32_t> m_RxRejected = {0};
+		uint8_t m_RxSequence = 0;
+		bool m_RxSequenceValid = false;
+		uint32_t m_RxCaptureUs = 0;
+		bool m_RxCaptureValid = false;
+		std::atomic<uint32_t> m_RxMaxAgeUs = {0};
+		std::atomic<uint32_t> m_RxLate = {0};
+		std::atomic<uint32_t> m_RxAgeCount = {0};
+		std::atomic<uint32_t> m_RxAgeSumUs = {0};
+		std::atomic<uint32_t> m_RxAgeMaxUs = {0};
+		uint32_t m_ReportedRxAgeCount = 0;
+		uint32_t m_ReportedRxAgeSumUs = 0;
+		//Clock sync. The estimate is kept by the RX task, the TX task only sees the pending response and the results.
+		LinkClockSync m_ClockSync;
+		std::mutex m_ClockMutex;
+		LinkClockSync_t m_ClockResponse;
+		bool m_ClockResponsePending = false;
+		unsigned long m_ClockSyncTime = 0;
+		std::atomic<bool> m_ClockSynchronized = {false};
+		std::atomic<int32_t> m_ClockOffsetUs = {0};
+		std::atomic<uint32_t> m_ClockRoundTripUs = {0};
+		//Schema handshake. Rejected items are only touched by the RX task, the TX task sees the flags and versions.
+		LinkItemTable<Named_Object_Callee_Interface, LINK_ITEM_TABLE_SIZE> m_SchemaRejectedItems;
+		std::atomic<bool> m_SchemaVerified = {false};
+		std::atomic<uint32_t> m_SchemaMismatches = {0};
+		std::atomic<uint32_t> m_SchemaVersion = {1};
+		std::atomic<uint32_t> m_SchemaAckedVersion = {0};
+		std::atomic<uint32_t> m_SchemaReplyVersion = {0};
+		std::atomic<bool> m_SchemaReplyPending = {false};
+		unsigned long m_SchemaTime = 0;
+		uint32_t m_SchemaSentVersion = 0;
+		LinkSchemaEntry_t m_SchemaEntries[LINK_ITEM_TABLE_SIZE];
+		uint8_t m_SchemaFrame[LINK_FRAME_MAX_ENCODED_SIZE(LINK_ITEM_TABLE_SIZE * sizeof(LinkSchemaEntry_t))];
+		LinkRxStats_t m_ReportedRxStats;
+		unsigned long m_RxStatsTime = 0;
 		TaskHandle_t m_RXTaskHandle = nullptr;
 		TaskHandle_t m_TXTaskHandle = nullptr;
-		QueueHandle_t m_TXQueue = nullptr;
+		LinkItemTable<LinkTxItem_t, LINK_ITEM_TABLE_SIZE> m_TxItems;
+		std::atomic<uint32_t> m_TxDropCount = {0};
+		//Link health. The hot paths only bump relaxed counters, the TX task turns them into a snapshot.
+		std::atomic<uint32_t> m_TxLatencyHistogram[LINK_HEALTH_LATENCY_BUCKETS] = {};
+		std::atomic<uint32_t> m_TxLatencyMaxUs = {0};
+		uint32_t m_ReportedTxLatencyHistogram[LINK_HEALTH_LATENCY_BUCKETS] = {};
+		LinkTxLaneStats_t m_LinkHealthTxStats;
+		LinkRxStats_t m_LinkHealthRxStats;
+		unsigned long m_LinkHealthTime = 0;
+		std::mutex m_LinkHealthMutex;
+		LinkHealth_t m_LinkHealth;
+		LinkHealthCallback_t m_LinkHealthCallback;
 		static void StaticSerialPortMessageManager_RxTask(void *Parameters)
 		{
 			SerialPortMessageManager* aSerialPortMessageManager = (SerialPortMessageManager*)Parameters;
 			aSerialPortMessageManager->SerialPortMessageManager_RxTask();
 		}
 		virtual void SerialPortMessageManager_RxTask();
+		void ReportRxStats();
+		enum TxStageResult_t
+		{
+			TxStageResult_NoSpace,
+			TxStageResult_Staged,
+			TxStageResult_Coalesced,
+		};
+		TxStageResult_t StageTxValue(TxLane_t &Lane, uint16_t ItemId, LinkQoS_t QoS, LinkFloatEncoder* Encoder, DataType_t DataType, const void* Object, size_t Length, size_t Count, size_t ChangeCount);
+		bool StageTxRecord(TxLane_t &Lane, uint16_t ItemId, LinkFloatEncoder* Encoder, DataType_t DataType, const void* Object, size_t Length, size_t Count, size_t ChangeCount, bool &Coalesced);
+		bool FlushTxBatch(TxLane_t &Lane);
+		//Encodes a frame straight into the lane's ring behind the time it was queued. encode(buffer, size) returns the
+		//frame length, or 0 to drop it. Locks are only held while space is reserved and filled, waiting happens outside them.
+		template <typename Encoder>
+		bool QueueEncodedFrame(TxLane_t &Lane, size_t maxLength, Encoder encode, TickType_t wait, unsigned long queuedUs)
+		{
+			const TickType_t deadline = xTaskGetTickCount() + wait;
+			for(;;)
+			{
+				{
+					std::lock_guard<std::mutex> lock(Lane.RingMutex);
+					uint8_t* buffer = (Lane.Depth < Lane.DepthLimit) ? Lane.Ring.Reserve(sizeof(uint32_t) + maxLength) : nullptr;
+					if(buffer)
+					{
+						const uint32_t timestamp = queuedUs;
+						memcpy(buffer, &timestamp, sizeof(timestamp));
+						const size_t length = encode(buffer + sizeof(timestamp), maxLength);
+						if(0 == length) return false;
+						Lane.Ring.Commit(sizeof(timestamp) + length);
+						const uint32_t depth = ++Lane.Depth;
+						if(depth > Lane.MaxDepth) Lane.MaxDepth = depth;
+						return true;
+					}
+				}
+				if(IsTxDeadlinePassed(deadline)) return false;
+				vTaskDelay(1);
+			}
+		}
+		//True once the tick count reaches deadline, also when the count has wrapped since it was set. Waits are
+		//bounded by elapsed ticks rather than by retries, since each retry also spends time locking and encoding.
+		static bool IsTxDeadlinePassed(TickType_t deadline)
+		{
+			return static_cast<int32_t>(xTaskGetTickCount() - deadline) >= 0;
+		}
+		bool FlushDueTxBatch(TxLane_t &Lane);
+		bool WriteTxFrame(TxLane_t &Lane);
+		bool WriteClockFrame(uint16_t Flags, LinkClockSync_t Sync);
+		bool WriteSchemaFrame(uint16_t Flags, uint32_t Version);
+		//Every write to the transport goes through here so a capture sees it
+		size_t WriteTransport(const uint8_t* Data, size_t Length);
+		void WriteTxLanes();
+		void ReportTxStats();
 		static void StaticSerialPortMessageManager_TxTask(void *Parameters)
 		{
 			SerialPortMessageManager* aSerialPortMessageManager = (SerialPortMessageManager*)Parameters;
@@ -0,0 +1,127 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+
+enum PeakInterpolation_t
+{
+	PeakInterpolation_Parabolic,
+	PeakInterpolation_Gaussian,
+};
+
+struct SpectralPeakEstimate_t
+{
+	float Frequency = 0.0f;
+	float Magnitude = 0.0f;
+};
+
+//Finds the K largest local maxima of a magnitude spectrum in a single pass
+//and refines each one to a sub-bin frequency and magnitude.
+template <size_t K>
+class SpectralPeakPicker
+{
+	static_assert(K > 0, "At least one peak is required");
+	public:
+		SpectralPeakPicker( float binWidth
+						  , PeakInterpolation_t interpolation = PeakInterpolation_Gaussian
+						  , float minimumMagnitude = 0.0f )
+						  : m_BinWidth(binWidth)
+						  , m_Interpolation(interpolation)
+						  , m_MinimumMagnitude(minimumMagnitude)
+		{
+		}
+		virtual ~SpectralPeakPicker(){}
+
+		void SetBinWidth(float binWidth) { m_BinWidth = binWidth; }
+		void SetInterpolation(PeakInterpolation_t interpolation) { m_Interpolation = interpolation; }
+		void SetMinimumMagnitude(float minimumMagnitude) { m_MinimumMagnitude = minimumMagnitude; }
+
+		//Fills peaks with up to K peaks sorted by descending magnitude. Returns the number of peaks found.
+		size_t FindPeaks(const float* magnitudes, size_t binCount, SpectralPeakEstimate_t (&peaks)[K])
+		{
+			size_t found = 0;
+			size_t bins[K] = {};
+			float values[K] = {};
+			for(size_t i = 1; i + 1 < binCount; ++i)
+			{
+				const float b = magnitudes[i];
+				if( b <= m_MinimumMagnitude || b <= magnitudes[i - 1] || b < magnitudes[i + 1] ) continue;
+				if( found == K && b <= values[K - 1] ) continue;
+				size_t j = (found < K) ? found++ : K - 1;
+				for(; j > 0 && values[j - 1] < b; --j)
+				{
+					values[j] = values[j - 1];
+					bins[j] = bins[j - 1];
+				}
+				values[j] = b;
+				bins[j] = i;
+			}
+			for(size_t i = 0; i < found; ++i)
+			{
+				peaks[i] = Refine(magnitudes, bins[i]);
+			}
+			for(size_t i = found; i < K; ++i)
+			{
+				peaks[i] = SpectralPeakEstimate_t();
+			}
+			return found;
+		}
+
+	private:
+		float m_BinWidth;
+		PeakInterpolation_t m_Interpolation;
+		float m_MinimumMagnitude;
+
+		SpectralPeakEstimate_t Refine(const float* magnitudes, size_t bin) const
+		{
+			const float a = magnitudes[bin - 1];
+			const float b = magnitudes[bin];
+			const float c = magnitudes[bin + 1];
+			float delta = 0.0f;
+			float magnitude = b;
+			if(PeakInterpolation_Gaussian == m_Interpolation && a > 0.0f && c > 0.0f)
+			{
+				const float la = std::log(a);
+				const float lb = std::log(b);
+				const float lc = std::log(c);
+				const float denominator = la - (2.0f * lb) + lc;
+				if(denominator < 0.0f)
+				{
+					delta = 0.5f * (la - lc) / denominator;
+					magnitude = std::exp(lb - (0.25f * (la - lc) * delta));
+				}
+			}
+			else
+			{
+				const float denominator = a - (2.0f * b) + c;
+				if(denominator < 0.0f)
+				{
+					delta = 0.5f * (a - c) / denominator;
+					magnitude = b - (0.25f * (a - c) * delta);
+				}
+			}
+			SpectralPeakEstimate_t peak;
+			peak.Frequency = (static_cast<float>(bin) + delta) * m_BinWidth;
+			peak.Magnitude = magnitude;
+			return peak;
+		}
+};
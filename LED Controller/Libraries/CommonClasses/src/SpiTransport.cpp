@@ -0,0 +1,171 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifdef BUILD_SPI_TRANSPORT
+
+#include "SpiTransport.h"
+
+SpiTransport::~SpiTransport()
+{
+	ESP_LOGD("~SpiTransport", "Deleting SpiTransport");
+	if(m_TransferTaskHandle)
+	{
+		vTaskDelete(m_TransferTaskHandle);
+		if(SpiTransportRole_Master == m_Role) m_Master.end();
+		else m_Slave.end();
+	}
+	if(m_TxSpaceSemaphore) vSemaphoreDelete(m_TxSpaceSemaphore);
+	for(uint8_t* buffer : mp_TxBuffers) heap_caps_free(buffer);
+	heap_caps_free(mp_RxBuffer);
+}
+
+bool SpiTransport::Begin()
+{
+	for(uint8_t* &buffer : mp_TxBuffers)
+	{
+		buffer = (SpiTransportRole_Master == m_Role) ? m_Master.allocDMABuffer(SPI_TRANSPORT_TRANSFER_SIZE) : m_Slave.allocDMABuffer(SPI_TRANSPORT_TRANSFER_SIZE);
+	}
+	mp_RxBuffer = (SpiTransportRole_Master == m_Role) ? m_Master.allocDMABuffer(SPI_TRANSPORT_TRANSFER_SIZE) : m_Slave.allocDMABuffer(SPI_TRANSPORT_TRANSFER_SIZE);
+	m_TxSpaceSemaphore = xSemaphoreCreateBinary();
+	if(!mp_TxBuffers[0] || !mp_TxBuffers[1] || !mp_RxBuffer || !m_TxSpaceSemaphore)
+	{
+		ESP_LOGE("Begin", "ERROR! \"%s\" could not allocate its DMA buffers.", m_Name.c_str());
+		return false;
+	}
+	m_Buffer.SetTxBuffers(mp_TxBuffers[0], mp_TxBuffers[1]);
+
+	bool started;
+	if(SpiTransportRole_Master == m_Role)
+	{
+		m_Master.setDataMode(SPI_MODE0);
+		m_Master.setFrequency(m_Frequency);
+		m_Master.setMaxTransferSize(SPI_TRANSPORT_TRANSFER_SIZE);
+		started = m_Master.begin(m_SpiBus, m_Sck, m_Miso, m_Mosi, m_Ss);
+	}
+	else
+	{
+		m_Slave.setDataMode(SPI_MODE0);
+		m_Slave.setMaxTransferSize(SPI_TRANSPORT_TRANSFER_SIZE);
+		started = m_Slave.begin(m_SpiBus, m_Sck, m_Miso, m_Mosi, m_Ss);
+	}
+	if(!started)
+	{
+		ESP_LOGE("Begin", "ERROR! \"%s\" could not start the SPI bus.", m_Name.c_str());
+		return false;
+	}
+
+	if(xTaskCreatePinnedToCore( StaticSpiTransport_TransferTask, m_Name.c_str(), 3000, this,  THREAD_PRIORITY_HIGH,  &m_TransferTaskHandle,  m_CoreId ) == pdPASS)
+	ESP_LOGD("Begin", "Transfer Task Created.");
+	else
+	{
+		ESP_LOGE("Begin", "ERROR! Error creating the Transfer Task.");
+		return false;
+	}
+	ESP_LOGI("Begin", "\"%s\" DMA SPI %s at %lu Hz", m_Name.c_str(), (SpiTransportRole_Master == m_Role) ? "master" : "slave", m_Frequency);
+	return true;
+}
+
+int SpiTransport::Available()
+{
+	return m_Buffer.Available();
+}
+
+size_t SpiTransport::Read(uint8_t* buffer, size_t size)
+{
+	return m_Buffer.Read(buffer, size);
+}
+
+//Waits for the transaction in flight to free the other buffer if the frame does not fit
+size_t SpiTransport::Write(const uint8_t* buffer, size_t size)
+{
+	while(!m_Buffer.Write(buffer, size))
+	{
+		if(!m_TxSpaceSemaphore || pdTRUE != xSemaphoreTake(m_TxSpaceSemaphore, SPI_TRANSPORT_WRITE_WAIT))
+		{
+			ESP_LOGW("Write", "WARNING! \"%s\" dropped a %i byte frame.", m_Name.c_str(), size);
+			return 0;
+		}
+	}
+	//An idle master clocks it out straight away, a slave sends it when the master next clocks
+	if(SpiTransportRole_Master == m_Role && m_TransferTaskHandle) xTaskNotifyGive(m_TransferTaskHandle);
+	return size;
+}
+
+void SpiTransport::SetRxCallbacks(TransportRxCallback_t onReceive, TransportRxErrorCallback_t onError)
+{
+	std::lock_guard<std::mutex> lock(m_CallbackMutex);
+	m_OnReceive = onReceive;
+	m_OnError = onError;
+}
+
+size_t SpiTransport::Transfer(const uint8_t* tx)
+{
+	if(SpiTransportRole_Master == m_Role)
+	{
+		return m_Master.transfer(tx, mp_RxBuffer, SPI_TRANSPORT_TRANSFER_SIZE);
+	}
+	//Blocks until the master clocks the transaction. Results are popped so the slave's result queue does not grow.
+	if(!m_Slave.wait(mp_RxBuffer, tx, SPI_TRANSPORT_TRANSFER_SIZE)) return 0;
+	size_t received = SPI_TRANSPORT_TRANSFER_SIZE;
+	if(m_Slave.available())
+	{
+		received = std::min(static_cast<size_t>(m_Slave.size()), received);
+		m_Slave.pop();
+	}
+	return received;
+}
+
+void SpiTransport::ReportRxError(hardwareSerial_error_t error)
+{
+	std::lock_guard<std::mutex> lock(m_CallbackMutex);
+	if(m_OnError) m_OnError(error);
+}
+
+void SpiTransport::SpiTransport_TransferTask()
+{
+	ESP_LOGD("SpiTransport_TransferTask", "Starting Transfer Task.");
+	while(true)
+	{
+		if(SpiTransportRole_Master == m_Role && !m_Buffer.HasTxData())
+		{
+			ulTaskNotifyTake(pdTRUE, SPI_TRANSPORT_POLL_PERIOD);
+		}
+		const uint8_t* tx = m_Buffer.BeginTransfer();
+		xSemaphoreGive(m_TxSpaceSemaphore);
+		const size_t received = Transfer(tx);
+		if(0 == received)
+		{
+			ReportRxError(UART_FRAME_ERROR);
+			vTaskDelay(1);
+			continue;
+		}
+		++m_TransferCount;
+		//Transactions holding nothing but padding are not worth waking the reader for
+		const size_t length = m_Buffer.GetReceivedLength(mp_RxBuffer, received);
+		if(0 == length) continue;
+		if(!m_Buffer.Receive(mp_RxBuffer, length))
+		{
+			ReportRxError(UART_BUFFER_FULL_ERROR);
+			continue;
+		}
+		std::lock_guard<std::mutex> lock(m_CallbackMutex);
+		if(m_OnReceive) m_OnReceive();
+	}
+}
+
+#endif
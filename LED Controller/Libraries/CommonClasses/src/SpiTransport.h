@@ -0,0 +1,114 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+#include <Arduino.h>
+#include <atomic>
+#include <mutex>
+#include <ESP32DMASPIMaster.h>
+#include <ESP32DMASPISlave.h>
+#include "LinkTransport.h"
+#include "LinkTransferBuffer.h"
+#include "SerialMessageManager.h"
+
+#define SPI_TRANSPORT_TRANSFER_SIZE 1024      //Bytes clocked each way by every transaction
+#define SPI_TRANSPORT_RX_RING_SIZE 4096       //Received bytes waiting for the manager's RX task
+#define SPI_TRANSPORT_FREQUENCY 8000000       //Hz. 1 transaction per ms, the ESP32 slave tops out near 10MHz with DMA
+#define SPI_TRANSPORT_POLL_PERIOD 1           //Ticks an idle master waits before clocking in whatever the slave has
+#define SPI_TRANSPORT_WRITE_WAIT 100          //Most ticks a frame waits for room in the fill buffer before it is dropped
+
+static_assert(SPI_TRANSPORT_TRANSFER_SIZE >= MaxMessageLength, "Every link frame must fit one transaction");
+
+enum SpiTransportRole_t
+{
+	SpiTransportRole_Master,
+	SpiTransportRole_Slave,
+};
+
+//Link transport over DMA SPI. Both ends exchange SPI_TRANSPORT_TRANSFER_SIZE bytes per transaction, full duplex,
+//so frames flow both ways at the SPI clock instead of the UART baud rate. The master clocks a transaction as soon
+//as it has a frame to send and every SPI_TRANSPORT_POLL_PERIOD otherwise, so frames from the slave wait at most a
+//poll period plus a transaction. Built with -DBUILD_SPI_TRANSPORT.
+//
+//  SpiTransport transport("CPU3 SPI", SpiTransportRole_Master, VSPI, SCK, MISO, MOSI, SS);
+//  SerialPortMessageManager manager("CPU3", &transport, &serializer);
+//  transport.Begin();
+//  manager.Setup();
+class SpiTransport: public ITransport
+{
+	public:
+		SpiTransport( const String& name
+					, SpiTransportRole_t role
+					, uint8_t spiBus
+					, int8_t sck
+					, int8_t miso
+					, int8_t mosi
+					, int8_t ss
+					, uint32_t frequency = SPI_TRANSPORT_FREQUENCY
+					, BaseType_t coreId = 1 )
+					: m_Name(name)
+					, m_Role(role)
+					, m_SpiBus(spiBus)
+					, m_Sck(sck)
+					, m_Miso(miso)
+					, m_Mosi(mosi)
+					, m_Ss(ss)
+					, m_Frequency(frequency)
+					, m_CoreId(coreId)
+		{
+		}
+		virtual ~SpiTransport();
+		//Starts the bus and the transfer task
+		bool Begin();
+		int Available() override;
+		size_t Read(uint8_t* buffer, size_t size) override;
+		size_t Write(const uint8_t* buffer, size_t size) override;
+		void SetRxCallbacks(TransportRxCallback_t onReceive, TransportRxErrorCallback_t onError) override;
+		uint32_t GetTransferCount() const { return m_TransferCount; }
+		uint32_t GetTxBytes() { return m_Buffer.GetTxBytes(); }
+	private:
+		String m_Name;
+		SpiTransportRole_t m_Role;
+		uint8_t m_SpiBus;
+		int8_t m_Sck;
+		int8_t m_Miso;
+		int8_t m_Mosi;
+		int8_t m_Ss;
+		uint32_t m_Frequency;
+		BaseType_t m_CoreId;
+		ESP32DMASPI::Master m_Master;
+		ESP32DMASPI::Slave m_Slave;
+		uint8_t* mp_TxBuffers[2] = { nullptr, nullptr };
+		uint8_t* mp_RxBuffer = nullptr;
+		LinkTransferBuffer<SPI_TRANSPORT_TRANSFER_SIZE, SPI_TRANSPORT_RX_RING_SIZE> m_Buffer;
+		SemaphoreHandle_t m_TxSpaceSemaphore = nullptr;
+		TaskHandle_t m_TransferTaskHandle = nullptr;
+		std::mutex m_CallbackMutex;
+		TransportRxCallback_t m_OnReceive;
+		TransportRxErrorCallback_t m_OnError;
+		std::atomic<uint32_t> m_TransferCount = {0};
+		//Runs one transaction. Returns the bytes received, 0 if it failed.
+		size_t Transfer(const uint8_t* tx);
+		void ReportRxError(hardwareSerial_error_t error);
+		static void StaticSpiTransport_TransferTask(void *Parameters)
+		{
+			SpiTransport* aSpiTransport = (SpiTransport*)Parameters;
+			aSpiTransport->SpiTransport_TransferTask();
+		}
+		void SpiTransport_TransferTask();
+};
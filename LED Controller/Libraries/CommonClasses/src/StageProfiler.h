@@ -0,0 +1,207 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <type_traits>
+#include <cstdint>
+#include <cstddef>
+#include "ValueStore.h"
+
+#if defined(ESP_PLATFORM)
+	#include <xtensa/core-macros.h>
+#else
+	#include <chrono>
+#endif
+
+//Profiling scopes compile to nothing unless ENABLE_STAGE_PROFILER is defined in the build flags.
+#ifdef ENABLE_STAGE_PROFILER
+	#define PROFILER_CONCAT_INNER(a, b) a##b
+	#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_INNER(a, b)
+	#define PROFILE_STAGE(profiler, stage) ScopedStageTimer<typename std::remove_reference<decltype(profiler)>::type> PROFILER_CONCAT(stageTimer_, __LINE__)(profiler, stage)
+#else
+	#define PROFILE_STAGE(profiler, stage)
+#endif
+
+//Cycle counter on the ESP32, nanoseconds on the host
+inline uint32_t GetProfilerTicks()
+{
+#if defined(ESP_PLATFORM)
+	return xthal_get_ccount();
+#else
+	return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+inline const char* GetProfilerTicksUnit()
+{
+#if defined(ESP_PLATFORM)
+	return "cycles";
+#else
+	return "ns";
+#endif
+}
+
+struct StageStatistics_t
+{
+	uint32_t Count = 0;
+	uint32_t Min = 0;
+	uint32_t Max = 0;
+	uint32_t Mean = 0;
+	uint32_t P95 = 0;  //Upper edge of the histogram bucket holding the 95th percentile
+};
+
+//Fixed size per stage accumulators with log2 histogram buckets.
+//Each stage must be recorded from a single task, and only that task may call GetStatistics for it. Other tasks
+//request a snapshot instead: the recording task publishes the stage's statistics on its next Record and starts a
+//new interval, and GetSnapshot returns the last one published. This keeps the recording path lock free.
+template <size_t STAGE_COUNT, size_t BUCKET_COUNT = 16, size_t FIRST_BUCKET_SHIFT = 6>
+class StageProfiler
+{
+	static_assert(BUCKET_COUNT > 1 && BUCKET_COUNT + FIRST_BUCKET_SHIFT <= 32, "Histogram must fit 32 bit ticks");
+	public:
+		StageProfiler()
+		{
+			for(size_t i = 0; i < STAGE_COUNT; ++i)
+			{
+				Clear(m_Stages[i]);
+				m_ResetRequested[i].store(false, std::memory_order_relaxed);
+				m_SnapshotRequested[i].store(false, std::memory_order_relaxed);
+			}
+		}
+		virtual ~StageProfiler(){}
+
+		inline void Record(size_t stage, uint32_t ticks)
+		{
+			Stage_t &s = m_Stages[stage];
+			if(m_SnapshotRequested[stage].load(std::memory_order_relaxed) && m_SnapshotRequested[stage].exchange(false, std::memory_order_relaxed))
+			{
+				const StageStatistics_t snapshot = GetStatistics(stage);
+				m_Snapshots[stage].Store(&snapshot);
+				Clear(s);
+			}
+			if(m_ResetRequested[stage].load(std::memory_order_relaxed))
+			{
+				Clear(s);
+				m_ResetRequested[stage].store(false, std::memory_order_relaxed);
+			}
+			if(ticks < s.Min) s.Min = ticks;
+			if(ticks > s.Max) s.Max = ticks;
+			s.Total += ticks;
+			++s.Buckets[GetBucket(ticks)];
+			++s.Count;
+		}
+
+		StageStatistics_t GetStatistics(size_t stage) const
+		{
+			const Stage_t &s = m_Stages[stage];
+			StageStatistics_t result;
+			result.Count = s.Count;
+			if(0 == result.Count) return result;
+			result.Min = s.Min;
+			result.Max = s.Max;
+			result.Mean = static_cast<uint32_t>(s.Total / result.Count);
+			const uint32_t target = result.Count - (result.Count / 20);
+			uint32_t cumulative = 0;
+			for(size_t i = 0; i < BUCKET_COUNT; ++i)
+			{
+				cumulative += s.Buckets[i];
+				if(cumulative >= target)
+				{
+					result.P95 = (i + 1 < BUCKET_COUNT) ? GetBucketUpperEdge(i) : result.Max;
+					break;
+				}
+			}
+			return result;
+		}
+
+		//Statistics of the interval that ended when the recording task last took a snapshot. Safe from any task.
+		StageStatistics_t GetSnapshot(size_t stage) const
+		{
+			StageStatistics_t result;
+			m_Snapshots[stage].Load(&result);
+			return result;
+		}
+
+		uint32_t GetBucketCount(size_t stage, size_t bucket) const { return m_Stages[stage].Buckets[bucket]; }
+		static uint32_t GetBucketUpperEdge(size_t bucket) { return (1UL << (bucket + FIRST_BUCKET_SHIFT + 1)) - 1; }
+		static size_t GetBucket(uint32_t ticks)
+		{
+			if(0 == ticks) return 0;
+			const size_t log2 = 31 - __builtin_clz(ticks);
+			if(log2 <= FIRST_BUCKET_SHIFT) return 0;
+			const size_t bucket = log2 - FIRST_BUCKET_SHIFT;
+			return (bucket < BUCKET_COUNT) ? bucket : BUCKET_COUNT - 1;
+		}
+
+		void RequestReset(size_t stage) { m_ResetRequested[stage].store(true, std::memory_order_relaxed); }
+		void RequestResetAll()
+		{
+			for(size_t i = 0; i < STAGE_COUNT; ++i) RequestReset(i);
+		}
+		void RequestSnapshot(size_t stage) { m_SnapshotRequested[stage].store(true, std::memory_order_relaxed); }
+		void RequestSnapshotAll()
+		{
+			for(size_t i = 0; i < STAGE_COUNT; ++i) RequestSnapshot(i);
+		}
+		size_t GetStageCount() const { return STAGE_COUNT; }
+
+	private:
+		struct Stage_t
+		{
+			uint32_t Count;
+			uint32_t Min;
+			uint32_t Max;
+			uint64_t Total;
+			uint32_t Buckets[BUCKET_COUNT];
+		};
+		Stage_t m_Stages[STAGE_COUNT];
+		std::atomic<bool> m_ResetRequested[STAGE_COUNT];
+		std::atomic<bool> m_SnapshotRequested[STAGE_COUNT];
+		ValueStore<StageStatistics_t, 1> m_Snapshots[STAGE_COUNT];
+
+		static void Clear(Stage_t &s)
+		{
+			s.Count = 0;
+			s.Min = UINT32_MAX;
+			s.Max = 0;
+			s.Total = 0;
+			for(size_t i = 0; i < BUCKET_COUNT; ++i) s.Buckets[i] = 0;
+		}
+};
+
+template <typename PROFILER>
+class ScopedStageTimer
+{
+	public:
+		ScopedStageTimer(PROFILER &profiler, size_t stage)
+						: m_Profiler(profiler)
+						, m_Stage(stage)
+						, m_Start(GetProfilerTicks())
+		{
+		}
+		~ScopedStageTimer()
+		{
+			m_Profiler.Record(m_Stage, GetProfilerTicks() - m_Start);
+		}
+	private:
+		PROFILER &m_Profiler;
+		const size_t m_Stage;
+		const uint32_t m_Start;
+};
@@ -2,6 +2,8 @@
 
 #include <vector>
 #include <sstream>
+#include <cstdlib>
+#include <cstring>
 #include "Streaming.h"
 
 typedef enum LogicType_t {
@@ -22,6 +24,8 @@ typedef struct ValidValueComparator_t {
     const String StringValue;
 } ValidValueComparator_t;
 
+#define VALID_VALUE_NUMBER_LENGTH 32
+
 typedef const std::vector<String> ValidStringValues_t;
 typedef const std::vector<ValidValueComparator_t> ValidValueComparators_t;
 
@@ -49,20 +53,27 @@ public:
 
     virtual ~ValidValueChecker() {}
 
-    virtual bool IsValidStringValue(const String &stringValue) const
+    bool IsValidStringValue(const String &stringValue) const
+    {
+        return IsValidStringValue(stringValue.c_str(), stringValue.length());
+    }
+
+    //Checks the first length characters of value, which need not be terminated, without allocating.
+    //Every check goes through this overload, so it is the one to override.
+    virtual bool IsValidStringValue(const char* value, size_t length) const
     {
         if (mp_ValidStrings)
         {
             for (const String& validValue : *mp_ValidStrings)
             {
                 ESP_LOGD("ValidValueChecker:IsValidStringValue", 
-                         "IsValidStringValue Match Check between: \"%s\" and \"%s\"", 
-                         stringValue.c_str(), validValue.c_str());
-                if (stringValue.equals(validValue))
+                         "IsValidStringValue Match Check between: \"%.*s\" and \"%s\"", 
+                         (int)length, value, validValue.c_str());
+                if (validValue.length() == length && 0 == strncmp(validValue.c_str(), value, length))
                 {
                     ESP_LOGD("ValidValueChecker:IsValidStringValue", 
-                             "\"%s\" IsValidStringValue VALID VALUE: \"%s\"", 
-                             stringValue.c_str(), validValue.c_str());
+                             "\"%.*s\" IsValidStringValue VALID VALUE: \"%s\"", 
+                             (int)length, value, validValue.c_str());
                     return true;
                 }
             }
@@ -70,7 +81,11 @@ public:
         } 
         else if (mp_ValidValueComparators)
         {
-            float numericValue = stringValue.toFloat();  // Convert the string to a float
+            char number[VALID_VALUE_NUMBER_LENGTH];
+            const size_t numberLength = (length < sizeof(number)) ? length : sizeof(number) - 1;
+            memcpy(number, value, numberLength);
+            number[numberLength] = '\0';
+            float numericValue = strtof(number, nullptr);  // Convert the string to a float
             for (const ValidValueComparator_t& comparator : *mp_ValidValueComparators)
             {
                 float comparatorValue = comparator.StringValue.toFloat();  // Convert comparator value to float
@@ -97,7 +112,7 @@ public:
                 {
                     ESP_LOGD("ValidValueChecker:IsValidStringValue", 
                              "\"%s\" IsValidStringValue VALID VALUE: \"%s\" with comparator %d", 
-                             stringValue.c_str(), comparator.StringValue.c_str(), comparator.ComparatorType);
+                             number, comparator.StringValue.c_str(), comparator.ComparatorType);
                     return true;
                 }
             }
@@ -110,6 +125,12 @@ public:
         return false;
     }
 
+    //False if every value is valid, so callers can skip encoding values to check them
+    bool IsConfigured() const
+    {
+        return m_IsConfigured;
+    }
+
 private:
     ValidStringValues_t* const mp_ValidStrings;
     ValidValueComparators_t* const mp_ValidValueComparators;
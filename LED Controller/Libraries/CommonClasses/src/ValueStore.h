@@ -0,0 +1,132 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
+enum ValueStoreKind_t
+{
+	ValueStoreKind_Atomic,          //The whole value fits one atomic word
+	ValueStoreKind_SequenceLock,    //Readers retry if a write ran while they copied
+	ValueStoreKind_Locked,          //Values that cannot be copied as bytes
+};
+
+template <typename T, size_t COUNT>
+constexpr ValueStoreKind_t GetValueStoreKind()
+{
+	if(!std::is_trivially_copyable<T>::value) return ValueStoreKind_Locked;
+	if(sizeof(T) * COUNT <= sizeof(uint64_t)) return ValueStoreKind_Atomic;
+	return ValueStoreKind_SequenceLock;
+}
+
+//Published copy of COUNT values, read without taking the writer's lock. Store must only be called by one writer at
+//a time, which the owner ensures, e.g. LocalDataItem stores under its own lock. Loads never block the writer.
+//Depends only on the standard library, so any layer can publish through it.
+//
+//  Writer:  store.Store(values);
+//  Reader:  store.Load(values);
+template <typename T, size_t COUNT, ValueStoreKind_t KIND = GetValueStoreKind<T, COUNT>()>
+class ValueStore;
+
+//Values of up to 8 bytes go through a single atomic word, 32 bits wide where they fit so the ESP32 needs no
+//library call for them.
+template <typename T, size_t COUNT>
+class ValueStore<T, COUNT, ValueStoreKind_Atomic>
+{
+	public:
+		void Store(const T* values)
+		{
+			Word_t word = 0;
+			memcpy(&word, values, SIZE);
+			m_Word.store(word, std::memory_order_release);
+		}
+		void Load(T* values) const
+		{
+			const Word_t word = m_Word.load(std::memory_order_acquire);
+			memcpy(values, &word, SIZE);
+		}
+	private:
+		static constexpr size_t SIZE = sizeof(T) * COUNT;
+		typedef typename std::conditional<(SIZE <= sizeof(uint32_t)), uint32_t, uint64_t>::type Word_t;
+		std::atomic<Word_t> m_Word = {0};
+};
+
+//Larger values are kept as relaxed atomic words behind a sequence count that is odd while a write runs. A reader
+//copies the words and retries if the count was odd or changed meanwhile, so it always gets one whole value.
+template <typename T, size_t COUNT>
+class ValueStore<T, COUNT, ValueStoreKind_SequenceLock>
+{
+	public:
+		void Store(const T* values)
+		{
+			uint32_t words[WORDS] = {};
+			memcpy(words, values, SIZE);
+			const uint32_t sequence = m_Sequence.load(std::memory_order_relaxed);
+			m_Sequence.store(sequence + 1, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+			for(size_t i = 0; i < WORDS; ++i) m_Words[i].store(words[i], std::memory_order_relaxed);
+			m_Sequence.store(sequence + 2, std::memory_order_release);
+		}
+		void Load(T* values) const
+		{
+			uint32_t words[WORDS];
+			for(size_t attempt = 0; ; ++attempt)
+			{
+				//A writer on the same core cannot finish while the reader spins, so give it the CPU after a few tries
+				if(attempt >= YIELD_AFTER_ATTEMPTS) std::this_thread::yield();
+				const uint32_t before = m_Sequence.load(std::memory_order_acquire);
+				if(before & 1) continue;
+				for(size_t i = 0; i < WORDS; ++i) words[i] = m_Words[i].load(std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_acquire);
+				if(before == m_Sequence.load(std::memory_order_relaxed)) break;
+			}
+			memcpy(values, words, SIZE);
+		}
+	private:
+		static constexpr size_t SIZE = sizeof(T) * COUNT;
+		static constexpr size_t WORDS = (SIZE + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+		static constexpr size_t YIELD_AFTER_ATTEMPTS = 4;
+		std::atomic<uint32_t> m_Sequence = {0};
+		std::atomic<uint32_t> m_Words[WORDS] = {};
+};
+
+template <typename T, size_t COUNT>
+class ValueStore<T, COUNT, ValueStoreKind_Locked>
+{
+	public:
+		void Store(const T* values)
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			for(size_t i = 0; i < COUNT; ++i) m_Values[i] = values[i];
+		}
+		void Load(T* values) const
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			for(size_t i = 0; i < COUNT; ++i) values[i] = m_Values[i];
+		}
+	private:
+		mutable std::mutex m_Mutex;
+		T m_Values[COUNT] = {};
+};
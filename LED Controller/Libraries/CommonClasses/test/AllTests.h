@@ -24,9 +24,26 @@
 
 #include "Test_PreferencesWrapper.h"
 #include "Test_AudioBuffer.h"
+#include "Test_GoertzelDetector.h"
+#include "Test_SpectralPeakPicker.h"
+#include "Test_BandLayout.h"
+#include "Test_StageProfiler.h"
+#include "Test_LinkFrame.h"
+#include "Test_LinkFrameReceiver.h"
+#include "Test_LinkItemTable.h"
+#include "Test_LinkTxBatcher.h"
+#include "Test_LinkTxRing.h"
+#include "Test_LinkFloatCodec.h"
+#include "Test_LinkTransferBuffer.h"
+#include "Test_LinkClockSync.h"
+#include "Test_LinkCapture.h"
+#include "Test_LoopbackTransport.h"
+#include "Test_SerialPortMessageManager.h"
 #include "Test_DataSerializer.h"
 #include "Test_SetupCallerInterface.h"
 #include "Test_ValidValueChecker.h"
+#include "Test_ValueStore.h"
+#include "Test_StringEncoderDecoder.h"
 #include "Test_LocalDataItem.h"
 #include "Test_LocalStringDataItem.h"
 #include "Test_SerialMessageInterface.h"
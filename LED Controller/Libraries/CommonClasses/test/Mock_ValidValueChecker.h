@@ -26,5 +26,6 @@
 class MockValidValueChecker : public ValidValueChecker
 {
 public:
-    MOCK_METHOD(bool, IsValidStringValue, (const String &stringValue), (const, override));
+    using ValidValueChecker::IsValidStringValue;
+    MOCK_METHOD(bool, IsValidStringValue, (const char* value, size_t length), (const, override));
 };
\ No newline at end of file
@@ -0,0 +1,171 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include "BandLayout.h"
+
+using namespace testing;
+
+const static size_t bandLayoutFFTSize = 512;
+const static float bandLayoutSampleRate = 44100.0f;
+const static float bandLayoutBinWidth = bandLayoutSampleRate / bandLayoutFFTSize;
+
+class BandLayoutTests : public Test
+{
+    protected:
+        BandLayout<bandLayoutFFTSize / 2, 64> m_Layout;
+        BandLayoutDescriptor_t Descriptor(uint8_t count, BandScale_t scale, uint16_t minFrequency, uint16_t maxFrequency)
+        {
+            BandLayoutDescriptor_t descriptor;
+            descriptor.BandCount = count;
+            descriptor.Scale = scale;
+            descriptor.MinFrequency = minFrequency;
+            descriptor.MaxFrequency = maxFrequency;
+            return descriptor;
+        }
+        //Original hard coded SAE assignment
+        int LegacySAEBand(float freq)
+        {
+            const float upperEdges[] = { 43, 86, 129, 172, 215, 258, 301, 344, 388, 431, 474, 517, 560, 603, 646, 689
+                                       , 800, 1000, 1250, 1600, 2000, 2500, 3150, 4000, 5000, 6300, 8000, 10000, 12500, 16000, 20000 };
+            if(freq <= 0) return -1;
+            for(int i = 0; i < 31; ++i)
+            {
+                if(freq <= upperEdges[i]) return i;
+            }
+            return 31;
+        }
+};
+
+TEST_F(BandLayoutTests, Default_SAE_Layout_Matches_Legacy_Assignment)
+{
+    ASSERT_TRUE(m_Layout.Configure(BandLayoutDescriptor_t(), bandLayoutSampleRate, bandLayoutFFTSize));
+    EXPECT_EQ(32, m_Layout.GetBandCount());
+    for(size_t bin = 0; bin < bandLayoutFFTSize / 2; ++bin)
+    {
+        EXPECT_EQ(LegacySAEBand(bin * bandLayoutBinWidth), m_Layout.GetBandForBin(bin)) << "Bin: " << bin;
+    }
+}
+
+TEST_F(BandLayoutTests, Reduced_SAE_Layout_Merges_Neighbouring_Bands)
+{
+    ASSERT_TRUE(m_Layout.Configure(Descriptor(16, BandScale_SAE, 0, 22050), bandLayoutSampleRate, bandLayoutFFTSize));
+    for(size_t bin = 1; bin < bandLayoutFFTSize / 2; ++bin)
+    {
+        EXPECT_EQ(LegacySAEBand(bin * bandLayoutBinWidth) / 2, m_Layout.GetBandForBin(bin)) << "Bin: " << bin;
+    }
+}
+
+TEST_F(BandLayoutTests, Band_Edges_And_Bin_Table_Are_Monotonic)
+{
+    const BandScale_t scales[] = { BandScale_Linear, BandScale_Mel, BandScale_Octave, BandScale_SAE };
+    const uint8_t counts[] = { 8, 16, 32, 64 };
+    for(BandScale_t scale : scales)
+    {
+        for(uint8_t count : counts)
+        {
+            BandLayoutDescriptor_t descriptor = Descriptor(count, scale, 40, 16000);
+            if(!m_Layout.IsValidDescriptor(descriptor)) continue;
+            ASSERT_TRUE(m_Layout.Configure(descriptor, bandLayoutSampleRate, bandLayoutFFTSize));
+            for(size_t band = 0; band < count; ++band)
+            {
+                EXPECT_LE(m_Layout.GetBandLowerFrequency(band), m_Layout.GetBandUpperFrequency(band));
+            }
+            int16_t previousBand = -1;
+            for(size_t bin = 0; bin < bandLayoutFFTSize / 2; ++bin)
+            {
+                int16_t band = m_Layout.GetBandForBin(bin);
+                if(band < 0) continue;
+                EXPECT_GE(band, previousBand);
+                previousBand = band;
+            }
+        }
+    }
+}
+
+TEST_F(BandLayoutTests, Octave_Edges_Are_Geometric)
+{
+    ASSERT_TRUE(m_Layout.Configure(Descriptor(10, BandScale_Octave, 20, 20480), bandLayoutSampleRate, bandLayoutFFTSize));
+    for(size_t band = 0; band < 10; ++band)
+    {
+        EXPECT_NEAR(2.0f, m_Layout.GetBandUpperFrequency(band) / m_Layout.GetBandLowerFrequency(band), 0.001f);
+    }
+}
+
+TEST_F(BandLayoutTests, Mel_Bands_Widen_With_Frequency)
+{
+    ASSERT_TRUE(m_Layout.Configure(Descriptor(16, BandScale_Mel, 0, 8000), bandLayoutSampleRate, bandLayoutFFTSize));
+    float previousWidth = 0.0f;
+    for(size_t band = 0; band < 16; ++band)
+    {
+        float width = m_Layout.GetBandUpperFrequency(band) - m_Layout.GetBandLowerFrequency(band);
+        EXPECT_GT(width, previousWidth);
+        previousWidth = width;
+    }
+    EXPECT_FLOAT_EQ(8000.0f, m_Layout.GetBandUpperFrequency(15));
+}
+
+TEST_F(BandLayoutTests, Accumulate_Sums_Bins_Into_Bands)
+{
+    ASSERT_TRUE(m_Layout.Configure(Descriptor(8, BandScale_Linear, 0, 22050), bandLayoutSampleRate, bandLayoutFFTSize));
+    float magnitudes[bandLayoutFFTSize / 2];
+    for(size_t bin = 0; bin < bandLayoutFFTSize / 2; ++bin)
+    {
+        magnitudes[bin] = 0.001f;
+    }
+    float bands[8];
+    m_Layout.Accumulate(magnitudes, bands);
+    float total = 0.0f;
+    for(size_t band = 0; band < 8; ++band)
+    {
+        EXPECT_GT(bands[band], 0.0f);
+        total += bands[band];
+    }
+    //DC bin is excluded
+    EXPECT_NEAR(0.001f * (bandLayoutFFTSize / 2 - 1), total, 0.0001f);
+}
+
+TEST_F(BandLayoutTests, Accumulate_Clips_Bands)
+{
+    ASSERT_TRUE(m_Layout.Configure(Descriptor(8, BandScale_Linear, 0, 22050), bandLayoutSampleRate, bandLayoutFFTSize));
+    float magnitudes[bandLayoutFFTSize / 2];
+    for(size_t bin = 0; bin < bandLayoutFFTSize / 2; ++bin)
+    {
+        magnitudes[bin] = 0.5f;
+    }
+    float bands[8];
+    m_Layout.Accumulate(magnitudes, bands);
+    for(size_t band = 0; band < 8; ++band)
+    {
+        EXPECT_EQ(1.0f, bands[band]);
+    }
+}
+
+TEST_F(BandLayoutTests, Invalid_Descriptors_Are_Rejected)
+{
+    ASSERT_TRUE(m_Layout.Configure(Descriptor(16, BandScale_Linear, 0, 22050), bandLayoutSampleRate, bandLayoutFFTSize));
+    EXPECT_FALSE(m_Layout.Configure(Descriptor(0, BandScale_Linear, 0, 22050), bandLayoutSampleRate, bandLayoutFFTSize));
+    EXPECT_FALSE(m_Layout.Configure(Descriptor(65, BandScale_Linear, 0, 22050), bandLayoutSampleRate, bandLayoutFFTSize));
+    EXPECT_FALSE(m_Layout.Configure(Descriptor(8, BandScale_Octave, 0, 22050), bandLayoutSampleRate, bandLayoutFFTSize));
+    EXPECT_FALSE(m_Layout.Configure(Descriptor(64, BandScale_SAE, 0, 22050), bandLayoutSampleRate, bandLayoutFFTSize));
+    EXPECT_FALSE(m_Layout.Configure(Descriptor(8, BandScale_Mel, 5000, 1000), bandLayoutSampleRate, bandLayoutFFTSize));
+    EXPECT_FALSE(m_Layout.Configure(Descriptor(8, BandScale_Count, 0, 22050), bandLayoutSampleRate, bandLayoutFFTSize));
+    EXPECT_EQ(16, m_Layout.GetBandCount());
+}
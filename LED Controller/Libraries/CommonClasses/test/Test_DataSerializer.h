@@ -411,4 +411,37 @@ TEST_F(DataSerializerTests, Data_Serializer_Serializes_Deserializes_SoundOutputS
     EXPECT_NE(nullptr, namedObject.Object);
     EXPECT_EQ(testValue, *(SoundOutputSource_t*)namedObject.Object);
     EXPECT_STREQ(objectName.c_str(), namedObject.Name.c_str());
-}
\ No newline at end of file
+}
+
+TEST_F(DataSerializerTests, Data_Serializer_Serializes_Deserializes_Float_Array_Frame_Correctly)
+{
+    float testValues[32];
+    for(size_t i = 0; i < 32; ++i) testValues[i] = 0.03f * i;
+    uint8_t frame[LINK_FRAME_MAX_ENCODED_SIZE(sizeof(testValues))];
+    size_t length = mp_dataSerializer->SerializeDataItemToFrame("R_Bands", DataType_Float_t, testValues, 32, 7, 3, frame, sizeof(frame));
+    ASSERT_GT(length, 0);
+    EXPECT_EQ(LINK_FRAME_DELIMITER, frame[length - 1]);
+    LinkFrameView_t view;
+    EXPECT_EQ(true, mp_dataSerializer->DeSerializeFrame(frame, length - 1, view));
+    EXPECT_EQ(GetLinkItemId("R_Bands"), view.Header.ItemId);
+    EXPECT_EQ(DataType_Float_t, view.Header.DataType);
+    EXPECT_EQ(32, view.Header.Count);
+    EXPECT_EQ(7, view.Header.ChangeCount);
+    EXPECT_EQ(3, view.Header.Sequence);
+    ASSERT_EQ(sizeof(testValues), view.PayloadLength);
+    EXPECT_EQ(0, memcmp(testValues, view.Payload, sizeof(testValues)));
+}
+
+TEST_F(DataSerializerTests, Data_Serializer_Frame_Byte_Count_Must_Match_Data_Type)
+{
+    uint32_t testValue = 10;
+    LinkFrameHeader_t header;
+    header.ItemId = GetLinkItemId("Object Name");
+    header.DataType = DataType_Float_t;
+    header.Count = 2;
+    uint8_t frame[LINK_FRAME_MAX_ENCODED_SIZE(sizeof(testValue))];
+    size_t length = EncodeLinkFrame(header, &testValue, sizeof(testValue), frame, sizeof(frame));
+    ASSERT_GT(length, 0);
+    LinkFrameView_t view;
+    EXPECT_EQ(false, mp_dataSerializer->DeSerializeFrame(frame, length - 1, view));
+}
@@ -0,0 +1,131 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include <random>
+#include "GoertzelDetector.h"
+
+using namespace testing;
+
+const static float goertzelSampleRate = 44100.0f;
+const static size_t goertzelBlockSize = 441;
+const static uint8_t goertzelHoldBlocks = 3;
+
+class GoertzelDetectorBankTests : public Test
+{
+    protected:
+        const GoertzelDetectorConfig_t configs[2] = { { 1000.0f, 0.05f, 0.5f }
+                                                    , { 2000.0f, 0.05f, 0.5f } };
+        GoertzelDetectorBank<2> *mp_Bank;
+        std::mt19937 m_Random = std::mt19937(1234);
+        size_t m_SampleCount = 0;
+        void SetUp() override
+        {
+            mp_Bank = new GoertzelDetectorBank<2>(configs, goertzelSampleRate, goertzelBlockSize, goertzelHoldBlocks);
+        }
+        void TearDown() override
+        {
+            delete mp_Bank;
+        }
+        float Tone(float frequency, float amplitude)
+        {
+            return amplitude * sinf(2.0f * (float)M_PI * frequency * (float)m_SampleCount / goertzelSampleRate);
+        }
+        //Returns the number of samples pushed before the first trigger of detector, or 0 if it never triggered.
+        size_t PushUntilTriggered(size_t detector, size_t maxSamples, float frequency, float amplitude, float noise)
+        {
+            std::uniform_real_distribution<float> distribution(-noise, noise);
+            for(size_t i = 1; i <= maxSamples; ++i, ++m_SampleCount)
+            {
+                float sample = Tone(frequency, amplitude) + ((noise > 0.0f) ? distribution(m_Random) : 0.0f);
+                if(mp_Bank->PushSample(sample) & (1UL << detector))
+                {
+                    return i;
+                }
+            }
+            return 0;
+        }
+        size_t CountTriggers(size_t maxSamples, float frequency, float amplitude, float noise)
+        {
+            size_t triggers = 0;
+            std::uniform_real_distribution<float> distribution(-noise, noise);
+            for(size_t i = 0; i < maxSamples; ++i, ++m_SampleCount)
+            {
+                float sample = Tone(frequency, amplitude) + ((noise > 0.0f) ? distribution(m_Random) : 0.0f);
+                uint32_t mask = mp_Bank->PushSample(sample);
+                for(; mask; mask &= (mask - 1)) ++triggers;
+            }
+            return triggers;
+        }
+};
+
+TEST_F(GoertzelDetectorBankTests, Pure_Tone_Magnitude_Is_Normalized)
+{
+    for(size_t i = 0; i < goertzelBlockSize; ++i, ++m_SampleCount)
+    {
+        mp_Bank->PushSample(Tone(1000.0f, 0.5f));
+    }
+    EXPECT_NEAR(0.5f, mp_Bank->GetDetector(0).GetMagnitude(), 0.01f);
+    EXPECT_NEAR(1.0f, mp_Bank->GetDetector(0).GetPurity(), 0.02f);
+    EXPECT_NEAR(0.0f, mp_Bank->GetDetector(1).GetMagnitude(), 0.01f);
+}
+
+TEST_F(GoertzelDetectorBankTests, Detection_Time_Is_Hold_Blocks)
+{
+    size_t samples = PushUntilTriggered(0, goertzelSampleRate, 1000.0f, 0.25f, 0.0f);
+    EXPECT_EQ(goertzelBlockSize * goertzelHoldBlocks, samples);
+    EXPECT_EQ(true, mp_Bank->IsTriggered(0));
+    EXPECT_EQ(false, mp_Bank->IsTriggered(1));
+}
+
+TEST_F(GoertzelDetectorBankTests, Detection_Time_In_Noise)
+{
+    size_t samples = PushUntilTriggered(1, goertzelSampleRate, 2000.0f, 0.1f, 0.1f);
+    EXPECT_GT(samples, 0);
+    EXPECT_LE(samples, goertzelBlockSize * (goertzelHoldBlocks + 1));
+}
+
+TEST_F(GoertzelDetectorBankTests, Continuous_Tone_Triggers_Once)
+{
+    EXPECT_EQ(1, CountTriggers(10 * goertzelSampleRate, 1000.0f, 0.25f, 0.0f));
+}
+
+TEST_F(GoertzelDetectorBankTests, Tone_Re_Arms_After_Absence)
+{
+    EXPECT_EQ(1, CountTriggers(goertzelSampleRate, 1000.0f, 0.25f, 0.0f));
+    EXPECT_EQ(0, CountTriggers(goertzelSampleRate, 1000.0f, 0.0f, 0.0f));
+    EXPECT_EQ(false, mp_Bank->IsTriggered(0));
+    EXPECT_EQ(1, CountTriggers(goertzelSampleRate, 1000.0f, 0.25f, 0.0f));
+}
+
+TEST_F(GoertzelDetectorBankTests, No_False_Triggers_On_Noise)
+{
+    EXPECT_EQ(0, CountTriggers(60 * goertzelSampleRate, 0.0f, 0.0f, 0.8f));
+}
+
+TEST_F(GoertzelDetectorBankTests, No_False_Triggers_On_Off_Frequency_Tone)
+{
+    EXPECT_EQ(0, CountTriggers(10 * goertzelSampleRate, 1500.0f, 0.8f, 0.0f));
+}
+
+TEST_F(GoertzelDetectorBankTests, No_Triggers_Below_Magnitude_Threshold)
+{
+    EXPECT_EQ(0, CountTriggers(10 * goertzelSampleRate, 1000.0f, 0.01f, 0.0f));
+}
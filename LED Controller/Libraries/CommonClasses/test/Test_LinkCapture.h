@@ -0,0 +1,159 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "LinkCapture.h"
+#include "LinkFrameReceiver.h"
+#include "LoopbackTransport.h"
+#include "SerialMessageManager.h"
+
+using namespace testing;
+
+#define TEST_CAPTURE_SIZE 64
+
+class LinkCaptureTests : public Test
+{
+    protected:
+        LinkCapture m_Capture = LinkCapture(TEST_CAPTURE_SIZE);
+
+        void SetUp() override
+        {
+            ASSERT_TRUE(m_Capture.Begin());
+        }
+        std::vector<uint8_t> Dump(LinkCapture &capture)
+        {
+            std::vector<uint8_t> file;
+            capture.Dump([&file](const uint8_t* data, size_t length){ file.insert(file.end(), data, data + length); });
+            return file;
+        }
+        //Records of a dumped capture, with the first byte of each
+        static std::vector<std::pair<LinkCaptureRecordHeader_t, uint8_t>> Records(const std::vector<uint8_t> &file)
+        {
+            std::vector<std::pair<LinkCaptureRecordHeader_t, uint8_t>> records;
+            size_t offset = sizeof(LinkCaptureFileHeader_t);
+            LinkCaptureRecordHeader_t record;
+            const uint8_t* bytes;
+            while(GetNextLinkCaptureRecord(file.data(), file.size(), offset, record, bytes))
+            {
+                records.push_back({ record, record.Length ? bytes[0] : 0 });
+            }
+            EXPECT_EQ(file.size(), offset) << "Records fill the file exactly";
+            return records;
+        }
+};
+
+TEST_F(LinkCaptureTests, Oldest_Records_Make_Room_For_The_Latest)
+{
+    //Each record takes 8 header bytes and 10 data bytes, so 3 fit and every later one wraps the ring
+    std::vector<uint8_t> data(10);
+    for(uint8_t i = 1; i <= 7; ++i)
+    {
+        data[0] = i;
+        m_Capture.Record((i & 1) ? LinkCaptureDirection_Tx : LinkCaptureDirection_Rx, i * 100, data.data(), data.size());
+    }
+    EXPECT_EQ(3, m_Capture.GetRecordCount());
+
+    const std::vector<uint8_t> file = Dump(m_Capture);
+    LinkCaptureFileHeader_t header;
+    memcpy(&header, file.data(), sizeof(header));
+    EXPECT_EQ(LINK_CAPTURE_MAGIC, header.Magic);
+    EXPECT_EQ(3, header.Records);
+    EXPECT_EQ(4, header.Overwritten);
+    const auto records = Records(file);
+    ASSERT_EQ(3, records.size());
+    for(size_t i = 0; i < records.size(); ++i)
+    {
+        EXPECT_EQ(5 + i, records[i].second);
+        EXPECT_EQ((5 + i) * 100, records[i].first.TimeUs);
+        EXPECT_EQ(10, records[i].first.Length);
+    }
+    EXPECT_EQ(LinkCaptureDirection_Tx, records[0].first.Direction);
+    EXPECT_EQ(LinkCaptureDirection_Rx, records[1].first.Direction);
+}
+
+TEST_F(LinkCaptureTests, Records_Larger_Than_The_Ring_Are_Skipped)
+{
+    std::vector<uint8_t> data(TEST_CAPTURE_SIZE);
+    m_Capture.Record(LinkCaptureDirection_Rx, 1, data.data(), 4);
+    m_Capture.Record(LinkCaptureDirection_Rx, 2, data.data(), data.size());
+    EXPECT_EQ(1, m_Capture.GetRecordCount()) << "The records already there are kept";
+    LinkCaptureFileHeader_t header;
+    memcpy(&header, Dump(m_Capture).data(), sizeof(header));
+    EXPECT_EQ(1, header.Skipped);
+
+    m_Capture.Clear();
+    EXPECT_EQ(0, m_Capture.GetUsed());
+    EXPECT_EQ(sizeof(LinkCaptureFileHeader_t), Dump(m_Capture).size());
+}
+
+TEST_F(LinkCaptureTests, Manager_Captures_The_Frames_It_Writes_And_The_Bytes_It_Reads)
+{
+    LoopbackTransport a;
+    LoopbackTransport b;
+    LoopbackTransport::Connect(a, b);
+    DataSerializer serializer;
+    LinkCapture senderCapture(4096);
+    LinkCapture receiverCapture(4096);
+    ASSERT_TRUE(senderCapture.Begin());
+    ASSERT_TRUE(receiverCapture.Begin());
+    SerialPortMessageManager sender("Sender", &a, &serializer);
+    SerialPortMessageManager receiver("Receiver", &b, &serializer);
+    sender.SetLinkCapture(&senderCapture);
+    receiver.SetLinkCapture(&receiverCapture);
+    sender.Setup();
+    receiver.Setup();
+
+    float values[4] = { 1.5f, 2.5f, 3.5f, 4.5f };
+    ASSERT_TRUE(sender.QueueMessageFromDataType("Captured", DataType_Float_t, values, 4, 1));
+    for(size_t i = 0; i < 100 && receiver.GetRxStats().Frames < 3; ++i) delay(5);
+    //The receiver keeps recording until it has read everything the sender recorded
+    sender.SetLinkCapture(nullptr);
+    delay(50);
+    receiver.SetLinkCapture(nullptr);
+
+    //Every frame the sender wrote is in its capture, and the same bytes are in the receiver's
+    std::vector<uint8_t> sent;
+    std::vector<uint8_t> read;
+    for(const auto &capture : { std::make_pair(&senderCapture, &sent), std::make_pair(&receiverCapture, &read) })
+    {
+        const std::vector<uint8_t> file = Dump(*capture.first);
+        size_t offset = sizeof(LinkCaptureFileHeader_t);
+        LinkCaptureRecordHeader_t record;
+        const uint8_t* bytes;
+        while(GetNextLinkCaptureRecord(file.data(), file.size(), offset, record, bytes))
+        {
+            const LinkCaptureDirection_t expected = (&senderCapture == capture.first) ? LinkCaptureDirection_Tx : LinkCaptureDirection_Rx;
+            if(expected == record.Direction) capture.second->insert(capture.second->end(), bytes, bytes + record.Length);
+        }
+    }
+    ASSERT_FALSE(sent.empty());
+    EXPECT_EQ(sent, std::vector<uint8_t>(read.begin(), read.begin() + std::min(read.size(), sent.size())));
+
+    LinkFrameReceiver<MaxMessageLength> frameReceiver;
+    bool found = false;
+    for(uint8_t value : sent)
+    {
+        if(!frameReceiver.Push(value)) continue;
+        const LinkFrameView_t &frame = frameReceiver.GetFrame();
+        found |= (GetLinkItemId("Captured") == frame.Header.ItemId) || (frame.Header.Flags & LINK_FRAME_FLAG_BATCH);
+    }
+    EXPECT_TRUE(found) << "The value frame is among the clock and schema frames";
+}
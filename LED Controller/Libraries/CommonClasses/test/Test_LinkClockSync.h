@@ -0,0 +1,91 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include "LinkClockSync.h"
+
+using namespace testing;
+
+class LinkClockSyncTests : public Test
+{
+    protected:
+        LinkClockSync m_ClockSync;
+
+        bool AddSample(uint32_t originUs, int32_t offsetUs, uint32_t outUs, uint32_t heldUs, uint32_t backUs)
+        {
+            uint32_t destinationUs;
+            const LinkClockSync_t response = Exchange(originUs, offsetUs, outUs, heldUs, backUs, destinationUs);
+            return m_ClockSync.AddSample(response, destinationUs);
+        }
+
+        //The peer clock runs offsetUs ahead. The request takes outUs, the peer holds it heldUs and the response takes backUs.
+        static LinkClockSync_t Exchange(uint32_t originUs, int32_t offsetUs, uint32_t outUs, uint32_t heldUs, uint32_t backUs, uint32_t &destinationUs)
+        {
+            LinkClockSync_t response;
+            response.OriginUs = originUs;
+            response.ReceiveUs = originUs + outUs + offsetUs;
+            response.TransmitUs = response.ReceiveUs + heldUs;
+            destinationUs = originUs + outUs + heldUs + backUs;
+            return response;
+        }
+};
+
+TEST_F(LinkClockSyncTests, Symmetric_Exchange_Gives_The_Exact_Offset)
+{
+    EXPECT_FALSE(m_ClockSync.IsSynchronized());
+    uint32_t destinationUs;
+    const LinkClockSync_t response = Exchange(1000, -250000, 400, 3000, 400, destinationUs);
+    ASSERT_TRUE(m_ClockSync.AddSample(response, destinationUs));
+    EXPECT_TRUE(m_ClockSync.IsSynchronized());
+    EXPECT_EQ(-250000, m_ClockSync.GetOffsetUs());
+    EXPECT_EQ(800, m_ClockSync.GetRoundTripUs());
+    EXPECT_EQ(5000, m_ClockSync.ToLocalTime(5000 - 250000));
+}
+
+TEST_F(LinkClockSyncTests, Shortest_Round_Trip_Wins_And_Ages_Out)
+{
+    //Queued 20ms behind other frames on the way out, so its offset is 10ms off
+    ASSERT_TRUE(AddSample(0, 5000, 20400, 100, 400));
+    EXPECT_EQ(15000, m_ClockSync.GetOffsetUs());
+    ASSERT_TRUE(AddSample(100000, 5000, 400, 100, 400));
+    EXPECT_EQ(5000, m_ClockSync.GetOffsetUs());
+    EXPECT_EQ(800, m_ClockSync.GetRoundTripUs());
+    for(uint32_t i = 1; i < LINK_CLOCK_SYNC_SAMPLES; ++i)
+    {
+        ASSERT_TRUE(AddSample(100000 + i * 100000, 5100, 600, 100, 600));
+        EXPECT_EQ(5000, m_ClockSync.GetOffsetUs()) << "The best sample is kept while it is one of the last " << LINK_CLOCK_SYNC_SAMPLES;
+    }
+    ASSERT_TRUE(AddSample(1000000, 5100, 600, 100, 600));
+    EXPECT_EQ(5100, m_ClockSync.GetOffsetUs());
+}
+
+TEST_F(LinkClockSyncTests, Times_Wrap_And_Nonsense_Is_Refused)
+{
+    uint32_t destinationUs;
+    ASSERT_TRUE(AddSample(UINT32_MAX - 200, 1000, 400, 50, 400));
+    EXPECT_EQ(1000, m_ClockSync.GetOffsetUs());
+    EXPECT_EQ(800, m_ClockSync.GetRoundTripUs());
+
+    LinkClockSync_t response = Exchange(5000, 0, 400, 50, 400, destinationUs);
+    EXPECT_FALSE(m_ClockSync.AddSample(response, response.OriginUs - 1)) << "Arrived before it was sent";
+    response.TransmitUs = response.ReceiveUs - 1;
+    EXPECT_FALSE(m_ClockSync.AddSample(response, destinationUs)) << "Sent before it was received";
+    EXPECT_EQ(1000, m_ClockSync.GetOffsetUs());
+}
@@ -0,0 +1,213 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include <cfloat>
+#include <random>
+#include <vector>
+#include "LinkFloatCodec.h"
+
+using namespace testing;
+
+#define TEST_CODEC_BANDS 32
+
+class LinkFloatCodecTests : public Test
+{
+    protected:
+        FixedLinkFloatEncoder<TEST_CODEC_BANDS> m_Encoder;
+        FixedLinkFloatDecoder<TEST_CODEC_BANDS> m_Decoder;
+        uint8_t m_Payload[LINK_CODEC_MAX_ENCODED_SIZE(TEST_CODEC_BANDS)];
+        std::mt19937 m_Random = std::mt19937(1234);
+
+        std::vector<float> Spectrum(float peak)
+        {
+            std::uniform_real_distribution<float> distribution(0.0f, peak);
+            std::vector<float> bands(TEST_CODEC_BANDS);
+            for(float &band : bands) band = distribution(m_Random);
+            bands[TEST_CODEC_BANDS / 2] = peak;
+            return bands;
+        }
+        size_t Encode(const std::vector<float> &bands, bool replacing = false)
+        {
+            const size_t length = m_Encoder.Encode(bands.data(), bands.size(), replacing, m_Payload, sizeof(m_Payload));
+            EXPECT_GT(length, 0);
+            EXPECT_EQ(length, GetLinkCodecPayloadLength(m_Payload, length));
+            m_Encoder.Accept(replacing);
+            return length;
+        }
+        LinkCodecHeader_t Header() const
+        {
+            LinkCodecHeader_t header;
+            memcpy(&header, m_Payload, sizeof(header));
+            return header;
+        }
+        bool Decode(size_t length, std::vector<float> &bands)
+        {
+            bands.resize(TEST_CODEC_BANDS);
+            return m_Decoder.Decode(m_Payload, length, bands.data(), bands.size());
+        }
+        //Decoded values are within half a quantization step, and the step within 4 * peak / range
+        void ExpectWithinBound(const std::vector<float> &sent, const std::vector<float> &received, float range)
+        {
+            const float scale = Header().Scale;
+            const float peak = *std::max_element(sent.begin(), sent.end());
+            EXPECT_LE(scale, 4.0f * peak / range * 1.0001f);
+            for(size_t i = 0; i < sent.size(); ++i)
+            {
+                EXPECT_NEAR(sent[i], received[i], scale / 2.0f + peak * 4.0f * FLT_EPSILON) << "Band " << i;
+            }
+        }
+};
+
+TEST(LinkRleTests, Round_Trips_Runs_And_Literals_Of_Any_Length)
+{
+    for(size_t width = 1; width <= 2; ++width)
+    {
+        std::vector<uint16_t> codes;
+        codes.insert(codes.end(), 300, 0);
+        for(size_t i = 0; i < 300; ++i) codes.push_back(1 + (i % 200));
+        codes.insert(codes.end(), { 0, 5, 0, 0, 7, 0 });
+        if(2 == width) codes.push_back(0xABCD);
+        std::vector<uint8_t> stream(3 * codes.size());
+        const size_t length = LinkRleEncode(codes.data(), codes.size(), width, stream.data(), stream.size());
+        ASSERT_GT(length, 0);
+        std::vector<uint16_t> decoded(codes.size());
+        EXPECT_TRUE(LinkRleDecode(stream.data(), length, width, decoded.data(), decoded.size()));
+        EXPECT_EQ(codes, decoded);
+        EXPECT_FALSE(LinkRleDecode(stream.data(), length - 1, width, decoded.data(), decoded.size()));
+        EXPECT_FALSE(LinkRleDecode(stream.data(), length, width, decoded.data(), decoded.size() - 1));
+        EXPECT_EQ(0, LinkRleEncode(codes.data(), codes.size(), width, stream.data(), length - 1));
+    }
+}
+
+TEST_F(LinkFloatCodecTests, Quantized8_Error_Stays_Within_Half_A_Step)
+{
+    m_Encoder.SetCodec(LinkCodec_Quantized8);
+    std::vector<float> received;
+    const float peaks[] = { 1.0f, 0.9f, 1.5f, 0.3f, 0.001f, 250.0f, 0.0f, 40.0f };
+    for(float peak : peaks)
+    {
+        const std::vector<float> sent = Spectrum(peak);
+        ASSERT_TRUE(Decode(Encode(sent), received));
+        if(peak > 0.0f) ExpectWithinBound(sent, received, UINT8_MAX);
+        else EXPECT_EQ(sent, received);
+    }
+}
+
+TEST_F(LinkFloatCodecTests, Quantized16_Error_Stays_Within_Half_A_Step)
+{
+    m_Encoder.SetCodec(LinkCodec_Quantized16);
+    std::vector<float> received;
+    for(float peak : { 1.0f, 3.0f, 0.01f })
+    {
+        const std::vector<float> sent = Spectrum(peak);
+        ASSERT_TRUE(Decode(Encode(sent), received));
+        ExpectWithinBound(sent, received, UINT16_MAX);
+    }
+}
+
+TEST_F(LinkFloatCodecTests, Negative_And_Invalid_Values_Are_Handled)
+{
+    m_Encoder.SetCodec(LinkCodec_Quantized8);
+    std::vector<float> sent = Spectrum(1.0f);
+    sent[0] = -0.5f;
+    sent[1] = NAN;
+    std::vector<float> received;
+    ASSERT_TRUE(Decode(Encode(sent), received));
+    EXPECT_EQ(0.0f, received[0]);
+    EXPECT_EQ(0.0f, received[1]);
+    sent[2] = INFINITY;
+    EXPECT_EQ(0, m_Encoder.Encode(sent.data(), sent.size(), false, m_Payload, sizeof(m_Payload)));
+}
+
+TEST_F(LinkFloatCodecTests, Mostly_Unchanged_Spectra_Compress_To_A_Few_Bytes)
+{
+    m_Encoder.SetCodec(LinkCodec_Quantized8);
+    std::vector<float> sent = Spectrum(1.0f);
+    std::vector<float> received;
+    ASSERT_TRUE(Decode(Encode(sent), received));
+    EXPECT_LE(Header().Length, TEST_CODEC_BANDS + 1) << "Key frame of a full spectrum";
+
+    size_t encodedBytes = 0;
+    const size_t frames = 100;
+    for(size_t frame = 0; frame < frames; ++frame)
+    {
+        //A couple of bands move a little between frames
+        sent[frame % TEST_CODEC_BANDS] *= 0.95f;
+        sent[(frame * 7) % TEST_CODEC_BANDS] *= 1.02f;
+        const size_t length = Encode(sent);
+        encodedBytes += length;
+        ASSERT_TRUE(Decode(length, received));
+        ExpectWithinBound(sent, received, UINT8_MAX);
+    }
+    const size_t rawBytes = frames * TEST_CODEC_BANDS * sizeof(float);
+    EXPECT_GE(rawBytes / encodedBytes, 6) << rawBytes << " raw bytes sent as " << encodedBytes;
+
+    //An unchanged spectrum is a single zero run
+    const size_t length = Encode(sent);
+    EXPECT_EQ(sizeof(LinkCodecHeader_t) + 1, length);
+    EXPECT_TRUE(Header().Format & LINK_CODEC_FLAG_DELTA);
+    ASSERT_TRUE(Decode(length, received));
+}
+
+TEST_F(LinkFloatCodecTests, Lost_Frame_Stalls_Deltas_Until_The_Next_Key_Frame)
+{
+    m_Encoder.SetCodec(LinkCodec_Quantized8);
+    std::vector<float> sent = Spectrum(1.0f);
+    std::vector<float> received;
+    ASSERT_TRUE(Decode(Encode(sent), received));
+    sent[3] *= 0.9f;
+    Encode(sent);      //Lost on the wire
+    size_t refused = 0;
+    for(size_t frame = 0; frame < LINK_CODEC_KEY_INTERVAL; ++frame)
+    {
+        sent[5] *= 0.98f;
+        const size_t length = Encode(sent);
+        if(Decode(length, received))
+        {
+            EXPECT_FALSE(Header().Format & LINK_CODEC_FLAG_DELTA);
+            ExpectWithinBound(sent, received, UINT8_MAX);
+            break;
+        }
+        ++refused;
+    }
+    EXPECT_GT(refused, 0);
+    EXPECT_LT(refused, LINK_CODEC_KEY_INTERVAL);
+}
+
+TEST_F(LinkFloatCodecTests, Replacing_A_Frame_Codes_Against_The_One_Before)
+{
+    m_Encoder.SetCodec(LinkCodec_Quantized8);
+    std::vector<float> sent = Spectrum(1.0f);
+    std::vector<float> received;
+    ASSERT_TRUE(Decode(Encode(sent), received));
+    sent[1] *= 0.5f;
+    Encode(sent);                       //Waiting in the batch
+    sent[2] *= 0.5f;
+    const size_t length = Encode(sent, true);   //Replaced it before it was sent
+    ASSERT_TRUE(Decode(length, received));
+    EXPECT_TRUE(Header().Format & LINK_CODEC_FLAG_DELTA);
+    ExpectWithinBound(sent, received, UINT8_MAX);
+
+    //And the next frame follows the replacement
+    sent[3] *= 0.5f;
+    ASSERT_TRUE(Decode(Encode(sent), received));
+    ExpectWithinBound(sent, received, UINT8_MAX);
+}
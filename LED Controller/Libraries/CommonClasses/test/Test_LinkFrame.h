@@ -0,0 +1,136 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "LinkFrame.h"
+
+using namespace testing;
+
+static std::vector<uint8_t> CobsRoundTrip(const std::vector<uint8_t> &input)
+{
+    std::vector<uint8_t> encoded(input.size() + (input.size() / 254) + 2);
+    CobsEncoder encoder(encoded.data(), encoded.size());
+    encoder.Write(input.data(), input.size());
+    size_t encodedLength = encoder.Finish();
+    EXPECT_GT(encodedLength, 0);
+    for(size_t i = 0; i + 1 < encodedLength; ++i)
+    {
+        EXPECT_NE(LINK_FRAME_DELIMITER, encoded[i]);
+    }
+    EXPECT_EQ(LINK_FRAME_DELIMITER, encoded[encodedLength - 1]);
+    std::vector<uint8_t> decoded(input.size() + 1);
+    size_t decodedLength = CobsDecode(encoded.data(), encodedLength - 1, decoded.data());
+    decoded.resize(decodedLength);
+    return decoded;
+}
+
+TEST(LinkFrameTests, Crc16_Matches_CCITT_False_Check_Value)
+{
+    const char* check = "123456789";
+    EXPECT_EQ(0x29B1, LinkCrc16(reinterpret_cast<const uint8_t*>(check), strlen(check)));
+}
+
+TEST(LinkFrameTests, Cobs_Round_Trips_Zeros_And_Long_Runs)
+{
+    std::vector<std::vector<uint8_t>> inputs =
+    {
+        { 0x00 },
+        { 0x00, 0x00 },
+        { 0x11, 0x22, 0x00, 0x33 },
+        { 0x11, 0x00, 0x00, 0x00 },
+        std::vector<uint8_t>(253, 0x01),
+        std::vector<uint8_t>(254, 0x01),
+        std::vector<uint8_t>(255, 0x01),
+        std::vector<uint8_t>(600, 0x00),
+    };
+    std::vector<uint8_t> ramp;
+    for(size_t i = 0; i < 700; ++i) ramp.push_back(static_cast<uint8_t>(i));
+    inputs.push_back(ramp);
+    for(const auto &input : inputs)
+    {
+        EXPECT_EQ(input, CobsRoundTrip(input));
+    }
+}
+
+TEST(LinkFrameTests, Cobs_Encoder_Reports_Overflow)
+{
+    uint8_t input[16] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
+    uint8_t output[16];
+    CobsEncoder encoder(output, sizeof(output));
+    encoder.Write(input, sizeof(input));
+    EXPECT_EQ(0, encoder.Finish());
+}
+
+TEST(LinkFrameTests, Frame_Round_Trip_Preserves_Header_And_Payload)
+{
+    float bands[32];
+    for(size_t i = 0; i < 32; ++i) bands[i] = (i % 3) ? 0.0f : 0.1f * i;
+    LinkFrameHeader_t header;
+    header.ItemId = GetLinkItemId("R_Bands");
+    header.DataType = 7;
+    header.Sequence = 200;
+    header.Count = 32;
+    header.ChangeCount = 123456;
+    uint8_t frame[LINK_FRAME_MAX_ENCODED_SIZE(sizeof(bands))];
+    size_t length = EncodeLinkFrame(header, bands, sizeof(bands), frame, sizeof(frame));
+    ASSERT_GT(length, 0);
+    EXPECT_LT(length, 160);
+
+    LinkFrameView_t view;
+    ASSERT_TRUE(DecodeLinkFrame(frame, length - 1, view));
+    EXPECT_EQ(header.ItemId, view.Header.ItemId);
+    EXPECT_EQ(header.DataType, view.Header.DataType);
+    EXPECT_EQ(header.Sequence, view.Header.Sequence);
+    EXPECT_EQ(header.Count, view.Header.Count);
+    EXPECT_EQ(header.ChangeCount, view.Header.ChangeCount);
+    ASSERT_EQ(sizeof(bands), view.PayloadLength);
+    EXPECT_EQ(0, memcmp(bands, view.Payload, sizeof(bands)));
+}
+
+TEST(LinkFrameTests, Corrupted_Frames_Are_Rejected)
+{
+    uint32_t value = 0xDEADBEEF;
+    LinkFrameHeader_t header;
+    header.ItemId = GetLinkItemId("Amp_Gain");
+    header.Count = 1;
+    uint8_t reference[LINK_FRAME_MAX_ENCODED_SIZE(sizeof(value))];
+    size_t length = EncodeLinkFrame(header, &value, sizeof(value), reference, sizeof(reference));
+    ASSERT_GT(length, 0);
+    for(size_t i = 0; i + 1 < length; ++i)
+    {
+        uint8_t frame[sizeof(reference)];
+        memcpy(frame, reference, length);
+        frame[i] ^= 0x10;
+        LinkFrameView_t view;
+        EXPECT_FALSE(DecodeLinkFrame(frame, length - 1, view)) << "Flipped byte " << i;
+    }
+    uint8_t truncated[sizeof(reference)];
+    memcpy(truncated, reference, length);
+    LinkFrameView_t view;
+    EXPECT_FALSE(DecodeLinkFrame(truncated, length - 3, view));
+}
+
+TEST(LinkFrameTests, Item_Ids_Are_Stable_And_Distinct)
+{
+    static_assert(GetLinkItemId("R_Bands") == GetLinkItemId("R_Bands"), "Item ids must be compile time constants");
+    EXPECT_NE(GetLinkItemId("R_Bands"), GetLinkItemId("L_Bands"));
+    EXPECT_NE(GetLinkItemId("R_Max_Band"), GetLinkItemId("L_Max_Band"));
+}
@@ -0,0 +1,172 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "LinkFrameReceiver.h"
+
+using namespace testing;
+
+#define TEST_RECEIVER_SIZE 256
+
+class LinkFrameReceiverTests : public Test
+{
+    protected:
+        LinkFrameReceiver<TEST_RECEIVER_SIZE> m_Receiver;
+        std::vector<LinkFrameHeader_t> m_Headers;
+        std::vector<std::vector<uint8_t>> m_Payloads;
+
+        std::vector<uint8_t> Encode(uint16_t itemId, uint32_t changeCount, const std::vector<uint8_t> &payload)
+        {
+            LinkFrameHeader_t header;
+            header.ItemId = itemId;
+            header.Count = payload.size();
+            header.ChangeCount = changeCount;
+            std::vector<uint8_t> frame(LINK_FRAME_MAX_ENCODED_SIZE(payload.size()));
+            size_t length = EncodeLinkFrame(header, payload.data(), payload.size(), frame.data(), frame.size());
+            EXPECT_GT(length, 0);
+            frame.resize(length);
+            return frame;
+        }
+        void Feed(const std::vector<uint8_t> &bytes, size_t chunkSize)
+        {
+            size_t index = 0;
+            while(index < bytes.size())
+            {
+                size_t count = std::min(chunkSize, bytes.size() - index);
+                bool frameReady = false;
+                index += m_Receiver.Push(bytes.data() + index, count, frameReady);
+                if(frameReady) Collect();
+            }
+        }
+        void Collect()
+        {
+            const LinkFrameView_t &frame = m_Receiver.GetFrame();
+            m_Headers.push_back(frame.Header);
+            m_Payloads.push_back(std::vector<uint8_t>(frame.Payload, frame.Payload + frame.PayloadLength));
+        }
+};
+
+TEST_F(LinkFrameReceiverTests, Single_Frame_Is_Received)
+{
+    std::vector<uint8_t> payload = { 0x01, 0x00, 0x02, 0x00, 0x00, 0x03 };
+    Feed(Encode(42, 7, payload), 1);
+    ASSERT_EQ(1, m_Payloads.size());
+    EXPECT_EQ(42, m_Headers[0].ItemId);
+    EXPECT_EQ(7, m_Headers[0].ChangeCount);
+    EXPECT_EQ(payload, m_Payloads[0]);
+    EXPECT_EQ(1, m_Receiver.GetFrameCount());
+    EXPECT_EQ(0, m_Receiver.GetCrcErrorCount());
+    EXPECT_EQ(0, m_Receiver.GetFramingErrorCount());
+}
+
+TEST_F(LinkFrameReceiverTests, Fragmented_Frames_Are_Reassembled)
+{
+    std::vector<uint8_t> payload;
+    for(size_t i = 0; i < 200; ++i) payload.push_back((i % 5) ? static_cast<uint8_t>(i) : 0);
+    std::vector<uint8_t> frame = Encode(1, 1, payload);
+    for(size_t chunkSize : { 1, 2, 3, 7, 13, 64 })
+    {
+        Feed(frame, chunkSize);
+    }
+    ASSERT_EQ(6, m_Payloads.size());
+    for(const auto &received : m_Payloads)
+    {
+        EXPECT_EQ(payload, received);
+    }
+}
+
+TEST_F(LinkFrameReceiverTests, Long_Non_Zero_Runs_Are_Received)
+{
+    std::vector<uint8_t> payload(TEST_RECEIVER_SIZE - sizeof(LinkFrameHeader_t) - LINK_FRAME_CRC_SIZE, 0xAA);
+    Feed(Encode(3, 3, payload), 5);
+    ASSERT_EQ(1, m_Payloads.size());
+    EXPECT_EQ(payload, m_Payloads[0]);
+    EXPECT_EQ(0, m_Receiver.GetOverrunCount());
+}
+
+TEST_F(LinkFrameReceiverTests, Back_To_Back_Frames_In_One_Buffer_Are_All_Received)
+{
+    std::vector<uint8_t> stream;
+    for(uint32_t i = 0; i < 10; ++i)
+    {
+        std::vector<uint8_t> frame = Encode(100 + i, i, { static_cast<uint8_t>(i), 0x00, 0xFF });
+        stream.insert(stream.end(), frame.begin(), frame.end());
+    }
+    Feed(stream, stream.size());
+    ASSERT_EQ(10, m_Headers.size());
+    for(uint32_t i = 0; i < 10; ++i)
+    {
+        EXPECT_EQ(100 + i, m_Headers[i].ItemId);
+        EXPECT_EQ(i, m_Headers[i].ChangeCount);
+    }
+}
+
+TEST_F(LinkFrameReceiverTests, Corrupted_Frame_Is_Dropped_And_Next_Frame_Received)
+{
+    std::vector<uint8_t> good = Encode(5, 5, { 0x10, 0x20, 0x30, 0x40 });
+    for(size_t i = 0; i + 1 < good.size(); ++i)
+    {
+        std::vector<uint8_t> bad = good;
+        bad[i] ^= 0x10;
+        if(LINK_FRAME_DELIMITER == bad[i]) bad[i] = 0x01;
+        Feed(bad, 3);
+    }
+    EXPECT_EQ(0, m_Payloads.size());
+    EXPECT_EQ(good.size() - 1, m_Receiver.GetCrcErrorCount() + m_Receiver.GetFramingErrorCount());
+    Feed(good, 3);
+    ASSERT_EQ(1, m_Payloads.size());
+    EXPECT_EQ(5, m_Headers[0].ItemId);
+}
+
+TEST_F(LinkFrameReceiverTests, Truncated_Frame_Resyncs_On_Delimiter)
+{
+    std::vector<uint8_t> good = Encode(9, 9, { 0x01, 0x02, 0x03 });
+    std::vector<uint8_t> stream(good.begin(), good.begin() + good.size() / 2);
+    stream.push_back(LINK_FRAME_DELIMITER);
+    stream.insert(stream.end(), good.begin(), good.end());
+    Feed(stream, 4);
+    ASSERT_EQ(1, m_Payloads.size());
+    EXPECT_EQ(9, m_Headers[0].ItemId);
+    EXPECT_EQ(1, m_Receiver.GetCrcErrorCount() + m_Receiver.GetFramingErrorCount());
+}
+
+TEST_F(LinkFrameReceiverTests, Leading_Garbage_And_Empty_Frames_Are_Ignored)
+{
+    std::vector<uint8_t> stream = { LINK_FRAME_DELIMITER, LINK_FRAME_DELIMITER, 0x37, 0x12, LINK_FRAME_DELIMITER, LINK_FRAME_DELIMITER };
+    std::vector<uint8_t> good = Encode(11, 1, { 0x00 });
+    stream.insert(stream.end(), good.begin(), good.end());
+    Feed(stream, 1);
+    ASSERT_EQ(1, m_Payloads.size());
+    EXPECT_EQ(std::vector<uint8_t>({ 0x00 }), m_Payloads[0]);
+    EXPECT_EQ(1, m_Receiver.GetFramingErrorCount());
+}
+
+TEST_F(LinkFrameReceiverTests, Overrun_Discards_Until_Delimiter)
+{
+    std::vector<uint8_t> stream(TEST_RECEIVER_SIZE * 3, 0x55);
+    stream.push_back(LINK_FRAME_DELIMITER);
+    std::vector<uint8_t> good = Encode(12, 2, { 0x01 });
+    stream.insert(stream.end(), good.begin(), good.end());
+    Feed(stream, 32);
+    EXPECT_EQ(1, m_Receiver.GetOverrunCount());
+    ASSERT_EQ(1, m_Payloads.size());
+    EXPECT_EQ(12, m_Headers[0].ItemId);
+}
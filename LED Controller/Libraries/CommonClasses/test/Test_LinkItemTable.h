@@ -0,0 +1,76 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "LinkItemTable.h"
+#include "LinkFrame.h"
+
+using namespace testing;
+
+TEST(LinkItemTableTests, Inserted_Items_Are_Found)
+{
+    LinkItemTable<int, 16> table;
+    int items[3] = {1, 2, 3};
+    EXPECT_TRUE(table.Insert(GetLinkItemId("R_Bands"), &items[0]));
+    EXPECT_TRUE(table.Insert(GetLinkItemId("L_Bands"), &items[1]));
+    EXPECT_TRUE(table.Insert(GetLinkItemId("Amp_Gain"), &items[2]));
+    EXPECT_EQ(&items[0], table.Find(GetLinkItemId("R_Bands")));
+    EXPECT_EQ(&items[1], table.Find(GetLinkItemId("L_Bands")));
+    EXPECT_EQ(&items[2], table.Find(GetLinkItemId("Amp_Gain")));
+    EXPECT_EQ(nullptr, table.Find(GetLinkItemId("FFT_Gain")));
+    EXPECT_EQ(3, table.GetCount());
+}
+
+TEST(LinkItemTableTests, Duplicate_Ids_And_Full_Table_Are_Rejected)
+{
+    LinkItemTable<int, 4> table;
+    int items[4];
+    EXPECT_TRUE(table.Insert(1, &items[0]));
+    EXPECT_FALSE(table.Insert(1, &items[1]));
+    EXPECT_TRUE(table.Insert(2, &items[1]));
+    EXPECT_TRUE(table.Insert(3, &items[2]));
+    EXPECT_FALSE(table.Insert(4, &items[3]));
+    EXPECT_EQ(nullptr, table.Find(4));
+}
+
+TEST(LinkItemTableTests, Colliding_Ids_Survive_Removal)
+{
+    //Every id lands in slot 5 so they form one probe run that wraps around the end of the table
+    LinkItemTable<int, 8> table;
+    const std::vector<uint16_t> ids = { 0x0005, 0x0105, 0x0205, 0x0305, 0x0006 };
+    int items[5];
+    for(size_t i = 0; i < ids.size(); ++i) ASSERT_TRUE(table.Insert(ids[i], &items[i]));
+    EXPECT_TRUE(table.Remove(0x0105));
+    EXPECT_FALSE(table.Remove(0x0105));
+    EXPECT_EQ(nullptr, table.Find(0x0105));
+    for(size_t i = 0; i < ids.size(); ++i)
+    {
+        if(0x0105 != ids[i])
+        {
+            EXPECT_EQ(&items[i], table.Find(ids[i])) << "Id " << ids[i];
+        }
+    }
+    EXPECT_TRUE(table.Remove(0x0005));
+    EXPECT_EQ(&items[2], table.Find(0x0205));
+    EXPECT_EQ(&items[3], table.Find(0x0305));
+    EXPECT_EQ(&items[4], table.Find(0x0006));
+    EXPECT_EQ(3, table.GetCount());
+}
@@ -0,0 +1,148 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "LinkTransferBuffer.h"
+#include "LinkFrameReceiver.h"
+
+using namespace testing;
+
+#define TEST_TRANSFER_SIZE 64
+#define TEST_TRANSFER_RING_SIZE 256
+
+class LinkTransferBufferTests : public Test
+{
+    protected:
+        typedef LinkTransferBuffer<TEST_TRANSFER_SIZE, TEST_TRANSFER_RING_SIZE> TransferBuffer_t;
+        uint8_t m_TxBuffers[2][TEST_TRANSFER_SIZE];
+        TransferBuffer_t m_Sender;
+        TransferBuffer_t m_Receiver;
+        LinkFrameReceiver<TEST_TRANSFER_SIZE> m_FrameReceiver;
+
+        void SetUp() override
+        {
+            m_Sender.SetTxBuffers(m_TxBuffers[0], m_TxBuffers[1]);
+        }
+        static std::vector<uint8_t> Frame(uint16_t itemId, uint32_t value)
+        {
+            LinkFrameHeader_t header;
+            header.ItemId = itemId;
+            header.Count = 1;
+            std::vector<uint8_t> frame(LINK_FRAME_MAX_ENCODED_SIZE(sizeof(value)));
+            frame.resize(EncodeLinkFrame(header, &value, sizeof(value), frame.data(), frame.size()));
+            return frame;
+        }
+        //Drains the receiver in small reads, the way the RX task does, and returns the ids of the frames decoded
+        std::vector<uint16_t> ReceivedIds()
+        {
+            std::vector<uint16_t> ids;
+            uint8_t chunk[7];
+            size_t count;
+            while((count = m_Receiver.Read(chunk, sizeof(chunk))) > 0)
+            {
+                for(size_t i = 0; i < count; ++i)
+                {
+                    if(m_FrameReceiver.Push(chunk[i])) ids.push_back(m_FrameReceiver.GetFrame().Header.ItemId);
+                }
+            }
+            return ids;
+        }
+};
+
+TEST_F(LinkTransferBufferTests, Frames_Are_Packed_Whole_And_Arrive_Through_The_Padding)
+{
+    std::vector<uint16_t> sent;
+    size_t bytes = 0;
+    for(uint16_t id = 1; ; ++id)
+    {
+        const std::vector<uint8_t> frame = Frame(id, id * 1000);
+        if(!m_Sender.Write(frame.data(), frame.size())) break;
+        sent.push_back(id);
+        bytes += frame.size();
+    }
+    ASSERT_GT(sent.size(), 1);
+    EXPECT_LT(bytes, TEST_TRANSFER_SIZE) << "The frame that did not fit was refused whole";
+
+    const uint8_t* transfer = m_Sender.BeginTransfer();
+    ASSERT_NE(nullptr, transfer);
+    for(size_t i = bytes; i < TEST_TRANSFER_SIZE; ++i) EXPECT_EQ(LINK_FRAME_DELIMITER, transfer[i]);
+    EXPECT_EQ(bytes, m_Sender.GetTxBytes());
+
+    EXPECT_TRUE(m_Receiver.Receive(transfer, TEST_TRANSFER_SIZE));
+    EXPECT_EQ(bytes, m_Receiver.Available()) << "Padding is trimmed to the delimiter that ends the last frame";
+    EXPECT_EQ(sent, ReceivedIds());
+    EXPECT_EQ(0, m_FrameReceiver.GetFramingErrorCount());
+    EXPECT_EQ(0, m_FrameReceiver.GetCrcErrorCount());
+}
+
+TEST_F(LinkTransferBufferTests, Frames_Written_During_A_Transfer_Go_In_The_Other_Buffer)
+{
+    const std::vector<uint8_t> first = Frame(1, 10);
+    const std::vector<uint8_t> second = Frame(2, 20);
+    ASSERT_TRUE(m_Sender.Write(first.data(), first.size()));
+    const uint8_t* inFlight = m_Sender.BeginTransfer();
+    const std::vector<uint8_t> clockedOut(inFlight, inFlight + TEST_TRANSFER_SIZE);
+    EXPECT_FALSE(m_Sender.HasTxData());
+
+    ASSERT_TRUE(m_Sender.Write(second.data(), second.size()));
+    EXPECT_TRUE(m_Sender.HasTxData());
+    EXPECT_EQ(clockedOut, std::vector<uint8_t>(inFlight, inFlight + TEST_TRANSFER_SIZE));
+
+    const uint8_t* next = m_Sender.BeginTransfer();
+    EXPECT_NE(inFlight, next);
+    m_Receiver.Receive(clockedOut.data(), clockedOut.size());
+    m_Receiver.Receive(next, TEST_TRANSFER_SIZE);
+    EXPECT_EQ(std::vector<uint16_t>({ 1, 2 }), ReceivedIds());
+}
+
+TEST_F(LinkTransferBufferTests, Frames_Larger_Than_A_Transfer_Are_Refused)
+{
+    const std::vector<uint8_t> frame(TEST_TRANSFER_SIZE + 1, 0x55);
+    EXPECT_FALSE(m_Sender.Write(frame.data(), frame.size()));
+    EXPECT_FALSE(m_Sender.HasTxData());
+    EXPECT_TRUE(m_Sender.Write(frame.data(), TEST_TRANSFER_SIZE));
+    const uint8_t* transfer = m_Sender.BeginTransfer();
+    EXPECT_EQ(0, memcmp(frame.data(), transfer, TEST_TRANSFER_SIZE));
+}
+
+TEST_F(LinkTransferBufferTests, Idle_Transfers_Add_Nothing_And_A_Full_Ring_Refuses_Whole_Transfers)
+{
+    const std::vector<uint8_t> idle(TEST_TRANSFER_SIZE, LINK_FRAME_DELIMITER);
+    EXPECT_TRUE(m_Receiver.Receive(idle.data(), idle.size()));
+    EXPECT_EQ(0, m_Receiver.Available());
+
+    std::vector<uint8_t> busy(TEST_TRANSFER_SIZE);
+    size_t accepted = 0;
+    for(uint8_t seed = 1; accepted < TEST_TRANSFER_RING_SIZE; ++seed)
+    {
+        for(size_t i = 0; i < busy.size(); ++i) busy[i] = static_cast<uint8_t>(seed + i) | 1;
+        if(!m_Receiver.Receive(busy.data(), busy.size())) break;
+        ++accepted;
+    }
+    EXPECT_EQ(3, accepted) << "Each transfer takes its bytes plus a 2 byte length in the ring";
+
+    //Reads cross transfer boundaries and return the bytes in order
+    std::vector<uint8_t> read(accepted * TEST_TRANSFER_SIZE + 5);
+    EXPECT_EQ(accepted * TEST_TRANSFER_SIZE, m_Receiver.Read(read.data(), read.size()));
+    EXPECT_EQ(static_cast<uint8_t>(2 | 1), read[TEST_TRANSFER_SIZE]);
+    EXPECT_EQ(0, m_Receiver.Available());
+    EXPECT_TRUE(m_Receiver.Receive(busy.data(), busy.size()));
+}
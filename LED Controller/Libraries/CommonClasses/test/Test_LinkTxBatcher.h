@@ -0,0 +1,229 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "LinkTxBatcher.h"
+#include "DataSerializer.h"
+
+using namespace testing;
+
+#define TEST_BATCH_SIZE 256
+#define TEST_BATCH_RECORDS 8
+
+class LinkTxBatcherTests : public Test
+{
+    protected:
+        LinkTxBatcher<TEST_BATCH_SIZE, TEST_BATCH_RECORDS> m_Batcher;
+        DataSerializer m_Serializer;
+        alignas(4) uint8_t m_Frame[LINK_FRAME_MAX_ENCODED_SIZE(TEST_BATCH_SIZE)];
+
+        bool Stage(uint16_t itemId, const std::vector<float> &values, uint32_t changeCount)
+        {
+            return m_Batcher.Stage(itemId, DataType_Float_t, values.data(), values.size() * sizeof(float), values.size(), changeCount);
+        }
+        std::vector<LinkFrameView_t> FlushAndDecode(LinkFrameView_t &frame)
+        {
+            size_t length = m_Batcher.Flush(42, m_Frame, sizeof(m_Frame));
+            EXPECT_GT(length, 0);
+            std::vector<LinkFrameView_t> records;
+            if(!DecodeLinkFrame(m_Frame, length - 1, frame)) return records;
+            if(frame.Header.Flags & LINK_FRAME_FLAG_BATCH)
+            {
+                size_t offset = 0;
+                LinkFrameView_t record;
+                while(m_Serializer.GetNextBatchRecord(frame, offset, record))
+                {
+                    EXPECT_TRUE(m_Serializer.ValidateFrame(record));
+                    records.push_back(record);
+                }
+                EXPECT_EQ(frame.PayloadLength, offset);
+            }
+            else
+            {
+                records.push_back(frame);
+            }
+            return records;
+        }
+        std::vector<float> Values(const LinkFrameView_t &record)
+        {
+            EXPECT_EQ(0, reinterpret_cast<uintptr_t>(record.Payload) % 4);
+            const float* values = reinterpret_cast<const float*>(record.Payload);
+            return std::vector<float>(values, values + record.PayloadLength / sizeof(float));
+        }
+};
+
+TEST_F(LinkTxBatcherTests, Single_Update_Is_Sent_As_Plain_Frame)
+{
+    ASSERT_TRUE(Stage(10, { 1.0f, 2.0f }, 3));
+    LinkFrameView_t frame;
+    std::vector<LinkFrameView_t> records = FlushAndDecode(frame);
+    ASSERT_EQ(1, records.size());
+    EXPECT_EQ(0, frame.Header.Flags);
+    EXPECT_EQ(10, records[0].Header.ItemId);
+    EXPECT_EQ(42, records[0].Header.Sequence);
+    EXPECT_EQ(3, records[0].Header.ChangeCount);
+    EXPECT_EQ(std::vector<float>({ 1.0f, 2.0f }), Values(records[0]));
+    EXPECT_TRUE(m_Batcher.IsEmpty());
+}
+
+TEST_F(LinkTxBatcherTests, Several_Items_Share_One_Frame)
+{
+    ASSERT_TRUE(Stage(10, { 1.0f, 2.0f, 3.0f }, 1));
+    ASSERT_TRUE(Stage(11, { 4.0f }, 2));
+    ASSERT_TRUE(m_Batcher.Stage(12, DataType_Uint8_t, "\x01", 1, 1, 3));
+    ASSERT_TRUE(Stage(13, { 5.0f, 6.0f }, 4));
+    LinkFrameView_t frame;
+    std::vector<LinkFrameView_t> records = FlushAndDecode(frame);
+    EXPECT_EQ(LINK_FRAME_FLAG_BATCH, frame.Header.Flags);
+    EXPECT_EQ(4, frame.Header.Count);
+    ASSERT_EQ(4, records.size());
+    EXPECT_EQ(std::vector<float>({ 1.0f, 2.0f, 3.0f }), Values(records[0]));
+    EXPECT_EQ(std::vector<float>({ 4.0f }), Values(records[1]));
+    EXPECT_EQ(1, records[2].PayloadLength);
+    EXPECT_EQ(0x01, records[2].Payload[0]);
+    EXPECT_EQ(std::vector<float>({ 5.0f, 6.0f }), Values(records[3]));
+    for(size_t i = 0; i < records.size(); ++i)
+    {
+        EXPECT_EQ(10 + i, records[i].Header.ItemId);
+        EXPECT_EQ(1 + i, records[i].Header.ChangeCount);
+        EXPECT_EQ(42, records[i].Header.Sequence);
+    }
+    EXPECT_EQ(1, m_Batcher.GetStats().Frames);
+    EXPECT_EQ(4, m_Batcher.GetStats().Records);
+}
+
+TEST_F(LinkTxBatcherTests, Superseded_Values_Collapse_To_The_Latest)
+{
+    ASSERT_TRUE(Stage(10, { 1.0f }, 1));
+    ASSERT_TRUE(Stage(11, { 2.0f }, 1));
+    ASSERT_TRUE(Stage(10, { 3.0f }, 2));
+    ASSERT_TRUE(Stage(10, { 4.0f }, 3));
+    EXPECT_EQ(2, m_Batcher.GetRecordCount());
+    LinkFrameView_t frame;
+    std::vector<LinkFrameView_t> records = FlushAndDecode(frame);
+    ASSERT_EQ(2, records.size());
+    EXPECT_EQ(std::vector<float>({ 4.0f }), Values(records[0]));
+    EXPECT_EQ(3, records[0].Header.ChangeCount);
+    EXPECT_EQ(std::vector<float>({ 2.0f }), Values(records[1]));
+    const LinkTxStats_t &stats = m_Batcher.GetStats();
+    EXPECT_EQ(4, stats.Updates);
+    EXPECT_EQ(2, stats.Coalesced);
+    EXPECT_LT(stats.Bytes, stats.UnbatchedBytes);
+}
+
+TEST_F(LinkTxBatcherTests, Waiting_Values_Are_Found_By_Change_Count)
+{
+    EXPECT_FALSE(m_Batcher.IsStaged(1, 5));
+    EXPECT_TRUE(Stage(1, { 1.0f, 2.0f }, 5));
+    EXPECT_TRUE(m_Batcher.IsStaged(1, 5));
+    EXPECT_FALSE(m_Batcher.IsStaged(1, 6));
+    EXPECT_FALSE(m_Batcher.IsStaged(2, 5));
+    EXPECT_TRUE(Stage(1, { 3.0f, 4.0f }, 6));
+    EXPECT_TRUE(m_Batcher.IsStaged(1, 6));
+    EXPECT_FALSE(m_Batcher.IsStaged(1, 5));
+    m_Batcher.Flush(0, m_Frame, sizeof(m_Frame));
+    EXPECT_FALSE(m_Batcher.IsStaged(1, 6));
+}
+
+TEST_F(LinkTxBatcherTests, Encoded_Values_Of_A_New_Length_Replace_The_Waiting_One)
+{
+    auto StageEncoded = [&](uint16_t itemId, size_t streamLength, uint32_t changeCount)
+    {
+        std::vector<uint8_t> payload(sizeof(LinkCodecHeader_t) + streamLength, static_cast<uint8_t>(changeCount));
+        LinkCodecHeader_t header;
+        header.Format = LinkCodec_Quantized8;
+        header.Length = streamLength;
+        memcpy(payload.data(), &header, sizeof(header));
+        return m_Batcher.Stage(itemId, DataType_Float_t | LINK_DATATYPE_FLAG_ENCODED, payload.data(), payload.size(), 32, changeCount);
+    };
+    ASSERT_TRUE(StageEncoded(10, 3, 1));
+    ASSERT_TRUE(Stage(11, { 2.0f }, 1));
+    ASSERT_TRUE(StageEncoded(10, 9, 2));
+    EXPECT_EQ(2, m_Batcher.GetRecordCount());
+    EXPECT_EQ(1, m_Batcher.GetStats().Coalesced);
+    LinkFrameView_t frame;
+    std::vector<LinkFrameView_t> records = FlushAndDecode(frame);
+    ASSERT_EQ(2, records.size());
+    EXPECT_EQ(std::vector<float>({ 2.0f }), Values(records[0]));
+    EXPECT_EQ(10, records[1].Header.ItemId);
+    EXPECT_EQ(2, records[1].Header.ChangeCount);
+    ASSERT_EQ(sizeof(LinkCodecHeader_t) + 9, records[1].PayloadLength);
+    EXPECT_EQ(2, records[1].Payload[records[1].PayloadLength - 1]);
+}
+
+TEST_F(LinkTxBatcherTests, Full_Batch_Rejects_Until_Flushed)
+{
+    std::vector<float> values(16, 1.0f);
+    size_t staged = 0;
+    while(Stage(100 + staged, values, 1)) ++staged;
+    EXPECT_EQ(TEST_BATCH_SIZE / (sizeof(LinkBatchRecordHeader_t) + sizeof(float) * values.size()), staged);
+    EXPECT_TRUE(Stage(100, values, 2)) << "Items already waiting still coalesce";
+    EXPECT_FALSE(Stage(100, std::vector<float>(2, 1.0f), 3)) << "A size change cannot replace in place";
+    EXPECT_FALSE(Stage(500, std::vector<float>(100, 1.0f), 1));
+    EXPECT_FALSE(m_Batcher.CanStage(LINK_BATCH_MAX_COUNT + 1, LINK_BATCH_MAX_COUNT + 1));
+    LinkFrameView_t frame;
+    EXPECT_EQ(staged, FlushAndDecode(frame).size());
+    EXPECT_TRUE(Stage(500, std::vector<float>(50, 1.0f), 1));
+}
+
+TEST_F(LinkTxBatcherTests, Truncated_Batch_Records_Are_Not_Read)
+{
+    ASSERT_TRUE(Stage(10, { 1.0f, 2.0f }, 1));
+    ASSERT_TRUE(Stage(11, { 3.0f }, 1));
+    LinkFrameView_t frame;
+    ASSERT_EQ(2, FlushAndDecode(frame).size());
+    frame.PayloadLength -= 2;
+    size_t offset = 0;
+    LinkFrameView_t record;
+    EXPECT_TRUE(m_Serializer.GetNextBatchRecord(frame, offset, record));
+    EXPECT_FALSE(m_Serializer.GetNextBatchRecord(frame, offset, record));
+}
+
+TEST_F(LinkTxBatcherTests, Timestamp_Leads_The_Payload_And_Keeps_Records_Aligned)
+{
+    const uint32_t captureUs = 0xC0FFEE01;
+    for(uint16_t batchSize = 1; batchSize <= 2; ++batchSize)
+    {
+        for(uint16_t id = 1; id <= batchSize; ++id) ASSERT_TRUE(Stage(id, { 1.0f * id, 2.0f }, id));
+        const size_t length = m_Batcher.Flush(42, m_Frame, sizeof(m_Frame), &captureUs);
+        LinkFrameView_t frame;
+        ASSERT_TRUE(DecodeLinkFrame(m_Frame, length - 1, frame));
+        EXPECT_TRUE(frame.Header.Flags & LINK_FRAME_FLAG_TIMESTAMP);
+        uint32_t timestampUs = 0;
+        ASSERT_TRUE(TakeLinkFrameTimestamp(frame, timestampUs));
+        EXPECT_EQ(captureUs, timestampUs);
+        EXPECT_FALSE(frame.Header.Flags & LINK_FRAME_FLAG_TIMESTAMP);
+        if(1 == batchSize)
+        {
+            EXPECT_TRUE(m_Serializer.ValidateFrame(frame));
+            EXPECT_EQ(std::vector<float>({ 1.0f, 2.0f }), Values(frame));
+        }
+        else
+        {
+            size_t offset = 0;
+            LinkFrameView_t record;
+            size_t records = 0;
+            while(m_Serializer.GetNextBatchRecord(frame, offset, record)) EXPECT_EQ(std::vector<float>({ 1.0f * ++records, 2.0f }), Values(record));
+            EXPECT_EQ(batchSize, records);
+        }
+    }
+}
+
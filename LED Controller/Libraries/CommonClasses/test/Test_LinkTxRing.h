@@ -0,0 +1,160 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include <deque>
+#include <thread>
+#include <vector>
+#include "LinkTxRing.h"
+
+using namespace testing;
+
+#define TEST_RING_SIZE 64
+
+class LinkTxRingTests : public Test
+{
+    protected:
+        LinkTxRing<TEST_RING_SIZE> m_Ring;
+
+        bool Write(const std::vector<uint8_t> &message)
+        {
+            uint8_t* slot = m_Ring.Reserve(message.size());
+            if(nullptr == slot) return false;
+            memcpy(slot, message.data(), message.size());
+            m_Ring.Commit(message.size());
+            return true;
+        }
+        bool Read(std::vector<uint8_t> &message)
+        {
+            const uint8_t* data;
+            size_t length;
+            if(!m_Ring.Peek(data, length)) return false;
+            message.assign(data, data + length);
+            m_Ring.Consume();
+            return true;
+        }
+        static std::vector<uint8_t> Message(size_t length, uint8_t seed)
+        {
+            std::vector<uint8_t> message(length);
+            for(size_t i = 0; i < length; ++i) message[i] = static_cast<uint8_t>(seed + i);
+            return message;
+        }
+};
+
+TEST_F(LinkTxRingTests, Messages_Come_Out_In_Order_With_Their_Own_Length)
+{
+    EXPECT_TRUE(m_Ring.IsEmpty());
+    ASSERT_TRUE(Write(Message(3, 1)));
+    ASSERT_TRUE(Write(Message(10, 2)));
+    ASSERT_TRUE(Write(Message(1, 3)));
+    EXPECT_EQ(3 * 2 + 14, m_Ring.GetUsed());
+    std::vector<uint8_t> message;
+    ASSERT_TRUE(Read(message));
+    EXPECT_EQ(Message(3, 1), message);
+    ASSERT_TRUE(Read(message));
+    EXPECT_EQ(Message(10, 2), message);
+    ASSERT_TRUE(Read(message));
+    EXPECT_EQ(Message(1, 3), message);
+    EXPECT_FALSE(Read(message));
+    EXPECT_TRUE(m_Ring.IsEmpty());
+}
+
+TEST_F(LinkTxRingTests, Full_Ring_Rejects_Until_Space_Is_Freed)
+{
+    size_t written = 0;
+    while(Write(Message(8, written))) ++written;
+    EXPECT_EQ((TEST_RING_SIZE - 1) / 10, written);
+    EXPECT_EQ(nullptr, m_Ring.Reserve(8));
+    std::vector<uint8_t> message;
+    ASSERT_TRUE(Read(message));
+    EXPECT_EQ(Message(8, 0), message);
+    EXPECT_FALSE(Write(Message(8, 100))) << "Head may not catch up with the tail";
+    ASSERT_TRUE(Read(message));
+    EXPECT_TRUE(Write(Message(8, 100)));
+    EXPECT_EQ(nullptr, m_Ring.Reserve(TEST_RING_SIZE));
+}
+
+TEST_F(LinkTxRingTests, Messages_Never_Split_Across_The_End)
+{
+    //Leave 6 bytes at the end, too few for the next message, so it has to wrap to the start
+    ASSERT_TRUE(Write(Message(56, 1)));
+    std::vector<uint8_t> message;
+    ASSERT_TRUE(Read(message));
+    ASSERT_TRUE(Write(Message(20, 2)));
+    ASSERT_TRUE(Read(message));
+    EXPECT_EQ(Message(20, 2), message);
+    EXPECT_TRUE(m_Ring.IsEmpty());
+}
+
+TEST_F(LinkTxRingTests, Wrap_With_Less_Than_A_Length_Header_Left)
+{
+    ASSERT_TRUE(Write(Message(61, 1)));
+    std::vector<uint8_t> message;
+    ASSERT_TRUE(Read(message));
+    ASSERT_TRUE(Write(Message(5, 2)));
+    ASSERT_TRUE(Read(message));
+    EXPECT_EQ(Message(5, 2), message);
+}
+
+TEST_F(LinkTxRingTests, Random_Sizes_Match_A_Reference_Queue)
+{
+    std::deque<std::vector<uint8_t>> reference;
+    uint32_t random = 12345;
+    for(size_t step = 0; step < 20000; ++step)
+    {
+        random = random * 1103515245 + 12345;
+        if((random >> 16) % 3)
+        {
+            std::vector<uint8_t> message = Message(1 + (random >> 8) % 30, step);
+            if(Write(message)) reference.push_back(message);
+        }
+        else
+        {
+            std::vector<uint8_t> message;
+            ASSERT_EQ(!reference.empty(), Read(message));
+            if(!reference.empty())
+            {
+                ASSERT_EQ(reference.front(), message) << "Step " << step;
+                reference.pop_front();
+            }
+        }
+    }
+}
+
+TEST_F(LinkTxRingTests, Concurrent_Writer_And_Reader_Keep_Every_Message)
+{
+    const size_t messages = 50000;
+    std::thread writer([&]()
+    {
+        for(size_t i = 0; i < messages; ++i)
+        {
+            std::vector<uint8_t> message = Message(1 + i % 20, i);
+            while(!Write(message)) std::this_thread::yield();
+        }
+    });
+    for(size_t i = 0; i < messages; ++i)
+    {
+        std::vector<uint8_t> message;
+        while(!Read(message)) std::this_thread::yield();
+        ASSERT_EQ(Message(1 + i % 20, i), message) << "Message " << i;
+    }
+    writer.join();
+    EXPECT_TRUE(m_Ring.IsEmpty());
+}
@@ -85,6 +85,17 @@ TEST_F(LocalDataItemFunctionCallTests, Registration_With_Setup_Caller)
     DestroyDataItem();
 }
 
+TEST_F(LocalDataItemFunctionCallTests, Values_Are_Stored_Inside_The_Item)
+{
+    CreateDataItem();
+    const uintptr_t item = reinterpret_cast<uintptr_t>(mp_DataItem);
+    const uintptr_t value = reinterpret_cast<uintptr_t>(mp_DataItem->GetValuePointer());
+    EXPECT_GE(value, item);
+    EXPECT_LE(value + sizeof(int32_t), item + sizeof(*mp_DataItem)) << "Setup allocates nothing";
+    EXPECT_EQ(initialValue, mp_DataItem->GetValue());
+    DestroyDataItem();
+}
+
 // Test Fixture for DataItemGetAndSetValueTests
 template <typename T, size_t COUNT>
 class LocalDataItemGetAndSetValueTests : public Test, public SetupCallerInterface
@@ -432,4 +443,18 @@ TEST_F(LocalDataItemGetAndSetValueTestsInt1, Callback_Only_Called_For_New_Values
     EXPECT_CALL(mockNamedCallback_Callback, NewValueCallbackFunction(_,_,_)).Times(1);
     mp_DataItem->SetValue(validValue30);
     ::testing::Mock::VerifyAndClearExpectations(&mockNamedCallback_Callback);
-}
\ No newline at end of file
+}
+TEST(LocalDataItemParseTests, Undecodable_Value_Is_Rejected)
+{
+    NiceMock<MockSetupCallerInterface> setupCaller;
+    const float initialValue = 1.5f;
+    LocalDataItem<float, 2> dataItem("Float Item", initialValue, nullptr, &setupCaller);
+    dataItem.Setup();
+    float values[2];
+    EXPECT_EQ(2, dataItem.ParseStringValueIntoValues(String("2.5|3.5"), values));
+    EXPECT_EQ(0, dataItem.ParseStringValueIntoValues(String("abc|3.5"), values));
+    EXPECT_EQ(0, dataItem.ParseStringValueIntoValues(String("2.5|abc"), values));
+    dataItem.SetValueFromString("abc|3.5");
+    EXPECT_EQ(initialValue, dataItem.GetValuePointer()[0]);
+    EXPECT_EQ(initialValue, dataItem.GetValuePointer()[1]);
+}
@@ -0,0 +1,125 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "LoopbackTransport.h"
+#include "SerialMessageManager.h"
+
+using namespace testing;
+
+#define TEST_LOOPBACK_BUFFER_SIZE 16
+#define TEST_LOOPBACK_DELIVERY_LIMIT_MS 1000
+
+//Receiving end of a float item that keeps the last change count from another thread
+class LoopbackCallee : public Named_Object_Callee_Interface
+{
+    public:
+        LoopbackCallee() : Named_Object_Callee_Interface(4) {}
+        virtual ~LoopbackCallee(){}
+        UpdateStatus_t New_Object_From_Sender(const Named_Object_Caller_Interface* sender, const void* object, const size_t changeCount) override
+        {
+            FirstValue = static_cast<const float*>(object)[0];
+            ChangeCount = changeCount;
+            return UpdateStatus_t();
+        }
+        String GetName() const override { return "Loopback_Value"; }
+        std::atomic<float> FirstValue = {0.0f};
+        std::atomic<size_t> ChangeCount = {0};
+};
+
+class LoopbackTransportTests : public Test
+{
+    protected:
+        LoopbackTransport m_A = LoopbackTransport(TEST_LOOPBACK_BUFFER_SIZE);
+        LoopbackTransport m_B = LoopbackTransport(TEST_LOOPBACK_BUFFER_SIZE);
+        size_t m_Received = 0;
+        std::vector<hardwareSerial_error_t> m_Errors;
+
+        void SetUp() override
+        {
+            LoopbackTransport::Connect(m_A, m_B);
+            m_B.SetRxCallbacks([this](){ ++m_Received; }, [this](hardwareSerial_error_t error){ m_Errors.push_back(error); });
+        }
+};
+
+TEST_F(LoopbackTransportTests, Bytes_Written_To_One_End_Are_Read_From_The_Other)
+{
+    const std::vector<uint8_t> first = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+    const std::vector<uint8_t> second = { 11, 12, 13, 14, 15, 16 };
+    EXPECT_EQ(first.size(), m_A.Write(first.data(), first.size()));
+    EXPECT_EQ(1, m_Received) << "The reader is woken by each write";
+    EXPECT_EQ(0, m_A.Available()) << "Nothing comes back to the writer";
+
+    std::vector<uint8_t> read(8);
+    EXPECT_EQ(8, m_B.Read(read.data(), read.size()));
+    EXPECT_EQ(second.size(), m_A.Write(second.data(), second.size())) << "Writes wrap around the buffer";
+    EXPECT_EQ(8, m_B.Available());
+    read.resize(20);
+    EXPECT_EQ(8, m_B.Read(read.data(), read.size()));
+    EXPECT_EQ(std::vector<uint8_t>({ 9, 10, 11, 12, 13, 14, 15, 16 }), std::vector<uint8_t>(read.begin(), read.begin() + 8));
+    EXPECT_TRUE(m_Errors.empty());
+}
+
+TEST_F(LoopbackTransportTests, Writes_That_Do_Not_Fit_Are_Dropped_Whole_And_Reported)
+{
+    const std::vector<uint8_t> data(TEST_LOOPBACK_BUFFER_SIZE - 2, 0x55);
+    EXPECT_EQ(data.size(), m_A.Write(data.data(), data.size()));
+    EXPECT_EQ(0, m_A.Write(data.data(), 3));
+    EXPECT_EQ(data.size(), m_B.Available());
+    EXPECT_EQ(std::vector<hardwareSerial_error_t>({ UART_BUFFER_FULL_ERROR }), m_Errors);
+
+    m_B.Disconnect();
+    EXPECT_EQ(0, m_A.Write(data.data(), 1)) << "A disconnected end sends nothing";
+}
+
+TEST_F(LoopbackTransportTests, Managers_Exchange_Values_Through_Their_Tasks)
+{
+    LoopbackTransport a;
+    LoopbackTransport b;
+    LoopbackTransport::Connect(a, b);
+    DataSerializer serializer;
+    //Declared before the managers so their tasks have stopped before it goes
+    LoopbackCallee callee;
+    SerialPortMessageManager sender("Sender", &a, &serializer);
+    SerialPortMessageManager receiver("Receiver", &b, &serializer);
+    receiver.RegisterForNewRxValueNotification(&callee);
+    sender.Setup();
+    receiver.Setup();
+
+    float values[4] = { 1.5f, 2.5f, 3.5f, 4.5f };
+    const size_t updates = 10;
+    for(size_t i = 1; i <= updates; ++i)
+    {
+        values[0] = i * 1.5f;
+        EXPECT_TRUE(sender.QueueMessageFromDataType(callee.GetName(), DataType_Float_t, values, 4, i));
+    }
+    const auto start = std::chrono::steady_clock::now();
+    while(callee.ChangeCount < updates && std::chrono::steady_clock::now() - start < std::chrono::milliseconds(TEST_LOOPBACK_DELIVERY_LIMIT_MS))
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(updates, callee.ChangeCount);
+    EXPECT_FLOAT_EQ(updates * 1.5f, callee.FirstValue);
+    EXPECT_EQ(0, receiver.GetRxStats().CrcErrors);
+}
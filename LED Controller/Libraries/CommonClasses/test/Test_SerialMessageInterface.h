@@ -39,7 +39,7 @@ template <typename T, size_t COUNT>
 class MockSerialMessageInterface
 {
     public:
-        MOCK_METHOD(T*, GetValuePointer, (), (const));
+        MOCK_METHOD(const T*, GetValuePointer, (), (const));
         MOCK_METHOD(bool, UpdateStore, (const T *value, size_t count), ());
         MOCK_METHOD(bool, EqualsValue, (T *object, size_t count), (const));
         MOCK_METHOD(String, GetName, (), (const));
@@ -68,7 +68,7 @@ class SerialMessageInterfaceTester: public SerialMessageInterface<T, COUNT>
         {
             return m_MockSerialMessageInterface;
         }
-        virtual T* GetValuePointer() const override
+        virtual const T* GetValuePointer() const override
         {
             return m_MockSerialMessageInterface.GetValuePointer();
         }
@@ -0,0 +1,631 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "SerialMessageManager.h"
+#include "LinkFrameReceiver.h"
+
+using namespace testing;
+
+#define TEST_FAST_CALL_LIMIT_MS 20
+
+//UART stand-in that takes WriteDelayMs for every frame written and keeps what was sent
+class SlowHardwareSerial : public HardwareSerial
+{
+    public:
+        SlowHardwareSerial() : HardwareSerial(1) {}
+        virtual ~SlowHardwareSerial(){}
+        size_t write(uint8_t data) override
+        {
+            return write(&data, 1);
+        }
+        size_t write(const uint8_t* buffer, size_t size) override
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(WriteDelayMs));
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Sent.insert(m_Sent.end(), buffer, buffer + size);
+            return size;
+        }
+        std::vector<uint8_t> GetSent()
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            return m_Sent;
+        }
+        uint32_t WriteDelayMs = 0;
+    private:
+        std::mutex m_Mutex;
+        std::vector<uint8_t> m_Sent;
+};
+
+//Runs the TX side without the FreeRTOS task so a test decides when, and how fast, the link drains
+class SerialPortMessageManagerTester : public SerialPortMessageManager
+{
+    public:
+        SerialPortMessageManagerTester(HardwareSerial* serial, DataSerializer* dataSerializer)
+                                      : SerialPortMessageManager("Tester", serial, dataSerializer)
+        {
+        }
+        using SerialPortMessageManager::ServiceTx;
+        using SerialPortMessageManager::ProcessRxFrame;
+        using SerialPortMessageManager::HandleRxError;
+        using SerialPortMessageManager::ReceiveRxFrame;
+        using SerialPortMessageManager::UpdateLinkHealth;
+        using SerialPortMessageManager::ServiceClockSync;
+        using SerialPortMessageManager::ServiceSchema;
+};
+
+//Receiving end of an encoded float array
+class EncodedBandsCallee : public Named_Object_Callee_Interface
+{
+    public:
+        EncodedBandsCallee() : Named_Object_Callee_Interface(32) {}
+        virtual ~EncodedBandsCallee(){}
+        UpdateStatus_t New_Object_From_Sender(const Named_Object_Caller_Interface* sender, const void* object, const size_t changeCount) override
+        {
+            const float* values = static_cast<const float*>(object);
+            Values.assign(values, values + 32);
+            ChangeCount = changeCount;
+            return UpdateStatus_t();
+        }
+        String GetName() const override { return "R_Bands"; }
+        LinkFloatDecoder* GetLinkDecoder() override { return &m_Decoder; }
+        std::vector<float> Values;
+        size_t ChangeCount = 0;
+    private:
+        FixedLinkFloatDecoder<32> m_Decoder;
+};
+
+//Receiving end of the bands that keeps the capture time reported with them
+class CaptureTimeCallee : public Named_Object_Callee_Interface
+{
+    public:
+        CaptureTimeCallee() : Named_Object_Callee_Interface(32) {}
+        virtual ~CaptureTimeCallee(){}
+        UpdateStatus_t New_Object_From_Sender(const Named_Object_Caller_Interface* sender, const void* object, const size_t changeCount) override
+        {
+            ++Calls;
+            HasCaptureTime = sender->GetRxCaptureTime(CaptureUs);
+            return UpdateStatus_t();
+        }
+        String GetName() const override { return "R_Bands"; }
+        size_t Calls = 0;
+        bool HasCaptureTime = false;
+        uint32_t CaptureUs = 0;
+};
+
+//Receiving end of a float item that reports its type for the schema check and counts its values
+class SchemaCallee : public Named_Object_Callee_Interface
+{
+    public:
+        SchemaCallee(const char* name, size_t count, DataType_t dataType) : Named_Object_Callee_Interface(count), m_Name(name), m_DataType(dataType) {}
+        virtual ~SchemaCallee(){}
+        UpdateStatus_t New_Object_From_Sender(const Named_Object_Caller_Interface* sender, const void* object, const size_t changeCount) override
+        {
+            ++Calls;
+            return UpdateStatus_t();
+        }
+        String GetName() const override { return m_Name; }
+        DataType_t GetDataType() override { return m_DataType; }
+        size_t Calls = 0;
+    private:
+        String m_Name;
+        DataType_t m_DataType;
+};
+
+class SerialPortMessageManagerTests : public Test
+{
+    protected:
+        SlowHardwareSerial m_Serial;
+        DataSerializer m_Serializer;
+        SerialPortMessageManagerTester m_Manager = SerialPortMessageManagerTester(&m_Serial, &m_Serializer);
+        float m_Bands[32] = {};
+
+        bool SendBands(const char* name, uint32_t changeCount, uint32_t &elapsedMs)
+        {
+            m_Bands[0] = changeCount;
+            const auto start = std::chrono::steady_clock::now();
+            const bool result = m_Manager.QueueMessageFromDataType(name, DataType_Float_t, m_Bands, 32, changeCount);
+            elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+            return result;
+        }
+        //Hands the frames written since the last call to the other end
+        static void Deliver(SlowHardwareSerial &serial, size_t &delivered, SerialPortMessageManagerTester &receiver)
+        {
+            LinkFrameReceiver<MaxMessageLength> frameReceiver;
+            const std::vector<uint8_t> sent = serial.GetSent();
+            for(; delivered < sent.size(); ++delivered)
+            {
+                if(frameReceiver.Push(sent[delivered])) receiver.ReceiveRxFrame(frameReceiver.GetFrame());
+            }
+        }
+        //Fills the TX ring while nothing drains it
+        void StallLink()
+        {
+            LinkTxItem_t filler;
+            filler.QoS = LinkQoS_BestEffort;
+            m_Manager.RegisterTxItem(GetLinkItemId("Filler"), &filler);
+            uint32_t elapsedMs;
+            for(size_t i = 0; i < 2 * SERIAL_TX_RING_SIZE / sizeof(m_Bands); ++i) SendBands("Filler", i, elapsedMs);
+            m_Manager.DeRegisterTxItem(GetLinkItemId("Filler"));
+            ASSERT_GT(filler.Dropped, 0);
+        }
+        //Change counts of every value of itemName that made it onto the wire
+        std::vector<uint32_t> ReceivedChangeCounts(const char* itemName)
+        {
+            std::vector<uint32_t> changeCounts;
+            LinkFrameReceiver<MaxMessageLength> receiver;
+            for(uint8_t value : m_Serial.GetSent())
+            {
+                if(!receiver.Push(value)) continue;
+                const LinkFrameView_t &frame = receiver.GetFrame();
+                if(frame.Header.Flags & LINK_FRAME_FLAG_BATCH)
+                {
+                    size_t offset = 0;
+                    LinkFrameView_t record;
+                    while(m_Serializer.GetNextBatchRecord(frame, offset, record))
+                    {
+                        if(GetLinkItemId(itemName) == record.Header.ItemId) changeCounts.push_back(record.Header.ChangeCount);
+                    }
+                }
+                else if(GetLinkItemId(itemName) == frame.Header.ItemId)
+                {
+                    changeCounts.push_back(frame.Header.ChangeCount);
+                }
+            }
+            return changeCounts;
+        }
+};
+
+TEST_F(SerialPortMessageManagerTests, Latest_Value_Items_Coalesce_While_Link_Is_Stalled)
+{
+    LinkTxItem_t item;
+    m_Manager.RegisterTxItem(GetLinkItemId("R_Bands"), &item);
+    uint32_t elapsedMs;
+    for(uint32_t i = 0; i < 100; ++i)
+    {
+        EXPECT_TRUE(SendBands("R_Bands", i, elapsedMs));
+    }
+    EXPECT_EQ(1, item.Queued);
+    EXPECT_EQ(99, item.Coalesced);
+    EXPECT_EQ(0, item.Dropped);
+    m_Manager.ServiceTx();
+    EXPECT_EQ(std::vector<uint32_t>({ 99 }), ReceivedChangeCounts("R_Bands"));
+    m_Manager.DeRegisterTxItem(GetLinkItemId("R_Bands"));
+}
+
+TEST_F(SerialPortMessageManagerTests, Best_Effort_Items_Drop_Without_Waiting_When_Full)
+{
+    StallLink();
+    LinkTxItem_t item;
+    item.QoS = LinkQoS_BestEffort;
+    m_Manager.RegisterTxItem(GetLinkItemId("L_Bands"), &item);
+    uint32_t elapsedMs;
+    uint32_t maxElapsedMs = 0;
+    for(uint32_t i = 0; i < 100; ++i)
+    {
+        SendBands("L_Bands", i, elapsedMs);
+        maxElapsedMs = std::max(maxElapsedMs, elapsedMs);
+    }
+    EXPECT_EQ(0, item.Coalesced);
+    EXPECT_GE(item.Dropped, 98);
+    EXPECT_EQ(100, item.Queued + item.Dropped);
+    EXPECT_LE(maxElapsedMs, TEST_FAST_CALL_LIMIT_MS);
+    m_Manager.DeRegisterTxItem(GetLinkItemId("L_Bands"));
+}
+
+TEST_F(SerialPortMessageManagerTests, Must_Deliver_Items_Wait_A_Bounded_Time_Then_Drop)
+{
+    StallLink();
+    LinkTxItem_t item;
+    item.QoS = LinkQoS_MustDeliver;
+    m_Manager.RegisterTxItem(GetLinkItemId("Amp_Gain"), &item);
+    uint32_t elapsedMs;
+    uint32_t maxElapsedMs = 0;
+    for(uint32_t i = 0; i < 3; ++i)
+    {
+        SendBands("Amp_Gain", i, elapsedMs);
+        maxElapsedMs = std::max(maxElapsedMs, elapsedMs);
+    }
+    EXPECT_EQ(0, item.Coalesced);
+    EXPECT_GT(item.Dropped, 0);
+    EXPECT_LE(maxElapsedMs, SERIAL_TX_RING_WAIT * portTICK_PERIOD_MS + TEST_FAST_CALL_LIMIT_MS);
+    m_Manager.DeRegisterTxItem(GetLinkItemId("Amp_Gain"));
+}
+
+TEST_F(SerialPortMessageManagerTests, Slow_Link_Never_Stalls_The_Producer)
+{
+    LinkTxItem_t bands;
+    LinkTxItem_t setting;
+    setting.QoS = LinkQoS_MustDeliver;
+    m_Manager.RegisterTxItem(GetLinkItemId("R_Bands"), &bands);
+    m_Manager.RegisterTxItem(GetLinkItemId("Amp_Gain"), &setting);
+    m_Serial.WriteDelayMs = 3;
+    std::atomic<bool> running = {true};
+    std::thread txTask([&]()
+    {
+        while(running)
+        {
+            m_Manager.ServiceTx();
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    });
+    uint32_t elapsedMs;
+    uint32_t maxBandsElapsedMs = 0;
+    const uint32_t updates = 500;
+    for(uint32_t i = 0; i < updates; ++i)
+    {
+        SendBands("R_Bands", i, elapsedMs);
+        maxBandsElapsedMs = std::max(maxBandsElapsedMs, elapsedMs);
+        if(0 == i % 10) SendBands("Amp_Gain", i / 10, elapsedMs);
+    }
+    running = false;
+    txTask.join();
+    m_Manager.ServiceTx();
+
+    EXPECT_LE(maxBandsElapsedMs, TEST_FAST_CALL_LIMIT_MS);
+    EXPECT_EQ(updates, bands.Queued + bands.Coalesced + bands.Dropped);
+    EXPECT_GT(bands.Coalesced, 0);
+    std::vector<uint32_t> received = ReceivedChangeCounts("R_Bands");
+    ASSERT_FALSE(received.empty());
+    EXPECT_EQ(updates - 1, received.back()) << "The latest value always goes out";
+
+    //Every setting value that was not dropped arrives, in order
+    received = ReceivedChangeCounts("Amp_Gain");
+    EXPECT_EQ(0, setting.Coalesced);
+    EXPECT_EQ(setting.Queued, received.size());
+    for(size_t i = 1; i < received.size(); ++i) EXPECT_LT(received[i - 1], received[i]);
+    m_Manager.DeRegisterTxItem(GetLinkItemId("R_Bands"));
+    m_Manager.DeRegisterTxItem(GetLinkItemId("Amp_Gain"));
+}
+
+TEST_F(SerialPortMessageManagerTests, Real_Time_Lane_Goes_Out_Ahead_Of_Queued_Bulk_Frames)
+{
+    LinkTxItem_t setting;
+    setting.QoS = LinkQoS_BestEffort;
+    LinkTxItem_t bands;
+    bands.Lane = LinkTxLane_RealTime;
+    m_Manager.RegisterTxItem(GetLinkItemId("Amp_Gain"), &setting);
+    m_Manager.RegisterTxItem(GetLinkItemId("R_Bands"), &bands);
+    m_Manager.SetTxFlushWindow(0);
+    m_Serial.WriteDelayMs = 1;
+    uint32_t elapsedMs;
+    for(uint32_t i = 0; i < 8; ++i) EXPECT_TRUE(SendBands("Amp_Gain", i, elapsedMs));
+    EXPECT_TRUE(SendBands("R_Bands", 1, elapsedMs));
+    m_Manager.ServiceTx();
+
+    //The band frame is the first on the wire even though every setting was queued before it
+    LinkFrameReceiver<MaxMessageLength> receiver;
+    std::vector<uint16_t> itemIds;
+    for(uint8_t value : m_Serial.GetSent())
+    {
+        if(receiver.Push(value)) itemIds.push_back(receiver.GetFrame().Header.ItemId);
+    }
+    ASSERT_EQ(9, itemIds.size());
+    EXPECT_EQ(GetLinkItemId("R_Bands"), itemIds.front());
+    EXPECT_EQ(std::vector<uint32_t>({ 0, 1, 2, 3, 4, 5, 6, 7 }), ReceivedChangeCounts("Amp_Gain"));
+
+    const LinkTxLaneStats_t realTime = m_Manager.GetTxLaneStats(LinkTxLane_RealTime);
+    const LinkTxLaneStats_t bulk = m_Manager.GetTxLaneStats(LinkTxLane_Bulk);
+    EXPECT_EQ(1, realTime.Frames);
+    EXPECT_EQ(8, bulk.Frames);
+    EXPECT_GT(bulk.Bytes, realTime.Bytes);
+    EXPECT_GE(bulk.LatencyMaxUs, 7000) << "The last setting waited for seven frames to be written";
+    EXPECT_LT(realTime.LatencyMaxUs, bulk.LatencyMaxUs);
+    EXPECT_GE(bulk.LatencySumUs, bulk.LatencyMaxUs);
+    m_Manager.DeRegisterTxItem(GetLinkItemId("Amp_Gain"));
+    m_Manager.DeRegisterTxItem(GetLinkItemId("R_Bands"));
+}
+
+TEST_F(SerialPortMessageManagerTests, Full_Bulk_Lane_Does_Not_Block_The_Real_Time_Lane)
+{
+    LinkTxItem_t setting;
+    setting.QoS = LinkQoS_BestEffort;
+    LinkTxItem_t bands;
+    bands.Lane = LinkTxLane_RealTime;
+    m_Manager.RegisterTxItem(GetLinkItemId("Amp_Gain"), &setting);
+    m_Manager.RegisterTxItem(GetLinkItemId("R_Bands"), &bands);
+    m_Manager.SetTxLaneDepthLimit(LinkTxLane_Bulk, 4);
+    uint32_t elapsedMs;
+    for(uint32_t i = 0; i < 10; ++i) SendBands("Amp_Gain", i, elapsedMs);
+
+    //Four frames fill the lane, one value stays staged behind them and the rest are dropped
+    EXPECT_EQ(5, setting.Queued);
+    EXPECT_EQ(5, setting.Dropped);
+    EXPECT_EQ(4, m_Manager.GetTxLaneStats(LinkTxLane_Bulk).MaxDepth);
+    EXPECT_EQ(5, m_Manager.GetTxLaneStats(LinkTxLane_Bulk).Dropped);
+    for(uint32_t i = 0; i < 10; ++i) EXPECT_TRUE(SendBands("R_Bands", i, elapsedMs));
+    EXPECT_EQ(0, bands.Dropped);
+    EXPECT_EQ(0, m_Manager.GetTxLaneStats(LinkTxLane_RealTime).Dropped);
+    m_Manager.ServiceTx();
+    EXPECT_EQ(std::vector<uint32_t>({ 9 }), ReceivedChangeCounts("R_Bands"));
+    EXPECT_EQ(std::vector<uint32_t>({ 0, 1, 2, 3, 4 }), ReceivedChangeCounts("Amp_Gain"));
+    m_Manager.DeRegisterTxItem(GetLinkItemId("Amp_Gain"));
+    m_Manager.DeRegisterTxItem(GetLinkItemId("R_Bands"));
+}
+
+TEST_F(SerialPortMessageManagerTests, Encoded_Items_Arrive_Decoded_In_A_Fraction_Of_The_Bytes)
+{
+    FixedLinkFloatEncoder<32> encoder;
+    encoder.SetCodec(LinkCodec_Quantized8);
+    LinkTxItem_t bands;
+    bands.Encoder = &encoder;
+    m_Manager.RegisterTxItem(GetLinkItemId("R_Bands"), &bands);
+    SerialPortMessageManagerTester receiver(nullptr, &m_Serializer);
+    EncodedBandsCallee callee;
+    receiver.RegisterForNewRxValueNotification(&callee);
+
+    for(size_t i = 0; i < 32; ++i) m_Bands[i] = 0.5f + 0.01f * i;
+    const uint32_t updates = 20;
+    for(uint32_t i = 0; i < updates; ++i)
+    {
+        m_Bands[i % 32] *= 0.9f;
+        uint32_t elapsedMs;
+        EXPECT_TRUE(SendBands("R_Bands", i + 1, elapsedMs));
+        m_Manager.ServiceTx();
+    }
+    const std::vector<uint8_t> sent = m_Serial.GetSent();
+    EXPECT_LT(sent.size() * 3, updates * sizeof(m_Bands)) << "Frames included, less than a third of the raw values";
+
+    LinkFrameReceiver<MaxMessageLength> frameReceiver;
+    for(uint8_t value : sent)
+    {
+        if(frameReceiver.Push(value)) receiver.ProcessRxFrame(frameReceiver.GetFrame());
+    }
+    EXPECT_EQ(updates, callee.ChangeCount);
+    ASSERT_EQ(32, callee.Values.size());
+    for(size_t i = 0; i < 32; ++i) EXPECT_NEAR(m_Bands[i], callee.Values[i], 2.0f * m_Bands[0] / UINT8_MAX);
+    receiver.DeRegisterForNewRxValueNotification(&callee);
+    m_Manager.DeRegisterTxItem(GetLinkItemId("R_Bands"));
+}
+
+TEST_F(SerialPortMessageManagerTests, Retransmissions_Of_A_Waiting_Value_Go_Out_Once)
+{
+    FixedLinkFloatEncoder<32> encoder;
+    encoder.SetCodec(LinkCodec_Quantized8);
+    LinkTxItem_t bands;
+    bands.QoS = LinkQoS_MustDeliver;
+    bands.Encoder = &encoder;
+    m_Manager.RegisterTxItem(GetLinkItemId("R_Bands"), &bands);
+
+    uint32_t elapsedMs;
+    for(size_t i = 0; i < 4; ++i) EXPECT_TRUE(SendBands("R_Bands", 1, elapsedMs));
+    EXPECT_EQ(1, bands.Queued);
+    EXPECT_EQ(3, bands.Coalesced);
+    EXPECT_EQ(3, m_Manager.GetTxStats().Retransmits);
+    m_Manager.ServiceTx();
+    EXPECT_EQ(std::vector<uint32_t>({ 1 }), ReceivedChangeCounts("R_Bands"));
+
+    //Once the value has gone out, a heartbeat sends it again
+    EXPECT_TRUE(SendBands("R_Bands", 1, elapsedMs));
+    m_Manager.ServiceTx();
+    EXPECT_EQ(std::vector<uint32_t>({ 1, 1 }), ReceivedChangeCounts("R_Bands"));
+    EXPECT_EQ(3, m_Manager.GetTxStats().Retransmits);
+    m_Manager.DeRegisterTxItem(GetLinkItemId("R_Bands"));
+}
+
+TEST_F(SerialPortMessageManagerTests, Uart_Error_Events_Are_Counted_As_Link_Statistics)
+{
+    m_Manager.HandleRxError(UART_FIFO_OVF_ERROR);
+    m_Manager.HandleRxError(UART_FIFO_OVF_ERROR);
+    m_Manager.HandleRxError(UART_BUFFER_FULL_ERROR);
+    m_Manager.HandleRxError(UART_PARITY_ERROR);
+    m_Manager.HandleRxError(UART_BREAK_ERROR);
+    const LinkRxStats_t stats = m_Manager.GetRxStats();
+    EXPECT_EQ(2, stats.FifoOverflows);
+    EXPECT_EQ(1, stats.BufferFull);
+    EXPECT_EQ(2, stats.LineErrors);
+    EXPECT_EQ(0, stats.Frames);
+    EXPECT_EQ(0, stats.CrcErrors);
+}
+
+TEST_F(SerialPortMessageManagerTests, Link_Health_Counts_Lost_Frames_And_Latency)
+{
+    LinkTxItem_t setting;
+    setting.QoS = LinkQoS_MustDeliver;
+    m_Manager.RegisterTxItem(GetLinkItemId("Amp_Gain"), &setting);
+    const uint32_t updates = 6;
+    for(uint32_t i = 0; i < updates; ++i)
+    {
+        uint32_t elapsedMs;
+        EXPECT_TRUE(SendBands("Amp_Gain", i, elapsedMs));
+        m_Manager.ServiceTx();
+    }
+
+    //The third frame is lost on the way
+    SerialPortMessageManagerTester receiver(nullptr, &m_Serializer);
+    LinkFrameReceiver<MaxMessageLength> frameReceiver;
+    size_t frames = 0;
+    for(uint8_t value : m_Serial.GetSent())
+    {
+        if(frameReceiver.Push(value) && 3 != ++frames) receiver.ReceiveRxFrame(frameReceiver.GetFrame());
+    }
+    ASSERT_EQ(updates, frames);
+    receiver.HandleRxError(UART_FIFO_OVF_ERROR);
+    receiver.HandleRxError(UART_BUFFER_FULL_ERROR);
+
+    LinkHealth_t published;
+    receiver.SetLinkHealthCallback([&published](const LinkHealth_t &health){ published = health; });
+    receiver.UpdateLinkHealth();
+    EXPECT_EQ(1, published.RxLost);
+    EXPECT_EQ(2, published.RxOverflows);
+    EXPECT_EQ(published, receiver.GetLinkHealth());
+
+    m_Manager.UpdateLinkHealth();
+    const LinkHealth_t sender = m_Manager.GetLinkHealth();
+    uint32_t histogramFrames = 0;
+    for(uint32_t count : sender.TxLatencyHistogram) histogramFrames += count;
+    EXPECT_EQ(updates, histogramFrames);
+    EXPECT_EQ(0, sender.TxDropped);
+    EXPECT_EQ(sender, LinkHealth_t::fromString(sender.toString().c_str()));
+
+    //Latency covers one period, counters run on
+    m_Manager.UpdateLinkHealth();
+    for(uint32_t count : m_Manager.GetLinkHealth().TxLatencyHistogram) EXPECT_EQ(0, count);
+    receiver.UpdateLinkHealth();
+    EXPECT_EQ(1, receiver.GetLinkHealth().RxLost);
+    m_Manager.DeRegisterTxItem(GetLinkItemId("Amp_Gain"));
+}
+
+TEST(LinkHealthTests, Latency_Buckets_Double_From_250us)
+{
+    EXPECT_EQ(0, LinkHealth_t::GetLatencyBucket(0));
+    EXPECT_EQ(0, LinkHealth_t::GetLatencyBucket(249));
+    EXPECT_EQ(1, LinkHealth_t::GetLatencyBucket(250));
+    EXPECT_EQ(2, LinkHealth_t::GetLatencyBucket(999));
+    EXPECT_EQ(3, LinkHealth_t::GetLatencyBucket(1000));
+    EXPECT_EQ(6, LinkHealth_t::GetLatencyBucket(15999));
+    EXPECT_EQ(LINK_HEALTH_LATENCY_BUCKETS - 1, LinkHealth_t::GetLatencyBucket(16000));
+    EXPECT_EQ(LINK_HEALTH_LATENCY_BUCKETS - 1, LinkHealth_t::GetLatencyBucket(UINT32_MAX));
+}
+
+TEST_F(SerialPortMessageManagerTests, Clocks_Synchronize_And_Late_Real_Time_Frames_Are_Dropped)
+{
+    SlowHardwareSerial peerSerial;
+    SerialPortMessageManagerTester peer(&peerSerial, &m_Serializer);
+    LinkTxItem_t bands;
+    bands.Lane = LinkTxLane_RealTime;
+    peer.RegisterTxItem(GetLinkItemId("R_Bands"), &bands);
+    CaptureTimeCallee callee;
+    m_Manager.RegisterForNewRxValueNotification(&callee);
+    size_t toPeer = 0;
+    size_t fromPeer = 0;
+
+    //Request, then the response and the bands come back together
+    m_Manager.ServiceClockSync();
+    Deliver(m_Serial, toPeer, peer);
+    EXPECT_FALSE(m_Manager.IsClockSynchronized());
+    const uint32_t queuedUs = micros();
+    ASSERT_TRUE(peer.QueueMessageFromDataType("R_Bands", DataType_Float_t, m_Bands, 32, 1));
+    peer.ServiceClockSync();
+    peer.ServiceTx();
+    Deliver(peerSerial, fromPeer, m_Manager);
+    ASSERT_TRUE(m_Manager.IsClockSynchronized());
+    EXPECT_LT(std::abs(m_Manager.GetClockOffsetUs()), 1000) << "Both ends run on the host clock";
+    ASSERT_EQ(1, callee.Calls);
+    ASSERT_TRUE(callee.HasCaptureTime);
+    EXPECT_LT(std::abs(static_cast<int32_t>(callee.CaptureUs - queuedUs)), 1000);
+    uint32_t captureUs;
+    EXPECT_FALSE(m_Manager.GetRxCaptureTime(captureUs)) << "Only valid while the value is delivered";
+
+    m_Manager.SetRxMaxAge(2000);
+    ASSERT_TRUE(peer.QueueMessageFromDataType("R_Bands", DataType_Float_t, m_Bands, 32, 2));
+    peer.ServiceTx();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    Deliver(peerSerial, fromPeer, m_Manager);
+    EXPECT_EQ(1, callee.Calls);
+
+    m_Manager.UpdateLinkHealth();
+    const LinkHealth_t health = m_Manager.GetLinkHealth();
+    EXPECT_EQ(1, health.RxLate);
+    EXPECT_GE(health.RxAgeMaxUs, 10000);
+    EXPECT_EQ(0, health.RxLost) << "Clock frames carry no sequence number";
+    m_Manager.DeRegisterForNewRxValueNotification(&callee);
+    peer.DeRegisterTxItem(GetLinkItemId("R_Bands"));
+}
+
+TEST(LinkSchemaTests, Entries_Are_Checked_Against_The_Receiving_Item)
+{
+    LinkSchemaEntry_t entry;
+    entry.DataType = DataType_Float_t;
+    entry.Count = 32;
+    EXPECT_EQ(LinkSchemaCheck_Match, CheckLinkSchemaEntry(entry, DataType_Float_t, 32, false));
+    EXPECT_EQ(LinkSchemaCheck_TypeMismatch, CheckLinkSchemaEntry(entry, DataType_Int32_t, 32, false));
+    EXPECT_EQ(LinkSchemaCheck_CountMismatch, CheckLinkSchemaEntry(entry, DataType_Float_t, 16, false));
+    EXPECT_EQ(LinkSchemaCheck_Match, CheckLinkSchemaEntry(entry, DataType_Undef, 32, false)) << "Unknown types are not compared";
+    entry.DataType |= LINK_DATATYPE_FLAG_ENCODED;
+    EXPECT_EQ(LinkSchemaCheck_NotDecodable, CheckLinkSchemaEntry(entry, DataType_Float_t, 32, false));
+    EXPECT_EQ(LinkSchemaCheck_Match, CheckLinkSchemaEntry(entry, DataType_Float_t, 32, true));
+    entry.Count = 0;
+    EXPECT_EQ(LinkSchemaCheck_Match, CheckLinkSchemaEntry(entry, DataType_Float_t, 16, true)) << "Unknown counts are not compared";
+}
+
+TEST_F(SerialPortMessageManagerTests, Schema_Mismatches_Are_Rejected_Once_At_Connect)
+{
+    SlowHardwareSerial peerSerial;
+    SerialPortMessageManagerTester peer(&peerSerial, &m_Serializer);
+    LinkTxItem_t bands;
+    bands.DataType = DataType_Float_t;
+    bands.Count = 32;
+    LinkTxItem_t wrongCount = bands;
+    LinkTxItem_t wrongType = bands;
+    peer.RegisterTxItem(GetLinkItemId("S_Bands"), &bands);
+    peer.RegisterTxItem(GetLinkItemId("S_WrongCount"), &wrongCount);
+    peer.RegisterTxItem(GetLinkItemId("S_WrongType"), &wrongType);
+    SchemaCallee bandsCallee("S_Bands", 32, DataType_Float_t);
+    SchemaCallee wrongCountCallee("S_WrongCount", 16, DataType_Float_t);
+    SchemaCallee wrongTypeCallee("S_WrongType", 32, DataType_Int32_t);
+    m_Manager.RegisterForNewRxValueNotification(&bandsCallee);
+    m_Manager.RegisterForNewRxValueNotification(&wrongCountCallee);
+    m_Manager.RegisterForNewRxValueNotification(&wrongTypeCallee);
+    size_t toPeer = 0;
+    size_t fromPeer = 0;
+
+    EXPECT_FALSE(m_Manager.IsSchemaVerified());
+    peer.ServiceSchema();
+    Deliver(peerSerial, fromPeer, m_Manager);
+    ASSERT_TRUE(m_Manager.IsSchemaVerified());
+    EXPECT_EQ(2, m_Manager.GetSchemaMismatchCount());
+    EXPECT_FALSE(peer.IsSchemaAcknowledged());
+    m_Manager.ServiceSchema();
+    Deliver(m_Serial, toPeer, peer);
+    EXPECT_TRUE(peer.IsSchemaAcknowledged()) << "The reply acknowledges the peer's schema";
+    EXPECT_TRUE(peer.IsSchemaVerified());
+    EXPECT_EQ(0, peer.GetSchemaMismatchCount()) << "Nothing is sent the other way";
+    EXPECT_FALSE(m_Manager.IsSchemaAcknowledged());
+    peer.ServiceSchema();
+    Deliver(peerSerial, fromPeer, m_Manager);
+    EXPECT_TRUE(m_Manager.IsSchemaAcknowledged());
+
+    //Only the item that matched is delivered, the others are dropped quietly
+    const size_t schemaBytes = peerSerial.GetSent().size();
+    ASSERT_TRUE(peer.QueueMessageFromDataType("S_Bands", DataType_Float_t, m_Bands, 32, 1));
+    ASSERT_TRUE(peer.QueueMessageFromDataType("S_WrongCount", DataType_Float_t, m_Bands, 32, 1));
+    ASSERT_TRUE(peer.QueueMessageFromDataType("S_WrongType", DataType_Float_t, m_Bands, 32, 1));
+    peer.ServiceSchema();
+    EXPECT_EQ(schemaBytes, peerSerial.GetSent().size()) << "An acknowledged schema is not sent again";
+    peer.ServiceTx();
+    Deliver(peerSerial, fromPeer, m_Manager);
+    EXPECT_EQ(1, bandsCallee.Calls);
+    EXPECT_EQ(0, wrongCountCallee.Calls);
+    EXPECT_EQ(0, wrongTypeCallee.Calls);
+    m_Manager.UpdateLinkHealth();
+    EXPECT_EQ(2, m_Manager.GetLinkHealth().RxRejected);
+
+    //A changed TX item list is sent again until it is acknowledged
+    peer.DeRegisterTxItem(GetLinkItemId("S_WrongType"));
+    EXPECT_FALSE(peer.IsSchemaAcknowledged());
+    peer.ServiceSchema();
+    Deliver(peerSerial, fromPeer, m_Manager);
+    EXPECT_EQ(1, m_Manager.GetSchemaMismatchCount());
+    m_Manager.ServiceSchema();
+    Deliver(m_Serial, toPeer, peer);
+    EXPECT_TRUE(peer.IsSchemaAcknowledged());
+
+    m_Manager.DeRegisterForNewRxValueNotification(&bandsCallee);
+    m_Manager.DeRegisterForNewRxValueNotification(&wrongCountCallee);
+    m_Manager.DeRegisterForNewRxValueNotification(&wrongTypeCallee);
+    peer.DeRegisterTxItem(GetLinkItemId("S_Bands"));
+    peer.DeRegisterTxItem(GetLinkItemId("S_WrongCount"));
+}
@@ -0,0 +1,119 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "SpectralPeakPicker.h"
+
+using namespace testing;
+
+const static size_t peakPickerFFTSize = 512;
+const static float peakPickerSampleRate = 44100.0f;
+const static float peakPickerBinWidth = peakPickerSampleRate / peakPickerFFTSize;
+
+// Test Fixture for SpectralPeakPicker accuracy on Hamming windowed synthetic tones
+class SpectralPeakPickerTests : public Test
+{
+    protected:
+        std::vector<float> m_Magnitudes = std::vector<float>(peakPickerFFTSize / 2, 0.0f);
+        void SynthesizeSpectrum(const std::vector<std::pair<float, float>> &tones)
+        {
+            std::vector<float> samples(peakPickerFFTSize, 0.0f);
+            float windowSum = 0.0f;
+            for(size_t n = 0; n < peakPickerFFTSize; ++n)
+            {
+                float window = 0.54f - 0.46f * cosf(2.0f * (float)M_PI * n / (peakPickerFFTSize - 1));
+                windowSum += window;
+                for(const auto &tone : tones)
+                {
+                    samples[n] += tone.second * sinf(2.0f * (float)M_PI * tone.first * n / peakPickerSampleRate);
+                }
+                samples[n] *= window;
+            }
+            for(size_t k = 0; k < m_Magnitudes.size(); ++k)
+            {
+                double re = 0.0;
+                double im = 0.0;
+                for(size_t n = 0; n < peakPickerFFTSize; ++n)
+                {
+                    double phase = 2.0 * M_PI * k * n / peakPickerFFTSize;
+                    re += samples[n] * cos(phase);
+                    im -= samples[n] * sin(phase);
+                }
+                m_Magnitudes[k] = (2.0f * (float)sqrt(re * re + im * im)) / windowSum;
+            }
+        }
+};
+
+TEST_F(SpectralPeakPickerTests, Gaussian_Sub_Bin_Frequency_Accuracy)
+{
+    SpectralPeakPicker<1> picker(peakPickerBinWidth, PeakInterpolation_Gaussian);
+    for(float frequency = 300.0f; frequency < 4000.0f; frequency += 37.3f)
+    {
+        SynthesizeSpectrum({{frequency, 0.5f}});
+        SpectralPeakEstimate_t peaks[1];
+        ASSERT_EQ(1, picker.FindPeaks(m_Magnitudes.data(), m_Magnitudes.size(), peaks));
+        EXPECT_NEAR(frequency, peaks[0].Frequency, 0.05f * peakPickerBinWidth);
+        EXPECT_NEAR(0.5f, peaks[0].Magnitude, 0.03f);
+    }
+}
+
+TEST_F(SpectralPeakPickerTests, Parabolic_Sub_Bin_Frequency_Accuracy)
+{
+    SpectralPeakPicker<1> picker(peakPickerBinWidth, PeakInterpolation_Parabolic);
+    for(float frequency = 300.0f; frequency < 4000.0f; frequency += 37.3f)
+    {
+        SynthesizeSpectrum({{frequency, 0.5f}});
+        SpectralPeakEstimate_t peaks[1];
+        ASSERT_EQ(1, picker.FindPeaks(m_Magnitudes.data(), m_Magnitudes.size(), peaks));
+        EXPECT_NEAR(frequency, peaks[0].Frequency, 0.15f * peakPickerBinWidth);
+        EXPECT_NEAR(0.5f, peaks[0].Magnitude, 0.05f);
+    }
+}
+
+TEST_F(SpectralPeakPickerTests, Top_K_Peaks_Sorted_By_Magnitude)
+{
+    SpectralPeakPicker<3> picker(peakPickerBinWidth);
+    SynthesizeSpectrum({{440.0f, 0.2f}, {1250.0f, 0.6f}, {3100.0f, 0.4f}, {6000.0f, 0.1f}});
+    SpectralPeakEstimate_t peaks[3];
+    ASSERT_EQ(3, picker.FindPeaks(m_Magnitudes.data(), m_Magnitudes.size(), peaks));
+    EXPECT_NEAR(1250.0f, peaks[0].Frequency, 0.05f * peakPickerBinWidth);
+    EXPECT_NEAR(3100.0f, peaks[1].Frequency, 0.05f * peakPickerBinWidth);
+    EXPECT_NEAR(440.0f, peaks[2].Frequency, 0.05f * peakPickerBinWidth);
+    EXPECT_GT(peaks[0].Magnitude, peaks[1].Magnitude);
+    EXPECT_GT(peaks[1].Magnitude, peaks[2].Magnitude);
+}
+
+TEST_F(SpectralPeakPickerTests, Minimum_Magnitude_Limits_Peak_Count)
+{
+    SpectralPeakPicker<4> picker(peakPickerBinWidth, PeakInterpolation_Gaussian, 0.05f);
+    SynthesizeSpectrum({{1000.0f, 0.5f}});
+    SpectralPeakEstimate_t peaks[4];
+    EXPECT_EQ(1, picker.FindPeaks(m_Magnitudes.data(), m_Magnitudes.size(), peaks));
+    EXPECT_EQ(0.0f, peaks[1].Frequency);
+    EXPECT_EQ(0.0f, peaks[3].Magnitude);
+}
+
+TEST_F(SpectralPeakPickerTests, Silence_Has_No_Peaks)
+{
+    SpectralPeakPicker<2> picker(peakPickerBinWidth);
+    SpectralPeakEstimate_t peaks[2];
+    EXPECT_EQ(0, picker.FindPeaks(m_Magnitudes.data(), m_Magnitudes.size(), peaks));
+}
@@ -0,0 +1,113 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include "StageProfiler.h"
+
+using namespace testing;
+
+class StageProfilerTests : public Test
+{
+    protected:
+        StageProfiler<2> m_Profiler;
+};
+
+TEST_F(StageProfilerTests, Empty_Stage_Has_No_Statistics)
+{
+    StageStatistics_t stats = m_Profiler.GetStatistics(0);
+    EXPECT_EQ(0, stats.Count);
+    EXPECT_EQ(0, stats.Min);
+    EXPECT_EQ(0, stats.Max);
+    EXPECT_EQ(0, stats.Mean);
+}
+
+TEST_F(StageProfilerTests, Min_Max_Mean_Are_Tracked_Per_Stage)
+{
+    m_Profiler.Record(0, 100);
+    m_Profiler.Record(0, 300);
+    m_Profiler.Record(0, 200);
+    m_Profiler.Record(1, 5000);
+    StageStatistics_t stats = m_Profiler.GetStatistics(0);
+    EXPECT_EQ(3, stats.Count);
+    EXPECT_EQ(100, stats.Min);
+    EXPECT_EQ(300, stats.Max);
+    EXPECT_EQ(200, stats.Mean);
+    EXPECT_EQ(1, m_Profiler.GetStatistics(1).Count);
+    EXPECT_EQ(5000, m_Profiler.GetStatistics(1).Mean);
+}
+
+TEST_F(StageProfilerTests, Histogram_Buckets_Are_Log2)
+{
+    EXPECT_EQ(0, m_Profiler.GetBucket(0));
+    EXPECT_EQ(0, m_Profiler.GetBucket(127));
+    EXPECT_EQ(1, m_Profiler.GetBucket(128));
+    EXPECT_EQ(1, m_Profiler.GetBucket(255));
+    EXPECT_EQ(2, m_Profiler.GetBucket(256));
+    EXPECT_EQ(15, m_Profiler.GetBucket(UINT32_MAX));
+    EXPECT_EQ(127, m_Profiler.GetBucketUpperEdge(0));
+    EXPECT_EQ(255, m_Profiler.GetBucketUpperEdge(1));
+}
+
+TEST_F(StageProfilerTests, P95_Reports_Tail_Bucket)
+{
+    for(int i = 0; i < 94; ++i) m_Profiler.Record(0, 100);
+    for(int i = 0; i < 6; ++i) m_Profiler.Record(0, 1000);
+    StageStatistics_t stats = m_Profiler.GetStatistics(0);
+    EXPECT_EQ(94, m_Profiler.GetBucketCount(0, 0));
+    EXPECT_EQ(6, m_Profiler.GetBucketCount(0, m_Profiler.GetBucket(1000)));
+    EXPECT_EQ(m_Profiler.GetBucketUpperEdge(m_Profiler.GetBucket(1000)), stats.P95);
+}
+
+TEST_F(StageProfilerTests, Reset_Is_Applied_On_Next_Record)
+{
+    m_Profiler.Record(0, 1000);
+    m_Profiler.RequestResetAll();
+    m_Profiler.Record(0, 10);
+    StageStatistics_t stats = m_Profiler.GetStatistics(0);
+    EXPECT_EQ(1, stats.Count);
+    EXPECT_EQ(10, stats.Max);
+}
+
+TEST_F(StageProfilerTests, Snapshot_Is_Published_On_Next_Record)
+{
+    m_Profiler.Record(0, 100);
+    m_Profiler.Record(0, 300);
+    EXPECT_EQ(0, m_Profiler.GetSnapshot(0).Count) << "Nothing is published until a snapshot is requested";
+    m_Profiler.RequestSnapshotAll();
+    EXPECT_EQ(0, m_Profiler.GetSnapshot(0).Count) << "The recording task publishes, not the requester";
+    m_Profiler.Record(0, 50);
+    StageStatistics_t snapshot = m_Profiler.GetSnapshot(0);
+    EXPECT_EQ(2, snapshot.Count);
+    EXPECT_EQ(100, snapshot.Min);
+    EXPECT_EQ(300, snapshot.Max);
+    EXPECT_EQ(200, snapshot.Mean);
+    EXPECT_EQ(1, m_Profiler.GetStatistics(0).Count) << "A new interval starts with the record that published";
+    EXPECT_EQ(50, m_Profiler.GetStatistics(0).Max);
+    EXPECT_EQ(0, m_Profiler.GetSnapshot(1).Count);
+}
+
+TEST_F(StageProfilerTests, Scoped_Timer_Records_On_Exit)
+{
+    {
+        ScopedStageTimer<StageProfiler<2>> timer(m_Profiler, 1);
+    }
+    EXPECT_EQ(0, m_Profiler.GetStatistics(0).Count);
+    EXPECT_EQ(1, m_Profiler.GetStatistics(1).Count);
+}
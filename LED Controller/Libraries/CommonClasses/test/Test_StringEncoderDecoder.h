@@ -0,0 +1,152 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include <limits>
+#include <sstream>
+#include <string>
+#include "DataItem/LocalDataItem.h"
+
+using namespace testing;
+
+//The encoders replace the stream operators, so every number must come out as the stream printed it
+template <typename T>
+static void ExpectStreamFormat(const std::vector<T> &values)
+{
+    StringEncoderDecoder<T> encoder;
+    char buffer[STRING_ENCODER_NUMBER_LENGTH];
+    for(const T &value : values)
+    {
+        std::ostringstream oss;
+        oss << value;
+        const char* end = encoder.EncodeToChars(value, buffer, buffer + sizeof(buffer));
+        ASSERT_NE(nullptr, end);
+        EXPECT_EQ(oss.str(), std::string(buffer, end - buffer));
+        EXPECT_STREQ(oss.str().c_str(), encoder.EncodeToString(value).c_str());
+
+        T decoded;
+        EXPECT_TRUE(encoder.DecodeFromChars(buffer, end, decoded));
+        T streamed;
+        std::istringstream(oss.str()) >> streamed;
+        EXPECT_EQ(streamed, decoded) << oss.str();
+    }
+}
+
+TEST(StringEncoderDecoderTests, Numbers_Are_Encoded_As_The_Streams_Encode_Them)
+{
+    ExpectStreamFormat<bool>({ false, true });
+    ExpectStreamFormat<char>({ 'a', 'Z', '7' });
+    ExpectStreamFormat<int32_t>({ 0, 1, -1, 123456, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max() });
+    ExpectStreamFormat<uint32_t>({ 0, 42, std::numeric_limits<uint32_t>::max() });
+    ExpectStreamFormat<uint16_t>({ 0, 65535 });
+    ExpectStreamFormat<float>({ 0.0f, -0.5f, 1.0f, 3.14159265f, 1e-7f, 123456789.0f, std::numeric_limits<float>::max() });
+    ExpectStreamFormat<double>({ 0.0, 2.5, -1e300 });
+}
+
+TEST(StringEncoderDecoderTests, Decoding_Reads_Only_The_Given_Characters)
+{
+    StringEncoderDecoder<int32_t> integers;
+    StringEncoderDecoder<float> floats;
+    const char* text = " +12|3.5e2|x";
+    int32_t integer;
+    float number;
+    EXPECT_TRUE(integers.DecodeFromChars(text, text + 4, integer));
+    EXPECT_EQ(12, integer);
+    EXPECT_TRUE(integers.DecodeFromChars(text, text + 3, integer));
+    EXPECT_EQ(1, integer);
+    EXPECT_TRUE(floats.DecodeFromChars(text + 5, text + 10, number));
+    EXPECT_FLOAT_EQ(350.0f, number);
+    EXPECT_TRUE(floats.DecodeFromChars(text + 5, text + 8, number));
+    EXPECT_FLOAT_EQ(3.5f, number);
+    integer = 5;
+    EXPECT_FALSE(integers.DecodeFromChars(text + 11, text + 12, integer));
+    EXPECT_EQ(0, integer) << "A value that cannot be read is reset, as the streams do";
+    EXPECT_FALSE(floats.DecodeFromChars(text, text, number));
+}
+
+TEST(StringEncoderDecoderTests, Encoding_Fails_When_The_Buffer_Is_Too_Small)
+{
+    StringEncoderDecoder<int32_t> integers;
+    StringEncoderDecoder<float> floats;
+    char buffer[4];
+    EXPECT_NE(nullptr, integers.EncodeToChars(123, buffer, buffer + 4));
+    EXPECT_STREQ("123", buffer);
+    EXPECT_EQ(nullptr, integers.EncodeToChars(1234, buffer, buffer + 4)) << "No room for the terminator";
+    EXPECT_EQ(nullptr, floats.EncodeToChars(1.25f, buffer, buffer + 4));
+    EXPECT_EQ(nullptr, floats.EncodeToChars(1.25f, buffer, buffer));
+}
+
+class StringValueParsingTests : public Test
+{
+    protected:
+        SetupCallerInterface m_SetupCaller;
+        const float m_InitialValue = 0.0f;
+        LocalDataItem<float, 3> m_Item = LocalDataItem<float, 3>("Floats", m_InitialValue, nullptr, &m_SetupCaller);
+};
+
+TEST_F(StringValueParsingTests, Strings_Are_Parsed_In_Place)
+{
+    float values[3];
+    const String input = "1.5|-2|3e1";
+    EXPECT_EQ(3, m_Item.ParseStringValueIntoValues(input, values));
+    EXPECT_FLOAT_EQ(1.5f, values[0]);
+    EXPECT_FLOAT_EQ(-2.0f, values[1]);
+    EXPECT_FLOAT_EQ(30.0f, values[2]);
+
+    const char* longer = "4|5|6|7";
+    EXPECT_EQ(3, m_Item.ParseStringValueIntoValues(longer, 5, values)) << "Only the first 5 characters are parsed";
+    EXPECT_FLOAT_EQ(6.0f, values[2]);
+    EXPECT_EQ(0, m_Item.ParseStringValueIntoValues(longer, strlen(longer), values)) << "Too many values";
+    EXPECT_EQ(0, m_Item.ParseStringValueIntoValues("1|2", 3, values)) << "Too few values";
+}
+
+TEST_F(StringValueParsingTests, Values_Convert_To_The_String_They_Are_Parsed_From)
+{
+    m_SetupCaller.SetupAllSetupCallees();
+    EXPECT_TRUE(m_Item.SetValueFromString("0.25|100|-7.5").UpdateSuccessful);
+    EXPECT_STREQ("0.25|100|-7.5", m_Item.GetValueAsString().c_str());
+
+    float values[3];
+    m_Item.GetValue(values, 3);
+    char buffer[32];
+    char* end = m_Item.ConvertValueToChars(values, 3, buffer, buffer + sizeof(buffer));
+    ASSERT_NE(nullptr, end);
+    EXPECT_STREQ("0.25|100|-7.5", buffer);
+    EXPECT_EQ(13, end - buffer);
+    EXPECT_EQ(nullptr, m_Item.ConvertValueToChars(values, 3, buffer, buffer + 13)) << "No room for the terminator";
+    EXPECT_EQ(nullptr, m_Item.ConvertValueToChars(values, 3, buffer, buffer + 5)) << "No room for the divider";
+}
+
+TEST(StringValueValidationTests, Parts_Outside_The_Valid_Values_Are_Rejected)
+{
+    SetupCallerInterface setupCaller;
+    const int32_t initialValue = 1;
+    ValidStringValues_t validValues = { "1", "2", "3" };
+    LocalDataItem<int32_t, 2> item("Choices", initialValue, nullptr, &setupCaller, &validValues);
+    setupCaller.SetupAllSetupCallees();
+    int32_t values[2];
+    EXPECT_EQ(2, item.ParseStringValueIntoValues("3|2", 3, values));
+    EXPECT_EQ(0, item.ParseStringValueIntoValues("3|4", 3, values));
+    EXPECT_FALSE(item.SetValueFromString("1|12").UpdateSuccessful);
+    EXPECT_TRUE(item.SetValueFromString("2|3").UpdateSuccessful);
+    const int32_t invalid[2] = { 2, 7 };
+    EXPECT_FALSE(item.SetValue(invalid, 2).ValidValue);
+    EXPECT_STREQ("2|3", item.GetValueAsString().c_str());
+}
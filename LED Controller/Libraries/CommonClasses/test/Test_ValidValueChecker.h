@@ -19,6 +19,7 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 #include "ValidValueChecker.h"
+#include "Mock_ValidValueChecker.h"
 
 TEST(ValidValueCheckerTest, Positive_Value_Test)
 {
@@ -45,4 +46,31 @@ TEST(ValidValueCheckerTest, Is_Not_Configured)
     ValidValueChecker valueChecker = ValidValueChecker();
     EXPECT_TRUE(valueChecker.IsValidStringValue(validValue));
     EXPECT_TRUE(valueChecker.IsValidStringValue(invalidValue));
-}
\ No newline at end of file
+}
+
+TEST(ValidValueCheckerTest, Checks_Characters_That_Are_Not_Terminated)
+{
+    ValidStringValues_t validStrings = {"On", "Off"};
+    ValidValueChecker valueChecker = ValidValueChecker(&validStrings);
+    const char* values = "Off|On|Onward";
+    EXPECT_TRUE(valueChecker.IsValidStringValue(values, 3));
+    EXPECT_TRUE(valueChecker.IsValidStringValue(values + 4, 2));
+    EXPECT_FALSE(valueChecker.IsValidStringValue(values + 7, 2 + 4)) << "Onward";
+    EXPECT_FALSE(valueChecker.IsValidStringValue(values, 2)) << "Of";
+    EXPECT_TRUE(valueChecker.IsConfigured());
+    EXPECT_FALSE(ValidValueChecker().IsConfigured());
+
+    ValidValueComparators_t comparators = {{GreaterOrEqual, "10"}};
+    ValidValueChecker comparatorChecker = ValidValueChecker(&comparators);
+    const char* numbers = "12|9";
+    EXPECT_TRUE(comparatorChecker.IsValidStringValue(numbers, 2));
+    EXPECT_FALSE(comparatorChecker.IsValidStringValue(numbers + 3, 1));
+    EXPECT_FALSE(comparatorChecker.IsValidStringValue(numbers, 1)) << "Only the 1 is read";
+}
+
+TEST(ValidValueCheckerTest, String_Values_Are_Checked_By_The_Overridable_Overload)
+{
+    MockValidValueChecker valueChecker;
+    EXPECT_CALL(valueChecker, IsValidStringValue(::testing::_, 8)).WillOnce(::testing::Return(false));
+    EXPECT_FALSE(valueChecker.IsValidStringValue(String("A String")));
+}
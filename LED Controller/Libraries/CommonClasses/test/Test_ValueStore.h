@@ -0,0 +1,140 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include <array>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "ValueStore.h"
+#include "DataItem/LocalDataItem.h"
+
+using namespace testing;
+
+#define TEST_VALUE_STORE_WRITES 200000
+#define TEST_DATA_ITEM_WRITES 5000
+#define TEST_VALUE_STORE_READERS 3
+
+//Every value a writer stores has all of its elements equal, so a read that mixes two writes shows up as a
+//value whose elements differ.
+template <typename T, size_t COUNT>
+class TornReadChecker
+{
+    public:
+        template <typename STORE, typename LOAD>
+        static size_t Run(STORE store, LOAD load, size_t writes = TEST_VALUE_STORE_WRITES)
+        {
+            std::atomic<bool> done = {false};
+            std::atomic<size_t> torn = {0};
+            std::atomic<size_t> started = {0};
+            std::vector<std::thread> readers;
+            for(size_t r = 0; r < TEST_VALUE_STORE_READERS; ++r)
+            {
+                readers.emplace_back([&]()
+                {
+                    std::array<T, COUNT> values;
+                    ++started;
+                    while(!done)
+                    {
+                        load(values.data());
+                        for(size_t i = 1; i < COUNT; ++i)
+                        {
+                            if(values[i] != values[0])
+                            {
+                                ++torn;
+                                break;
+                            }
+                        }
+                    }
+                });
+            }
+            //Writes only start once every reader is reading, so they all run against the writer
+            while(started < TEST_VALUE_STORE_READERS) std::this_thread::yield();
+            std::array<T, COUNT> values;
+            for(size_t w = 1; w <= writes; ++w)
+            {
+                values.fill(static_cast<T>(w));
+                store(values.data());
+            }
+            done = true;
+            for(std::thread &reader : readers) reader.join();
+            return torn;
+        }
+};
+
+TEST(ValueStoreTests, Stores_Are_Chosen_By_Value_Size)
+{
+    EXPECT_EQ(ValueStoreKind_Atomic, (GetValueStoreKind<bool, 1>()));
+    EXPECT_EQ(ValueStoreKind_Atomic, (GetValueStoreKind<float, 2>()));
+    EXPECT_EQ(ValueStoreKind_Atomic, (GetValueStoreKind<char, 8>()));
+    EXPECT_EQ(ValueStoreKind_SequenceLock, (GetValueStoreKind<float, 3>()));
+    EXPECT_EQ(ValueStoreKind_SequenceLock, (GetValueStoreKind<char, 50>()));
+    EXPECT_EQ(ValueStoreKind_Locked, (GetValueStoreKind<std::string, 1>()));
+}
+
+TEST(ValueStoreTests, Loads_Return_The_Last_Store)
+{
+    ValueStore<uint8_t, 3> small;
+    ValueStore<uint16_t, 7> odd;
+    const uint8_t smallValues[3] = { 1, 2, 3 };
+    const uint16_t oddValues[7] = { 10, 20, 30, 40, 50, 60, 70 };
+    uint8_t smallRead[3] = {};
+    uint16_t oddRead[7] = {};
+    small.Load(smallRead);
+    EXPECT_EQ(0, smallRead[2]) << "Stores start out zeroed";
+    small.Store(smallValues);
+    odd.Store(oddValues);
+    small.Load(smallRead);
+    odd.Load(oddRead);
+    EXPECT_EQ(0, memcmp(smallValues, smallRead, sizeof(smallValues)));
+    EXPECT_EQ(0, memcmp(oddValues, oddRead, sizeof(oddValues)));
+}
+
+TEST(ValueStoreTests, Atomic_Store_Has_No_Torn_Reads)
+{
+    ValueStore<uint16_t, 4> store;
+    EXPECT_EQ(0, (TornReadChecker<uint16_t, 4>::Run( [&](const uint16_t* values){ store.Store(values); }
+                                                    , [&](uint16_t* values){ store.Load(values); } )));
+}
+
+TEST(ValueStoreTests, Sequence_Lock_Store_Has_No_Torn_Reads)
+{
+    ValueStore<uint32_t, 64> store;
+    EXPECT_EQ(0, (TornReadChecker<uint32_t, 64>::Run( [&](const uint32_t* values){ store.Store(values); }
+                                                     , [&](uint32_t* values){ store.Load(values); } )));
+}
+
+TEST(ValueStoreTests, Data_Item_Getters_Have_No_Torn_Reads)
+{
+    SetupCallerInterface setupCaller;
+    const float initialValue = 0.0f;
+    LocalDataItem<float, 2> small("Small", initialValue, nullptr, &setupCaller);
+    LocalDataItem<float, 16> large("Large", initialValue, nullptr, &setupCaller);
+    setupCaller.SetupAllSetupCallees();
+    EXPECT_EQ(0, (TornReadChecker<float, 2>::Run( [&](const float* values){ small.SetValue(values, 2); }
+                                                 , [&](float* values){ small.GetValue(values, 2); }
+                                                 , TEST_DATA_ITEM_WRITES )));
+    EXPECT_EQ(0, (TornReadChecker<float, 16>::Run( [&](const float* values){ large.SetValue(values, 16); }
+                                                  , [&](float* values){ large.GetValue(values, 16); }
+                                                  , TEST_DATA_ITEM_WRITES )));
+    float value[16];
+    large.GetValue(value, 16);
+    EXPECT_EQ(static_cast<float>(TEST_DATA_ITEM_WRITES), value[15]);
+}
@@ -0,0 +1,198 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//Offline replay of the CPU2 audio analysis. Streams a WAV file through the FFT and band logic,
+//writes the peak and band outputs to CSV and reports throughput and per stage timings.
+//
+//  cd Tools/AudioReplay && pio run
+//  .pio/build/native/program input.wav [options]
+
+#include <Arduino.h>
+#include <chrono>
+#include <thread>
+#include "WavReader.h"
+#include "ReplaySound_Processor.h"
+
+struct ReplayOptions_t
+{
+  const char* InputPath = nullptr;
+  const char* CsvPath = nullptr;
+  bool Realtime = false;
+  float FFT_Gain = 1.1;
+  BandLayout_t Layout = BAND_LAYOUT_DEFAULT;
+};
+
+static void PrintUsage(const char* Program)
+{
+  fprintf( stderr
+         , "Usage: %s <input.wav> [options]\n"
+           "  --csv <path>          Write one row of peak and band values per FFT\n"
+           "  --realtime            Pace the replay at the WAV sample rate instead of running at max speed\n"
+           "  --bands <count>       Band count (default %u)\n"
+           "  --scale <scale>       linear, mel, octave or sae (default sae)\n"
+           "  --min <Hz>            Lowest band edge (default %u)\n"
+           "  --max <Hz>            Highest band edge (default %u)\n"
+           "  --fft-gain <gain>     FFT gain (default 1.1)\n"
+         , Program
+         , BAND_LAYOUT_DEFAULT.BandCount
+         , BAND_LAYOUT_DEFAULT.MinFrequency
+         , BAND_LAYOUT_DEFAULT.MaxFrequency );
+}
+
+static bool ParseScale(const char* Value, uint8_t &Scale)
+{
+  static const char* ScaleNames[BandScale_Count] = { "linear", "mel", "octave", "sae" };
+  for(uint8_t i = 0; i < BandScale_Count; ++i)
+  {
+    if(0 == strcmp(Value, ScaleNames[i]))
+    {
+      Scale = i;
+      return true;
+    }
+  }
+  return false;
+}
+
+static bool ParseOptions(int argc, char** argv, ReplayOptions_t &Options)
+{
+  for(int i = 1; i < argc; ++i)
+  {
+    const char* Arg = argv[i];
+    const bool HasValue = (i + 1 < argc);
+    if(0 == strcmp(Arg, "--realtime")) Options.Realtime = true;
+    else if(0 == strcmp(Arg, "--csv") && HasValue) Options.CsvPath = argv[++i];
+    else if(0 == strcmp(Arg, "--bands") && HasValue) Options.Layout.BandCount = atoi(argv[++i]);
+    else if(0 == strcmp(Arg, "--min") && HasValue) Options.Layout.MinFrequency = atoi(argv[++i]);
+    else if(0 == strcmp(Arg, "--max") && HasValue) Options.Layout.MaxFrequency = atoi(argv[++i]);
+    else if(0 == strcmp(Arg, "--fft-gain") && HasValue) Options.FFT_Gain = atof(argv[++i]);
+    else if(0 == strcmp(Arg, "--scale") && HasValue)
+    {
+      if(!ParseScale(argv[++i], Options.Layout.Scale)) return false;
+    }
+    else if('-' != Arg[0] && !Options.InputPath) Options.InputPath = Arg;
+    else return false;
+  }
+  return (nullptr != Options.InputPath);
+}
+
+static void WriteCsvHeader(FILE *Csv, size_t BandCount)
+{
+  fprintf(Csv, "Time,R_Major_Peak,L_Major_Peak,R_Max_Band,L_Max_Band");
+  for(size_t i = 0; i < BandCount; ++i) fprintf(Csv, ",R_Band_%zu", i);
+  for(size_t i = 0; i < BandCount; ++i) fprintf(Csv, ",L_Band_%zu", i);
+  fprintf(Csv, "\n");
+}
+
+static void WriteCsvRow(FILE *Csv, float Time, const ReplaySound_Processor &Processor)
+{
+  const size_t BandCount = Processor.GetBandCount();
+  fprintf( Csv
+         , "%.4f,%u,%u,%i,%i"
+         , Time
+         , Processor.GetRightPeaks().GetValuePointer()[0].Frequency
+         , Processor.GetLeftPeaks().GetValuePointer()[0].Frequency
+         , Processor.GetRightMaxBand().GetValue().MaxBandIndex
+         , Processor.GetLeftMaxBand().GetValue().MaxBandIndex );
+  for(size_t i = 0; i < BandCount; ++i) fprintf(Csv, ",%.5f", Processor.GetRightBands()[i]);
+  for(size_t i = 0; i < BandCount; ++i) fprintf(Csv, ",%.5f", Processor.GetLeftBands()[i]);
+  fprintf(Csv, "\n");
+}
+
+static void PrintReport(const WavReader &Wav, size_t FramesRead, size_t FFTCount, double WallSeconds)
+{
+  const double AudioSeconds = (double)FramesRead / (double)Wav.GetSampleRate();
+  printf("Frames: %zu (%.2f s of audio) FFTs: %zu Wall Time: %.3f s\n", FramesRead, AudioSeconds, FFTCount, WallSeconds);
+  if(WallSeconds > 0.0)
+  {
+    printf( "Throughput: %.0f audio frames/s, %.1f FFT frames/s, %.1fx realtime\n"
+          , FramesRead / WallSeconds
+          , FFTCount / WallSeconds
+          , AudioSeconds / WallSeconds );
+  }
+#ifdef ENABLE_STAGE_PROFILER
+  AudioPipelineProfiler_t &Profiler = GetAudioPipelineProfiler();
+  printf("%-14s %10s %10s %10s %10s %10s\n", "Stage (us)", "Count", "Min", "Mean", "P95", "Max");
+  for(size_t i = 0; i < AudioPipelineStage_Count; ++i)
+  {
+    const StageStatistics_t Stats = Profiler.GetStatistics(i);
+    if(0 == Stats.Count) continue;
+    printf( "%-14s %10u %10.2f %10.2f %10.2f %10.2f\n"
+          , AudioPipelineStageStrings[i]
+          , Stats.Count
+          , Stats.Min / 1000.0
+          , Stats.Mean / 1000.0
+          , Stats.P95 / 1000.0
+          , Stats.Max / 1000.0 );
+  }
+#else
+  printf("Per stage timings require -DENABLE_STAGE_PROFILER\n");
+#endif
+}
+
+int main(int argc, char** argv)
+{
+  ReplayOptions_t Options;
+  if(!ParseOptions(argc, argv, Options))
+  {
+    PrintUsage(argv[0]);
+    return 1;
+  }
+  WavReader Wav;
+  if(!Wav.Open(Options.InputPath)) return 1;
+  if(I2S_SAMPLE_RATE != Wav.GetSampleRate())
+  {
+    ESP_LOGW("AudioReplay", "WARNING! WAV Sample Rate %u Hz differs from the device rate %u Hz", Wav.GetSampleRate(), I2S_SAMPLE_RATE);
+  }
+
+  ReplaySound_Processor Processor(Wav.GetSampleRate(), Options.FFT_Gain);
+  if(!Processor.SetBandLayout(Options.Layout)) return 1;
+
+  FILE *Csv = nullptr;
+  if(Options.CsvPath)
+  {
+    Csv = fopen(Options.CsvPath, "w");
+    if(!Csv)
+    {
+      ESP_LOGE("AudioReplay", "ERROR! Unable to open \"%s\"", Options.CsvPath);
+      return 1;
+    }
+    WriteCsvHeader(Csv, Processor.GetBandCount());
+  }
+
+  //Blocks of FFT_SIZE frames, the same read size Sound_Processor::Calculate_FFTs takes from the audio buffer.
+  Frame_t Buffer[FFT_SIZE];
+  size_t FramesRead = 0;
+  const auto Start = std::chrono::steady_clock::now();
+  while(size_t Count = Wav.ReadFrames(Buffer, FFT_SIZE))
+  {
+    if(Processor.PushFrames(Buffer, Count) && Csv)
+    {
+      WriteCsvRow(Csv, (float)(FramesRead + Count) / Wav.GetSampleRate(), Processor);
+    }
+    FramesRead += Count;
+    if(Options.Realtime)
+    {
+      std::this_thread::sleep_until(Start + std::chrono::microseconds((uint64_t)FramesRead * 1000000ULL / Wav.GetSampleRate()));
+    }
+  }
+  const double WallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+  if(Csv) fclose(Csv);
+
+  PrintReport(Wav, FramesRead, Processor.GetFFTCount(), WallSeconds);
+  return 0;
+}
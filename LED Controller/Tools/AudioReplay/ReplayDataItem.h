@@ -0,0 +1,81 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <Arduino.h>
+#include <DataTypes.h>
+#include <cstring>
+
+//Stand-in for DataItem<T, COUNT> in the host replay. Keeps the same SetValue semantics (store and count a
+//transmission only when the value changes) without the serial port, preferences or callbacks.
+template <typename T, size_t COUNT>
+class ReplayDataItem
+{
+  public:
+    ReplayDataItem(const String &Name, const T &InitialValue): m_Name(Name)
+    {
+      for(size_t i = 0; i < COUNT; ++i)
+      {
+        m_Value[i] = InitialValue;
+      }
+    }
+    virtual ~ReplayDataItem(){}
+
+    UpdateStatus_t SetValue(const T *Values, size_t Count)
+    {
+      UpdateStatus_t Status;
+      Status.ValidValue = (COUNT == Count);
+      Status.UpdateAllowed = Status.ValidValue;
+      if(!Status.ValidValue)
+      {
+        ESP_LOGE("ReplayDataItem", "ERROR! \"%s\": Count Error!", m_Name.c_str());
+        return Status;
+      }
+      Status.ValueChanged = (0 != memcmp(m_Value, Values, sizeof(T) * COUNT));
+      if(Status.ValueChanged)
+      {
+        memcpy(m_Value, Values, sizeof(T) * COUNT);
+        ++m_ChangeCount;
+      }
+      ++m_SetCount;
+      Status.UpdateSuccessful = true;
+      return Status;
+    }
+    UpdateStatus_t SetValue(const T &Value)
+    {
+      static_assert(1 == COUNT, "Count must 1 to use this function");
+      return SetValue(&Value, 1);
+    }
+    const T* GetValuePointer() const { return m_Value; }
+    T GetValue() const
+    {
+      static_assert(1 == COUNT, "Count must 1 to use this function");
+      return m_Value[0];
+    }
+    String GetName() const { return m_Name; }
+    size_t GetCount() const { return COUNT; }
+    size_t GetChangeCount() const { return m_ChangeCount; }
+    size_t GetSetCount() const { return m_SetCount; }
+
+  private:
+    String m_Name;
+    T m_Value[COUNT];
+    size_t m_ChangeCount = 0;
+    size_t m_SetCount = 0;
+};
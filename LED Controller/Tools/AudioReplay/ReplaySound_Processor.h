@@ -0,0 +1,144 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <Arduino.h>
+#include <DataTypes.h>
+#include <BandLayout.h>
+#include "Tunes.h"
+#include "FFT_Calculator.h"
+#include "Band_Calculator.h"
+#include "AudioPipelineProfiler.h"
+#include "ReplayDataItem.h"
+
+//Host copy of the Sound_Processor analysis path. Frames are pushed directly instead of going through the
+//I2S task and ContinuousAudioBuffer, and results land in ReplayDataItems instead of the serial links. The per FFT
+//results come from Band_Calculator.h, as on the device. The amplitude path is left out because the device does
+//not run it either.
+class ReplaySound_Processor
+{
+  public:
+    ReplaySound_Processor(int32_t SampleRate, float FFT_Gain)
+                         : m_SampleRate(SampleRate)
+                         , m_FFT_Gain(FFT_Gain)
+                         , m_R_FFT(FFT_SIZE, SampleRate, BitLength_16)
+                         , m_L_FFT(FFT_SIZE, SampleRate, BitLength_16)
+    {
+    }
+    virtual ~ReplaySound_Processor(){}
+
+    bool SetBandLayout(const BandLayout_t &Layout)
+    {
+      if(m_BandLayout.Configure(Layout, m_SampleRate, FFT_SIZE))
+      {
+        ESP_LOGI("SetBandLayout", "Band Layout Set: \"%s\"", Layout.toString().c_str());
+        return true;
+      }
+      ESP_LOGE("SetBandLayout", "ERROR! Unsupported Band Layout Rejected: \"%s\"", Layout.toString().c_str());
+      return false;
+    }
+
+    //Same per frame order as Sound_Processor::Calculate_FFTs. Returns true when a new FFT solution is ready for both channels.
+    bool PushFrames(const Frame_t *Frames, size_t Count)
+    {
+      bool FFT_Calculated = false;
+      for(size_t i = 0; i < Count; ++i)
+      {
+        bool R_FFT_Calculated = false;
+        bool L_FFT_Calculated = false;
+        if(m_R_FFT.PushValueAndCalculateNormalizedFFT(Frames[i].channel1, m_FFT_Gain))
+        {
+          Update_Bands_And_Send_Result(m_R_FFT, m_R_Bands_8, m_R_Bands_16, m_R_Bands, m_R_Bands_64, m_R_Max_Band, m_R_Peaks);
+          R_FFT_Calculated = true;
+        }
+        if(m_L_FFT.PushValueAndCalculateNormalizedFFT(Frames[i].channel2, m_FFT_Gain))
+        {
+          Update_Bands_And_Send_Result(m_L_FFT, m_L_Bands_8, m_L_Bands_16, m_L_Bands, m_L_Bands_64, m_L_Max_Band, m_L_Peaks);
+          L_FFT_Calculated = true;
+        }
+        assert(R_FFT_Calculated == L_FFT_Calculated);
+        if(R_FFT_Calculated) ++m_FFTCount;
+        FFT_Calculated |= R_FFT_Calculated;
+      }
+      return FFT_Calculated;
+    }
+
+    size_t GetBandCount() const { return m_BandLayout.GetBandCount(); }
+    size_t GetFFTCount() const { return m_FFTCount; }
+    //The values of the band item sized for the layout in use, GetBandCount() of them
+    const float* GetRightBands() const { return GetBands(m_R_Bands_8, m_R_Bands_16, m_R_Bands, m_R_Bands_64); }
+    const float* GetLeftBands() const { return GetBands(m_L_Bands_8, m_L_Bands_16, m_L_Bands, m_L_Bands_64); }
+    const ReplayDataItem<MaxBandSoundData_t, 1>& GetRightMaxBand() const { return m_R_Max_Band; }
+    const ReplayDataItem<MaxBandSoundData_t, 1>& GetLeftMaxBand() const { return m_L_Max_Band; }
+    const ReplayDataItem<SpectralPeak_t, SPECTRAL_PEAK_COUNT>& GetRightPeaks() const { return m_R_Peaks; }
+    const ReplayDataItem<SpectralPeak_t, SPECTRAL_PEAK_COUNT>& GetLeftPeaks() const { return m_L_Peaks; }
+
+  private:
+    const int32_t m_SampleRate;
+    const float m_FFT_Gain;
+    size_t m_FFTCount = 0;
+    FFT_Calculator m_R_FFT;
+    FFT_Calculator m_L_FFT;
+    FFT_BandLayout_t m_BandLayout;
+
+    ReplayDataItem<float, 8> m_R_Bands_8 = ReplayDataItem<float, 8>("R_Bands_8", 0.0);
+    ReplayDataItem<float, 16> m_R_Bands_16 = ReplayDataItem<float, 16>("R_Bands_16", 0.0);
+    ReplayDataItem<float, 32> m_R_Bands = ReplayDataItem<float, 32>("R_Bands", 0.0);
+    ReplayDataItem<float, 64> m_R_Bands_64 = ReplayDataItem<float, 64>("R_Bands_64", 0.0);
+    ReplayDataItem<float, 8> m_L_Bands_8 = ReplayDataItem<float, 8>("L_Bands_8", 0.0);
+    ReplayDataItem<float, 16> m_L_Bands_16 = ReplayDataItem<float, 16>("L_Bands_16", 0.0);
+    ReplayDataItem<float, 32> m_L_Bands = ReplayDataItem<float, 32>("L_Bands", 0.0);
+    ReplayDataItem<float, 64> m_L_Bands_64 = ReplayDataItem<float, 64>("L_Bands_64", 0.0);
+    ReplayDataItem<MaxBandSoundData_t, 1> m_R_Max_Band = ReplayDataItem<MaxBandSoundData_t, 1>("R_Max_Band", MaxBandSoundData_t(0.0, 0, 0));
+    ReplayDataItem<MaxBandSoundData_t, 1> m_L_Max_Band = ReplayDataItem<MaxBandSoundData_t, 1>("L_Max_Band", MaxBandSoundData_t(0.0, 0, 0));
+    ReplayDataItem<SpectralPeak_t, SPECTRAL_PEAK_COUNT> m_R_Peaks = ReplayDataItem<SpectralPeak_t, SPECTRAL_PEAK_COUNT>("R_Peaks", SpectralPeak_t());
+    ReplayDataItem<SpectralPeak_t, SPECTRAL_PEAK_COUNT> m_L_Peaks = ReplayDataItem<SpectralPeak_t, SPECTRAL_PEAK_COUNT>("L_Peaks", SpectralPeak_t());
+
+    void Update_Bands_And_Send_Result( FFT_Calculator &FFT
+                                     , ReplayDataItem<float, 8> &Bands_8
+                                     , ReplayDataItem<float, 16> &Bands_16
+                                     , ReplayDataItem<float, 32> &Bands_32
+                                     , ReplayDataItem<float, 64> &Bands_64
+                                     , ReplayDataItem<MaxBandSoundData_t, 1> &MaxBand
+                                     , ReplayDataItem<SpectralPeak_t, SPECTRAL_PEAK_COUNT> &Peaks )
+    {
+      float Bands_DataBuffer[BAND_LAYOUT_MAX_BANDS];
+      const MaxBandSoundData_t MaxBandData = CalculateBands(m_BandLayout, FFT.GetFFTBuffer(), Bands_DataBuffer);
+      SendBands(Bands_DataBuffer, MaxBandData.TotalBands, Bands_8, Bands_16, Bands_32, Bands_64);
+      MaxBand.SetValue(MaxBandData);
+
+      SpectralPeak_t PeakBuffer[SPECTRAL_PEAK_COUNT];
+      GetSpectralPeaks(FFT, PeakBuffer);
+      Peaks.SetValue(PeakBuffer, SPECTRAL_PEAK_COUNT);
+    }
+
+    const float* GetBands( const ReplayDataItem<float, 8> &Bands_8
+                         , const ReplayDataItem<float, 16> &Bands_16
+                         , const ReplayDataItem<float, 32> &Bands_32
+                         , const ReplayDataItem<float, 64> &Bands_64 ) const
+    {
+      switch(m_BandLayout.GetBandCount())
+      {
+        case 8: return Bands_8.GetValuePointer();
+        case 16: return Bands_16.GetValuePointer();
+        case 64: return Bands_64.GetValuePointer();
+        default: return Bands_32.GetValuePointer();
+      }
+    }
+};
@@ -0,0 +1,126 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <Arduino.h>
+#include <DataTypes.h>
+#include <cstdio>
+#include <vector>
+
+//Streams 16 bit PCM WAV files as the same stereo Frame_t the I2S input produces. Mono files are copied to both channels.
+class WavReader
+{
+  public:
+    WavReader(){}
+    virtual ~WavReader()
+    {
+      Close();
+    }
+    bool Open(const char* Path)
+    {
+      Close();
+      mp_File = fopen(Path, "rb");
+      if(!mp_File)
+      {
+        ESP_LOGE("WavReader", "ERROR! Unable to open \"%s\"", Path);
+        return false;
+      }
+      if(!ReadHeader())
+      {
+        ESP_LOGE("WavReader", "ERROR! \"%s\" is not a 16 bit PCM WAV file", Path);
+        Close();
+        return false;
+      }
+      return true;
+    }
+    void Close()
+    {
+      if(mp_File) fclose(mp_File);
+      mp_File = nullptr;
+    }
+    //Reads up to Count frames. Returns the number of frames read, 0 at the end of the data chunk.
+    size_t ReadFrames(Frame_t *Frames, size_t Count)
+    {
+      if(!mp_File) return 0;
+      const size_t FramesRemaining = m_FrameCount - m_FramesRead;
+      if(Count > FramesRemaining) Count = FramesRemaining;
+      m_Samples.resize(Count * m_ChannelCount);
+      const size_t Read = fread(m_Samples.data(), sizeof(int16_t) * m_ChannelCount, Count, mp_File);
+      for(size_t i = 0; i < Read; ++i)
+      {
+        Frames[i].channel1 = m_Samples[i * m_ChannelCount];
+        Frames[i].channel2 = (m_ChannelCount > 1) ? m_Samples[(i * m_ChannelCount) + 1] : Frames[i].channel1;
+      }
+      m_FramesRead += Read;
+      return Read;
+    }
+    uint32_t GetSampleRate() const { return m_SampleRate; }
+    uint16_t GetChannelCount() const { return m_ChannelCount; }
+    size_t GetFrameCount() const { return m_FrameCount; }
+    float GetDuration() const { return (m_SampleRate) ? (float)m_FrameCount / (float)m_SampleRate : 0.0f; }
+
+  private:
+    FILE *mp_File = nullptr;
+    uint32_t m_SampleRate = 0;
+    uint16_t m_ChannelCount = 0;
+    size_t m_FrameCount = 0;
+    size_t m_FramesRead = 0;
+    std::vector<int16_t> m_Samples;
+
+    bool ReadHeader()
+    {
+      char Id[4];
+      uint32_t Size;
+      char Format[4];
+      if( 1 != fread(Id, 4, 1, mp_File) || 0 != memcmp(Id, "RIFF", 4) ||
+          1 != fread(&Size, 4, 1, mp_File) ||
+          1 != fread(Format, 4, 1, mp_File) || 0 != memcmp(Format, "WAVE", 4) ) return false;
+      bool FormatFound = false;
+      while(1 == fread(Id, 4, 1, mp_File) && 1 == fread(&Size, 4, 1, mp_File))
+      {
+        if(0 == memcmp(Id, "fmt ", 4))
+        {
+          uint16_t AudioFormat;
+          uint16_t BitsPerSample;
+          uint8_t Unused[6];
+          if( Size < 16 ||
+              1 != fread(&AudioFormat, 2, 1, mp_File) ||
+              1 != fread(&m_ChannelCount, 2, 1, mp_File) ||
+              1 != fread(&m_SampleRate, 4, 1, mp_File) ||
+              1 != fread(Unused, 6, 1, mp_File) ||
+              1 != fread(&BitsPerSample, 2, 1, mp_File) ) return false;
+          if(1 != AudioFormat || 16 != BitsPerSample || 0 == m_ChannelCount || m_ChannelCount > 2) return false;
+          FormatFound = true;
+          fseek(mp_File, (Size - 16) + (Size & 1), SEEK_CUR);
+        }
+        else if(0 == memcmp(Id, "data", 4))
+        {
+          if(!FormatFound) return false;
+          m_FrameCount = Size / (sizeof(int16_t) * m_ChannelCount);
+          m_FramesRead = 0;
+          return true;
+        }
+        else
+        {
+          fseek(mp_File, Size + (Size & 1), SEEK_CUR);
+        }
+      }
+      return false;
+    }
+};
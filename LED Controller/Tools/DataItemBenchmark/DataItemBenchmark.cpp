@@ -0,0 +1,185 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//Get and set latency of LocalDataItems of the sizes the CPUs use. Each set alternates between two values so every
+//call stores a change. "Get Busy" is the get latency while another thread keeps setting the item. The second table
+//is the cost of converting one value of each type to and from its string, through the streams and in place.
+//
+//  cd Tools/DataItemBenchmark && pio run
+//  .pio/build/native/program [iterations]
+
+#include <Arduino.h>
+#include <DataItem/LocalDataItem.h>
+#include <StageProfiler.h>
+#include <array>
+#include <atomic>
+#include <sstream>
+#include <thread>
+
+#define DATAITEM_BENCHMARK_DEFAULT_ITERATIONS 20000
+
+struct DataItemBenchmarkResult_t
+{
+	double GetTicks = 0.0;
+	double SetTicks = 0.0;
+	double BusyGetTicks = 0.0;
+	double FromStringTicks = 0.0;
+	bool Correct = false;
+};
+
+struct StringCodecBenchmarkResult_t
+{
+	double StreamEncodeTicks = 0.0;
+	double EncodeTicks = 0.0;
+	double StreamDecodeTicks = 0.0;
+	double DecodeTicks = 0.0;
+	bool Correct = false;
+};
+
+template <typename T, size_t COUNT>
+static DataItemBenchmarkResult_t BenchmarkLocalDataItem(SetupCallerInterface &SetupCaller, const T &First, const T &Second, size_t Iterations)
+{
+	DataItemBenchmarkResult_t Result;
+	LocalDataItem<T, COUNT> Item("Benchmark", First, nullptr, &SetupCaller);
+	SetupCaller.SetupAllSetupCallees();
+	std::array<T, COUNT> Values[2];
+	Values[0].fill(First);
+	Values[1].fill(Second);
+	std::array<T, COUNT> Read;
+
+	uint32_t Start = GetProfilerTicks();
+	for(size_t i = 0; i < Iterations; ++i)
+	{
+		Item.SetValue(Values[(i + 1) & 1].data(), COUNT);
+	}
+	Result.SetTicks = (double)(GetProfilerTicks() - Start) / Iterations;
+
+	const String Strings[2] = { Item.ConvertValueToString(Values[0].data(), COUNT), Item.ConvertValueToString(Values[1].data(), COUNT) };
+	Start = GetProfilerTicks();
+	for(size_t i = 0; i < Iterations; ++i)
+	{
+		Item.SetValueFromString(Strings[(i + 1) & 1]);
+	}
+	Result.FromStringTicks = (double)(GetProfilerTicks() - Start) / Iterations;
+
+	Start = GetProfilerTicks();
+	for(size_t i = 0; i < Iterations; ++i)
+	{
+		Item.GetValue(Read.data(), COUNT);
+	}
+	Result.GetTicks = (double)(GetProfilerTicks() - Start) / Iterations;
+	Result.Correct = (Read == Values[Iterations & 1]);
+
+	std::atomic<bool> Done = {false};
+	std::thread Writer([&]()
+	{
+		for(size_t i = 0; !Done; ++i) Item.SetValue(Values[(i + 1) & 1].data(), COUNT);
+	});
+	Start = GetProfilerTicks();
+	for(size_t i = 0; i < Iterations; ++i)
+	{
+		Item.GetValue(Read.data(), COUNT);
+		Result.Correct &= (Read == Values[0] || Read == Values[1]);
+	}
+	Result.BusyGetTicks = (double)(GetProfilerTicks() - Start) / Iterations;
+	Done = true;
+	Writer.join();
+	return Result;
+}
+
+//The streams are what StringEncoderDecoder used before converting numbers in place
+template <typename T>
+static StringCodecBenchmarkResult_t BenchmarkStringCodec(const T &Value, size_t Iterations)
+{
+	StringCodecBenchmarkResult_t Result;
+	StringEncoderDecoder<T> Codec;
+	char Buffer[STRING_ENCODER_NUMBER_LENGTH];
+	size_t Length = 0;
+	T Decoded = T();
+
+	uint32_t Start = GetProfilerTicks();
+	for(size_t i = 0; i < Iterations; ++i)
+	{
+		std::ostringstream Stream;
+		Stream << Value;
+		Length += String(Stream.str().c_str()).length();
+	}
+	Result.StreamEncodeTicks = (double)(GetProfilerTicks() - Start) / Iterations;
+
+	Start = GetProfilerTicks();
+	for(size_t i = 0; i < Iterations; ++i)
+	{
+		Length += Codec.EncodeToChars(Value, Buffer, Buffer + sizeof(Buffer)) - Buffer;
+	}
+	Result.EncodeTicks = (double)(GetProfilerTicks() - Start) / Iterations;
+
+	const String Encoded = String(Buffer);
+	Start = GetProfilerTicks();
+	for(size_t i = 0; i < Iterations; ++i)
+	{
+		std::istringstream Stream(std::string(Encoded.c_str()));
+		Stream >> Decoded;
+	}
+	Result.StreamDecodeTicks = (double)(GetProfilerTicks() - Start) / Iterations;
+	const T StreamDecoded = Decoded;
+
+	Start = GetProfilerTicks();
+	for(size_t i = 0; i < Iterations; ++i)
+	{
+		Codec.DecodeFromChars(Encoded.c_str(), Encoded.c_str() + Encoded.length(), Decoded);
+	}
+	Result.DecodeTicks = (double)(GetProfilerTicks() - Start) / Iterations;
+	Result.Correct = (Length > 0) && (StreamDecoded == Decoded);
+	return Result;
+}
+
+template <typename T>
+static void ReportStringCodec(const char* Name, const T &Value, size_t Iterations)
+{
+	const StringCodecBenchmarkResult_t Result = BenchmarkStringCodec<T>(Value, Iterations);
+	printf("%-14s | %13.0f %10.0f %13.0f %10.0f%s\n", Name, Result.StreamEncodeTicks, Result.EncodeTicks, Result.StreamDecodeTicks, Result.DecodeTicks, Result.Correct ? "" : "  WRONG VALUE");
+}
+
+template <typename T, size_t COUNT>
+static void Report(const char* Name, SetupCallerInterface &SetupCaller, const T &First, const T &Second, size_t Iterations)
+{
+	const DataItemBenchmarkResult_t Result = BenchmarkLocalDataItem<T, COUNT>(SetupCaller, First, Second, Iterations);
+	printf("%-14s %6zu | %10.0f %10.0f %10.0f %12.0f%s\n", Name, sizeof(T) * COUNT, Result.GetTicks, Result.BusyGetTicks, Result.SetTicks, Result.FromStringTicks, Result.Correct ? "" : "  WRONG VALUE");
+}
+
+int main(int argc, char** argv)
+{
+	const size_t Iterations = (argc > 1) ? strtoul(argv[1], nullptr, 10) : DATAITEM_BENCHMARK_DEFAULT_ITERATIONS;
+	SetupCallerInterface SetupCaller;
+	printf("%zu iterations, times in %s per call\n", Iterations, GetProfilerTicksUnit());
+	printf("%-14s %6s | %10s %10s %10s %12s\n", "Item", "Bytes", "Get", "Get Busy", "Set", "From String");
+	Report<bool, 1>("bool", SetupCaller, false, true, Iterations);
+	Report<float, 1>("float", SetupCaller, 1.0f, 2.0f, Iterations);
+	Report<float, 8>("float[8]", SetupCaller, 1.0f, 2.0f, Iterations);
+	Report<float, 32>("float[32]", SetupCaller, 1.0f, 2.0f, Iterations);
+	Report<float, 64>("float[64]", SetupCaller, 1.0f, 2.0f, Iterations);
+
+	printf("\n%-14s | %13s %10s %13s %10s\n", "Type", "Stream Encode", "Encode", "Stream Decode", "Decode");
+	ReportStringCodec<bool>("bool", true, Iterations);
+	ReportStringCodec<char>("char", 'L', Iterations);
+	ReportStringCodec<int32_t>("int32_t", -1234567, Iterations);
+	ReportStringCodec<uint32_t>("uint32_t", 4000000000u, Iterations);
+	ReportStringCodec<float>("float", 3.14159f, Iterations);
+	ReportStringCodec<double>("double", -2.5e-10, Iterations);
+	return 0;
+}
@@ -0,0 +1,347 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//Minimal stand-in for the Arduino core used by the host tools. Only covers what the shared
+//CommonClasses headers need: String, Print, timing, the ESP log macros and the FreeRTOS names they use.
+#pragma once
+
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#define ARDUINO_HOST 1
+
+#ifndef configMAX_PRIORITIES
+	#define configMAX_PRIORITIES 25
+#endif
+
+#ifndef HOST_LOG_LEVEL
+	#define HOST_LOG_LEVEL 1
+#endif
+#define HOST_LOG(level, letter, tag, format, ...) do{ if(HOST_LOG_LEVEL >= level) fprintf(stderr, letter " (%s) " format "\n", tag, ##__VA_ARGS__); }while(0)
+#define ESP_LOGE(tag, format, ...) HOST_LOG(1, "E", tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) HOST_LOG(2, "W", tag, format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...) HOST_LOG(3, "I", tag, format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...) HOST_LOG(4, "D", tag, format, ##__VA_ARGS__)
+#define ESP_LOGV(tag, format, ...) HOST_LOG(5, "V", tag, format, ##__VA_ARGS__)
+
+inline unsigned long millis()
+{
+	using namespace std::chrono;
+	static const steady_clock::time_point start = steady_clock::now();
+	return static_cast<unsigned long>(duration_cast<milliseconds>(steady_clock::now() - start).count());
+}
+
+inline unsigned long micros()
+{
+	using namespace std::chrono;
+	static const steady_clock::time_point start = steady_clock::now();
+	return static_cast<unsigned long>(duration_cast<microseconds>(steady_clock::now() - start).count());
+}
+
+inline void delay(unsigned long ms)
+{
+	std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+class String
+{
+	public:
+		String(){}
+		String(const char* value): m_Value(value ? value : ""){}
+		String(const std::string &value): m_Value(value){}
+		String(char value): m_Value(1, value){}
+		String(int value, unsigned char base = 10): m_Value(ToBase(static_cast<long long>(value), base)){}
+		String(unsigned int value, unsigned char base = 10): m_Value(ToBase(static_cast<long long>(value), base)){}
+		String(long value, unsigned char base = 10): m_Value(ToBase(static_cast<long long>(value), base)){}
+		String(unsigned long value, unsigned char base = 10): m_Value(ToBase(static_cast<long long>(value), base)){}
+		String(long long value, unsigned char base = 10): m_Value(ToBase(value, base)){}
+		String(unsigned long long value, unsigned char base = 10): m_Value(ToBase(static_cast<long long>(value), base)){}
+		String(float value, unsigned char decimalPlaces = 2): m_Value(ToFixed(value, decimalPlaces)){}
+		String(double value, unsigned char decimalPlaces = 2): m_Value(ToFixed(value, decimalPlaces)){}
+
+		const char* c_str() const { return m_Value.c_str(); }
+		unsigned int length() const { return static_cast<unsigned int>(m_Value.length()); }
+		bool isEmpty() const { return m_Value.empty(); }
+		void reserve(unsigned int size) { m_Value.reserve(size); }
+		bool equals(const String &other) const { return m_Value == other.m_Value; }
+		bool equals(const char* other) const { return m_Value == (other ? other : ""); }
+		bool startsWith(const String &prefix) const { return 0 == m_Value.compare(0, prefix.m_Value.length(), prefix.m_Value); }
+		bool endsWith(const String &suffix) const
+		{
+			return m_Value.length() >= suffix.m_Value.length() && 0 == m_Value.compare(m_Value.length() - suffix.m_Value.length(), suffix.m_Value.length(), suffix.m_Value);
+		}
+		int indexOf(char value, unsigned int from = 0) const { return Position(m_Value.find(value, from)); }
+		int indexOf(const String &value, unsigned int from = 0) const { return Position(m_Value.find(value.m_Value, from)); }
+		int lastIndexOf(char value) const { return Position(m_Value.rfind(value)); }
+		String substring(unsigned int from) const { return (from < m_Value.length()) ? String(m_Value.substr(from)) : String(); }
+		String substring(unsigned int from, unsigned int to) const
+		{
+			if(from > to) std::swap(from, to);
+			return (from < m_Value.length()) ? String(m_Value.substr(from, to - from)) : String();
+		}
+		char charAt(unsigned int index) const { return (index < m_Value.length()) ? m_Value[index] : 0; }
+		char operator[](unsigned int index) const { return charAt(index); }
+		long toInt() const { return strtol(m_Value.c_str(), nullptr, 10); }
+		float toFloat() const { return strtof(m_Value.c_str(), nullptr); }
+		double toDouble() const { return strtod(m_Value.c_str(), nullptr); }
+		void trim()
+		{
+			const char* whitespace = " \t\r\n";
+			size_t first = m_Value.find_first_not_of(whitespace);
+			size_t last = m_Value.find_last_not_of(whitespace);
+			m_Value = (std::string::npos == first) ? std::string() : m_Value.substr(first, last - first + 1);
+		}
+		bool concat(const String &value) { m_Value += value.m_Value; return true; }
+
+		String& operator+=(const String &value) { m_Value += value.m_Value; return *this; }
+		String& operator+=(const char* value) { m_Value += (value ? value : ""); return *this; }
+		String& operator+=(char value) { m_Value += value; return *this; }
+		friend String operator+(const String &a, const String &b) { return String(a.m_Value + b.m_Value); }
+		friend String operator+(const String &a, const char* b) { return String(a.m_Value + (b ? b : "")); }
+		friend String operator+(const char* a, const String &b) { return String((a ? a : "") + b.m_Value); }
+		friend String operator+(const String &a, char b) { return String(a.m_Value + b); }
+		bool operator==(const String &other) const { return m_Value == other.m_Value; }
+		bool operator==(const char* other) const { return equals(other); }
+		bool operator!=(const String &other) const { return m_Value != other.m_Value; }
+		bool operator!=(const char* other) const { return !equals(other); }
+		bool operator<(const String &other) const { return m_Value < other.m_Value; }
+
+	private:
+		std::string m_Value;
+
+		static int Position(size_t position) { return (std::string::npos == position) ? -1 : static_cast<int>(position); }
+		static std::string ToBase(long long value, unsigned char base)
+		{
+			if(10 == base) return std::to_string(value);
+			const char* digits = "0123456789abcdef";
+			unsigned long long magnitude = static_cast<unsigned long long>(value);
+			std::string result;
+			do
+			{
+				result.insert(result.begin(), digits[magnitude % base]);
+				magnitude /= base;
+			} while(magnitude);
+			return result;
+		}
+		static std::string ToFixed(double value, unsigned char decimalPlaces)
+		{
+			char buffer[64];
+			snprintf(buffer, sizeof(buffer), "%.*f", decimalPlaces, value);
+			return buffer;
+		}
+};
+
+//FreeRTOS types and queue calls referenced by the shared headers. The host tools never create queues, so every
+//queue call reports failure.
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef void* QueueHandle_t;
+typedef void* TaskHandle_t;
+typedef uint32_t TickType_t;
+typedef void (*TaskFunction_t)(void*);
+#define pdTRUE          1
+#define pdFALSE         0
+#define pdPASS          pdTRUE
+#define pdFAIL          pdFALSE
+#define portMAX_DELAY   0xFFFFFFFFUL
+#define portTICK_PERIOD_MS 1
+inline QueueHandle_t xQueueCreate(UBaseType_t, UBaseType_t) { return nullptr; }
+inline void vQueueDelete(QueueHandle_t) {}
+inline BaseType_t xQueueSend(QueueHandle_t, const void*, TickType_t) { return pdFALSE; }
+inline BaseType_t xQueueReceive(QueueHandle_t, void*, TickType_t) { return pdFALSE; }
+inline UBaseType_t uxQueueMessagesWaiting(QueueHandle_t) { return 0; }
+
+//Tasks run on threads, so the link manager's RX and TX tasks work unchanged on the host. Priorities and cores are
+//ignored. vTaskDelete cannot stop a thread where it stands, it wakes the task and unwinds it at its next delay or
+//notification wait, then waits for it to finish.
+typedef enum
+{
+	eRunning,
+	eReady,
+	eBlocked,
+	eSuspended,
+	eDeleted,
+	eInvalid
+} eTaskState;
+
+struct HostTask_t
+{
+	std::thread Thread;
+	std::mutex Mutex;
+	std::condition_variable Wake;
+	uint32_t NotifyCount = 0;
+	bool Deleted = false;
+};
+struct HostTaskDeleted_t {};
+
+inline HostTask_t*& HostCurrentTask()
+{
+	static thread_local HostTask_t* task = nullptr;
+	return task;
+}
+
+//Blocks the calling task for ticks, or until notified when takeNotify is set. Returns the notification count taken.
+inline uint32_t HostTaskBlock(TickType_t ticks, bool takeNotify, bool clearNotify)
+{
+	HostTask_t* task = HostCurrentTask();
+	if(!task)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(ticks * portTICK_PERIOD_MS));
+		return 0;
+	}
+	std::unique_lock<std::mutex> lock(task->Mutex);
+	auto ready = [&]{ return task->Deleted || (takeNotify && task->NotifyCount > 0); };
+	if(portMAX_DELAY == ticks) task->Wake.wait(lock, ready);
+	else task->Wake.wait_for(lock, std::chrono::milliseconds(ticks * portTICK_PERIOD_MS), ready);
+	if(task->Deleted) throw HostTaskDeleted_t();
+	if(!takeNotify) return 0;
+	const uint32_t count = task->NotifyCount;
+	if(count > 0) task->NotifyCount = clearNotify ? 0 : count - 1;
+	return count;
+}
+
+inline BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char*, uint32_t, void* parameters, UBaseType_t, TaskHandle_t* handle, BaseType_t)
+{
+	HostTask_t* task = new HostTask_t();
+	if(handle) *handle = task;
+	task->Thread = std::thread([task, function, parameters]
+	{
+		HostCurrentTask() = task;
+		try
+		{
+			function(parameters);
+		}
+		catch(const HostTaskDeleted_t&)
+		{
+		}
+	});
+	return pdPASS;
+}
+
+inline void vTaskDelete(TaskHandle_t handle)
+{
+	HostTask_t* task = handle ? static_cast<HostTask_t*>(handle) : HostCurrentTask();
+	if(!task) return;
+	if(task == HostCurrentTask()) throw HostTaskDeleted_t();
+	{
+		std::lock_guard<std::mutex> lock(task->Mutex);
+		task->Deleted = true;
+	}
+	task->Wake.notify_all();
+	if(task->Thread.joinable()) task->Thread.join();
+	delete task;
+}
+
+inline eTaskState eTaskGetState(TaskHandle_t handle)
+{
+	HostTask_t* task = static_cast<HostTask_t*>(handle);
+	if(!task) return eInvalid;
+	std::lock_guard<std::mutex> lock(task->Mutex);
+	return task->Deleted ? eDeleted : eRunning;
+}
+
+inline void xTaskNotifyGive(TaskHandle_t handle)
+{
+	HostTask_t* task = static_cast<HostTask_t*>(handle);
+	if(!task) return;
+	{
+		std::lock_guard<std::mutex> lock(task->Mutex);
+		++task->NotifyCount;
+	}
+	task->Wake.notify_all();
+}
+
+inline uint32_t ulTaskNotifyTake(BaseType_t clearCountOnExit, TickType_t ticksToWait)
+{
+	return HostTaskBlock(ticksToWait, true, pdFALSE != clearCountOnExit);
+}
+
+inline TickType_t xTaskGetTickCount()
+{
+	return static_cast<TickType_t>(millis() / portTICK_PERIOD_MS);
+}
+
+inline void vTaskDelay(TickType_t ticks)
+{
+	HostTaskBlock(ticks, false, false);
+}
+
+inline void vTaskDelayUntil(TickType_t* previousWakeTime, TickType_t increment)
+{
+	*previousWakeTime += increment;
+	const int32_t remaining = static_cast<int32_t>(*previousWakeTime - xTaskGetTickCount());
+	if(remaining > 0) vTaskDelay(static_cast<TickType_t>(remaining));
+}
+
+class Print
+{
+	public:
+		virtual ~Print(){}
+		virtual size_t write(uint8_t value)
+		{
+			return fwrite(&value, 1, 1, stdout);
+		}
+		virtual size_t write(const uint8_t* buffer, size_t size)
+		{
+			return fwrite(buffer, 1, size, stdout);
+		}
+		size_t print(const String &value) { return fwrite(value.c_str(), 1, value.length(), stdout); }
+		size_t print(const char* value) { return print(String(value)); }
+		template<typename T> size_t print(T value) { return print(String(value)); }
+		template<typename T> size_t print(T value, int format) { return print(String(value, format)); }
+		size_t println() { return print("\n"); }
+		template<typename T> size_t println(T value) { return print(value) + println(); }
+};
+
+typedef enum
+{
+	UART_NO_ERROR,
+	UART_BREAK_ERROR,
+	UART_BUFFER_FULL_ERROR,
+	UART_FIFO_OVF_ERROR,
+	UART_FRAME_ERROR,
+	UART_PARITY_ERROR
+} hardwareSerial_error_t;
+typedef std::function<void(void)> OnReceiveCb;
+typedef std::function<void(hardwareSerial_error_t)> OnReceiveErrorCb;
+
+class HardwareSerial: public Print
+{
+	public:
+		HardwareSerial(int uartNum = 0) {}
+		virtual int available() { return 0; }
+		virtual int read() { return -1; }
+		virtual size_t read(uint8_t* buffer, size_t size) { return 0; }
+		void onReceive(OnReceiveCb function) { m_OnReceive = function; }
+		void onReceiveError(OnReceiveErrorCb function) { m_OnReceiveError = function; }
+	protected:
+		OnReceiveCb m_OnReceive;
+		OnReceiveErrorCb m_OnReceiveError;
+};
+
+static HardwareSerial Serial;
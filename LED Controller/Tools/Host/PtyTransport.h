@@ -0,0 +1,182 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//Link transport over a Linux pseudo terminal, so two host processes can run the link the way two boards do.
+//One process opens the master side and passes GetPeerPath() to the other, which opens that path. Both ends are
+//raw, 8 bit clean. A reader thread waits on the descriptor and calls the receive callback when bytes arrive,
+//standing in for the UART event task.
+//
+//  PtyTransport master;                  PtyTransport slave;
+//  master.Open();                        slave.Open("/dev/pts/7");
+//  printf("%s", master.GetPeerPath());
+#pragma once
+
+#include <atomic>
+#include <cerrno>
+#include <fcntl.h>
+#include <mutex>
+#include <poll.h>
+#include <stdlib.h>
+#include <string>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <thread>
+#include <unistd.h>
+#include "Arduino.h"
+#include "LinkTransport.h"
+
+#define PTY_TRANSPORT_POLL_MS 50          //How often the reader thread checks whether it should stop
+#define PTY_TRANSPORT_DRAIN_CHECK_US 100   //How often the reader thread checks that the woken reader took the bytes
+
+class PtyTransport: public ITransport
+{
+	public:
+		PtyTransport(){}
+		virtual ~PtyTransport()
+		{
+			Close();
+		}
+
+		//Opens a new pseudo terminal master, or the slave at peerPath when one is given
+		bool Open(const char* peerPath = nullptr)
+		{
+			Close();
+			if(peerPath)
+			{
+				m_Fd = open(peerPath, O_RDWR | O_NOCTTY);
+			}
+			else
+			{
+				m_Fd = posix_openpt(O_RDWR | O_NOCTTY);
+				if(m_Fd >= 0 && (0 != grantpt(m_Fd) || 0 != unlockpt(m_Fd)))
+				{
+					close(m_Fd);
+					m_Fd = -1;
+				}
+				if(m_Fd >= 0)
+				{
+					m_PeerPath = ptsname(m_Fd);
+					//Held open so the master does not see a hang up before the peer process opens it
+					m_HoldFd = open(m_PeerPath.c_str(), O_RDWR | O_NOCTTY);
+				}
+			}
+			if(m_Fd < 0)
+			{
+				ESP_LOGE("Open", "ERROR! Could not open a pseudo terminal: %s", strerror(errno));
+				return false;
+			}
+			MakeRaw(peerPath ? m_Fd : m_HoldFd);
+			m_Running = true;
+			m_ReaderThread = std::thread(&PtyTransport::ReaderThread, this);
+			return true;
+		}
+
+		void Close()
+		{
+			m_Running = false;
+			if(m_ReaderThread.joinable()) m_ReaderThread.join();
+			if(m_HoldFd >= 0) close(m_HoldFd);
+			if(m_Fd >= 0) close(m_Fd);
+			m_HoldFd = -1;
+			m_Fd = -1;
+		}
+
+		//Path the other process opens, empty on the slave side
+		const char* GetPeerPath() const { return m_PeerPath.c_str(); }
+
+		int Available() override
+		{
+			int count = 0;
+			if(m_Fd < 0 || 0 != ioctl(m_Fd, FIONREAD, &count)) return 0;
+			return count;
+		}
+
+		size_t Read(uint8_t* buffer, size_t size) override
+		{
+			if(m_Fd < 0) return 0;
+			const ssize_t count = read(m_Fd, buffer, size);
+			return (count > 0) ? static_cast<size_t>(count) : 0;
+		}
+
+		//Blocks while the terminal's buffer is full, the way the UART driver waits for room in its TX buffer
+		size_t Write(const uint8_t* buffer, size_t size) override
+		{
+			size_t written = 0;
+			while(m_Fd >= 0 && written < size)
+			{
+				const ssize_t count = write(m_Fd, buffer + written, size - written);
+				if(count > 0) written += count;
+				else if(count < 0 && EINTR != errno && EAGAIN != errno) return 0;
+			}
+			return written;
+		}
+
+		void SetRxCallbacks(TransportRxCallback_t onReceive, TransportRxErrorCallback_t onError) override
+		{
+			std::lock_guard<std::mutex> lock(m_CallbackMutex);
+			m_OnReceive = onReceive;
+			m_OnError = onError;
+		}
+
+	private:
+		int m_Fd = -1;
+		int m_HoldFd = -1;
+		std::string m_PeerPath;
+		std::atomic<bool> m_Running = {false};
+		std::thread m_ReaderThread;
+		std::mutex m_CallbackMutex;
+		TransportRxCallback_t m_OnReceive;
+		TransportRxErrorCallback_t m_OnError;
+
+		//No echo, no line editing and no character translation, so link frames pass through unchanged
+		static void MakeRaw(int fd)
+		{
+			termios settings;
+			if(fd < 0 || 0 != tcgetattr(fd, &settings)) return;
+			cfmakeraw(&settings);
+			tcsetattr(fd, TCSANOW, &settings);
+		}
+
+		void ReaderThread()
+		{
+			pollfd descriptor = { m_Fd, POLLIN, 0 };
+			while(m_Running)
+			{
+				descriptor.revents = 0;
+				if(poll(&descriptor, 1, PTY_TRANSPORT_POLL_MS) <= 0) continue;
+				if(descriptor.revents & POLLIN)
+				{
+					{
+						std::lock_guard<std::mutex> lock(m_CallbackMutex);
+						if(m_OnReceive) m_OnReceive();
+					}
+					//poll keeps reporting the bytes until they are read, so wake the reader once per batch of them
+					while(m_Running && Available() > 0) std::this_thread::sleep_for(std::chrono::microseconds(PTY_TRANSPORT_DRAIN_CHECK_US));
+				}
+				else if(descriptor.revents & (POLLERR | POLLHUP))
+				{
+					//The peer has gone, wait for it to come back rather than spin
+					{
+						std::lock_guard<std::mutex> lock(m_CallbackMutex);
+						if(m_OnError) m_OnError(UART_BREAK_ERROR);
+					}
+					std::this_thread::sleep_for(std::chrono::milliseconds(PTY_TRANSPORT_POLL_MS));
+				}
+			}
+		}
+};
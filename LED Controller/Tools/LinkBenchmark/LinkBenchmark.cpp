@@ -0,0 +1,163 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//Compares the JSON-hex DataSerializer encoding with the binary link frame for typical DataItems.
+//Reports bytes on the wire per message and the average encode and decode time.
+//
+//  cd Tools/LinkBenchmark && pio run
+//  .pio/build/native/program [iterations]
+
+#include <Arduino.h>
+#include <DataSerializer.h>
+#include <StageProfiler.h>
+#include <LinkTxBatcher.h>
+#include <vector>
+
+#define LINK_BENCHMARK_DEFAULT_ITERATIONS 20000
+
+struct LinkBenchmarkCase_t
+{
+	const char* Name;
+	DataType_t DataType;
+	size_t Count;
+};
+
+struct LinkBenchmarkResult_t
+{
+	size_t Bytes = 0;
+	double EncodeTicks = 0.0;
+	double DecodeTicks = 0.0;
+	bool RoundTrip = false;
+};
+
+static LinkBenchmarkResult_t BenchmarkJson(DataSerializer &Serializer, const LinkBenchmarkCase_t &Case, const uint8_t* Object, size_t Iterations)
+{
+	LinkBenchmarkResult_t Result;
+	const size_t ByteCount = Serializer.GetSizeOfDataType(Case.DataType) * Case.Count;
+	String Message;
+	uint32_t Start = GetProfilerTicks();
+	for(size_t i = 0; i < Iterations; ++i)
+	{
+		Message = Serializer.SerializeDataItemToJson(Case.Name, Case.DataType, (void*)Object, Case.Count, i);
+	}
+	Result.EncodeTicks = (double)(GetProfilerTicks() - Start) / Iterations;
+	Result.Bytes = Message.length() + 2;  //println appends CR LF
+
+	Start = GetProfilerTicks();
+	for(size_t i = 0; i < Iterations; ++i)
+	{
+		NamedObject_t NamedObject;
+		Result.RoundTrip = Serializer.DeSerializeJsonToNamedObject(Message, NamedObject) &&
+						   (0 == memcmp(NamedObject.Object, Object, ByteCount));
+	}
+	Result.DecodeTicks = (double)(GetProfilerTicks() - Start) / Iterations;
+	return Result;
+}
+
+static LinkBenchmarkResult_t BenchmarkFrame(DataSerializer &Serializer, const LinkBenchmarkCase_t &Case, const uint8_t* Object, size_t Iterations)
+{
+	LinkBenchmarkResult_t Result;
+	const size_t ByteCount = Serializer.GetSizeOfDataType(Case.DataType) * Case.Count;
+	uint8_t Frame[LINK_FRAME_MAX_ENCODED_SIZE(1024)];
+	alignas(4) uint8_t RxFrame[sizeof(Frame)];
+	size_t Length = 0;
+	uint32_t Start = GetProfilerTicks();
+	for(size_t i = 0; i < Iterations; ++i)
+	{
+		Length = Serializer.SerializeDataItemToFrame(Case.Name, Case.DataType, Object, Case.Count, i, i, Frame, sizeof(Frame));
+	}
+	Result.EncodeTicks = (double)(GetProfilerTicks() - Start) / Iterations;
+	Result.Bytes = Length;
+
+	Start = GetProfilerTicks();
+	for(size_t i = 0; i < Iterations; ++i)
+	{
+		//Decoding is in place, so every pass starts from a fresh copy the way the RX buffer would be filled
+		memcpy(RxFrame, Frame, Length - 1);
+		LinkFrameView_t View;
+		Result.RoundTrip = Serializer.DeSerializeFrame(RxFrame, Length - 1, View) &&
+						   (View.PayloadLength == ByteCount) &&
+						   (0 == memcmp(View.Payload, Object, ByteCount));
+	}
+	Result.DecodeTicks = (double)(GetProfilerTicks() - Start) / Iterations;
+	return Result;
+}
+
+//One sound processor update: both channels of bands and max band, sent as separate frames and as one batch
+static void BenchmarkBatch(DataSerializer &Serializer)
+{
+	const LinkBenchmarkCase_t Burst[] =
+	{
+		{ "R_Bands",        DataType_Float_t,              32 },
+		{ "L_Bands",        DataType_Float_t,              32 },
+		{ "R_Max_Band",     DataType_MaxBandSoundData_t,   1 },
+		{ "L_Max_Band",     DataType_MaxBandSoundData_t,   1 },
+	};
+	LinkTxBatcher<960, 32> Batcher;
+	uint8_t Frame[LINK_FRAME_MAX_ENCODED_SIZE(960)];
+	std::vector<uint8_t> Object(1024, 0x5A);
+	size_t SeparateBytes = 0;
+	for(const LinkBenchmarkCase_t &Case : Burst)
+	{
+		SeparateBytes += Serializer.SerializeDataItemToFrame(Case.Name, Case.DataType, Object.data(), Case.Count, 1, 0, Frame, sizeof(Frame));
+		Batcher.Stage(GetLinkItemId(Case.Name), Case.DataType, Object.data(), Serializer.GetSizeOfDataType(Case.DataType) * Case.Count, Case.Count, 1);
+	}
+	const size_t BatchBytes = Batcher.Flush(0, Frame, sizeof(Frame));
+	printf("\nBurst of %zu items: %zu bytes in %zu frames, %zu bytes in 1 batch frame\n", sizeof(Burst) / sizeof(Burst[0]), SeparateBytes, sizeof(Burst) / sizeof(Burst[0]), BatchBytes);
+}
+
+int main(int argc, char** argv)
+{
+	const size_t Iterations = (argc > 1) ? strtoul(argv[1], nullptr, 10) : LINK_BENCHMARK_DEFAULT_ITERATIONS;
+	const LinkBenchmarkCase_t Cases[] =
+	{
+		{ "Amp_Gain",       DataType_Float_t,              1 },
+		{ "Bool_Value",     DataType_Bool_t,               1 },
+		{ "R_Max_Band",     DataType_MaxBandSoundData_t,   1 },
+		{ "R_Peaks",        DataType_SpectralPeak_t,       4 },
+		{ "R_Bands_8",      DataType_Float_t,              8 },
+		{ "R_Bands",        DataType_Float_t,              32 },
+		{ "R_Bands_64",     DataType_Float_t,              64 },
+		{ "Stage_Profile",  DataType_StageProfile_t,       AudioPipelineStage_Count },
+	};
+
+	DataSerializer Serializer;
+	printf("%zu iterations, times in %s per message\n", Iterations, GetProfilerTicksUnit());
+	printf("%-14s %6s | %10s %10s %10s | %10s %10s %10s | %6s\n", "Item", "Raw", "JSON Bytes", "Encode", "Decode", "Frame Bytes", "Encode", "Decode", "Ratio");
+	for(const LinkBenchmarkCase_t &Case : Cases)
+	{
+		const size_t ByteCount = Serializer.GetSizeOfDataType(Case.DataType) * Case.Count;
+		std::vector<uint8_t> Object(ByteCount);
+		for(size_t i = 0; i < ByteCount; ++i)
+		{
+			Object[i] = static_cast<uint8_t>((i * 37) + 11);
+		}
+		if(DataType_Bool_t == Case.DataType) Object[0] = 1;
+		const LinkBenchmarkResult_t Json = BenchmarkJson(Serializer, Case, Object.data(), Iterations);
+		const LinkBenchmarkResult_t Frame = BenchmarkFrame(Serializer, Case, Object.data(), Iterations);
+		printf( "%-14s %6zu | %10zu %10.0f %10.0f | %11zu %10.0f %10.0f | %5.1fx%s\n"
+			  , Case.Name
+			  , ByteCount
+			  , Json.Bytes, Json.EncodeTicks, Json.DecodeTicks
+			  , Frame.Bytes, Frame.EncodeTicks, Frame.DecodeTicks
+			  , (double)Json.Bytes / (double)Frame.Bytes
+			  , (Json.RoundTrip && Frame.RoundTrip) ? "" : "  ROUND TRIP FAILED" );
+	}
+	BenchmarkBatch(Serializer);
+	return 0;
+}
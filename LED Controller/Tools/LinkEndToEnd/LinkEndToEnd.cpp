@@ -0,0 +1,248 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//End to end benchmark of the inter CPU link on the host. Two SerialPortMessageManagers run their RX and TX tasks
+//over an in-memory loopback, or over a pseudo terminal between two processes. The initiator streams float arrays
+//as fast as the link takes them and pings the responder, which echoes every ping straight back. Reports the arrays
+//delivered per second and the ping round trip percentiles.
+//
+//  cd Tools/LinkEndToEnd && pio run
+//  .pio/build/native/program loopback [seconds]
+//  .pio/build/native/program pty [seconds]         Starts the responder as a second process on a new pty
+
+#include <Arduino.h>
+#include <DataSerializer.h>
+#include <LoopbackTransport.h>
+#include <PtyTransport.h>
+#include <SerialMessageManager.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <signal.h>
+#include <sys/wait.h>
+#include <vector>
+
+#define LINK_END_TO_END_DEFAULT_SECONDS 5
+#define LINK_END_TO_END_BAND_COUNT 32
+#define LINK_END_TO_END_PING_PERIOD_US 5000         //Between pings from the initiator
+#define LINK_END_TO_END_REPORT_PERIOD_MS 100        //Between delivered counts from the responder
+#define LINK_END_TO_END_CONNECT_TIMEOUT_MS 5000     //Most the initiator waits for the first pong
+#define LINK_END_TO_END_SETTLE_MS 500               //Time after the last array for the final delivered count
+
+//Hands every value of one item to a function, on the manager's RX task
+class LinkEndToEndCallee : public Named_Object_Callee_Interface
+{
+	public:
+		typedef std::function<void(const void* Object, size_t ChangeCount)> Handler_t;
+		LinkEndToEndCallee(const char* Name, size_t Count, Handler_t Handler)
+						  : Named_Object_Callee_Interface(Count)
+						  , m_Name(Name)
+						  , m_Handler(Handler)
+		{
+		}
+		virtual ~LinkEndToEndCallee(){}
+		UpdateStatus_t New_Object_From_Sender(const Named_Object_Caller_Interface* Sender, const void* Object, const size_t ChangeCount) override
+		{
+			m_Handler(Object, ChangeCount);
+			return UpdateStatus_t();
+		}
+		String GetName() const override { return m_Name; }
+	private:
+		String m_Name;
+		Handler_t m_Handler;
+};
+
+//Echoes pings and reports how many arrays arrived until Running is cleared or Seconds have passed
+static void RunResponder(ITransport &Transport, const std::atomic<bool> &Running, uint32_t Seconds)
+{
+	LinkTxItem_t Pong;
+	Pong.QoS = LinkQoS_MustDeliver;
+	Pong.Lane = LinkTxLane_RealTime;
+	std::atomic<uint32_t> Received = {0};
+	SerialPortMessageManager* pManager = nullptr;
+	LinkEndToEndCallee Bands("E2E_Bands", LINK_END_TO_END_BAND_COUNT, [&](const void*, size_t){ Received.fetch_add(1, std::memory_order_relaxed); });
+	LinkEndToEndCallee Ping("E2E_Ping", 1, [&](const void* Object, size_t ChangeCount)
+	{
+		uint32_t Value = *static_cast<const uint32_t*>(Object);
+		pManager->QueueMessageFromDataType("E2E_Pong", DataType_Uint32_t, &Value, 1, ChangeCount);
+	});
+	//Declared after the items it uses, so its tasks have stopped before they go
+	DataSerializer Serializer;
+	SerialPortMessageManager Manager("Responder", &Transport, &Serializer);
+	pManager = &Manager;
+	Manager.RegisterTxItem(GetLinkItemId("E2E_Pong"), &Pong);
+	Manager.RegisterForNewRxValueNotification(&Bands);
+	Manager.RegisterForNewRxValueNotification(&Ping);
+	Manager.Setup();
+
+	const unsigned long Start = millis();
+	for(uint32_t Reports = 1; Running && millis() - Start < Seconds * 1000UL; ++Reports)
+	{
+		delay(LINK_END_TO_END_REPORT_PERIOD_MS);
+		uint32_t Value = Received.load(std::memory_order_relaxed);
+		Manager.QueueMessageFromDataType("E2E_Received", DataType_Uint32_t, &Value, 1, Reports);
+	}
+}
+
+static uint32_t Percentile(const std::vector<uint32_t> &Sorted, double Fraction)
+{
+	if(Sorted.empty()) return 0;
+	return Sorted[std::min(Sorted.size() - 1, static_cast<size_t>(Fraction * Sorted.size()))];
+}
+
+//Streams arrays and pings for Seconds, then prints what the responder received
+static int RunInitiator(ITransport &Transport, const char* TransportName, uint32_t Seconds)
+{
+	LinkTxItem_t BandsItem;
+	BandsItem.QoS = LinkQoS_MustDeliver;
+	LinkTxItem_t PingItem;
+	PingItem.QoS = LinkQoS_MustDeliver;
+	PingItem.Lane = LinkTxLane_RealTime;
+	std::mutex SamplesMutex;
+	std::vector<uint32_t> RoundTrips;
+	std::atomic<uint32_t> Delivered = {0};
+	LinkEndToEndCallee Pong("E2E_Pong", 1, [&](const void* Object, size_t)
+	{
+		const uint32_t RoundTripUs = micros() - *static_cast<const uint32_t*>(Object);
+		std::lock_guard<std::mutex> Lock(SamplesMutex);
+		RoundTrips.push_back(RoundTripUs);
+	});
+	LinkEndToEndCallee Received("E2E_Received", 1, [&](const void* Object, size_t){ Delivered.store(*static_cast<const uint32_t*>(Object)); });
+	DataSerializer Serializer;
+	SerialPortMessageManager Manager("Initiator", &Transport, &Serializer);
+	Manager.RegisterTxItem(GetLinkItemId("E2E_Bands"), &BandsItem);
+	Manager.RegisterTxItem(GetLinkItemId("E2E_Ping"), &PingItem);
+	Manager.RegisterForNewRxValueNotification(&Pong);
+	Manager.RegisterForNewRxValueNotification(&Received);
+	Manager.Setup();
+
+	//The responder may still be starting, so keep pinging until it answers
+	size_t Pings = 0;
+	bool Connected = false;
+	const unsigned long ConnectStart = millis();
+	while(!Connected && millis() - ConnectStart < LINK_END_TO_END_CONNECT_TIMEOUT_MS)
+	{
+		uint32_t Now = micros();
+		Manager.QueueMessageFromDataType("E2E_Ping", DataType_Uint32_t, &Now, 1, ++Pings);
+		delay(10);
+		std::lock_guard<std::mutex> Lock(SamplesMutex);
+		Connected = !RoundTrips.empty();
+		RoundTrips.clear();
+	}
+	if(!Connected)
+	{
+		fprintf(stderr, "No answer from the responder over %s\n", TransportName);
+		return 1;
+	}
+
+	float Bands[LINK_END_TO_END_BAND_COUNT];
+	for(size_t i = 0; i < LINK_END_TO_END_BAND_COUNT; ++i) Bands[i] = 0.01f * i;
+	size_t Sent = 0;
+	size_t Refused = 0;
+	const uint32_t StartDelivered = Delivered.load();
+	const LinkTxStats_t StartStats = Manager.GetTxStats();
+	const uint32_t Start = micros();
+	uint32_t LastPing = Start;
+	while(micros() - Start < Seconds * 1000000UL)
+	{
+		Bands[Sent % LINK_END_TO_END_BAND_COUNT] += 1.0f;
+		if(Manager.QueueMessageFromDataType("E2E_Bands", DataType_Float_t, Bands, LINK_END_TO_END_BAND_COUNT, Sent + 1)) ++Sent;
+		else ++Refused;
+		uint32_t Now = micros();
+		if(Now - LastPing >= LINK_END_TO_END_PING_PERIOD_US)
+		{
+			Manager.QueueMessageFromDataType("E2E_Ping", DataType_Uint32_t, &Now, 1, ++Pings);
+			LastPing = Now;
+		}
+	}
+	const double ElapsedSeconds = (micros() - Start) / 1000000.0;
+	delay(LINK_END_TO_END_SETTLE_MS);
+	const LinkTxStats_t EndStats = Manager.GetTxStats();
+	const uint32_t Arrived = Delivered.load() - StartDelivered;
+
+	std::vector<uint32_t> Sorted;
+	{
+		std::lock_guard<std::mutex> Lock(SamplesMutex);
+		Sorted = RoundTrips;
+	}
+	std::sort(Sorted.begin(), Sorted.end());
+	printf("Transport %s, %.1f s, arrays of %i floats\n", TransportName, ElapsedSeconds, LINK_END_TO_END_BAND_COUNT);
+	printf("Arrays:  %zu sent, %zu refused, %u delivered, %.0f per second\n", Sent, Refused, Arrived, Arrived / ElapsedSeconds);
+	printf("Link:    %u frames, %.0f bytes per second\n", EndStats.Frames - StartStats.Frames, (EndStats.Bytes - StartStats.Bytes) / ElapsedSeconds);
+	printf( "Ping round trip us: %zu samples, p50 %u, p90 %u, p99 %u, max %u\n"
+		  , Sorted.size()
+		  , Percentile(Sorted, 0.50), Percentile(Sorted, 0.90), Percentile(Sorted, 0.99)
+		  , Sorted.empty() ? 0 : Sorted.back() );
+	return 0;
+}
+
+static int RunLoopback(uint32_t Seconds)
+{
+	LoopbackTransport InitiatorEnd;
+	LoopbackTransport ResponderEnd;
+	LoopbackTransport::Connect(InitiatorEnd, ResponderEnd);
+	std::atomic<bool> Running = {true};
+	std::thread Responder([&]{ RunResponder(ResponderEnd, Running, Seconds * 2); });
+	const int Result = RunInitiator(InitiatorEnd, "loopback", Seconds);
+	Running = false;
+	Responder.join();
+	return Result;
+}
+
+static int RunPty(const char* Program, uint32_t Seconds)
+{
+	PtyTransport Master;
+	if(!Master.Open()) return 1;
+	const std::string PeerPath = Master.GetPeerPath();
+	const std::string PeerSeconds = std::to_string(Seconds * 2);
+	const pid_t Peer = fork();
+	if(Peer < 0)
+	{
+		perror("fork");
+		return 1;
+	}
+	if(0 == Peer)
+	{
+		execl("/proc/self/exe", Program, "pty-peer", PeerPath.c_str(), PeerSeconds.c_str(), (char*)nullptr);
+		_exit(127);
+	}
+	const int Result = RunInitiator(Master, PeerPath.c_str(), Seconds);
+	kill(Peer, SIGTERM);
+	waitpid(Peer, nullptr, 0);
+	return Result;
+}
+
+static int RunPtyPeer(const char* Path, uint32_t Seconds)
+{
+	PtyTransport Slave;
+	if(!Slave.Open(Path)) return 1;
+	const std::atomic<bool> Running = {true};
+	RunResponder(Slave, Running, Seconds);
+	return 0;
+}
+
+int main(int argc, char** argv)
+{
+	const String Mode = (argc > 1) ? argv[1] : "loopback";
+	if(Mode == "pty-peer" && argc > 3) return RunPtyPeer(argv[2], strtoul(argv[3], nullptr, 10));
+	const uint32_t Seconds = (argc > 2) ? strtoul(argv[2], nullptr, 10) : LINK_END_TO_END_DEFAULT_SECONDS;
+	if(Mode == "loopback") return RunLoopback(Seconds);
+	if(Mode == "pty") return RunPty(argv[0], Seconds);
+	fprintf(stderr, "Usage: %s loopback|pty [seconds]\n", argv[0]);
+	return 1;
+}
@@ -0,0 +1,113 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//Fuzz harness for link frame decoding: COBS, the CRC, header validation, batch records, timestamps, schema entries
+//and the float codec. The input goes through twice. As raw line bytes it exercises the framing, where almost every
+//mutation fails the CRC. As a header and payload sealed into a valid frame it reaches the checks behind the CRC,
+//which see whatever a corrupt or mismatched peer sends.
+//
+//  cd Tools/LinkFuzz && pio run -e frame
+//  clang++ -std=gnu++17 -g -O1 -fsanitize=fuzzer,address,undefined -DLINK_FUZZ_LIBFUZZER -DHOST_LOG_LEVEL=0 \
+//      -I../Host -I../../Libraries/CommonClasses/src -I../../Libraries/Arduino_JSON/src -I../../Libraries/Streaming/src \
+//      FuzzLinkFrame.cpp ../../Libraries/Arduino_JSON/src/*.cpp ../../Libraries/Arduino_JSON/src/cjson/*.c -o fuzz_frame
+
+#include <Arduino.h>
+#include <DataSerializer.h>
+#include <LinkFrameReceiver.h>
+#include <LinkSchema.h>
+#include <vector>
+
+#define LINK_FUZZ_MAX_FRAME_SIZE 1000     //MaxMessageLength of the manager
+
+//Reads every payload byte so the sanitizer sees any view that reaches past its frame
+static volatile uint8_t g_Sink;
+static void Touch(const uint8_t* Data, size_t Length)
+{
+	uint8_t Sum = 0;
+	for(size_t i = 0; i < Length; ++i) Sum += Data[i];
+	g_Sink = Sum;
+}
+
+static void CheckValue(const LinkFrameView_t &View)
+{
+	Touch(View.Payload, View.PayloadLength);
+	if(View.Header.DataType & LINK_DATATYPE_FLAG_ENCODED)
+	{
+		FixedLinkFloatDecoder<LINK_CODEC_MAX_COUNT> Decoder;
+		float Values[LINK_CODEC_MAX_COUNT];
+		Decoder.Decode(View.Payload, View.PayloadLength, Values, std::min<size_t>(View.Header.Count, LINK_CODEC_MAX_COUNT));
+	}
+}
+
+static void CheckFrame(DataSerializer &Serializer, LinkFrameView_t View)
+{
+	if(View.Header.Flags & LINK_FRAME_FLAG_SCHEMA)
+	{
+		LinkSchemaEntry_t Entry;
+		for(size_t Offset = 0; Offset + sizeof(Entry) <= View.PayloadLength; Offset += sizeof(Entry))
+		{
+			memcpy(&Entry, View.Payload + Offset, sizeof(Entry));
+			CheckLinkSchemaEntry(Entry, DataType_Float_t, 32, true);
+		}
+		return;
+	}
+	uint32_t TimestampUs;
+	if((View.Header.Flags & LINK_FRAME_FLAG_TIMESTAMP) && !TakeLinkFrameTimestamp(View, TimestampUs)) return;
+	if(View.Header.Flags & LINK_FRAME_FLAG_BATCH)
+	{
+		size_t Offset = 0;
+		LinkFrameView_t Record;
+		while(Serializer.GetNextBatchRecord(View, Offset, Record)) CheckValue(Record);
+	}
+	else if(Serializer.ValidateFrame(View))
+	{
+		CheckValue(View);
+	}
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* Data, size_t Size)
+{
+	DataSerializer Serializer;
+
+	//Raw line bytes
+	LinkFrameReceiver<LINK_FUZZ_MAX_FRAME_SIZE> Receiver;
+	for(size_t i = 0; i < Size; ++i)
+	{
+		if(Receiver.Push(Data[i])) CheckFrame(Serializer, Receiver.GetFrame());
+	}
+	//The whole input as the bytes of one frame before its delimiter, decoded in place by DeSerializeFrame
+	std::vector<uint8_t> Frame(Data, Data + Size);
+	LinkFrameView_t View;
+	if(Serializer.DeSerializeFrame(Frame.data(), Frame.size(), View)) CheckFrame(Serializer, View);
+
+	//Header and payload sealed into a frame that passes the CRC
+	LinkFrameHeader_t Header;
+	if(Size < sizeof(Header) || Size - sizeof(Header) > LINK_FUZZ_MAX_FRAME_SIZE) return 0;
+	memcpy(&Header, Data, sizeof(Header));
+	std::vector<uint8_t> Encoded(LINK_FRAME_MAX_ENCODED_SIZE(Size - sizeof(Header)));
+	const size_t Length = EncodeLinkFrame(Header, Data + sizeof(Header), Size - sizeof(Header), Encoded.data(), Encoded.size());
+	if(0 == Length) return 0;
+	LinkFrameReceiver<LINK_FUZZ_MAX_FRAME_SIZE + sizeof(LinkFrameHeader_t) + LINK_FRAME_CRC_SIZE> SealedReceiver;
+	for(size_t i = 0; i < Length; ++i)
+	{
+		if(SealedReceiver.Push(Encoded[i])) CheckFrame(Serializer, SealedReceiver.GetFrame());
+	}
+	return 0;
+}
+
+#include "LinkFuzzMain.h"
@@ -0,0 +1,42 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//Fuzz harness for the JSON-hex DataSerializer messages, the link format before binary frames. The input is
+//taken as one message string.
+//
+//  cd Tools/LinkFuzz && pio run -e json
+//  clang++ -std=gnu++17 -g -O1 -fsanitize=fuzzer,address,undefined -DLINK_FUZZ_LIBFUZZER -DHOST_LOG_LEVEL=0 \
+//      -I../Host -I../../Libraries/CommonClasses/src -I../../Libraries/Arduino_JSON/src -I../../Libraries/Streaming/src \
+//      FuzzLinkJson.cpp ../../Libraries/Arduino_JSON/src/*.cpp ../../Libraries/Arduino_JSON/src/cjson/*.c -o fuzz_json
+
+#include <Arduino.h>
+#include <DataSerializer.h>
+#include <string>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* Data, size_t Size)
+{
+	static DataSerializer Serializer;
+	const std::string Json(reinterpret_cast<const char*>(Data), Size);
+	//Frees the object it is given on the way out
+	NamedObject_t NamedObject;
+	NamedObject.Object = nullptr;
+	Serializer.DeSerializeJsonToNamedObject(String(Json.c_str()), NamedObject);
+	return 0;
+}
+
+#include "LinkFuzzMain.h"
@@ -0,0 +1,129 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//Fuzz harness for the RX path of SerialPortMessageManager: transport reads, framing, clock and schema frames,
+//batches, sequence tracking and delivery to registered items. The input is a list of chunks, each starting with a
+//control byte:
+//
+//  0x80 | n      n + 1 raw line bytes follow
+//  otherwise     a uint16_t length and that many bytes follow, a header and payload sealed into a valid frame
+//
+//so the fuzzer can both corrupt the line and reach everything behind the CRC. No tasks are started, the harness
+//writes each chunk to a loopback transport and runs the RX service on it.
+//
+//  cd Tools/LinkFuzz && pio run -e manager
+//  clang++ -std=gnu++17 -g -O1 -fsanitize=fuzzer,address,undefined -DLINK_FUZZ_LIBFUZZER -DHOST_LOG_LEVEL=0 \
+//      -I../Host -I../../Libraries/CommonClasses/src -I../../Libraries/Arduino_JSON/src -I../../Libraries/Streaming/src \
+//      FuzzLinkManager.cpp ../../Libraries/CommonClasses/src/SerialMessageManager.cpp \
+//      ../../Libraries/Arduino_JSON/src/*.cpp ../../Libraries/Arduino_JSON/src/cjson/*.c -lpthread -o fuzz_manager
+
+#include <Arduino.h>
+#include <DataSerializer.h>
+#include <LoopbackTransport.h>
+#include <SerialMessageManager.h>
+#include <vector>
+
+#define LINK_FUZZ_RAW_CHUNK 0x80
+
+static volatile uint8_t g_Sink;
+
+//Receiving end of one item that reads every byte it is handed
+class LinkFuzzCallee : public Named_Object_Callee_Interface
+					 , public DataTypeFunctions
+{
+	public:
+		LinkFuzzCallee(const char* Name, DataType_t DataType, size_t Count, LinkFloatDecoder* Decoder = nullptr)
+					  : Named_Object_Callee_Interface(Count)
+					  , m_Name(Name)
+					  , m_DataType(DataType)
+					  , mp_Decoder(Decoder)
+		{
+		}
+		virtual ~LinkFuzzCallee(){}
+		UpdateStatus_t New_Object_From_Sender(const Named_Object_Caller_Interface* Sender, const void* Object, const size_t ChangeCount) override
+		{
+			const uint8_t* Bytes = static_cast<const uint8_t*>(Object);
+			uint8_t Sum = 0;
+			for(size_t i = 0; i < GetSizeOfDataType(m_DataType) * GetCount(); ++i) Sum += Bytes[i];
+			g_Sink = Sum;
+			uint32_t CaptureUs;
+			Sender->GetRxCaptureTime(CaptureUs);
+			return UpdateStatus_t();
+		}
+		String GetName() const override { return m_Name; }
+		DataType_t GetDataType() override { return m_DataType; }
+		LinkFloatDecoder* GetLinkDecoder() override { return mp_Decoder; }
+	private:
+		String m_Name;
+		DataType_t m_DataType;
+		LinkFloatDecoder* mp_Decoder;
+};
+
+class LinkFuzzManager : public SerialPortMessageManager
+{
+	public:
+		LinkFuzzManager(ITransport* Transport, DataSerializer* Serializer): SerialPortMessageManager("Fuzz", Transport, Serializer){}
+		using SerialPortMessageManager::ServiceRx;
+};
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* Data, size_t Size)
+{
+	LoopbackTransport Line;
+	LoopbackTransport Target;
+	LoopbackTransport::Connect(Line, Target);
+	DataSerializer Serializer;
+	FixedLinkFloatDecoder<32> BandsDecoder;
+	LinkFuzzCallee Bands("R_Bands", DataType_Float_t, 32, &BandsDecoder);
+	LinkFuzzCallee MaxBand("R_Max_Band", DataType_MaxBandSoundData_t, 1);
+	LinkFuzzCallee Gain("Amp_Gain", DataType_Float_t, 1);
+	LinkFuzzCallee Peaks("R_Peaks", DataType_SpectralPeak_t, 4);
+	LinkFuzzManager Manager(&Target, &Serializer);
+	for(LinkFuzzCallee* Callee : { &Bands, &MaxBand, &Gain, &Peaks }) Manager.RegisterForNewRxValueNotification(Callee);
+
+	std::vector<uint8_t> Encoded;
+	size_t Offset = 0;
+	while(Offset < Size)
+	{
+		const uint8_t Control = Data[Offset++];
+		if(Control & LINK_FUZZ_RAW_CHUNK)
+		{
+			const size_t Length = std::min<size_t>((Control & ~LINK_FUZZ_RAW_CHUNK) + 1, Size - Offset);
+			Line.Write(Data + Offset, Length);
+			Offset += Length;
+		}
+		else
+		{
+			uint16_t Length = 0;
+			if(Offset + sizeof(Length) > Size) break;
+			memcpy(&Length, Data + Offset, sizeof(Length));
+			Offset += sizeof(Length);
+			Length = std::min<size_t>(Length, Size - Offset);
+			LinkFrameHeader_t Header;
+			if(Length < sizeof(Header)) break;
+			memcpy(&Header, Data + Offset, sizeof(Header));
+			Encoded.resize(LINK_FRAME_MAX_ENCODED_SIZE(Length));
+			Line.Write(Encoded.data(), EncodeLinkFrame(Header, Data + Offset + sizeof(Header), Length - sizeof(Header), Encoded.data(), Encoded.size()));
+			Offset += Length;
+		}
+		Manager.ServiceRx();
+	}
+	Manager.GetRxStats();
+	return 0;
+}
+
+#include "LinkFuzzMain.h"
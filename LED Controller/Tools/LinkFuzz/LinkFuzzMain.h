@@ -0,0 +1,61 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+//Driver shared by the link fuzz harnesses. Each harness defines LLVMFuzzerTestOneInput and includes this file last.
+//Built with -DLINK_FUZZ_LIBFUZZER, libFuzzer supplies main. Otherwise main runs every file named on the command
+//line, or stdin when there are none, through the harness once, which is how AFL and a saved crash are run. Any
+//starting inputs will do as seeds, link captures downloaded from CPU3 among them:
+//
+//  afl-fuzz -i seeds -o findings -- .pio/build/frame/program @@
+//  .pio/build/frame/program crash-0123abcd
+
+#include <cstdint>
+#include <cstddef>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* Data, size_t Size);
+
+#if !defined(LINK_FUZZ_LIBFUZZER)
+int main(int argc, char** argv)
+{
+	std::vector<uint8_t> Input;
+	if(argc < 2)
+	{
+		Input.assign(std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>());
+		LLVMFuzzerTestOneInput(Input.data(), Input.size());
+		return 0;
+	}
+	for(int i = 1; i < argc; ++i)
+	{
+		std::ifstream File(argv[i], std::ios::binary);
+		if(!File)
+		{
+			fprintf(stderr, "Unable to open \"%s\"\n", argv[i]);
+			return 1;
+		}
+		Input.assign(std::istreambuf_iterator<char>(File), std::istreambuf_iterator<char>());
+		LLVMFuzzerTestOneInput(Input.data(), Input.size());
+	}
+	return 0;
+}
+#endif
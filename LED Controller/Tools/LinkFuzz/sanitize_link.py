@@ -0,0 +1,4 @@
+# Links the harnesses against the sanitizer runtimes. PlatformIO only hands -fsanitize in build_flags to the compiler.
+Import("env")
+
+env.Append(LINKFLAGS=["-fsanitize=address,undefined"])
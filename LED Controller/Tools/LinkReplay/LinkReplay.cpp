@@ -0,0 +1,254 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//Replays a link capture, downloaded from CPU3's /link_capture/cpu1 or /link_capture/cpu2, into a host
+//SerialPortMessageManager running its RX and TX tasks. The bytes go in at the pace they were captured, or faster,
+//and every value is decoded and counted by item, so the parser and dispatch can be profiled against field traffic.
+//
+//A capture holds both directions as seen by CPU3. rx replays what CPU3 received, tx what it sent, which is what the
+//CPU at the other end received.
+//
+//  cd Tools/LinkReplay && pio run
+//  .pio/build/native/program cpu1.ltcap [--direction rx|tx] [--speed 4] [--names names.txt]
+
+#include <Arduino.h>
+#include <DataSerializer.h>
+#include <LinkCapture.h>
+#include <LoopbackTransport.h>
+#include <SerialMessageManager.h>
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#define LINK_REPLAY_SETTLE_MS 200      //Time after the last record for the RX task to finish
+#define LINK_REPLAY_TOP_ITEMS 20       //Items listed in the report, busiest first
+
+struct LinkReplayOptions_t
+{
+	const char* InputPath = nullptr;
+	const char* NamesPath = nullptr;
+	LinkCaptureDirection_t Direction = LinkCaptureDirection_Rx;
+	double Speed = 1.0;                //0 replays as fast as the manager takes the bytes
+	uint32_t Loops = 1;
+};
+
+struct LinkReplayItem_t
+{
+	uint32_t Values = 0;
+	uint32_t Encoded = 0;
+	uint32_t DecodeFailures = 0;
+	size_t Count = 0;
+};
+
+static void PrintUsage(const char* Program)
+{
+	fprintf( stderr
+		   , "Usage: %s <capture.ltcap> [options]\n"
+			 "  --direction rx|tx    Direction to replay (default rx)\n"
+			 "  --speed <factor>     Replay speed, 0 for as fast as possible (default 1)\n"
+			 "  --loops <count>      Replay the capture this many times (default 1)\n"
+			 "  --names <path>       Item names, one per line, to label the report\n"
+		   , Program );
+}
+
+static bool ParseOptions(int argc, char** argv, LinkReplayOptions_t &Options)
+{
+	for(int i = 1; i < argc; ++i)
+	{
+		const char* Arg = argv[i];
+		const bool HasValue = (i + 1 < argc);
+		if(0 == strcmp(Arg, "--speed") && HasValue) Options.Speed = atof(argv[++i]);
+		else if(0 == strcmp(Arg, "--loops") && HasValue) Options.Loops = std::max(1, atoi(argv[++i]));
+		else if(0 == strcmp(Arg, "--names") && HasValue) Options.NamesPath = argv[++i];
+		else if(0 == strcmp(Arg, "--direction") && HasValue)
+		{
+			const char* Value = argv[++i];
+			if(0 == strcmp(Value, "rx")) Options.Direction = LinkCaptureDirection_Rx;
+			else if(0 == strcmp(Value, "tx")) Options.Direction = LinkCaptureDirection_Tx;
+			else return false;
+		}
+		else if('-' != Arg[0] && !Options.InputPath) Options.InputPath = Arg;
+		else return false;
+	}
+	return (nullptr != Options.InputPath) && Options.Speed >= 0.0;
+}
+
+//Takes every value the manager dispatches in place of the DataItems, and decodes coded ones the way they would
+class LinkReplayManager: public SerialPortMessageManager
+{
+	public:
+		LinkReplayManager(ITransport* Transport, DataSerializer* Serializer)
+						 : SerialPortMessageManager("Replay", Transport, Serializer)
+		{
+		}
+		virtual ~LinkReplayManager(){}
+		std::map<uint16_t, LinkReplayItem_t> GetItems()
+		{
+			std::lock_guard<std::mutex> Lock(m_Mutex);
+			return m_Items;
+		}
+	protected:
+		void Call_Item_Id_Callback(uint16_t ItemId, void* Object, const size_t Count, const size_t ChangeCount) override
+		{
+			std::lock_guard<std::mutex> Lock(m_Mutex);
+			LinkReplayItem_t &Item = m_Items[ItemId];
+			++Item.Values;
+			Item.Count = Count;
+		}
+		void Call_Item_Id_Encoded_Callback(uint16_t ItemId, const uint8_t* Payload, size_t Length, const size_t Count, const size_t ChangeCount) override
+		{
+			std::unique_ptr<FixedLinkFloatDecoder<LINK_CODEC_MAX_COUNT>> &Decoder = m_Decoders[ItemId];
+			if(!Decoder) Decoder.reset(new FixedLinkFloatDecoder<LINK_CODEC_MAX_COUNT>());
+			float Values[LINK_CODEC_MAX_COUNT];
+			const bool Decoded = Decoder->Decode(Payload, Length, Values, Count);
+			std::lock_guard<std::mutex> Lock(m_Mutex);
+			LinkReplayItem_t &Item = m_Items[ItemId];
+			++Item.Values;
+			++Item.Encoded;
+			if(!Decoded) ++Item.DecodeFailures;
+			Item.Count = Count;
+		}
+	private:
+		std::mutex m_Mutex;
+		std::map<uint16_t, LinkReplayItem_t> m_Items;
+		std::map<uint16_t, std::unique_ptr<FixedLinkFloatDecoder<LINK_CODEC_MAX_COUNT>>> m_Decoders;
+};
+
+static bool ReadFile(const char* Path, std::vector<uint8_t> &Data)
+{
+	std::ifstream File(Path, std::ios::binary);
+	if(!File)
+	{
+		ESP_LOGE("LinkReplay", "ERROR! Unable to open \"%s\"", Path);
+		return false;
+	}
+	Data.assign(std::istreambuf_iterator<char>(File), std::istreambuf_iterator<char>());
+	return true;
+}
+
+static std::map<uint16_t, String> ReadNames(const char* Path)
+{
+	std::map<uint16_t, String> Names;
+	std::ifstream File(Path);
+	std::string Line;
+	while(std::getline(File, Line))
+	{
+		Line.erase(std::remove_if(Line.begin(), Line.end(), [](char c){ return isspace(static_cast<unsigned char>(c)); }), Line.end());
+		if(!Line.empty() && '#' != Line[0]) Names[GetLinkItemId(Line.c_str())] = Line.c_str();
+	}
+	return Names;
+}
+
+static void PrintReport( LinkReplayManager &Manager, const std::map<uint16_t, String> &Names
+					   , size_t Records, size_t Bytes, double CaptureSeconds, double ReplaySeconds, size_t Overflows )
+{
+	const LinkRxStats_t Stats = Manager.GetRxStats();
+	printf("Replayed: %zu records, %zu bytes, %.3f s of capture in %.3f s (%.1fx)\n", Records, Bytes, CaptureSeconds, ReplaySeconds, ReplaySeconds > 0.0 ? CaptureSeconds / ReplaySeconds : 0.0);
+	printf("Throughput: %.0f bytes/s, %.0f frames/s\n", Stats.Bytes / ReplaySeconds, Stats.Frames / ReplaySeconds);
+	printf( "RX: %u frames, CRC Errors: %u, Framing Errors: %u, Overruns: %u, Replay Overflows: %zu\n"
+		  , Stats.Frames, Stats.CrcErrors, Stats.FramingErrors, Stats.Overruns, Overflows );
+	printf( "Schema: %s, %u mismatches. Clock: %s\n"
+		  , Manager.IsSchemaVerified() ? "received" : "not in the capture", Manager.GetSchemaMismatchCount()
+		  , Manager.IsClockSynchronized() ? "synchronized" : "not synchronized" );
+
+	std::vector<std::pair<uint16_t, LinkReplayItem_t>> Items;
+	for(const auto &Item : Manager.GetItems()) Items.push_back(Item);
+	std::sort(Items.begin(), Items.end(), [](const std::pair<uint16_t, LinkReplayItem_t> &a, const std::pair<uint16_t, LinkReplayItem_t> &b){ return a.second.Values > b.second.Values; });
+	printf("%-32s %6s %10s %10s %8s %8s\n", "Item", "Count", "Values", "Values/s", "Encoded", "Failed");
+	for(size_t i = 0; i < Items.size() && i < LINK_REPLAY_TOP_ITEMS; ++i)
+	{
+		const auto Name = Names.find(Items[i].first);
+		char Id[8];
+		snprintf(Id, sizeof(Id), "%04X", Items[i].first);
+		const LinkReplayItem_t &Item = Items[i].second;
+		printf( "%-32s %6zu %10u %10.1f %8u %8u\n"
+			  , (Names.end() != Name) ? Name->second.c_str() : Id
+			  , Item.Count, Item.Values, Item.Values / ReplaySeconds, Item.Encoded, Item.DecodeFailures );
+	}
+	if(Items.size() > LINK_REPLAY_TOP_ITEMS) printf("... %zu more items\n", Items.size() - LINK_REPLAY_TOP_ITEMS);
+}
+
+int main(int argc, char** argv)
+{
+	LinkReplayOptions_t Options;
+	if(!ParseOptions(argc, argv, Options))
+	{
+		PrintUsage(argv[0]);
+		return 1;
+	}
+	std::vector<uint8_t> Capture;
+	if(!ReadFile(Options.InputPath, Capture)) return 1;
+	LinkCaptureFileHeader_t Header;
+	if(Capture.size() < sizeof(Header)) Header.Magic = 0;
+	else memcpy(&Header, Capture.data(), sizeof(Header));
+	if(LINK_CAPTURE_MAGIC != Header.Magic || LINK_CAPTURE_VERSION != Header.Version)
+	{
+		ESP_LOGE("LinkReplay", "ERROR! \"%s\" is not a version %u link capture", Options.InputPath, LINK_CAPTURE_VERSION);
+		return 1;
+	}
+	if(Header.Overwritten || Header.Skipped)
+	{
+		ESP_LOGW("LinkReplay", "WARNING! Capture starts after %u overwritten records and is missing %u skipped ones", Header.Overwritten, Header.Skipped);
+	}
+	const std::map<uint16_t, String> Names = Options.NamesPath ? ReadNames(Options.NamesPath) : std::map<uint16_t, String>();
+
+	LoopbackTransport Source;
+	LoopbackTransport Target;
+	LoopbackTransport::Connect(Source, Target);
+	DataSerializer Serializer;
+	LinkReplayManager Manager(&Target, &Serializer);
+	Manager.Setup();
+
+	size_t Records = 0;
+	size_t Bytes = 0;
+	size_t Overflows = 0;
+	uint64_t CaptureUs = 0;
+	const auto Start = std::chrono::steady_clock::now();
+	for(uint32_t Loop = 0; Loop < Options.Loops; ++Loop)
+	{
+		size_t Offset = sizeof(Header);
+		LinkCaptureRecordHeader_t Record;
+		const uint8_t* Data;
+		bool First = true;
+		uint32_t LastUs = 0;
+		while(GetNextLinkCaptureRecord(Capture.data(), Capture.size(), Offset, Record, Data))
+		{
+			if(Options.Direction != Record.Direction) continue;
+			if(!First) CaptureUs += static_cast<uint32_t>(Record.TimeUs - LastUs);
+			First = false;
+			LastUs = Record.TimeUs;
+			if(Options.Speed > 0.0)
+			{
+				std::this_thread::sleep_until(Start + std::chrono::microseconds(static_cast<uint64_t>(CaptureUs / Options.Speed)));
+			}
+			//Keeps the replay from outrunning the RX task, the way the UART's RX buffer would overflow
+			while(Target.Available() + Record.Length > LOOPBACK_TRANSPORT_BUFFER_SIZE / 2) std::this_thread::yield();
+			if(Record.Length != Source.Write(Data, Record.Length)) ++Overflows;
+			++Records;
+			Bytes += Record.Length;
+		}
+	}
+	while(Target.Available() > 0) std::this_thread::yield();
+	delay(LINK_REPLAY_SETTLE_MS);
+	const double ReplaySeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count() - LINK_REPLAY_SETTLE_MS / 1000.0;
+	PrintReport(Manager, Names, Records, Bytes, CaptureUs / 1000000.0, ReplaySeconds, Overflows);
+	return 0;
+}
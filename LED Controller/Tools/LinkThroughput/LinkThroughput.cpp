@@ -0,0 +1,284 @@
+/*
+    Light Tower by Rob Shockency
+    Copyright (C) 2021 Rob Shockency degnarraer@yahoo.com
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version of the License, or
+    (at your option) any later version. 3
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//Throughput benchmarks of the link encodings as googletest cases, one per encoding, data type and count. Each case
+//encodes and decodes one message for at least LINK_THROUGHPUT_MIN_TIME_MS, checks the round trip, and records the
+//results as test properties, so the googletest JSON or XML report is the machine readable result:
+//
+//  cd Tools/LinkThroughput && pio run
+//  .pio/build/native/program --gtest_output=json:link_throughput.json
+//
+//Per case: raw_bytes of the value, wire_bytes of the encoded message, and encode_ns and decode_ns per message.
+//Case names are stable, <Encoding>/LinkThroughputTest.Encode_Decode/<DataType>_<Count>, for tracking across builds.
+
+#include <Arduino.h>
+#include <DataSerializer.h>
+#include <LinkFrameReceiver.h>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#ifndef LINK_THROUGHPUT_MIN_TIME_MS
+	#define LINK_THROUGHPUT_MIN_TIME_MS 20
+#endif
+#define LINK_THROUGHPUT_CODEC_BATCH 64              //Coded frames encoded before they are decoded in the same order
+#define LINK_THROUGHPUT_MAX_FRAME_SIZE 32768        //Largest type times the largest count, encoded
+
+using namespace testing;
+
+enum LinkThroughputEncoding_t
+{
+	LinkThroughputEncoding_Json,
+	LinkThroughputEncoding_Frame,
+	LinkThroughputEncoding_Quantized8,
+	LinkThroughputEncoding_Quantized16,
+};
+
+struct LinkThroughputCase_t
+{
+	LinkThroughputEncoding_t Encoding;
+	DataType_t DataType;
+	size_t Count;
+};
+
+struct LinkThroughputResult_t
+{
+	size_t WireBytes = 0;
+	double EncodeNs = 0.0;
+	double DecodeNs = 0.0;
+	bool RoundTrip = true;
+};
+
+static const size_t g_Counts[] = { 1, 4, 32, 256 };
+
+//Runs Pass, which handles Iterations messages, with doubling iterations until it takes the minimum time. Returns ns per message.
+template <typename Pass>
+static double Measure(Pass pass)
+{
+	for(size_t Iterations = 1; ; Iterations *= 2)
+	{
+		const auto Start = std::chrono::steady_clock::now();
+		pass(Iterations);
+		const auto Elapsed = std::chrono::steady_clock::now() - Start;
+		if(Elapsed >= std::chrono::milliseconds(LINK_THROUGHPUT_MIN_TIME_MS))
+		{
+			return std::chrono::duration<double, std::nano>(Elapsed).count() / Iterations;
+		}
+	}
+}
+
+class LinkThroughputTest : public TestWithParam<LinkThroughputCase_t>
+{
+	protected:
+		DataSerializer m_Serializer;
+		std::vector<uint8_t> m_Object;
+
+		void SetUp() override
+		{
+			const LinkThroughputCase_t &Case = GetParam();
+			m_Object.resize(m_Serializer.GetSizeOfDataType(Case.DataType) * Case.Count);
+			for(size_t i = 0; i < m_Object.size(); ++i)
+			{
+				m_Object[i] = static_cast<uint8_t>((i * 37) + 11);
+			}
+			if(DataType_Float_t == Case.DataType)
+			{
+				//Sound bands rather than bit patterns, the codec quantizes them
+				float* Values = reinterpret_cast<float*>(m_Object.data());
+				for(size_t i = 0; i < Case.Count; ++i) Values[i] = 0.5f + 0.4f * std::sin(i * 0.3f);
+			}
+			if(DataType_Bool_t == Case.DataType) std::fill(m_Object.begin(), m_Object.end(), 1);
+		}
+
+		LinkThroughputResult_t RunJson()
+		{
+			const LinkThroughputCase_t &Case = GetParam();
+			LinkThroughputResult_t Result;
+			String Message;
+			Result.EncodeNs = Measure([&](size_t Iterations)
+			{
+				for(size_t i = 0; i < Iterations; ++i)
+				{
+					Message = m_Serializer.SerializeDataItemToJson("Item", Case.DataType, m_Object.data(), Case.Count, i);
+				}
+			});
+			Result.WireBytes = Message.length() + 2;  //println appends CR LF
+			Result.DecodeNs = Measure([&](size_t Iterations)
+			{
+				for(size_t i = 0; i < Iterations; ++i)
+				{
+					NamedObject_t NamedObject;
+					NamedObject.Object = nullptr;
+					Result.RoundTrip &= m_Serializer.DeSerializeJsonToNamedObject(Message, NamedObject) &&
+										(0 == memcmp(NamedObject.Object, m_Object.data(), m_Object.size()));
+				}
+			});
+			return Result;
+		}
+
+		//Decoded the way the RX task does it, byte by byte through the frame receiver and then validated
+		LinkThroughputResult_t RunFrame()
+		{
+			const LinkThroughputCase_t &Case = GetParam();
+			LinkThroughputResult_t Result;
+			std::vector<uint8_t> Frame(LINK_FRAME_MAX_ENCODED_SIZE(m_Object.size()));
+			std::unique_ptr<LinkFrameReceiver<LINK_THROUGHPUT_MAX_FRAME_SIZE>> Receiver(new LinkFrameReceiver<LINK_THROUGHPUT_MAX_FRAME_SIZE>());
+			Result.EncodeNs = Measure([&](size_t Iterations)
+			{
+				for(size_t i = 0; i < Iterations; ++i)
+				{
+					Result.WireBytes = m_Serializer.SerializeDataItemToFrame("Item", Case.DataType, m_Object.data(), Case.Count, i, i, Frame.data(), Frame.size());
+				}
+			});
+			Result.DecodeNs = Measure([&](size_t Iterations)
+			{
+				for(size_t i = 0; i < Iterations; ++i)
+				{
+					bool Delivered = false;
+					for(size_t j = 0; j < Result.WireBytes; ++j)
+					{
+						if(!Receiver->Push(Frame[j])) continue;
+						const LinkFrameView_t &View = Receiver->GetFrame();
+						Delivered = m_Serializer.ValidateFrame(View) &&
+									(View.PayloadLength == m_Object.size()) &&
+									(0 == memcmp(View.Payload, m_Object.data(), m_Object.size()));
+					}
+					Result.RoundTrip &= Delivered;
+				}
+			});
+			return Result;
+		}
+
+		//Float arrays through the link codec. The values drift a little every frame so deltas and key frames both
+		//turn up, and each pass encodes a batch of frames and then decodes them in order, as the peer would.
+		//The times are the codec's alone, wire_bytes includes the frame around it.
+		LinkThroughputResult_t RunCodec(LinkCodec_t Codec)
+		{
+			const LinkThroughputCase_t &Case = GetParam();
+			LinkThroughputResult_t Result;
+			FixedLinkFloatEncoder<LINK_CODEC_MAX_COUNT> Encoder;
+			FixedLinkFloatDecoder<LINK_CODEC_MAX_COUNT> Decoder;
+			Encoder.SetCodec(Codec);
+			const float* Source = reinterpret_cast<const float*>(m_Object.data());
+			std::vector<std::vector<float>> Values(LINK_THROUGHPUT_CODEC_BATCH, std::vector<float>(Source, Source + Case.Count));
+			std::vector<std::vector<uint8_t>> Payloads(LINK_THROUGHPUT_CODEC_BATCH, std::vector<uint8_t>(LINK_CODEC_MAX_ENCODED_SIZE(Case.Count)));
+			std::vector<size_t> Lengths(LINK_THROUGHPUT_CODEC_BATCH);
+			float Decoded[LINK_CODEC_MAX_COUNT];
+			size_t Frames = 0;
+			for(size_t b = 0; b < LINK_THROUGHPUT_CODEC_BATCH; ++b)
+			{
+				for(size_t i = 0; i < Case.Count; ++i) Values[b][i] += 0.01f * std::sin(b * 0.7f + i);
+			}
+			double EncodeNs = 0.0;
+			double DecodeNs = 0.0;
+			//Both directions are timed per batch and summed, so each gets the minimum time between them
+			const auto Start = std::chrono::steady_clock::now();
+			while(std::chrono::steady_clock::now() - Start < std::chrono::milliseconds(2 * LINK_THROUGHPUT_MIN_TIME_MS))
+			{
+				auto Begin = std::chrono::steady_clock::now();
+				for(size_t b = 0; b < LINK_THROUGHPUT_CODEC_BATCH; ++b)
+				{
+					Lengths[b] = Encoder.Encode(Values[b].data(), Case.Count, false, Payloads[b].data(), Payloads[b].size());
+					Encoder.Accept(false);
+				}
+				auto End = std::chrono::steady_clock::now();
+				EncodeNs += std::chrono::duration<double, std::nano>(End - Begin).count();
+				Begin = End;
+				for(size_t b = 0; b < LINK_THROUGHPUT_CODEC_BATCH; ++b)
+				{
+					Result.RoundTrip &= Decoder.Decode(Payloads[b].data(), Lengths[b], Decoded, Case.Count);
+				}
+				End = std::chrono::steady_clock::now();
+				DecodeNs += std::chrono::duration<double, std::nano>(End - Begin).count();
+				Frames += LINK_THROUGHPUT_CODEC_BATCH;
+			}
+			const float Scale = (LinkCodec_Quantized8 == Codec) ? UINT8_MAX : UINT16_MAX;
+			for(size_t i = 0; i < Case.Count; ++i)
+			{
+				Result.RoundTrip &= std::fabs(Decoded[i] - Values.back()[i]) <= 2.0f / Scale;
+			}
+			Result.EncodeNs = EncodeNs / Frames;
+			Result.DecodeNs = DecodeNs / Frames;
+			//Average frame of the last batch, with the header and CRC around the coded values
+			LinkFrameHeader_t Header;
+			Header.DataType = DataType_Float_t | LINK_DATATYPE_FLAG_ENCODED;
+			Header.Count = Case.Count;
+			std::vector<uint8_t> Frame(LINK_FRAME_MAX_ENCODED_SIZE(LINK_CODEC_MAX_ENCODED_SIZE(Case.Count)));
+			for(size_t b = 0; b < LINK_THROUGHPUT_CODEC_BATCH; ++b)
+			{
+				Result.WireBytes += EncodeLinkFrame(Header, Payloads[b].data(), Lengths[b], Frame.data(), Frame.size());
+			}
+			Result.WireBytes /= LINK_THROUGHPUT_CODEC_BATCH;
+			return Result;
+		}
+};
+
+TEST_P(LinkThroughputTest, Encode_Decode)
+{
+	const LinkThroughputCase_t &Case = GetParam();
+	LinkThroughputResult_t Result;
+	switch(Case.Encoding)
+	{
+		case LinkThroughputEncoding_Json: Result = RunJson(); break;
+		case LinkThroughputEncoding_Frame: Result = RunFrame(); break;
+		case LinkThroughputEncoding_Quantized8: Result = RunCodec(LinkCodec_Quantized8); break;
+		case LinkThroughputEncoding_Quantized16: Result = RunCodec(LinkCodec_Quantized16); break;
+	}
+	EXPECT_TRUE(Result.RoundTrip);
+	EXPECT_GT(Result.WireBytes, 0);
+	RecordProperty("raw_bytes", static_cast<int>(m_Object.size()));
+	RecordProperty("wire_bytes", static_cast<int>(Result.WireBytes));
+	RecordProperty("encode_ns", static_cast<int>(std::lround(Result.EncodeNs)));
+	RecordProperty("decode_ns", static_cast<int>(std::lround(Result.DecodeNs)));
+}
+
+static std::vector<LinkThroughputCase_t> GetCases(LinkThroughputEncoding_t Encoding)
+{
+	std::vector<LinkThroughputCase_t> Cases;
+	for(int DataType = 0; DataType < DataType_Undef; ++DataType)
+	{
+		//String items go over the link as Char_t arrays, a String object has no wire form
+		if(DataType_String_t == DataType) continue;
+		const bool Coded = (LinkThroughputEncoding_Quantized8 == Encoding) || (LinkThroughputEncoding_Quantized16 == Encoding);
+		if(Coded && DataType_Float_t != DataType) continue;
+		for(size_t Count : g_Counts)
+		{
+			if(Coded && Count > LINK_CODEC_MAX_COUNT) continue;
+			Cases.push_back({ Encoding, static_cast<DataType_t>(DataType), Count });
+		}
+	}
+	return Cases;
+}
+
+static std::string GetCaseName(const TestParamInfo<LinkThroughputCase_t> &Info)
+{
+	return std::string(DataTypeStrings[Info.param.DataType]) + "_" + std::to_string(Info.param.Count);
+}
+
+INSTANTIATE_TEST_SUITE_P(Json, LinkThroughputTest, ValuesIn(GetCases(LinkThroughputEncoding_Json)), GetCaseName);
+INSTANTIATE_TEST_SUITE_P(Frame, LinkThroughputTest, ValuesIn(GetCases(LinkThroughputEncoding_Frame)), GetCaseName);
+INSTANTIATE_TEST_SUITE_P(Quantized8, LinkThroughputTest, ValuesIn(GetCases(LinkThroughputEncoding_Quantized8)), GetCaseName);
+INSTANTIATE_TEST_SUITE_P(Quantized16, LinkThroughputTest, ValuesIn(GetCases(LinkThroughputEncoding_Quantized16)), GetCaseName);
+
+int main(int argc, char** argv)
+{
+	InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}